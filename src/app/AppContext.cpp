@@ -2,6 +2,16 @@
 #include <QFile>
 #include <QApplication>
 #include <QDebug>
+#include <QSettings>
+#include <QStandardPaths>
+
+namespace
+{
+	QString settingsPath()
+	{
+		return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + QStringLiteral("/settings.ini");
+	}
+}
 
 void AppContext::loadStyle(const QString& qssPath)
 {
@@ -15,3 +25,24 @@ void AppContext::loadStyle(const QString& qssPath)
 // 	qDebug().noquote() << "[Style] head =" << style.left(200);
 	qApp->setStyleSheet(style);
 }
+
+void AppContext::loadSettings()
+{
+	QSettings settings(settingsPath(), QSettings::IniFormat);
+	thumbnailService.setDiskCacheEnabled(settings.value(QStringLiteral("thumbnails/diskCache"), true).toBool());
+	const qint64 limitMB = settings.value(QStringLiteral("thumbnails/diskCacheLimitMB"),
+		thumbnailService.diskCacheLimit() / (1024 * 1024)).toLongLong();
+	thumbnailService.setDiskCacheLimit(limitMB * 1024 * 1024);
+
+	lodMipBelow = settings.value(QStringLiteral("map/lodMipBelow"), lodMipBelow).toDouble();
+	lodColorBelow = settings.value(QStringLiteral("map/lodColorBelow"), lodColorBelow).toDouble();
+}
+
+void AppContext::saveSettings() const
+{
+	QSettings settings(settingsPath(), QSettings::IniFormat);
+	settings.setValue(QStringLiteral("thumbnails/diskCache"), thumbnailService.isDiskCacheEnabled());
+	settings.setValue(QStringLiteral("thumbnails/diskCacheLimitMB"), thumbnailService.diskCacheLimit() / (1024 * 1024));
+	settings.setValue(QStringLiteral("map/lodMipBelow"), lodMipBelow);
+	settings.setValue(QStringLiteral("map/lodColorBelow"), lodColorBelow);
+}
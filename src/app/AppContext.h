@@ -1,15 +1,31 @@
 #pragma once
 
 #include "DocumentManager.h"
+#include "PrefabLibrary.h"
+#include "ThumbnailService.h"
 
 class AppContext
 {
 public:
 	AppContext() = default;
 
-	// ʱֻһԱӸ
+	// ĵ
 	DocumentManager documentManager;
 
+	// Ԥ
+	PrefabLibrary prefabLibrary;
+
+	// ͼƬ༭ͼ干ã
+	ThumbnailService thumbnailService;
+
 	// ӣáʽ
 	void loadStyle(const QString& qssPath);
+
+	// ûãͼ̻濪غޡͼϸڲ㼶ֵûĿ¼ settings.ini
+	void loadSettings();
+	void saveSettings() const;
+
+	// ͼŵ lodMipBelow ʱƷֿСͼ lodColorBelow ʱÿֻƽɫ
+	double lodMipBelow = 0.3;
+	double lodColorBelow = 0.15;
 };
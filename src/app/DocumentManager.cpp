@@ -22,3 +22,11 @@ void DocumentManager::newDefaultDocument()
 	m_hasDocument = true;
 	emit documentChanged();
 }
+
+void DocumentManager::newInfiniteDocument()
+{
+	m_document = MapDocument(50, 30, 32, 32, QStringLiteral("Untitled Infinite Map"));
+	m_document.infinite = true;
+	m_hasDocument = true;
+	emit documentChanged();
+}
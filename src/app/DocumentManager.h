@@ -17,6 +17,9 @@ public:
 	// ½һ򵥵Ĭĵ
 	void newDefaultDocument();
 
+	// ½޵ͼĵֿʽأ
+	void newInfiniteDocument();
+
 signals:
 	// ĵ仯źţ½/أ
 	void documentChanged();
@@ -0,0 +1,65 @@
+#include "PrefabLibrary.h"
+
+PrefabLibrary::PrefabLibrary(QObject* parent)
+	: QObject(parent)
+{
+}
+
+QUuid PrefabLibrary::addPrefab(const QString& name, const TileRegionData& content)
+{
+	PrefabDefinition prefab;
+	prefab.id = QUuid::createUuid();
+	prefab.name = name;
+	prefab.content = content;
+
+	m_prefabs.insert(prefab.id, prefab);
+	m_order.append(prefab.id);
+
+	emit prefabAdded(prefab.id);
+	return prefab.id;
+}
+
+bool PrefabLibrary::updatePrefab(const QUuid& id, const TileRegionData& content)
+{
+	auto it = m_prefabs.find(id);
+	if (it == m_prefabs.end())
+		return false;
+
+	it->content = content;
+	it->revision++;
+
+	emit prefabChanged(id);
+	return true;
+}
+
+bool PrefabLibrary::renamePrefab(const QUuid& id, const QString& name)
+{
+	auto it = m_prefabs.find(id);
+	if (it == m_prefabs.end())
+		return false;
+
+	it->name = name;
+	return true;
+}
+
+void PrefabLibrary::clear()
+{
+	m_prefabs.clear();
+	m_order.clear();
+	emit prefabsCleared();
+}
+
+const PrefabDefinition* PrefabLibrary::prefab(const QUuid& id) const
+{
+	auto it = m_prefabs.constFind(id);
+	return it == m_prefabs.constEnd() ? nullptr : &it.value();
+}
+
+QVector<PrefabDefinition> PrefabLibrary::prefabs() const
+{
+	QVector<PrefabDefinition> result;
+	result.reserve(m_order.size());
+	for (const QUuid& id : m_order)
+		result.append(m_prefabs.value(id));
+	return result;
+}
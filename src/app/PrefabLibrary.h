@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include "../core/PrefabDefine.h"
+
+// Ԥ⣺Ԥ嶨壬޸ĺ֪ͨͼˢʵ
+class PrefabLibrary : public QObject
+{
+	Q_OBJECT
+public:
+	explicit PrefabLibrary(QObject* parent = nullptr);
+
+	// ½Ԥ壬 ID
+	QUuid addPrefab(const QString& name, const TileRegionData& content);
+
+	// 滻Ԥݣʵ֮£
+	bool updatePrefab(const QUuid& id, const TileRegionData& content);
+	bool renamePrefab(const QUuid& id, const QString& name);
+
+	void clear();
+
+	// ѯҲ nullptr
+	const PrefabDefinition* prefab(const QUuid& id) const;
+
+	// ˳򷵻
+	QVector<PrefabDefinition> prefabs() const;
+	bool isEmpty() const { return m_prefabs.isEmpty(); }
+
+signals:
+	void prefabAdded(const QUuid& id);
+	void prefabChanged(const QUuid& id);
+	void prefabsCleared();
+
+private:
+	QHash<QUuid, PrefabDefinition> m_prefabs;
+	QVector<QUuid> m_order;
+};
@@ -0,0 +1,265 @@
+#include "ThumbnailService.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
+
+namespace
+{
+	// Ĭڴ滺
+	constexpr qint64 DefaultMemoryLimit = 64ll * 1024 * 1024;
+
+	// Ĭϴ̻
+	constexpr qint64 DefaultDiskCacheLimit = 256ll * 1024 * 1024;
+
+	// ÿдôļһδ̻С
+	constexpr int DiskTrimInterval = 64;
+
+	// ûԴļͼıʶǰ׺д̻棩
+	const QString MemoryKeyPrefix = QStringLiteral("mem-");
+}
+
+ThumbnailService::ThumbnailService(QObject* parent)
+	: QObject(parent)
+{
+	setMemoryLimit(DefaultMemoryLimit);
+	m_diskCacheLimit = DefaultDiskCacheLimit;
+
+	const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	if (!cacheRoot.isEmpty())
+		m_diskCacheDir = cacheRoot + QStringLiteral("/thumbnails");
+
+	// һĸ߳
+	m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+ThumbnailService::~ThumbnailService()
+{
+	m_pool.clear();
+	m_pool.waitForDone();
+}
+
+QString ThumbnailService::registerImage(const QImage& image, const QString& filePath)
+{
+	if (image.isNull())
+		return QString();
+
+	auto known = m_hashOfCacheKey.constFind(image.cacheKey());
+	if (known != m_hashOfCacheKey.constEnd())
+	{
+		++m_sources[known.value()].refCount;
+		return known.value();
+	}
+
+	// Դļ·޸ʱʹСͼߴ͸ʽϣȡ
+	QString imageKey;
+	const QFileInfo info(filePath);
+	if (!filePath.isEmpty() && info.exists())
+	{
+		const QString identity = QStringLiteral("%1|%2|%3|%4x%5|%6").arg(info.absoluteFilePath())
+			.arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size())
+			.arg(image.width()).arg(image.height()).arg(static_cast<int>(image.format()));
+		imageKey = QString::fromLatin1(QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Md5).toHex());
+	}
+	else
+	{
+		imageKey = MemoryKeyPrefix + QString::number(image.cacheKey());
+	}
+	m_hashOfCacheKey.insert(image.cacheKey(), imageKey);
+
+	SourceImage& source = m_sources[imageKey];
+	if (source.image.isNull())
+		source.image = image;
+	++source.refCount;
+	return imageKey;
+}
+
+void ThumbnailService::releaseImage(const QString& imageKey)
+{
+	auto it = m_sources.find(imageKey);
+	if (it == m_sources.end() || --it->refCount > 0)
+		return;
+
+	// ɵͼڻУ¼ͬһͼʱԿ
+	m_sources.erase(it);
+	for (auto known = m_hashOfCacheKey.begin(); known != m_hashOfCacheKey.end();)
+	{
+		if (known.value() == imageKey)
+			known = m_hashOfCacheKey.erase(known);
+		else
+			++known;
+	}
+}
+
+QString ThumbnailService::thumbnailKey(const QString& imageKey, const QRect& rect, const QSize& size)
+{
+	return QStringLiteral("%1/%2_%3_%4x%5_%6x%7").arg(imageKey)
+		.arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height())
+		.arg(size.width()).arg(size.height());
+}
+
+QImage ThumbnailService::thumbnail(const QString& imageKey, const QRect& rect, const QSize& size)
+{
+	if (imageKey.isEmpty() || rect.isEmpty() || size.isEmpty())
+		return QImage();
+
+	const QString key = thumbnailKey(imageKey, rect, size);
+	if (const QImage* cached = m_memory.object(key))
+		return *cached;
+
+	if (m_pending.contains(key))
+		return QImage();
+
+	auto source = m_sources.constFind(imageKey);
+	if (source == m_sources.constEnd())
+		return QImage();
+
+	m_pending.insert(key);
+
+	const QImage image = source->image;
+	const QString path = diskPath(key);
+	m_pool.start([this, key, image, rect, size, path]() {
+		bool written = false;
+		const QImage thumb = loadOrRender(image, rect, size, path, &written);
+		QMetaObject::invokeMethod(this, [this, key, thumb, written]() {
+			onThumbnailBuilt(key, thumb, written);
+			}, Qt::QueuedConnection);
+		});
+
+	return QImage();
+}
+
+void ThumbnailService::setDiskCacheDir(const QString& dir)
+{
+	m_diskCacheDir = dir;
+	scheduleDiskTrim();
+}
+
+void ThumbnailService::setDiskCacheEnabled(bool enabled)
+{
+	if (m_diskCacheEnabled == enabled)
+		return;
+
+	m_diskCacheEnabled = enabled;
+	scheduleDiskTrim();
+}
+
+void ThumbnailService::setDiskCacheLimit(qint64 bytes)
+{
+	m_diskCacheLimit = qMax<qint64>(0, bytes);
+	scheduleDiskTrim();
+}
+
+void ThumbnailService::setMemoryLimit(qint64 bytes)
+{
+	m_memory.setMaxCost(static_cast<int>(qBound<qint64>(1, bytes / 1024, INT_MAX)));
+}
+
+QImage ThumbnailService::loadOrRender(const QImage& source, const QRect& rect, const QSize& size, const QString& diskPath, bool* written)
+{
+	if (!diskPath.isEmpty())
+	{
+		QImage cached(diskPath);
+		if (!cached.isNull())
+		{
+			// ޸ʱ伴ʹʱ䣬̭ʱ
+			QFile file(diskPath);
+			if (file.open(QIODevice::ReadWrite))
+				file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+			return cached.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+		}
+	}
+
+	QImage thumb = source.copy(rect);
+	if (thumb.size() != thumb.size().scaled(size, Qt::KeepAspectRatio))
+		thumb = thumb.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	thumb = thumb.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+	if (!diskPath.isEmpty() && QDir().mkpath(QFileInfo(diskPath).absolutePath()))
+		*written = thumb.save(diskPath, "PNG");
+
+	return thumb;
+}
+
+void ThumbnailService::trimDiskCache(const QString& dir, qint64 limit)
+{
+	struct CacheFile
+	{
+		qint64 lastUsed = 0;
+		qint64 size = 0;
+		QString path;
+	};
+
+	QVector<CacheFile> files;
+	qint64 total = 0;
+	QDirIterator it(dir, QStringList() << QStringLiteral("*.png"), QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		it.next();
+		const QFileInfo info = it.fileInfo();
+		files.append(CacheFile{ info.lastModified().toMSecsSinceEpoch(), info.size(), info.filePath() });
+		total += info.size();
+	}
+	if (total <= limit)
+		return;
+
+	// һζɾһЩÿдҪɨ
+	const qint64 target = limit / 10 * 8;
+	std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.lastUsed < b.lastUsed; });
+
+	int removed = 0;
+	for (const CacheFile& file : files)
+	{
+		if (total <= target)
+			break;
+		if (QFile::remove(file.path))
+		{
+			total -= file.size;
+			++removed;
+		}
+	}
+	qDebug() << "ThumbnailService: evicted" << removed << "disk thumbnails, remaining bytes:" << total;
+}
+
+void ThumbnailService::scheduleDiskTrim()
+{
+	m_writesSinceTrim = 0;
+	if (m_trimPending || !m_diskCacheEnabled || m_diskCacheDir.isEmpty())
+		return;
+
+	m_trimPending = true;
+	const QString dir = m_diskCacheDir;
+	const qint64 limit = m_diskCacheLimit;
+	m_pool.start([this, dir, limit]() {
+		trimDiskCache(dir, limit);
+		QMetaObject::invokeMethod(this, [this]() { m_trimPending = false; }, Qt::QueuedConnection);
+		});
+}
+
+void ThumbnailService::onThumbnailBuilt(const QString& key, const QImage& image, bool written)
+{
+	m_pending.remove(key);
+	if (written && ++m_writesSinceTrim >= DiskTrimInterval)
+		scheduleDiskTrim();
+
+	if (image.isNull())
+		return;
+
+	m_memory.insert(key, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+	emit thumbnailReady(key);
+}
+
+QString ThumbnailService::diskPath(const QString& key) const
+{
+	// е '/' ͬһͼͼͬһĿ¼ûԴļͼֻڴл
+	if (!m_diskCacheEnabled || m_diskCacheDir.isEmpty() || key.startsWith(MemoryKeyPrefix))
+		return QString();
+	return m_diskCacheDir + QLatin1Char('/') + key + QStringLiteral(".png");
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+
+// ͼƬ༭ͼ干
+// - ͼ (Դļʶ, Ƭ, Ŀߴ) ʶͬһļظҲ
+// - Դļʶ·޸ʱļСõȡأûļͼֻʹڴ滺
+// - δʱؿͼ̳߳ɣȲ̻棩ɺ󷢳 thumbnailReady
+// - ڴаʹñһֽڼƳɱ
+// - ̻ɹرգʱ̳߳аʹʱ̭
+class ThumbnailService : public QObject
+{
+	Q_OBJECT
+public:
+	explicit ThumbnailService(QObject* parent = nullptr);
+	~ThumbnailService();
+
+	// ǼԴͼ񣬷Դͼʶ֮ͼ
+	// filePath ΪͼԴļΪջļʱʶֻڱЧд̻
+	// ͬһ QImagecacheKey ֻͬһαʶǼͷųɶԵ
+	QString registerImage(const QImage& image, const QString& filePath = QString());
+	void releaseImage(const QString& imageKey);
+
+	// ͼʶ
+	static QString thumbnailKey(const QString& imageKey, const QRect& rect, const QSize& size);
+
+	// ȡͼŵ size ڣδʱؿͼʼ̨
+	QImage thumbnail(const QString& imageKey, const QRect& rect, const QSize& size);
+
+	// ̻Ŀ¼Ϊʱʹô̻棩
+	void setDiskCacheDir(const QString& dir);
+	QString diskCacheDir() const { return m_diskCacheDir; }
+
+	// ̻濪أرպ󲻶Ҳдļ
+	void setDiskCacheEnabled(bool enabled);
+	bool isDiskCacheEnabled() const { return m_diskCacheEnabled; }
+
+	// ̻ޣֽڣʱ̭δʹõͼ
+	void setDiskCacheLimit(qint64 bytes);
+	qint64 diskCacheLimit() const { return m_diskCacheLimit; }
+
+	// ڴ滺ޣֽڣ
+	void setMemoryLimit(qint64 bytes);
+
+signals:
+	void thumbnailReady(const QString& key);
+
+private:
+	struct SourceImage
+	{
+		QImage image;
+		int refCount = 0;
+	};
+
+	// ִ߳У̻棨ʱļʱΪʹãûɲд
+	static QImage loadOrRender(const QImage& source, const QRect& rect, const QSize& size, const QString& diskPath, bool* written);
+
+	// ִ߳УܴС limit ʱ޸ʱӾɵɾ޵İ˳
+	static void trimDiskCache(const QString& dir, qint64 limit);
+
+	void onThumbnailBuilt(const QString& key, const QImage& image, bool written);
+	void scheduleDiskTrim();
+	QString diskPath(const QString& key) const;
+
+private:
+	QHash<QString, SourceImage> m_sources;          // ݹϣ -> Դͼ
+	QHash<qint64, QString> m_hashOfCacheKey;        // QImage::cacheKey -> ݹϣ
+	QCache<QString, QImage> m_memory;               // ͼ LRUɱΪ KB
+	QSet<QString> m_pending;                        // ɵͼ
+	QString m_diskCacheDir;
+	bool m_diskCacheEnabled = true;
+	qint64 m_diskCacheLimit = 0;
+	int m_writesSinceTrim = 0;                      // ϴ̭дļ
+	bool m_trimPending = false;
+	QThreadPool m_pool;
+};
@@ -0,0 +1,382 @@
+#include "CollisionBaker.h"
+#include "MapChunkCache.h"
+
+#include <algorithm>
+
+namespace
+{
+	quint64 pointKey(int x, int y)
+	{
+		return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+	}
+
+	// ׷õߣڲǰҲࣩ
+	struct OutlineEdge
+	{
+		QPoint from;
+		QPoint to;
+		bool used = false;
+	};
+}
+
+// ============== 決 ==============
+
+void CollisionBaker::clear()
+{
+	m_chunks.clear();
+	m_dirty.clear();
+	m_rectCount = 0;
+}
+
+void CollisionBaker::markDirty(const QRect& gridRect)
+{
+	if (gridRect.isEmpty())
+		return;
+
+	const QPoint first = MapChunkCache::chunkOf(gridRect.left(), gridRect.top());
+	const QPoint last = MapChunkCache::chunkOf(gridRect.right(), gridRect.bottom());
+	for (int cy = first.y(); cy <= last.y(); ++cy)
+	{
+		for (int cx = first.x(); cx <= last.x(); ++cx)
+		{
+			const QPoint chunk(cx, cy);
+			m_dirty.insert(MapChunkCache::chunkKey(chunk), chunk);
+		}
+	}
+}
+
+QVector<QPoint> CollisionBaker::takeDirtyChunks()
+{
+	QVector<QPoint> chunks;
+	chunks.reserve(m_dirty.size());
+	for (const QPoint& chunk : m_dirty)
+		chunks.append(chunk);
+	m_dirty.clear();
+	return chunks;
+}
+
+void CollisionBaker::setChunkRects(const QPoint& chunk, const QVector<CollisionRect>& rects)
+{
+	const quint64 key = MapChunkCache::chunkKey(chunk);
+	m_rectCount -= m_chunks.value(key).size();
+
+	if (rects.isEmpty())
+	{
+		m_chunks.remove(key);
+		return;
+	}
+
+	m_chunks.insert(key, rects);
+	m_rectCount += rects.size();
+}
+
+void CollisionBaker::translate(const QPoint& delta)
+{
+	if (delta.isNull())
+		return;
+
+	// ƫƺοܿԽµķֿ߽磬пԵķֿ
+	// пľβһϲڷֿ´α༭ʱº決
+	QHash<quint64, QVector<CollisionRect>> chunks;
+	chunks.reserve(m_chunks.size());
+	int rectCount = 0;
+	for (const QVector<CollisionRect>& chunkRects : m_chunks)
+	{
+		for (const CollisionRect& rect : chunkRects)
+		{
+			const QRect cells = rect.cells.translated(delta);
+			const QPoint first = MapChunkCache::chunkOf(cells.left(), cells.top());
+			const QPoint last = MapChunkCache::chunkOf(cells.right(), cells.bottom());
+			for (int cy = first.y(); cy <= last.y(); ++cy)
+			{
+				for (int cx = first.x(); cx <= last.x(); ++cx)
+				{
+					const QPoint chunk(cx, cy);
+					chunks[MapChunkCache::chunkKey(chunk)].append(
+						CollisionRect{ cells.intersected(MapChunkCache::chunkRect(chunk)), rect.type });
+					++rectCount;
+				}
+			}
+		}
+	}
+	m_chunks = std::move(chunks);
+	m_rectCount = rectCount;
+
+	const QHash<quint64, QPoint> dirty = std::move(m_dirty);
+	m_dirty.clear();
+	for (const QPoint& chunk : dirty)
+		markDirty(MapChunkCache::chunkRect(chunk).translated(delta));
+}
+
+QVector<CollisionRect> CollisionBaker::rects() const
+{
+	QVector<CollisionRect> result;
+	result.reserve(m_rectCount);
+	for (const QVector<CollisionRect>& chunkRects : m_chunks)
+		result += chunkRects;
+	return result;
+}
+
+// ============== 決㷨 ==============
+
+QVector<CollisionType> CollisionBaker::rasterize(const QRect& area, QVector<CollisionFootprint> footprints)
+{
+	QVector<CollisionType> cells(area.width() * area.height(), CollisionType::None);
+
+	// ͼдͼ㸲
+	std::stable_sort(footprints.begin(), footprints.end(),
+		[](const CollisionFootprint& a, const CollisionFootprint& b) { return a.layer < b.layer; });
+
+	for (const CollisionFootprint& footprint : footprints)
+	{
+		if (footprint.type == CollisionType::None)
+			continue;
+
+		const QRect clipped = footprint.cells.intersected(area);
+		for (int y = clipped.top(); y <= clipped.bottom(); ++y)
+		{
+			const int rowStart = (y - area.top()) * area.width() + (clipped.left() - area.left());
+			std::fill_n(cells.begin() + rowStart, clipped.width(), footprint.type);
+		}
+	}
+
+	return cells;
+}
+
+QVector<CollisionRect> CollisionBaker::greedyMesh(const QVector<CollisionType>& cells, const QRect& area)
+{
+	QVector<CollisionRect> result;
+	const int width = area.width();
+	const int height = area.height();
+	if (cells.size() != width * height)
+		return result;
+
+	QVector<bool> consumed(cells.size(), false);
+	auto at = [width](int x, int y) { return y * width + x; };
+
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const CollisionType type = cells[at(x, y)];
+			if (type == CollisionType::None || consumed[at(x, y)])
+				continue;
+
+			// ͬ
+			int w = 1;
+			while (x + w < width && !consumed[at(x + w, y)] && cells[at(x + w, y)] == type)
+				++w;
+
+			// չζΪͬͲż
+			int h = 1;
+			for (; y + h < height; ++h)
+			{
+				bool rowMatches = true;
+				for (int dx = 0; dx < w && rowMatches; ++dx)
+					rowMatches = !consumed[at(x + dx, y + h)] && cells[at(x + dx, y + h)] == type;
+				if (!rowMatches)
+					break;
+			}
+
+			for (int dy = 0; dy < h; ++dy)
+				std::fill_n(consumed.begin() + at(x, y + dy), w, true);
+
+			result.append(CollisionRect{ QRect(area.left() + x, area.top() + y, w, h), type });
+			x += w - 1;
+		}
+	}
+
+	return result;
+}
+
+QVector<CollisionRect> CollisionBaker::mergeAdjacent(QVector<CollisionRect> rects)
+{
+	// ƴӣͬͬ͡зΧٺƴӣͬͬ͡зΧֱټ
+	int previousCount = -1;
+	while (rects.size() != previousCount)
+	{
+		previousCount = rects.size();
+
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			const bool vertical = (pass == 0);
+			std::sort(rects.begin(), rects.end(), [vertical](const CollisionRect& a, const CollisionRect& b) {
+				if (a.type != b.type) return a.type < b.type;
+				if (vertical)
+				{
+					if (a.cells.left() != b.cells.left()) return a.cells.left() < b.cells.left();
+					if (a.cells.width() != b.cells.width()) return a.cells.width() < b.cells.width();
+					return a.cells.top() < b.cells.top();
+				}
+				if (a.cells.top() != b.cells.top()) return a.cells.top() < b.cells.top();
+				if (a.cells.height() != b.cells.height()) return a.cells.height() < b.cells.height();
+				return a.cells.left() < b.cells.left();
+				});
+
+			QVector<CollisionRect> merged;
+			merged.reserve(rects.size());
+			for (const CollisionRect& rect : rects)
+			{
+				if (!merged.isEmpty())
+				{
+					CollisionRect& last = merged.last();
+					const bool sameType = last.type == rect.type;
+					const bool joins = vertical
+						? (last.cells.left() == rect.cells.left() && last.cells.width() == rect.cells.width()
+							&& last.cells.bottom() + 1 == rect.cells.top())
+						: (last.cells.top() == rect.cells.top() && last.cells.height() == rect.cells.height()
+							&& last.cells.right() + 1 == rect.cells.left());
+					if (sameType && joins)
+					{
+						last.cells = last.cells.united(rect.cells);
+						continue;
+					}
+				}
+				merged.append(rect);
+			}
+			rects = std::move(merged);
+		}
+	}
+
+	return rects;
+}
+
+QVector<CollisionRect> CollisionBaker::bake(const QVector<CollisionFootprint>& footprints)
+{
+	// ֿ飨ֿƬÿཻķֿ飩
+	QHash<quint64, QPoint> chunks;
+	QHash<quint64, QVector<CollisionFootprint>> chunkFootprints;
+	for (const CollisionFootprint& footprint : footprints)
+	{
+		if (footprint.type == CollisionType::None || footprint.cells.isEmpty())
+			continue;
+
+		const QPoint first = MapChunkCache::chunkOf(footprint.cells.left(), footprint.cells.top());
+		const QPoint last = MapChunkCache::chunkOf(footprint.cells.right(), footprint.cells.bottom());
+		for (int cy = first.y(); cy <= last.y(); ++cy)
+		{
+			for (int cx = first.x(); cx <= last.x(); ++cx)
+			{
+				const QPoint chunk(cx, cy);
+				const quint64 key = MapChunkCache::chunkKey(chunk);
+				chunks.insert(key, chunk);
+				chunkFootprints[key].append(footprint);
+			}
+		}
+	}
+
+	QVector<CollisionRect> rects;
+	for (auto it = chunks.constBegin(); it != chunks.constEnd(); ++it)
+	{
+		const QRect area = MapChunkCache::chunkRect(it.value());
+		rects += greedyMesh(rasterize(area, chunkFootprints.value(it.key())), area);
+	}
+
+	return mergeAdjacent(std::move(rects));
+}
+
+QVector<CollisionPolygon> CollisionBaker::traceOutlines(const QVector<CollisionRect>& rects)
+{
+	// ռ
+	QHash<int, QSet<quint64>> cellsByType;
+	for (const CollisionRect& rect : rects)
+	{
+		QSet<quint64>& cells = cellsByType[static_cast<int>(rect.type)];
+		for (int y = rect.cells.top(); y <= rect.cells.bottom(); ++y)
+		{
+			for (int x = rect.cells.left(); x <= rect.cells.right(); ++x)
+				cells.insert(pointKey(x, y));
+		}
+	}
+
+	QVector<CollisionPolygon> polygons;
+	for (auto typeIt = cellsByType.constBegin(); typeIt != cellsByType.constEnd(); ++typeIt)
+	{
+		const QSet<quint64>& cells = typeIt.value();
+
+		// ߽ߣڸӲͬһ͵һ
+		QVector<OutlineEdge> edges;
+		QMultiHash<quint64, int> outgoing;
+		auto addEdge = [&](int x0, int y0, int x1, int y1) {
+			outgoing.insert(pointKey(x0, y0), edges.size());
+			edges.append(OutlineEdge{ QPoint(x0, y0), QPoint(x1, y1) });
+		};
+
+		for (quint64 key : cells)
+		{
+			const int x = static_cast<int>(static_cast<quint32>(key >> 32));
+			const int y = static_cast<int>(static_cast<quint32>(key));
+			if (!cells.contains(pointKey(x, y - 1))) addEdge(x, y, x + 1, y);
+			if (!cells.contains(pointKey(x + 1, y))) addEdge(x + 1, y, x + 1, y + 1);
+			if (!cells.contains(pointKey(x, y + 1))) addEdge(x + 1, y + 1, x, y + 1);
+			if (!cells.contains(pointKey(x - 1, y))) addEdge(x, y + 1, x, y);
+		}
+
+		for (int start = 0; start < edges.size(); ++start)
+		{
+			if (edges[start].used)
+				continue;
+
+			QVector<QPoint> loop;
+			int current = start;
+			while (current >= 0 && !edges[current].used)
+			{
+				OutlineEdge& edge = edges[current];
+				edge.used = true;
+				loop.append(edge.from);
+
+				// ͬһжߣԽӣʱתʹԽӵԱպ
+				const QPoint dir = edge.to - edge.from;
+				const QPoint preferred[3] = { QPoint(-dir.y(), dir.x()), dir, QPoint(dir.y(), -dir.x()) };
+				int next = -1;
+				const QList<int> candidates = outgoing.values(pointKey(edge.to.x(), edge.to.y()));
+				for (const QPoint& wanted : preferred)
+				{
+					for (int candidate : candidates)
+					{
+						if (!edges[candidate].used && edges[candidate].to - edges[candidate].from == wanted)
+						{
+							next = candidate;
+							break;
+						}
+					}
+					if (next >= 0)
+						break;
+				}
+				current = next;
+			}
+
+			// ȥ߶
+			QVector<QPoint> simplified;
+			for (int i = 0; i < loop.size(); ++i)
+			{
+				const QPoint& prev = loop[(i + loop.size() - 1) % loop.size()];
+				const QPoint& point = loop[i];
+				const QPoint& next = loop[(i + 1) % loop.size()];
+				const QPoint a = point - prev;
+				const QPoint b = next - point;
+				if (a.x() * b.y() - a.y() * b.x() != 0)
+					simplified.append(point);
+			}
+			if (simplified.size() < 4)
+				continue;
+
+			// ΪĻϵ˳ʱ룩׶Ϊ
+			qint64 area2 = 0;
+			for (int i = 0; i < simplified.size(); ++i)
+			{
+				const QPoint& p = simplified[i];
+				const QPoint& q = simplified[(i + 1) % simplified.size()];
+				area2 += static_cast<qint64>(p.x()) * q.y() - static_cast<qint64>(q.x()) * p.y();
+			}
+
+			CollisionPolygon polygon;
+			polygon.points = std::move(simplified);
+			polygon.type = static_cast<CollisionType>(typeIt.key());
+			polygon.hole = area2 < 0;
+			polygons.append(polygon);
+		}
+	}
+
+	return polygons;
+}
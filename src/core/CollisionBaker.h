@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QHash>
+#include <QPoint>
+#include <QRect>
+#include <QSet>
+#include <QVector>
+#include "SpriteSliceDefine.h"
+
+// ϲײΣ꣩
+struct CollisionRect
+{
+	QRect cells;
+	CollisionType type = CollisionType::None;
+};
+
+// ײΪӽǵ꣬˳ʱ롢׶ʱ룬Ļϵ
+struct CollisionPolygon
+{
+	QVector<QPoint> points;
+	CollisionType type = CollisionType::None;
+	bool hole = false;
+};
+
+// ƬռõĸӼײͣ決룩
+struct CollisionFootprint
+{
+	QRect cells;
+	int layer = 0;
+	CollisionType type = CollisionType::None;
+};
+
+// ײ決ͬײ͵ڸӺϲΪľΣ̰ϲ
+// - ӵײȡͼз None ƬNone Ƭ²ײ
+// - ֿ決༭ʱֻֿ飻ʱٰѿֿ߽ľƴ
+class CollisionBaker
+{
+public:
+	// ========== 決༭Ԥ ==========
+	void clear();
+
+	// ڵķֿҪ
+	void markDirty(const QRect& gridRect);
+	bool hasDirty() const { return !m_dirty.isEmpty(); }
+	QVector<QPoint> takeDirtyChunks();
+
+	// дֿĺ決սƳֿ飩
+	void setChunkRects(const QPoint& chunk, const QVector<CollisionRect>& rects);
+
+	// ԭƽƣѺ決ľκֿƫƣµķֿ߽пº決
+	void translate(const QPoint& delta);
+
+	// ǰзֿľ
+	QVector<CollisionRect> rects() const;
+	const QHash<quint64, QVector<CollisionRect>>& chunks() const { return m_chunks; }
+	int rectCount() const { return m_rectCount; }
+
+	// ========== 決㷨 ==========
+	// Ѹ area ƬդΪ飨ȣarea.width() * area.height()
+	static QVector<CollisionType> rasterize(const QRect& area, QVector<CollisionFootprint> footprints);
+
+	// ̰ĺϲͬΣչչΪֹ
+	static QVector<CollisionRect> greedyMesh(const QVector<CollisionType>& cells, const QRect& area);
+
+	// ƴӷֿ߽ԺϲľΣͬ͡ߣ
+	static QVector<CollisionRect> mergeAdjacent(QVector<CollisionRect> rects);
+
+	// һԺ決ŵͼã
+	static QVector<CollisionRect> bake(const QVector<CollisionFootprint>& footprints);
+
+	// ɾμ׷׶ȥ߶
+	static QVector<CollisionPolygon> traceOutlines(const QVector<CollisionRect>& rects);
+
+private:
+	QHash<quint64, QVector<CollisionRect>> m_chunks;
+	QHash<quint64, QPoint> m_dirty;
+	int m_rectCount = 0;
+};
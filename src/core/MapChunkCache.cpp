@@ -0,0 +1,373 @@
+#include "MapChunkCache.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+namespace
+{
+	// ȡͬ䵽ȷķֿ飩
+	int floorDiv(int value, int divisor)
+	{
+		return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+	}
+
+	QHash<QUuid, int> countSlices(const TileRegionData& region)
+	{
+		QVector<int> perRef(region.slices.size(), 0);
+		for (const TileRegionCell& cell : region.cells)
+			++perRef[cell.sliceRef];
+
+		QHash<QUuid, int> counts;
+		for (int i = 0; i < region.slices.size(); ++i)
+		{
+			if (perRef[i] > 0)
+				counts[region.slices[i].sliceId] += perRef[i];
+		}
+		return counts;
+	}
+}
+
+QPoint MapChunkCache::chunkOf(int gridX, int gridY)
+{
+	return QPoint(floorDiv(gridX, CHUNK_SIZE), floorDiv(gridY, CHUNK_SIZE));
+}
+
+QRect MapChunkCache::chunkRect(const QPoint& chunk)
+{
+	return QRect(chunk.x() * CHUNK_SIZE, chunk.y() * CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE);
+}
+
+quint64 MapChunkCache::chunkKey(const QPoint& chunk)
+{
+	return (static_cast<quint64>(static_cast<quint32>(chunk.x())) << 32)
+		| static_cast<quint64>(static_cast<quint32>(chunk.y()));
+}
+
+MapChunkCache::MapChunkCache(QObject* parent)
+	: QObject(parent)
+{
+	// ȡܴƣ߳㹻дֻ׷ӵļĩβһ̱֤߳˳
+	m_pool.setMaxThreadCount(2);
+	m_writePool.setMaxThreadCount(1);
+}
+
+MapChunkCache::~MapChunkCache()
+{
+	m_writePool.waitForDone();
+	m_pool.waitForDone();
+}
+
+void MapChunkCache::clear()
+{
+	// ŶӵĶдصԻᵽҲ¼ֱӶɻص㣩
+	m_writePool.waitForDone();
+	m_pool.waitForDone();
+
+	for (const ChunkRecord& record : m_records)
+		addUsageDelta(record.sliceCounts, -1);
+	m_records.clear();
+	m_liveBytes = 0;
+	m_garbageBytes = 0;
+	m_file.reset();
+}
+
+bool MapChunkCache::isLoading(const QPoint& chunk) const
+{
+	auto it = m_records.constFind(chunkKey(chunk));
+	return it != m_records.constEnd() && it->loading;
+}
+
+QVector<QPoint> MapChunkCache::evictedChunks() const
+{
+	QVector<QPoint> result;
+	result.reserve(m_records.size());
+	for (const ChunkRecord& record : m_records)
+		result.append(record.chunk);
+	return result;
+}
+
+bool MapChunkCache::ensureFile()
+{
+	if (m_file)
+		return true;
+
+	m_file = std::make_unique<QTemporaryFile>(QDir::tempPath() + QStringLiteral("/meditor-chunks-XXXXXX.bin"));
+	if (!m_file->open())
+	{
+		qWarning() << "MapChunkCache: cannot create backing file:" << m_file->errorString();
+		m_file.reset();
+		return false;
+	}
+	return true;
+}
+
+bool MapChunkCache::store(const QPoint& chunk, const TileRegionData& region)
+{
+	const quint64 key = chunkKey(chunk);
+	if (m_records.contains(key) || !ensureFile())
+		return false;
+
+	ChunkRecord record;
+	record.chunk = chunk;
+	record.generation = m_nextGeneration++;
+	record.region = region;
+	record.sliceCounts = countSlices(region);
+	addUsageDelta(record.sliceCounts, 1);
+	m_records.insert(key, record);
+
+	// дļд̣߳ǰֱʹڴе
+	++m_pendingWrites;
+	const QString filePath = m_file->fileName();
+	const quint32 generation = record.generation;
+	m_writePool.start([this, filePath, key, generation, region]() {
+		const QByteArray bytes = TileRegionCodec::encode(region);
+
+		// ֻ׷д룺ڱ첽ȡľɼ¼ᱻ
+		QFile file(filePath);
+		qint64 offset = -1;
+		bool ok = file.open(QIODevice::WriteOnly | QIODevice::Append);
+		if (ok)
+		{
+			offset = file.size();
+			ok = file.write(bytes) == bytes.size() && file.flush();
+		}
+		const qint64 size = bytes.size();
+
+		QMetaObject::invokeMethod(this, [this, filePath, key, generation, ok, offset, size]() {
+			onWriteFinished(filePath, key, generation, ok, offset, size);
+			}, Qt::QueuedConnection);
+		});
+	return true;
+}
+
+void MapChunkCache::onWriteFinished(const QString& filePath, quint64 key, quint32 generation, bool ok, qint64 offset, qint64 size)
+{
+	--m_pendingWrites;
+
+	// дڼջ棨ļѻ
+	if (!m_file || m_file->fileName() != filePath)
+		return;
+
+	auto it = m_records.find(key);
+	const bool current = it != m_records.end() && it->generation == generation;
+	if (!ok)
+	{
+		// дʧܣڴУʱֱʹ
+		if (current)
+			qWarning() << "MapChunkCache: write failed for chunk" << it->chunk << "- keeping it in memory";
+		return;
+	}
+
+	// дڼѱأдֱ
+	if (!current)
+	{
+		m_garbageBytes += size;
+		compactIfNeeded();
+		return;
+	}
+
+	it->offset = offset;
+	it->size = size;
+	it->written = true;
+	it->region = TileRegionData();
+	m_liveBytes += size;
+	compactIfNeeded();
+}
+
+QByteArray MapChunkCache::readBytes(const QString& filePath, qint64 offset, qint64 size)
+{
+	// ÿζȡļ֮߳Լ̵߳д뻥
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(offset))
+		return QByteArray();
+	return file.read(size);
+}
+
+bool MapChunkCache::readRecord(const ChunkRecord& record, TileRegionData& outRegion) const
+{
+	if (!record.written)
+	{
+		outRegion = record.region;
+		return true;
+	}
+
+	if (!m_file)
+		return false;
+
+	const QByteArray bytes = readBytes(m_file->fileName(), record.offset, record.size);
+	return bytes.size() == record.size && TileRegionCodec::decode(bytes, outRegion);
+}
+
+bool MapChunkCache::take(const QPoint& chunk, TileRegionData& outRegion)
+{
+	auto it = m_records.find(chunkKey(chunk));
+	if (it == m_records.end())
+		return false;
+
+	const bool ok = readRecord(*it, outRegion);
+	if (!ok)
+		qWarning() << "MapChunkCache: failed to read chunk" << chunk;
+
+	addUsageDelta(it->sliceCounts, -1);
+	m_liveBytes -= it->size;
+	m_garbageBytes += it->size;
+	m_records.erase(it);
+
+	compactIfNeeded();
+	return ok;
+}
+
+bool MapChunkCache::peek(const QPoint& chunk, TileRegionData& outRegion) const
+{
+	auto it = m_records.constFind(chunkKey(chunk));
+	return it != m_records.constEnd() && readRecord(*it, outRegion);
+}
+
+void MapChunkCache::requestLoad(const QPoint& chunk)
+{
+	const quint64 key = chunkKey(chunk);
+	auto it = m_records.find(key);
+	if (it == m_records.end() || it->loading || !m_file)
+		return;
+
+	it->loading = true;
+	++m_pendingLoads;
+
+	// δд꣺ֱʹڴеݣ԰첽ʽصļһ£
+	if (!it->written)
+	{
+		const quint32 generation = it->generation;
+		const TileRegionData region = it->region;
+		QMetaObject::invokeMethod(this, [this, key, generation, region]() {
+			onLoadFinished(key, generation, true, region);
+			}, Qt::QueuedConnection);
+		return;
+	}
+
+	const QString filePath = m_file->fileName();
+	const qint64 offset = it->offset;
+	const qint64 size = it->size;
+	const quint32 generation = it->generation;
+
+	m_pool.start([this, filePath, offset, size, key, generation]() {
+		TileRegionData region;
+		const QByteArray bytes = readBytes(filePath, offset, size);
+		const bool ok = bytes.size() == size && TileRegionCodec::decode(bytes, region);
+
+		QMetaObject::invokeMethod(this, [this, key, generation, ok, region]() {
+			onLoadFinished(key, generation, ok, region);
+			}, Qt::QueuedConnection);
+		});
+}
+
+void MapChunkCache::onLoadFinished(quint64 key, quint32 generation, bool ok, const TileRegionData& region)
+{
+	--m_pendingLoads;
+
+	// ֿڶȡڼѱͬأд
+	auto it = m_records.find(key);
+	if (it == m_records.end() || it->generation != generation)
+	{
+		compactIfNeeded();
+		return;
+	}
+
+	if (!ok)
+	{
+		// ¼´οӿʱ
+		qWarning() << "MapChunkCache: async read failed for chunk" << it->chunk;
+		it->loading = false;
+		return;
+	}
+
+	const QPoint chunk = it->chunk;
+	addUsageDelta(it->sliceCounts, -1);
+	m_liveBytes -= it->size;
+	m_garbageBytes += it->size;
+	m_records.erase(it);
+
+	emit chunkLoaded(chunk, region);
+	compactIfNeeded();
+}
+
+QHash<QUuid, int> MapChunkCache::takeUsageDelta()
+{
+	QHash<QUuid, int> delta = std::move(m_usageDelta);
+	m_usageDelta.clear();
+	return delta;
+}
+
+void MapChunkCache::addUsageDelta(const QHash<QUuid, int>& counts, int sign)
+{
+	for (auto it = counts.constBegin(); it != counts.constEnd(); ++it)
+		m_usageDelta[it.key()] += sign * it.value();
+}
+
+bool MapChunkCache::chunkUsesSlice(const QPoint& chunk, const QUuid& sliceId) const
+{
+	auto it = m_records.constFind(chunkKey(chunk));
+	return it != m_records.constEnd() && it->sliceCounts.contains(sliceId);
+}
+
+QHash<QUuid, int> MapChunkCache::sliceUsage() const
+{
+	QHash<QUuid, int> usage;
+	for (const ChunkRecord& record : m_records)
+	{
+		for (auto it = record.sliceCounts.constBegin(); it != record.sliceCounts.constEnd(); ++it)
+			usage[it.key()] += it.value();
+	}
+	return usage;
+}
+
+void MapChunkCache::compactIfNeeded()
+{
+	// Сļֵд
+	constexpr qint64 MIN_GARBAGE_BYTES = 4 * 1024 * 1024;
+	if (!m_file || m_pendingLoads > 0 || m_pendingWrites > 0 || m_garbageBytes < MIN_GARBAGE_BYTES || m_garbageBytes < m_liveBytes)
+		return;
+
+	if (m_records.isEmpty())
+	{
+		m_file.reset();
+		m_garbageBytes = 0;
+		return;
+	}
+
+	auto compacted = std::make_unique<QTemporaryFile>(QDir::tempPath() + QStringLiteral("/meditor-chunks-XXXXXX.bin"));
+	if (!compacted->open())
+		return;
+
+	// ׷д߳̾ɣҲ¾ m_file Ķ
+	QFile source(m_file->fileName());
+	if (!source.open(QIODevice::ReadOnly))
+		return;
+
+	QHash<quint64, qint64> newOffsets;
+	newOffsets.reserve(m_records.size());
+	for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it)
+	{
+		// дʧڴеķֿ鲻ļ
+		if (!it->written)
+			continue;
+		if (!source.seek(it->offset))
+			return;
+		const QByteArray bytes = source.read(it->size);
+		newOffsets.insert(it.key(), compacted->pos());
+		if (bytes.size() != it->size || compacted->write(bytes) != bytes.size())
+			return;
+	}
+	if (!compacted->flush())
+		return;
+
+	for (auto it = m_records.begin(); it != m_records.end(); ++it)
+	{
+		if (it->written)
+			it->offset = newOffsets.value(it.key());
+	}
+
+	qDebug() << "MapChunkCache: compacted" << m_garbageBytes << "bytes, live:" << m_liveBytes;
+	m_file = std::move(compacted);
+	m_garbageBytes = 0;
+}
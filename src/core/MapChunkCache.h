@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+#include <QTemporaryFile>
+#include <QThreadPool>
+#include <QUuid>
+#include <memory>
+#include "TileRegion.h"
+
+// ޵ͼķֿ黻
+// - ֿΪз (x, y) ڷֿ (floor(x / CHUNK_SIZE), floor(y / CHUNK_SIZE))
+// - Զӿڵķֿ TileRegionCodec ׷дʱļڴֻƫƺƬ
+// - дڵ̵߳дɣ + ׷ӣд֮ǰֿڴУʱֱʹڴе
+// - ̳߳ɣļ + 룩ص̺߳ͨ chunkLoaded 
+class MapChunkCache : public QObject
+{
+	Q_OBJECT
+public:
+	static constexpr int CHUNK_SIZE = 32;
+
+	static QPoint chunkOf(int gridX, int gridY);
+	static QRect chunkRect(const QPoint& chunk);
+	static quint64 chunkKey(const QPoint& chunk);
+
+	explicit MapChunkCache(QObject* parent = nullptr);
+	~MapChunkCache();
+
+	// лķֿ飨½ͼʱã
+	void clear();
+
+	bool isEvicted(const QPoint& chunk) const { return m_records.contains(chunkKey(chunk)); }
+	bool isLoading(const QPoint& chunk) const;
+	int evictedCount() const { return m_records.size(); }
+	QVector<QPoint> evictedChunks() const;
+
+	// дֿ飨ֿ鵱ǰڻУʧʱ÷ӦڴеƬ
+	// дļں̨ɣ̨дʧʱһֱڴУᶪʧ
+	bool store(const QPoint& chunk, const TileRegionData& region);
+
+	// ͬزƳ棨дѻķֿǰʹãе첽ȡᱻ
+	bool take(const QPoint& chunk, TileRegionData& outRegion);
+
+	// ͬȡƳã
+	bool peek(const QPoint& chunk, TileRegionData& outRegion) const;
+
+	// 첽أɺ󷢳 chunkLoadedڶȡ
+	void requestLoad(const QPoint& chunk);
+
+	// ѻֿиƬʹô
+	QHash<QUuid, int> sliceUsage() const;
+
+	// ϴȡֿиƬʹôı仯дΪΪ
+	QHash<QUuid, int> takeUsageDelta();
+
+	// ѻķֿǷõָƬļ
+	bool chunkUsesSlice(const QPoint& chunk, const QUuid& sliceId) const;
+
+signals:
+	// 첽ɣֿƳ棬÷´Ƭ
+	void chunkLoaded(const QPoint& chunk, const TileRegionData& region);
+
+private:
+	struct ChunkRecord
+	{
+		QPoint chunk;
+		qint64 offset = 0;
+		qint64 size = 0;
+		quint32 generation = 0;                    // ÿдʶڵ첽
+		bool loading = false;
+		bool written = false;                      // дļoffset / size Ч
+		TileRegionData region;                     // дǰдʧʱ
+		QHash<QUuid, int> sliceCounts;
+	};
+
+	bool ensureFile();
+	void addUsageDelta(const QHash<QUuid, int>& counts, int sign);
+	bool readRecord(const ChunkRecord& record, TileRegionData& outRegion) const;
+	void onLoadFinished(quint64 key, quint32 generation, bool ok, const TileRegionData& region);
+	void onWriteFinished(const QString& filePath, quint64 key, quint32 generation, bool ok, qint64 offset, qint64 size);
+	static QByteArray readBytes(const QString& filePath, qint64 offset, qint64 size);
+
+	// ʧЧݳһʱдļûнеĶȡдʱִУ
+	void compactIfNeeded();
+
+private:
+	std::unique_ptr<QTemporaryFile> m_file;
+	QHash<quint64, ChunkRecord> m_records;
+	quint32 m_nextGeneration = 1;
+	qint64 m_liveBytes = 0;
+	qint64 m_garbageBytes = 0;
+	int m_pendingLoads = 0;
+	int m_pendingWrites = 0;
+	QHash<QUuid, int> m_usageDelta;
+
+	// ̳߳أʱȴждص䵽ٵĶ
+	QThreadPool m_pool;
+	QThreadPool m_writePool;                       // ̣߳׷д밴ύ˳
+};
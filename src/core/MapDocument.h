@@ -1,6 +1,30 @@
 #pragma once
 
 #include <QString>
+#include <QVector>
+
+// Ⱦʽ
+enum class MapRenderProfile
+{
+	Smooth,     // ƽ + 
+	PixelArt    // ط磺ڲš
+};
+
+// ͼ״̬
+struct MapLayerState
+{
+	bool visible = true;
+	bool locked = false;
+	double opacity = 1.0;
+};
+
+// ͼ
+struct MapLayerInfo
+{
+	int id = 0;             // Ƭͨͼ㣬ɾٸ
+	QString name;
+	MapLayerState state;
+};
 
 struct MapDocument
 {
@@ -14,6 +38,15 @@ struct MapDocument
 
 	QString name;
 
+	// ޵ͼûб߽磬width/height ֻΪʼӷΧ
+	bool infinite = false;
+
+	MapRenderProfile renderProfile = MapRenderProfile::Smooth;
+
+	// ͼ㣨˳µϣ
+	QVector<MapLayerInfo> layers = defaultLayers();
+	int nextLayerId = 4;
+
 	MapDocument() = default;
 
 	MapDocument(int w, int h, int tileW, int tileH, const QString& n = QString())
@@ -24,4 +57,15 @@ struct MapDocument
 		, name(n)
 	{
 	}
+
+	// µͼĬͼ
+	static QVector<MapLayerInfo> defaultLayers()
+	{
+		return {
+			{ 0, QStringLiteral("Background"), {} },
+			{ 1, QStringLiteral("Ground"), {} },
+			{ 2, QStringLiteral("Decoration"), {} },
+			{ 3, QStringLiteral("Foreground"), {} },
+		};
+	}
 };
@@ -1,7 +1,7 @@
 #include "MapExporter.h"
 #include "MapDocument.h"
 #include "SpriteSliceDefine.h"
-#include "ui/MapTileItem.h"
+#include "CollisionBaker.h"
 
 #include <QFileInfo>
 #include <QJsonDocument>
@@ -18,7 +18,7 @@ QString MapExporter::s_lastError;
 bool MapExporter::exportToJson(
 	const QString& filePath,
 	const MapDocument* document,
-	const QVector<MapTileItem*>& tiles,
+	const QVector<MapExportLayer>& layers,
 	const QVector<SpriteSheetData>& tilesets,
 	int tileWidth,
 	int tileHeight,
@@ -34,7 +34,7 @@ bool MapExporter::exportToJson(
 
 	// ========== ļͷϢ ==========
 	QJsonObject header;
-	header["version"] = "1.3";  // 汾
+	header["version"] = "1.4";  // 汾
 	header["generator"] = "MEditor";
 	header["exportTime"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 	root["header"] = header;
@@ -47,11 +47,14 @@ bool MapExporter::exportToJson(
 
 	// ========== Ƭ ==========
 	QMap<QString, int> sliceIdMap;  // UUID -> 
-	root["slices"] = buildSlicesArray(tiles, sliceIdMap);
+	root["slices"] = buildSlicesArray(layers, sliceIdMap);
 
 	// ========== ͼ ==========
-	const int layerCount = 4;
-	root["layers"] = buildLayers(tiles, layerCount, sliceIdMap);
+	root["layers"] = buildLayers(layers, tileWidth, tileHeight, sliceIdMap);
+
+	// ========== ײݣϲľ̬ײ壩 ==========
+	if (options.bakeCollision)
+		root["collision"] = buildCollision(layers, tileWidth, tileHeight, options.collisionOutlines);
 
 	// ========== дļ ==========
 	QJsonDocument jsonDoc(root);
@@ -117,6 +120,11 @@ QJsonArray MapExporter::buildTilesetData(const QVector<SpriteSheetData>& tileset
 
 			sliceObj["collisionType"] = static_cast<int>(slice.collisionType);
 
+			if (slice.isAnimated())
+				sliceObj["frames"] = buildFramesArray(slice);
+			if (slice.isTrimmed())
+				sliceObj["trim"] = buildTrimObject(slice);
+
 			slicesArray.append(sliceObj);
 		}
 		tilesetObj["slices"] = slicesArray;
@@ -137,6 +145,10 @@ QJsonObject MapExporter::buildMapMeta(const MapDocument* doc, int tileWidth, int
 	map["height"] = doc->height;
 	map["tileWidth"] = tileWidth;
 	map["tileHeight"] = tileHeight;
+	if (doc->infinite)
+		map["infinite"] = true;
+	if (doc->renderProfile == MapRenderProfile::PixelArt)
+		map["renderProfile"] = "pixelArt";
 
 	// سߴ
 	QJsonObject pixelSize;
@@ -148,32 +160,32 @@ QJsonObject MapExporter::buildMapMeta(const MapDocument* doc, int tileWidth, int
 }
 
 QJsonArray MapExporter::buildSlicesArray(
-	const QVector<MapTileItem*>& tiles,
+	const QVector<MapExportLayer>& layers,
 	QMap<QString, int>& outSliceIdMap)
 {
 	QJsonArray slices;
 	QSet<QString> addedSlices;  // ȥ
 
 	int index = 0;
-	for (const auto* tile : tiles)
+	for (const MapExportLayer& layer : layers)
 	{
-		if (!tile)
-			continue;
-
-		const SpriteSlice& slice = tile->slice();
-		QString sliceUuid = slice.id.toString(QUuid::WithoutBraces);
-
-		// Ƭûӹ
-		if (!addedSlices.contains(sliceUuid))
+		for (const MapExportTile& tile : layer.tiles)
 		{
-			addedSlices.insert(sliceUuid);
-			outSliceIdMap[sliceUuid] = index;
+			const SpriteSlice& slice = tile.slice;
+			QString sliceUuid = slice.id.toString(QUuid::WithoutBraces);
+
+			// Ƭûӹ
+			if (!addedSlices.contains(sliceUuid))
+			{
+				addedSlices.insert(sliceUuid);
+				outSliceIdMap[sliceUuid] = index;
 
-			QJsonObject sliceObj = buildSliceData(slice);
-			sliceObj["index"] = index;  // 
+				QJsonObject sliceObj = buildSliceData(slice);
+				sliceObj["index"] = index;  // 
 
-			slices.append(sliceObj);
-			index++;
+				slices.append(sliceObj);
+				index++;
+			}
 		}
 	}
 
@@ -208,122 +220,138 @@ QJsonObject MapExporter::buildSliceData(const SpriteSlice& slice)
 	// װα
 	sliceObj["decorationOnly"] = slice.isDecorationOnly;
 
+	// ֡
+	if (slice.isAnimated())
+		sliceObj["frames"] = buildFramesArray(slice);
+
+	// üϢsourceRect Ϊü򣬻ʱƫƷŻԭʼ
+	if (slice.isTrimmed())
+		sliceObj["trim"] = buildTrimObject(slice);
+
 	return sliceObj;
 }
 
-QJsonArray MapExporter::buildLayers(
-	const QVector<MapTileItem*>& tiles,
-	int layerCount,
-	const QMap<QString, int>& sliceIdMap)
+QJsonObject MapExporter::buildTrimObject(const SpriteSlice& slice)
 {
-	QJsonArray layers;
+	QJsonObject trim;
+	trim["x"] = slice.trimOffset.x();
+	trim["y"] = slice.trimOffset.y();
+	trim["sourceWidth"] = slice.sourceWidth();
+	trim["sourceHeight"] = slice.sourceHeight();
+	return trim;
+}
 
-	// ͼƬ
-	QVector<QVector<MapTileItem*>> layeredTiles(layerCount);
-	for (auto* tile : tiles)
+QJsonArray MapExporter::buildFramesArray(const SpriteSlice& slice)
+{
+	QJsonArray frames;
+	for (const SpriteSliceFrame& frame : slice.frames)
 	{
-		if (tile && tile->layer() >= 0 && tile->layer() < layerCount)
-		{
-			layeredTiles[tile->layer()].append(tile);
-		}
+		QJsonObject frameObj;
+		frameObj["x"] = frame.rect.x();
+		frameObj["y"] = frame.rect.y();
+		frameObj["width"] = frame.rect.width();
+		frameObj["height"] = frame.rect.height();
+		frameObj["duration"] = frame.duration;
+		frames.append(frameObj);
 	}
+	return frames;
+}
 
-	// ͼ
-	static const QStringList layerNames = {
-		"Background",
-		"Ground",
-		"Decoration",
-		"Foreground"
-	};
+QJsonArray MapExporter::buildLayers(
+	const QVector<MapExportLayer>& layers,
+	int tileWidth,
+	int tileHeight,
+	const QMap<QString, int>& sliceIdMap)
+{
+	QJsonArray layersArray;
 
-	// ÿͼ
-	for (int i = 0; i < layerCount; ++i)
+	// ÿͼ㣨id ΪͼţƬ layer һ£order Ϊ˳
+	for (int i = 0; i < layers.size(); ++i)
 	{
+		const MapExportLayer& source = layers[i];
+
 		QJsonObject layer;
-		layer["id"] = i;
-		layer["name"] = (i < layerNames.size()) ? layerNames[i] : QString("Layer %1").arg(i);
-		layer["visible"] = true;
-		layer["locked"] = false;
-		layer["opacity"] = 1.0;
+		layer["id"] = source.id;
+		layer["order"] = i;
+		layer["name"] = source.name.isEmpty() ? QString("Layer %1").arg(i) : source.name;
+		layer["visible"] = source.state.visible;
+		layer["locked"] = source.state.locked;
+		layer["opacity"] = source.state.opacity;
 
 		// ͼеƬ
 		QJsonArray tilesArray;
-		for (auto* tile : layeredTiles[i])
+		for (const MapExportTile& tile : source.tiles)
 		{
-			tilesArray.append(buildTileData(tile, sliceIdMap));
+			tilesArray.append(buildTileData(tile, i, tileWidth, tileHeight, sliceIdMap));
 		}
 		layer["tiles"] = tilesArray;
 		layer["tileCount"] = tilesArray.size();
 
-		layers.append(layer);
+		layersArray.append(layer);
 	}
 
-	return layers;
+	return layersArray;
 }
 
-QJsonObject MapExporter::buildTileData(MapTileItem* tile, const QMap<QString, int>& sliceIdMap)
+QJsonObject MapExporter::buildTileData(const MapExportTile& tile, int layerOrder, int tileWidth, int tileHeight,
+	const QMap<QString, int>& sliceIdMap)
 {
 	QJsonObject tileObj;
 
 	// ========== λϢ ==========
 	QJsonObject position;
-	position["gridX"] = tile->gridX();
-	position["gridY"] = tile->gridY();
-	position["pixelX"] = static_cast<int>(tile->pos().x());
-	position["pixelY"] = static_cast<int>(tile->pos().y());
+	position["gridX"] = tile.gridX;
+	position["gridY"] = tile.gridY;
+	position["pixelX"] = tile.gridX * tileWidth;
+	position["pixelY"] = tile.gridY * tileHeight;
 	tileObj["position"] = position;
 
 	// ========== ߴϢ ==========
+	// ת 90/270 ʱ߻
+	const bool swapped = (tile.rotation == 90 || tile.rotation == 270);
 	QJsonObject size;
-	size["gridWidth"] = tile->gridWidth();
-	size["gridHeight"] = tile->gridHeight();
-	size["pixelWidth"] = static_cast<int>(tile->boundingRect().width());
-	size["pixelHeight"] = static_cast<int>(tile->boundingRect().height());
+	size["gridWidth"] = tile.gridWidth;
+	size["gridHeight"] = tile.gridHeight;
+	size["pixelWidth"] = (swapped ? tile.gridHeight * tileHeight : tile.gridWidth * tileWidth);
+	size["pixelHeight"] = (swapped ? tile.gridWidth * tileWidth : tile.gridHeight * tileHeight);
 	tileObj["size"] = size;
 
 	// ========== ͼ ==========
-	tileObj["tilesetId"] = tile->tilesetId();
+	tileObj["tilesetId"] = tile.tilesetId;
 
 	// ========== Ƭ ==========
-	QString sliceUuid = tile->slice().id.toString(QUuid::WithoutBraces);
+	QString sliceUuid = tile.slice.id.toString(QUuid::WithoutBraces);
 	tileObj["sliceIndex"] = sliceIdMap.value(sliceUuid, -1);
 	tileObj["sliceId"] = sliceUuid;  //  UUID ڵ
 
 	// ========== ʾ ==========
-	tileObj["displayName"] = tile->displayName();
+	tileObj["displayName"] = tile.displayName;
 
 	// ========== ײϢ ==========
 	QJsonObject collision;
-	CollisionType collisionType = tile->collisionType();
+	CollisionType collisionType = tile.collisionType;
 	collision["enabled"] = (collisionType != CollisionType::None);
 
 	// ײַ
-	QString collisionTypeStr;
-	switch (collisionType)
-	{
-	case CollisionType::None:    collisionTypeStr = "none"; break;
-	case CollisionType::Ground:  collisionTypeStr = "ground"; break;
-	case CollisionType::Trigger: collisionTypeStr = "trigger"; break;
-	default: collisionTypeStr = "none"; break;
-	}
-	collision["type"] = collisionTypeStr;
+	collision["type"] = collisionTypeName(collisionType);
 	collision["typeId"] = static_cast<int>(collisionType);
 	tileObj["collision"] = collision;
 
 	// ========== 任Ϣ ==========
 	QJsonObject transform;
-	transform["flipX"] = tile->isFlippedX();
-	transform["flipY"] = tile->isFlippedY();
-	transform["rotation"] = tile->rotation();	// Ƕ
+	transform["flipX"] = tile.flipX;
+	transform["flipY"] = tile.flipY;
+	transform["rotation"] = tile.rotation;	// Ƕ
 	tileObj["transform"] = transform;
 
 	// ========== ͼϢ ==========
-	tileObj["layer"] = tile->layer();
-	tileObj["zIndex"] = static_cast<int>(tile->zValue());
+	// layer ΪͼţӦ layers[].idzIndex ˳򣨶Ӧ layers[].order
+	tileObj["layer"] = tile.layer;
+	tileObj["zIndex"] = 10 + layerOrder;
 
 	// ========== ǩ ==========
 	QJsonArray tags;
-	const QString& tileTags = tile->tags();
+	const QString& tileTags = tile.tags;
 	if (!tileTags.isEmpty())
 	{
 		QStringList tagList = tileTags.split(',', Qt::SkipEmptyParts);
@@ -339,4 +367,80 @@ QJsonObject MapExporter::buildTileData(MapTileItem* tile, const QMap<QString, in
 	tileObj["customData"] = customData;
 
 	return tileObj;
+}
+
+QString MapExporter::collisionTypeName(CollisionType type)
+{
+	switch (type)
+	{
+	case CollisionType::None:    return "none";
+	case CollisionType::Ground:  return "ground";
+	case CollisionType::Trigger: return "trigger";
+	default: return "none";
+	}
+}
+
+QJsonObject MapExporter::buildCollision(const QVector<MapExportLayer>& layers, int tileWidth, int tileHeight,
+	bool includeOutlines)
+{
+	// ƬռõĸΪ決루Ե˳Ϊͼߵͣ
+	QVector<CollisionFootprint> footprints;
+	for (int i = 0; i < layers.size(); ++i)
+	{
+		for (const MapExportTile& tile : layers[i].tiles)
+		{
+			if (tile.collisionType == CollisionType::None)
+				continue;
+			footprints.append(CollisionFootprint{
+				QRect(tile.gridX, tile.gridY, tile.gridWidth, tile.gridHeight), i, tile.collisionType });
+		}
+	}
+
+	const QVector<CollisionRect> rects = CollisionBaker::bake(footprints);
+
+	QJsonObject collision;
+	QJsonArray rectsArray;
+	for (const CollisionRect& rect : rects)
+	{
+		QJsonObject rectObj;
+		rectObj["type"] = collisionTypeName(rect.type);
+		rectObj["typeId"] = static_cast<int>(rect.type);
+		rectObj["gridX"] = rect.cells.x();
+		rectObj["gridY"] = rect.cells.y();
+		rectObj["gridWidth"] = rect.cells.width();
+		rectObj["gridHeight"] = rect.cells.height();
+		rectObj["pixelX"] = rect.cells.x() * tileWidth;
+		rectObj["pixelY"] = rect.cells.y() * tileHeight;
+		rectObj["pixelWidth"] = rect.cells.width() * tileWidth;
+		rectObj["pixelHeight"] = rect.cells.height() * tileHeight;
+		rectsArray.append(rectObj);
+	}
+	collision["rects"] = rectsArray;
+	collision["rectCount"] = rectsArray.size();
+	collision["sourceTileCount"] = footprints.size();
+
+	if (includeOutlines)
+	{
+		QJsonArray polygonsArray;
+		for (const CollisionPolygon& polygon : CollisionBaker::traceOutlines(rects))
+		{
+			QJsonObject polygonObj;
+			polygonObj["type"] = collisionTypeName(polygon.type);
+			polygonObj["typeId"] = static_cast<int>(polygon.type);
+			polygonObj["hole"] = polygon.hole;
+
+			// ꣬[x0, y0, x1, y1, ...]
+			QJsonArray points;
+			for (const QPoint& point : polygon.points)
+			{
+				points.append(point.x() * tileWidth);
+				points.append(point.y() * tileHeight);
+			}
+			polygonObj["points"] = points;
+			polygonsArray.append(polygonObj);
+		}
+		collision["polygons"] = polygonsArray;
+	}
+
+	return collision;
 }
\ No newline at end of file
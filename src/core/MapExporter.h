@@ -5,11 +5,35 @@
 #include <QJsonArray>
 #include <QVector>
 #include <QMap>
+#include "SpriteSliceDefine.h"
+#include "MapDocument.h"
 
-class MapTileItem;
-struct MapDocument;
-struct SpriteSlice;
-struct SpriteSheetData;
+// õƬ¼ͨƬչԤʵͳһΪ˽ṹ
+struct MapExportTile
+{
+	int gridX = 0;
+	int gridY = 0;
+	int gridWidth = 1;
+	int gridHeight = 1;
+	int layer = 0;
+	QString tilesetId;
+	SpriteSlice slice;
+	QString displayName;
+	QString tags;
+	CollisionType collisionType = CollisionType::None;
+	bool flipX = false;
+	bool flipY = false;
+	int rotation = 0;
+};
+
+// õͼ㣨ƬѰͼֺã˳µУ
+struct MapExportLayer
+{
+	int id = 0;
+	QString name;
+	MapLayerState state;
+	QVector<MapExportTile> tiles;
+};
 
 // ͼ
 class MapExporter
@@ -20,13 +44,15 @@ public:
 		bool includeEmptyLayers = false;   // Ƿ񵼳ͼ
 		bool prettyPrint = true;           // Ƿʽ
 		int indentSize = 2;                // С
+		bool bakeCollision = true;         // ϲײΣcollision Σ
+		bool collisionOutlines = false;    // ⵼ײ
 	};
 
 	// ͼ JSON ļ
 	static bool exportToJson(
 		const QString& filePath,
 		const MapDocument* document,
-		const QVector<MapTileItem*>& tiles,
+		const QVector<MapExportLayer>& layers,
 		const QVector<SpriteSheetData>& tilesets,  // ͼ
 		int tileWidth,
 		int tileHeight,
@@ -42,23 +68,38 @@ private:
 
 	// ͼ
 	static QJsonArray buildLayers(
-		const QVector<MapTileItem*>& tiles,
-		int layerCount,
+		const QVector<MapExportLayer>& layers,
+		int tileWidth,
+		int tileHeight,
 		const QMap<QString, int>& sliceIdMap
 	);
 
-	// Ƭݣʹ sliceId ã
-	static QJsonObject buildTileData(MapTileItem* tile, const QMap<QString, int>& sliceIdMap);
+	// Ƭݣʹ sliceId ãlayerOrder Ϊͼĵ˳
+	static QJsonObject buildTileData(const MapExportTile& tile, int layerOrder, int tileWidth, int tileHeight,
+		const QMap<QString, int>& sliceIdMap);
 
 	// Ƭ
 	static QJsonArray buildSlicesArray(
-		const QVector<MapTileItem*>& tiles,
+		const QVector<MapExportLayer>& layers,
 		QMap<QString, int>& outSliceIdMap
 	);
 
 	// Ƭ
 	static QJsonObject buildSliceData(const SpriteSlice& slice);
 
+	// ֡飨֡ + ʱ䣩
+	static QJsonArray buildFramesArray(const SpriteSlice& slice);
+
+	// üϢԭʼеƫ + ԭʼߴ磩
+	static QJsonObject buildTrimObject(const SpriteSlice& slice);
+
+	// 決ײݣͬ͸ӺϲΪΣ
+	static QJsonObject buildCollision(const QVector<MapExportLayer>& layers, int tileWidth, int tileHeight,
+		bool includeOutlines);
+
+	// ײַ
+	static QString collisionTypeName(CollisionType type);
+
 	// ͼ
 	static QJsonArray buildTilesetData(const QVector<SpriteSheetData>& tilesets, const QString& jsonFilePath);
 
@@ -0,0 +1,438 @@
+#include "NavGrid.h"
+#include "MapChunkCache.h"
+
+#include <QtAlgorithms>
+#include <QtMath>
+#include <algorithm>
+#include <queue>
+
+namespace
+{
+	constexpr double SQRT2 = 1.4142135623730951;
+
+	// ˷루ֱ 1б sqrt(2)
+	double octile(const QPoint& a, const QPoint& b)
+	{
+		const int dx = qAbs(a.x() - b.x());
+		const int dy = qAbs(a.y() - b.y());
+		return (dx + dy) + (SQRT2 - 2.0) * qMin(dx, dy);
+	}
+
+	int sign(int value)
+	{
+		return (value > 0) - (value < 0);
+	}
+
+	struct SearchNode
+	{
+		double g = 0.0;
+		int parent = -1;
+		QPoint point;
+		bool closed = false;
+	};
+
+	struct OpenEntry
+	{
+		double f;
+		double g;
+		int key;
+		bool operator<(const OpenEntry& other) const {
+			// ȶȡֵﷴf ͬʱ g ģյ㣩
+			return f != other.f ? f > other.f : g < other.g;
+		}
+	};
+}
+
+void NavGrid::setBounds(const QRect& bounds)
+{
+	if (bounds == m_bounds)
+		return;
+
+	// ɷΧصдĲֱӱֻҪд
+	const QRect oldBounds = m_bounds;
+	const int oldStride = m_stride;
+	const QVector<quint8> oldBlocked = m_blocked;
+	const QHash<quint64, QPoint> oldDirty = m_dirty;
+	const QRect kept = m_allDirty ? QRect() : oldBounds.intersected(bounds);
+
+	m_bounds = bounds;
+	m_stride = 0;
+	m_blocked.clear();
+	m_rows = BitLines();
+	m_cols = BitLines();
+
+	if (!bounds.isEmpty())
+	{
+		// һȦ̶Ϊ赲
+		const int paddedW = bounds.width() + 2;
+		const int paddedH = bounds.height() + 2;
+		m_stride = paddedW;
+		m_blocked = QVector<quint8>(paddedW * paddedH, 1);
+
+		m_rows.words = (paddedW + 63) / 64 + 2;
+		m_rows.data = QVector<quint64>(m_rows.words * paddedH, ~quint64(0));
+		m_cols.words = (paddedH + 63) / 64 + 2;
+		m_cols.data = QVector<quint64>(m_cols.words * paddedW, ~quint64(0));
+
+		clearRect(bounds);
+	}
+	markAllDirty();
+
+	if (kept.isEmpty())
+		return;
+
+	for (int y = kept.top(); y <= kept.bottom(); ++y)
+	{
+		const quint8* oldRow = oldBlocked.constData() + (y - oldBounds.top() + 1) * oldStride;
+		for (int x = kept.left(); x <= kept.right(); ++x)
+		{
+			if (oldRow[x - oldBounds.left() + 1])
+				setCell(x - m_bounds.left() + 1, y - m_bounds.top() + 1, 1);
+		}
+	}
+
+	m_allDirty = false;
+	for (const QPoint& chunk : oldDirty)
+		markDirty(MapChunkCache::chunkRect(chunk));
+
+	// 򣺷Χȥ֣
+	const QRect strips[] = {
+		QRect(QPoint(bounds.left(), bounds.top()), QPoint(bounds.right(), kept.top() - 1)),
+		QRect(QPoint(bounds.left(), kept.bottom() + 1), QPoint(bounds.right(), bounds.bottom())),
+		QRect(QPoint(bounds.left(), kept.top()), QPoint(kept.left() - 1, kept.bottom())),
+		QRect(QPoint(kept.right() + 1, kept.top()), QPoint(bounds.right(), kept.bottom())),
+	};
+	for (const QRect& strip : strips)
+		markDirty(strip);
+}
+
+void NavGrid::translate(const QPoint& delta)
+{
+	if (delta.isNull())
+		return;
+
+	if (!m_bounds.isEmpty())
+		m_bounds.translate(delta);
+
+	const QHash<quint64, QPoint> dirty = std::move(m_dirty);
+	m_dirty.clear();
+	for (const QPoint& chunk : dirty)
+		markDirty(MapChunkCache::chunkRect(chunk).translated(delta));
+}
+
+void NavGrid::markDirty(const QRect& gridRect)
+{
+	if (m_allDirty || gridRect.isEmpty())
+		return;
+
+	const QPoint first = MapChunkCache::chunkOf(gridRect.left(), gridRect.top());
+	const QPoint last = MapChunkCache::chunkOf(gridRect.right(), gridRect.bottom());
+	for (int cy = first.y(); cy <= last.y(); ++cy)
+	{
+		for (int cx = first.x(); cx <= last.x(); ++cx)
+		{
+			const QPoint chunk(cx, cy);
+			m_dirty.insert(MapChunkCache::chunkKey(chunk), chunk);
+		}
+	}
+}
+
+void NavGrid::markAllDirty()
+{
+	m_allDirty = true;
+	m_dirty.clear();
+}
+
+QVector<QRect> NavGrid::takeDirtyRects()
+{
+	QVector<QRect> rects;
+	if (m_allDirty)
+	{
+		if (!m_bounds.isEmpty())
+			rects.append(m_bounds);
+	}
+	else
+	{
+		rects.reserve(m_dirty.size());
+		for (const QPoint& chunk : m_dirty)
+		{
+			const QRect rect = MapChunkCache::chunkRect(chunk).intersected(m_bounds);
+			if (!rect.isEmpty())
+				rects.append(rect);
+		}
+	}
+
+	m_allDirty = false;
+	m_dirty.clear();
+	return rects;
+}
+
+void NavGrid::setCell(int localX, int localY, quint8 blocked)
+{
+	m_blocked[localY * m_stride + localX] = blocked;
+
+	// λͼ±ƫһ֣ǰ䣩
+	const quint64 rowBit = quint64(1) << ((localX + 64) & 63);
+	quint64& rowWord = m_rows.data[localY * m_rows.words + ((localX + 64) >> 6)];
+	rowWord = blocked ? (rowWord | rowBit) : (rowWord & ~rowBit);
+
+	const quint64 colBit = quint64(1) << ((localY + 64) & 63);
+	quint64& colWord = m_cols.data[localX * m_cols.words + ((localY + 64) >> 6)];
+	colWord = blocked ? (colWord | colBit) : (colWord & ~colBit);
+}
+
+void NavGrid::clearRect(const QRect& gridRect)
+{
+	const QRect clipped = gridRect.intersected(m_bounds);
+	for (int y = clipped.top(); y <= clipped.bottom(); ++y)
+	{
+		for (int x = clipped.left(); x <= clipped.right(); ++x)
+			setCell(x - m_bounds.left() + 1, y - m_bounds.top() + 1, 0);
+	}
+}
+
+void NavGrid::blockRect(const QRect& gridRect)
+{
+	const QRect clipped = gridRect.intersected(m_bounds);
+	for (int y = clipped.top(); y <= clipped.bottom(); ++y)
+	{
+		for (int x = clipped.left(); x <= clipped.right(); ++x)
+			setCell(x - m_bounds.left() + 1, y - m_bounds.top() + 1, 1);
+	}
+}
+
+// ==============  ==============
+
+quint64 NavGrid::bitsAt(const BitLines& lines, int line, int pos)
+{
+	// ȡ pos  64 bit i Ӧ pos + i
+	const int bit = pos + 64;
+	const int word = bit >> 6;
+	const int offset = bit & 63;
+	const quint64* data = lines.data.constData() + line * lines.words;
+	if (offset == 0)
+		return data[word];
+	return (data[word] >> offset) | (data[word + 1] << (64 - offset));
+}
+
+int NavGrid::scanLine(const BitLines& lines, int line, int pos, int dir, int goalLine, int goalPos, int& scanned)
+{
+	// ֱɨ裺ǿھӣ赲Ϊߣյ㼴Ϊ㣬赲û
+	const bool goalOnLine = (line == goalLine);
+
+	if (dir > 0)
+	{
+		for (int base = pos;; base += 64)
+		{
+			const quint64 blocked = bitsAt(lines, line, base);
+			const quint64 before = bitsAt(lines, line - 1, base);
+			const quint64 beforeBehind = bitsAt(lines, line - 1, base - 1);
+			const quint64 after = bitsAt(lines, line + 1, base);
+			const quint64 afterBehind = bitsAt(lines, line + 1, base - 1);
+			const quint64 forced = (~before & beforeBehind) | (~after & afterBehind);
+			const quint64 stop = blocked | forced;
+			const int run = stop ? qCountTrailingZeroBits(stop) : 64;
+
+			if (goalOnLine && goalPos >= base && goalPos < base + run)
+			{
+				scanned += goalPos - base + 1;
+				return goalPos;
+			}
+			scanned += run;
+			if (stop)
+				return ((blocked >> run) & 1) ? -1 : base + run;
+		}
+	}
+
+	for (int top = pos;; top -= 64)
+	{
+		// bit 63 Ӧ topλɨ
+		const int base = top - 63;
+		const quint64 blocked = bitsAt(lines, line, base);
+		const quint64 before = bitsAt(lines, line - 1, base);
+		const quint64 beforeBehind = bitsAt(lines, line - 1, base + 1);
+		const quint64 after = bitsAt(lines, line + 1, base);
+		const quint64 afterBehind = bitsAt(lines, line + 1, base + 1);
+		const quint64 forced = (~before & beforeBehind) | (~after & afterBehind);
+		const quint64 stop = blocked | forced;
+		const int run = stop ? qCountLeadingZeroBits(stop) : 64;
+
+		if (goalOnLine && goalPos <= top && goalPos > top - run)
+		{
+			scanned += top - goalPos + 1;
+			return goalPos;
+		}
+		scanned += run;
+		if (stop)
+			return ((blocked >> (63 - run)) & 1) ? -1 : top - run;
+	}
+}
+
+int NavGrid::jumpStraight(int idx, int dx, int dy, int goal, int& scanned) const
+{
+	const int x = idx % m_stride;
+	const int y = idx / m_stride;
+	const int goalX = goal % m_stride;
+	const int goalY = goal / m_stride;
+
+	if (dx != 0)
+	{
+		const int hit = scanLine(m_rows, y, x, dx, goalY, goalX, scanned);
+		return hit < 0 ? -1 : y * m_stride + hit;
+	}
+
+	const int hit = scanLine(m_cols, x, y, dy, goalX, goalY, scanned);
+	return hit < 0 ? -1 : hit * m_stride + x;
+}
+
+int NavGrid::jump(int idx, int dx, int dy, int goal, int& scanned) const
+{
+	if (dx == 0 || dy == 0)
+		return jumpStraight(idx, dx, dy, goal, scanned);
+
+	// бɨ裺ÿһֱɨ裬ǰΪ
+	const int stepX = dx;
+	const int stepY = dy * m_stride;
+	while (open(idx))
+	{
+		++scanned;
+		if (idx == goal)
+			return idx;
+
+		if (jumpStraight(idx + stepX, dx, 0, goal, scanned) >= 0 || jumpStraight(idx + stepY, 0, dy, goal, scanned) >= 0)
+			return idx;
+
+		// н
+		if (!open(idx + stepX) || !open(idx + stepY))
+			return -1;
+
+		idx += stepX + stepY;
+	}
+	return -1;
+}
+
+NavPathResult NavGrid::findPath(const QPoint& start, const QPoint& goal) const
+{
+	NavPathResult result;
+	if (!isWalkable(start.x(), start.y()) || !isWalkable(goal.x(), goal.y()))
+		return result;
+
+	// ֻڵģԶС
+	QHash<int, SearchNode> nodes;
+	std::priority_queue<OpenEntry> openList;
+
+	const int startKey = index(start.x(), start.y());
+	const int goalKey = index(goal.x(), goal.y());
+	nodes.insert(startKey, SearchNode{ 0.0, -1, start, false });
+	openList.push(OpenEntry{ octile(start, goal), 0.0, startKey });
+
+	QVector<QPoint> directions;
+	directions.reserve(8);
+
+	while (!openList.empty())
+	{
+		const OpenEntry entry = openList.top();
+		openList.pop();
+
+		SearchNode& node = nodes[entry.key];
+		if (node.closed || entry.g > node.g)
+			continue;
+		node.closed = true;
+
+		const QPoint p = node.point;
+		const double g = node.g;
+		const int idx = entry.key;
+		result.explored.append(p);
+
+		if (idx == goalKey)
+		{
+			result.found = true;
+			result.cost = g;
+			for (int key = idx; key >= 0; key = nodes[key].parent)
+				result.waypoints.append(nodes[key].point);
+			std::reverse(result.waypoints.begin(), result.waypoints.end());
+			return result;
+		}
+
+		// ھӼֻ֦ظڵ㷽ǿھӷ
+		directions.clear();
+		auto walkable = [this, idx](int dx, int dy) { return open(idx + dx + dy * m_stride); };
+		if (node.parent < 0)
+		{
+			for (int dy = -1; dy <= 1; ++dy)
+			{
+				for (int dx = -1; dx <= 1; ++dx)
+				{
+					if ((dx == 0 && dy == 0) || !walkable(dx, dy))
+						continue;
+					if (dx != 0 && dy != 0 && (!walkable(dx, 0) || !walkable(0, dy)))
+						continue;
+					directions.append(QPoint(dx, dy));
+				}
+			}
+		}
+		else
+		{
+			const QPoint parent = nodes[node.parent].point;
+			const int dx = sign(p.x() - parent.x());
+			const int dy = sign(p.y() - parent.y());
+
+			if (dx != 0 && dy != 0)
+			{
+				const bool vertical = walkable(0, dy);
+				const bool horizontal = walkable(dx, 0);
+				if (vertical) directions.append(QPoint(0, dy));
+				if (horizontal) directions.append(QPoint(dx, 0));
+				if (vertical && horizontal) directions.append(QPoint(dx, dy));
+			}
+			else if (dx != 0)
+			{
+				const bool next = walkable(dx, 0);
+				const bool down = walkable(0, 1);
+				const bool up = walkable(0, -1);
+				if (next)
+				{
+					directions.append(QPoint(dx, 0));
+					if (down) directions.append(QPoint(dx, 1));
+					if (up) directions.append(QPoint(dx, -1));
+				}
+				if (down) directions.append(QPoint(0, 1));
+				if (up) directions.append(QPoint(0, -1));
+			}
+			else
+			{
+				const bool next = walkable(0, dy);
+				const bool right = walkable(1, 0);
+				const bool left = walkable(-1, 0);
+				if (next)
+				{
+					directions.append(QPoint(0, dy));
+					if (right) directions.append(QPoint(1, dy));
+					if (left) directions.append(QPoint(-1, dy));
+				}
+				if (right) directions.append(QPoint(1, 0));
+				if (left) directions.append(QPoint(-1, 0));
+			}
+		}
+
+		for (const QPoint& dir : directions)
+		{
+			const int key = jump(idx + dir.x() + dir.y() * m_stride, dir.x(), dir.y(), goalKey, result.scannedCells);
+			if (key < 0)
+				continue;
+
+			const QPoint jumpPoint = pointAt(key);
+			const double newG = g + octile(p, jumpPoint);
+
+			auto it = nodes.find(key);
+			if (it != nodes.end() && (it->closed || newG >= it->g))
+				continue;
+
+			// insert ʹ node ʧЧ֮ʹ node
+			nodes.insert(key, SearchNode{ newG, idx, jumpPoint, false });
+			openList.push(OpenEntry{ newG + octile(jumpPoint, goal), newG, key });
+		}
+	}
+
+	return result;
+}
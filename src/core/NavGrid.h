@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QHash>
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+// Ѱ·
+struct NavPathResult
+{
+	bool found = false;
+	QVector<QPoint> waypoints;      // Уֱ֮߻ 45 бߣ
+	QVector<QPoint> explored;       // չ㣨Ԥã
+	double cost = 0.0;              // ֱ 1б sqrt(2)
+	int scannedCells = 0;           // Ծɨ辭ĸ
+};
+
+//  + Jump Point Search
+// - ΧΪߣ˷ƶбʱֱڸ񶼱ߣнǣ
+// - ֱɨʹλͼȡȸһݣÿμ 64 
+// - ֿѯǰɵ÷дֿ
+class NavGrid
+{
+public:
+	// ΧɷΧصĲֱΪࣩ
+	void setBounds(const QRect& bounds);
+	QRect bounds() const { return m_bounds; }
+
+	// ԭƽƣ淶Χһƫƣ洢ڷΧϽǣҪؽֿͬƫ
+	void translate(const QPoint& delta);
+
+	// ==========  ==========
+	void markDirty(const QRect& gridRect);
+	void markAllDirty();
+	bool isAllDirty() const { return m_allDirty; }
+	bool hasDirty() const { return m_allDirty || !m_dirty.isEmpty(); }
+	QVector<QRect> takeDirtyRects();       // ѲüΧڣȫΪʱΧ
+
+	// վڵ赲 / 赲
+	void clearRect(const QRect& gridRect);
+	void blockRect(const QRect& gridRect);
+
+	bool isWalkable(int x, int y) const {
+		return m_bounds.contains(x, y) && !m_blocked[index(x, y)];
+	}
+
+	// Ѱ·յ㲻ʱ found = false
+	NavPathResult findPath(const QPoint& start, const QPoint& goal) const;
+
+private:
+	// 洢һȦ赲߿ɨʱ±ƶΧ
+	int index(int x, int y) const { return (y - m_bounds.top() + 1) * m_stride + (x - m_bounds.left() + 1); }
+	QPoint pointAt(int idx) const {
+		return QPoint(idx % m_stride - 1 + m_bounds.left(), idx / m_stride - 1 + m_bounds.top());
+	}
+	bool open(int idx) const { return !m_blocked[idx]; }
+
+	//  (dx, dy) Ծһ±꣬û򷵻 -1
+	int jump(int idx, int dx, int dy, int goal, int& scanned) const;
+	int jumpStraight(int idx, int dx, int dy, int goal, int& scanned) const;
+
+	// λͼÿǰһȫ赲֣ԽȡΪ赲
+	struct BitLines
+	{
+		int words = 0;
+		QVector<quint64> data;
+	};
+	static quint64 bitsAt(const BitLines& lines, int line, int pos);
+	void setCell(int localX, int localY, quint8 blocked);
+
+	// һɨ裨dir = 1ϵλãû򷵻 -1
+	static int scanLine(const BitLines& lines, int line, int pos, int dir, int goalLine, int goalPos, int& scanned);
+
+private:
+	QRect m_bounds;
+	int m_stride = 0;
+	QVector<quint8> m_blocked;
+	BitLines m_rows;
+	BitLines m_cols;
+	QHash<quint64, QPoint> m_dirty;        // ֿ
+	bool m_allDirty = true;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QString>
+#include <QUuid>
+#include "TileRegion.h"
+
+// ============== Ԥ ==============
+// ĶͼƬ飬ֻһݣͼʵԤ ID + λã
+struct PrefabDefinition
+{
+	QUuid id;					// Ψһʶ
+	QString name;				// Ԥ
+	TileRegionData content;		// ݣݣƬ + Ա + Ƭ
+	int revision = 0;			// ޸ĴжϹդǷ
+};
@@ -0,0 +1,306 @@
+#include "SliceSearchIndex.h"
+
+#include <QSet>
+#include <algorithm>
+
+namespace
+{
+	// ƳĿһʱ±
+	constexpr int MinCompactSize = 1024;
+
+	bool isHan(QChar ch)
+	{
+		return ch.script() == QChar::Script_Han;
+	}
+
+	// űɾ [firstId, lastId]
+	void eraseRange(QVector<int>& list, int firstId, int lastId)
+	{
+		auto begin = std::lower_bound(list.begin(), list.end(), firstId);
+		auto end = std::upper_bound(begin, list.end(), lastId);
+		list.erase(begin, end);
+	}
+}
+
+void SliceSearchIndex::addTileset(const QString& tilesetId, const QVector<SpriteSlice>& slices)
+{
+	removeTileset(tilesetId);
+	if (slices.isEmpty())
+		return;
+
+	const int firstId = m_entries.size();
+	m_entries.reserve(firstId + slices.size());
+	for (int i = 0; i < slices.size(); ++i)
+	{
+		const SpriteSlice& slice = slices[i];
+
+		Entry entry;
+		entry.tilesetId = tilesetId;
+		entry.sliceIndex = i;
+		entry.tokens = tokenize(slice.name + QLatin1Char(' ') + slice.group + QLatin1Char(' ') + slice.tags);
+		entry.tokens.removeDuplicates();
+		m_entries.append(entry);
+
+		link(m_entries.size() - 1);
+	}
+
+	m_tilesets.insert(tilesetId, qMakePair(firstId, m_entries.size() - 1));
+	m_liveCount += slices.size();
+}
+
+void SliceSearchIndex::removeTileset(const QString& tilesetId)
+{
+	auto it = m_tilesets.find(tilesetId);
+	if (it == m_tilesets.end())
+		return;
+
+	const int firstId = it->first;
+	const int lastId = it->second;
+	m_tilesets.erase(it);
+
+	unlink(firstId, lastId);
+	for (int id = firstId; id <= lastId; ++id)
+	{
+		m_entries[id].tilesetId.clear();
+		m_entries[id].tokens.clear();
+		m_entries[id].sliceIndex = -1;
+	}
+	m_liveCount -= lastId - firstId + 1;
+
+	if (m_entries.size() >= MinCompactSize && m_liveCount * 2 < m_entries.size())
+		compact();
+}
+
+void SliceSearchIndex::clear()
+{
+	m_entries.clear();
+	m_tilesets.clear();
+	m_tokens.clear();
+	m_prefixes.clear();
+	m_liveCount = 0;
+}
+
+QHash<QString, QVector<int>> SliceSearchIndex::query(const QString& text) const
+{
+	QHash<QString, QVector<int>> result;
+
+	const QStringList terms = tokenize(text);
+	if (terms.isEmpty())
+		return result;
+
+	// һʺûзָʱУǰ׺ƥ
+	const bool lastIsPrefix = !text.isEmpty() && text.back().isLetterOrNumber();
+
+	struct Term
+	{
+		const QVector<int>* list;
+		QString text;
+		bool prefix;
+	};
+
+	QVector<Term> lists;
+	lists.reserve(terms.size());
+	for (int i = 0; i < terms.size(); ++i)
+	{
+		const bool prefix = lastIsPrefix && i == terms.size() - 1;
+		const QVector<int>* list = postings(terms[i], prefix);
+		if (!list || list->isEmpty())
+			return result;
+		lists.append({ list, terms[i], prefix });
+	}
+
+	// ̵ıʼ󽻼
+	std::sort(lists.begin(), lists.end(), [](const Term& a, const Term& b) {
+		return a.list->size() < b.list->size();
+		});
+
+	QVector<int> hits = *lists.first().list;
+	QVector<int> merged;
+	for (int i = 1; i < lists.size() && !hits.isEmpty(); ++i)
+	{
+		merged.clear();
+		std::set_intersection(hits.cbegin(), hits.cend(), lists[i].list->cbegin(), lists[i].list->cend(),
+			std::back_inserter(merged));
+		hits.swap(merged);
+	}
+
+	// ǰ׺ȵĴֻȡ˺ѡ˶
+	QVector<const Term*> verify;
+	for (const Term& term : lists)
+	{
+		if (term.prefix && term.text.size() > MAX_PREFIX_LENGTH)
+			verify.append(&term);
+	}
+
+	// ͬһͼĿ˳鼴
+	QVector<int>* group = nullptr;
+	const QString* groupId = nullptr;
+	for (int id : hits)
+	{
+		const Entry& entry = m_entries[id];
+
+		bool matched = true;
+		for (const Term* term : verify)
+		{
+			if (!entryHasPrefix(entry, term->text))
+			{
+				matched = false;
+				break;
+			}
+		}
+		if (!matched)
+			continue;
+
+		if (!groupId || *groupId != entry.tilesetId)
+		{
+			groupId = &entry.tilesetId;
+			group = &result[entry.tilesetId];
+		}
+		group->append(entry.sliceIndex);
+	}
+
+	return result;
+}
+
+QStringList SliceSearchIndex::tokenize(const QString& text)
+{
+	QStringList tokens;
+	const QString folded = text.toCaseFolded();
+
+	int start = -1;
+	for (int i = 0; i <= folded.size(); ++i)
+	{
+		const bool inWord = i < folded.size() && folded[i].isLetterOrNumber();
+		if (inWord && start < 0)
+		{
+			start = i;
+		}
+		else if (!inWord && start >= 0)
+		{
+			tokens.append(folded.mid(start, i - start));
+			start = -1;
+		}
+	}
+	return tokens;
+}
+
+void SliceSearchIndex::link(int entryId)
+{
+	// Ŀŵ룬ͬһĿĶʹǰ׺ʱֻһ
+	auto appendId = [entryId](QVector<int>& list) {
+		if (list.isEmpty() || list.last() != entryId)
+			list.append(entryId);
+	};
+
+	for (const QString& token : m_entries[entryId].tokens)
+	{
+		appendId(m_tokens[token]);
+		for (const QString& key : prefixKeys(token))
+			appendId(m_prefixes[key]);
+	}
+}
+
+void SliceSearchIndex::unlink(int firstId, int lastId)
+{
+	QSet<QString> tokens;
+	for (int id = firstId; id <= lastId; ++id)
+	{
+		for (const QString& token : m_entries[id].tokens)
+			tokens.insert(token);
+	}
+
+	QSet<QString> prefixes;
+	for (const QString& token : tokens)
+	{
+		for (const QString& key : prefixKeys(token))
+			prefixes.insert(key);
+	}
+
+	auto unlinkFrom = [firstId, lastId](QHash<QString, QVector<int>>& table, const QSet<QString>& keys) {
+		for (const QString& key : keys)
+		{
+			auto it = table.find(key);
+			if (it == table.end())
+				continue;
+
+			eraseRange(it.value(), firstId, lastId);
+			if (it->isEmpty())
+				table.erase(it);
+		}
+	};
+
+	unlinkFrom(m_tokens, tokens);
+	unlinkFrom(m_prefixes, prefixes);
+}
+
+void SliceSearchIndex::compact()
+{
+	QVector<Entry> entries;
+	entries.swap(m_entries);
+	m_tilesets.clear();
+	m_tokens.clear();
+	m_prefixes.clear();
+
+	m_entries.reserve(m_liveCount);
+	for (Entry& entry : entries)
+	{
+		if (entry.sliceIndex < 0)
+			continue;
+
+		const int id = m_entries.size();
+		auto it = m_tilesets.find(entry.tilesetId);
+		if (it == m_tilesets.end())
+			m_tilesets.insert(entry.tilesetId, qMakePair(id, id));
+		else
+			it->second = id;
+
+		m_entries.append(std::move(entry));
+		link(id);
+	}
+}
+
+QStringList SliceSearchIndex::prefixKeys(const QString& token)
+{
+	QStringList keys;
+	auto addPrefixes = [&keys](QStringView word) {
+		const int length = qMin<int>(word.size(), MAX_PREFIX_LENGTH);
+		for (int n = 1; n <= length; ++n)
+			keys.append(word.left(n).toString());
+	};
+
+	addPrefixes(token);
+
+	// ִʣÿֿʼĺ׺Ҳǰ׺
+	for (int i = 1; i < token.size(); ++i)
+	{
+		if (isHan(token[i]))
+			addPrefixes(QStringView(token).mid(i));
+	}
+	return keys;
+}
+
+const QVector<int>* SliceSearchIndex::postings(const QString& term, bool prefix) const
+{
+	const auto& table = prefix ? m_prefixes : m_tokens;
+	const QString key = prefix ? term.left(MAX_PREFIX_LENGTH) : term;
+
+	auto it = table.constFind(key);
+	return it == table.constEnd() ? nullptr : &it.value();
+}
+
+bool SliceSearchIndex::entryHasPrefix(const Entry& entry, const QString& term)
+{
+	for (const QString& token : entry.tokens)
+	{
+		if (token.startsWith(term))
+			return true;
+
+		//  prefixKeys һ£ֺ׺
+		for (int i = 1; i < token.size(); ++i)
+		{
+			if (isHan(token[i]) && QStringView(token).mid(i).startsWith(term))
+				return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "SpriteSliceDefine.h"
+
+// Ƭͼ
+// - ơ顢ǩĸַдʲתСдű -> Ŀǰ׺ -> Ŀ
+// - ѯĴʣ˷ָƥ䣬һʰǰ׺ƥ䣬ȡ
+// - ֵĴⰴÿʼĺ׺ǰ׺мҲѵ
+// - ĿֻűȻ󽻼ԺϲͼĿƳʱɾ
+class SliceSearchIndex
+{
+public:
+	// ǰ׺ȣĲѯøóȵǰ׺ȡѡ˶
+	static constexpr int MAX_PREFIX_LENGTH = 16;
+
+	// ͼͬͼƳ
+	void addTileset(const QString& tilesetId, const QVector<SpriteSlice>& slices);
+	void removeTileset(const QString& tilesetId);
+	void clear();
+
+	// ѯͼ ID -> еƬ±꣨򣩣ѯΪʱؿձ
+	QHash<QString, QVector<int>> query(const QString& text) const;
+
+	static QStringList tokenize(const QString& text);
+
+private:
+	struct Entry
+	{
+		QString tilesetId;
+		int sliceIndex = -1;
+		QStringList tokens;   // ȥغĴʣΪձʾƳ
+	};
+
+	void link(int entryId);
+	void unlink(int firstId, int lastId);
+	void compact();
+
+	// ʵǰ׺ʱ׺ǰ׺
+	static QStringList prefixKeys(const QString& token);
+
+	const QVector<int>* postings(const QString& term, bool prefix) const;
+	static bool entryHasPrefix(const Entry& entry, const QString& term);
+
+private:
+	QVector<Entry> m_entries;                       // Ŀ -> Ŀ
+	QHash<QString, QPair<int, int>> m_tilesets;     // ͼ ID -> Ŀ [first, last]
+	QHash<QString, QVector<int>> m_tokens;          //  -> Ŀ
+	QHash<QString, QVector<int>> m_prefixes;        // ǰ׺ -> Ŀ
+	int m_liveCount = 0;
+};
@@ -0,0 +1,178 @@
+#include "SliceSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SliceSpatialIndex::rebuild(const QVector<SpriteSlice>& slices)
+{
+	clear();
+	m_rects.reserve(slices.size());
+	for (const SpriteSlice& slice : slices)
+		append(QRect(slice.x, slice.y, slice.width, slice.height));
+}
+
+void SliceSpatialIndex::clear()
+{
+	m_rects.clear();
+	m_buckets.clear();
+}
+
+void SliceSpatialIndex::append(const QRect& rect)
+{
+	m_rects.append(rect);
+	link(m_rects.size() - 1, rect);
+}
+
+void SliceSpatialIndex::update(int row, const QRect& rect)
+{
+	if (row < 0 || row >= m_rects.size() || m_rects[row] == rect)
+		return;
+
+	unlink(row, m_rects[row]);
+	m_rects[row] = rect;
+	link(row, rect);
+}
+
+void SliceSpatialIndex::remove(QVector<int> rows)
+{
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+	rows.erase(std::remove_if(rows.begin(), rows.end(),
+		[this](int row) { return row < 0 || row >= m_rects.size(); }), rows.end());
+	if (rows.isEmpty())
+		return;
+
+	for (int row : rows)
+		unlink(row, m_rects[row]);
+
+	// һɾ֮ǰкŲ䣻֮кżȥǰ汻ɾ
+	const int first = rows.first();
+	for (QVector<int>& bucket : m_buckets)
+	{
+		for (int& row : bucket)
+		{
+			if (row > first)
+				row -= static_cast<int>(std::upper_bound(rows.cbegin(), rows.cend(), row) - rows.cbegin());
+		}
+	}
+
+	int write = first;
+	int next = 0;
+	for (int read = first; read < m_rects.size(); ++read)
+	{
+		if (next < rows.size() && rows[next] == read)
+		{
+			++next;
+			continue;
+		}
+		m_rects[write++] = m_rects[read];
+	}
+	m_rects.resize(write);
+}
+
+int SliceSpatialIndex::indexAt(const QPointF& point) const
+{
+	const int cellX = static_cast<int>(std::floor(point.x() / CELL_SIZE));
+	const int cellY = static_cast<int>(std::floor(point.y() / CELL_SIZE));
+
+	auto it = m_buckets.constFind(cellKey(cellX, cellY));
+	if (it == m_buckets.constEnd())
+		return -1;
+
+	int result = -1;
+	for (int row : it.value())
+	{
+		if (row > result && QRectF(m_rects[row]).contains(point))
+			result = row;
+	}
+	return result;
+}
+
+QVector<int> SliceSpatialIndex::indicesIntersecting(const QRectF& rect) const
+{
+	QVector<int> result;
+	if (rect.isEmpty() || m_rects.isEmpty())
+		return result;
+
+	const QRect cells = cellRange(rect);
+
+	// ѡΧǵͰеͰʱֱȽϸ
+	if (static_cast<qint64>(cells.width()) * cells.height() > m_buckets.size())
+	{
+		for (int row = 0; row < m_rects.size(); ++row)
+		{
+			if (rect.intersects(QRectF(m_rects[row])))
+				result.append(row);
+		}
+		return result;
+	}
+
+	for (int cy = cells.top(); cy <= cells.bottom(); ++cy)
+	{
+		for (int cx = cells.left(); cx <= cells.right(); ++cx)
+		{
+			auto it = m_buckets.constFind(cellKey(cx, cy));
+			if (it == m_buckets.constEnd())
+				continue;
+
+			for (int row : it.value())
+			{
+				if (rect.intersects(QRectF(m_rects[row])))
+					result.append(row);
+			}
+		}
+	}
+
+	// ͰƬظ
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+quint64 SliceSpatialIndex::cellKey(int cellX, int cellY)
+{
+	return (static_cast<quint64>(static_cast<quint32>(cellX)) << 32)
+		| static_cast<quint64>(static_cast<quint32>(cellY));
+}
+
+QRect SliceSpatialIndex::cellRange(const QRectF& rect)
+{
+	// ҡ±߽Ҳڣ QRectF::contains һ£
+	return QRect(
+		QPoint(static_cast<int>(std::floor(rect.left() / CELL_SIZE)), static_cast<int>(std::floor(rect.top() / CELL_SIZE))),
+		QPoint(static_cast<int>(std::floor(rect.right() / CELL_SIZE)), static_cast<int>(std::floor(rect.bottom() / CELL_SIZE))));
+}
+
+void SliceSpatialIndex::link(int row, const QRect& rect)
+{
+	if (rect.isEmpty())
+		return;
+
+	const QRect cells = cellRange(QRectF(rect));
+	for (int cy = cells.top(); cy <= cells.bottom(); ++cy)
+	{
+		for (int cx = cells.left(); cx <= cells.right(); ++cx)
+			m_buckets[cellKey(cx, cy)].append(row);
+	}
+}
+
+void SliceSpatialIndex::unlink(int row, const QRect& rect)
+{
+	if (rect.isEmpty())
+		return;
+
+	const QRect cells = cellRange(QRectF(rect));
+	for (int cy = cells.top(); cy <= cells.bottom(); ++cy)
+	{
+		for (int cx = cells.left(); cx <= cells.right(); ++cx)
+		{
+			auto it = m_buckets.find(cellKey(cx, cy));
+			if (it == m_buckets.end())
+				continue;
+
+			it->removeOne(row);
+			if (it->isEmpty())
+				m_buckets.erase(it);
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QHash>
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QVector>
+#include "SpriteSliceDefine.h"
+
+// ƬĿռƬ༭ĵѡѡ
+// - ȷͰͼ CELL_SIZE ػ֣ÿͰ¼ཻ֮Ƭк
+// - ѯֻһͰѯֻǵͰƬ޹
+// - кƬһһӦɾƬʱֻժɾУͰкԭǰƣؽ
+class SliceSpatialIndex
+{
+public:
+	static constexpr int CELL_SIZE = 64;
+
+	void rebuild(const QVector<SpriteSlice>& slices);
+	void clear();
+
+	// ׷ / һУappend кűڵǰ
+	void append(const QRect& rect);
+	void update(int row, const QRect& rect);
+
+	// ɾУƬͬɾкǰ
+	void remove(QVector<int> rows);
+
+	int size() const { return m_rects.size(); }
+
+	// õƬкһӵϲ㣩ûʱ -1
+	int indexAt(const QPointF& point) const;
+
+	// ཻƬкţ
+	QVector<int> indicesIntersecting(const QRectF& rect) const;
+
+private:
+	static quint64 cellKey(int cellX, int cellY);
+	static QRect cellRange(const QRectF& rect);
+
+	void link(int row, const QRect& rect);
+	void unlink(int row, const QRect& rect);
+
+private:
+	QVector<QRect> m_rects;                     // к -> Ƭ
+	QHash<quint64, QVector<int>> m_buckets;     // Ͱ -> ཻƬк
+};
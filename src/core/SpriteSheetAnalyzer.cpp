@@ -0,0 +1,892 @@
+#include "SpriteSheetAnalyzer.h"
+#include "TileRegion.h"
+
+#include <QHash>
+#include <QThreadPool>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MEDITOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// һĲ͸ [start, end]
+	struct OpaqueRun
+	{
+		int start = 0;
+		int end = 0;
+		int label = 0;
+	};
+
+	struct LabelBox
+	{
+		int left = 0;
+		int top = 0;
+		int right = 0;
+		int bottom = 0;
+
+		void unite(const LabelBox& other)
+		{
+			left = std::min(left, other.left);
+			top = std::min(top, other.top);
+			right = std::max(right, other.right);
+			bottom = std::max(bottom, other.bottom);
+		}
+	};
+
+	// ȡһеĲ͸Σalpha λÿصĸ 8 λ
+	void scanOpaqueRuns(const quint32* line, int width, quint32 threshold, QVector<OpaqueRun>& runs)
+	{
+		runs.clear();
+		int runStart = -1;
+		int x = 0;
+
+#ifdef MEDITOR_SSE2
+		// 16 һ飺͸鲻͸ʱж
+		const __m128i limit = _mm_set1_epi32(static_cast<int>(threshold));
+		for (; x + 16 <= width; x += 16)
+		{
+			const __m128i* block = reinterpret_cast<const __m128i*>(line + x);
+			int mask = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				const __m128i alpha = _mm_srli_epi32(_mm_loadu_si128(block + i), 24);
+				const __m128i opaque = _mm_cmpgt_epi32(alpha, limit);
+				mask |= _mm_movemask_ps(_mm_castsi128_ps(opaque)) << (i * 4);
+			}
+
+			if (mask == 0)
+			{
+				if (runStart >= 0)
+				{
+					runs.append({ runStart, x - 1 });
+					runStart = -1;
+				}
+				continue;
+			}
+			if (mask == 0xFFFF)
+			{
+				if (runStart < 0)
+					runStart = x;
+				continue;
+			}
+
+			for (int bit = 0; bit < 16; ++bit)
+			{
+				const bool opaque = (mask >> bit) & 1;
+				if (opaque && runStart < 0)
+				{
+					runStart = x + bit;
+				}
+				else if (!opaque && runStart >= 0)
+				{
+					runs.append({ runStart, x + bit - 1 });
+					runStart = -1;
+				}
+			}
+		}
+#endif
+
+		for (; x < width; ++x)
+		{
+			const bool opaque = (line[x] >> 24) > threshold;
+			if (opaque && runStart < 0)
+			{
+				runStart = x;
+			}
+			else if (!opaque && runStart >= 0)
+			{
+				runs.append({ runStart, x - 1 });
+				runStart = -1;
+			}
+		}
+
+		if (runStart >= 0)
+			runs.append({ runStart, width - 1 });
+	}
+
+	int findRoot(QVector<int>& parent, int label)
+	{
+		while (parent[label] != label)
+		{
+			parent[label] = parent[parent[label]];   // ·
+			label = parent[label];
+		}
+		return label;
+	}
+
+	// ϲȼ࣬СıǩΪ
+	int uniteLabels(QVector<int>& parent, int a, int b)
+	{
+		a = findRoot(parent, a);
+		b = findRoot(parent, b);
+		if (a == b)
+			return a;
+		if (b < a)
+			std::swap(a, b);
+		parent[b] = a;
+		return a;
+	}
+
+	bool readingOrder(const QRect& a, const QRect& b)
+	{
+		if (a.top() != b.top())
+			return a.top() < b.top();
+		return a.left() < b.left();
+	}
+
+	// ========== ʶ ==========
+
+	constexpr int MIN_GRID_TILE = 4;
+	constexpr int MAX_GRID_TILE = 1024;   // ʱƬߴ
+
+	// 
+	struct AxisGrid
+	{
+		int margin = 0;
+		int tile = 0;
+		int spacing = 0;
+	};
+
+	// /
+	struct GridProfiles
+	{
+		QVector<bool> rowGutter;         // жǱɫ
+		QVector<bool> columnGutter;      // жǱɫ
+		QVector<quint32> rowEdges;       // һвͬ
+		QVector<quint32> columnEdges;    // һвͬ
+	};
+
+	quint32 pixelAt(const QImage& image, int x, int y)
+	{
+		return reinterpret_cast<const quint32*>(image.constScanLine(y))[x];
+	}
+
+	// ĸгɫ
+	quint32 pickBackground(const QImage& image)
+	{
+		const int right = image.width() - 1;
+		const int bottom = image.height() - 1;
+		const quint32 corners[4] = {
+			pixelAt(image, 0, 0), pixelAt(image, right, 0),
+			pixelAt(image, 0, bottom), pixelAt(image, right, bottom)
+		};
+
+		quint32 background = corners[0];
+		int bestCount = 0;
+		for (quint32 color : corners)
+		{
+			const int count = static_cast<int>(std::count(corners, corners + 4, color));
+			if (count > bestCount)
+			{
+				background = color;
+				bestCount = count;
+			}
+		}
+		return background;
+	}
+
+	// һɨУͬʱۼ
+	GridProfiles buildProfiles(const QImage& image, quint32 background)
+	{
+		const int width = image.width();
+		const int height = image.height();
+
+		GridProfiles profiles;
+		profiles.rowGutter.resize(height);
+		profiles.rowEdges.resize(height);
+		profiles.columnEdges.fill(0, width);
+
+		// ǷȫΪλۻ0xFFFFFFFF Ϊǣ
+		QVector<quint32> columnMask(width, 0xFFFFFFFFu);
+		quint32* mask = columnMask.data();
+		quint32* columnEdges = profiles.columnEdges.data();
+
+		for (int y = 0; y < height; ++y)
+		{
+			const quint32* line = reinterpret_cast<const quint32*>(image.constScanLine(y));
+			const quint32* previous = y > 0 ? reinterpret_cast<const quint32*>(image.constScanLine(y - 1)) : nullptr;
+
+			bool uniform = true;
+			quint32 edges = 0;
+
+			//  0 û
+			if (line[0] != background)
+			{
+				uniform = false;
+				mask[0] = 0;
+			}
+			if (previous && line[0] != previous[0])
+				++edges;
+
+			int x = 1;
+
+#ifdef MEDITOR_SSE2
+			// ڽڼĴۻĩٹԼ
+			const __m128i backgroundColor = _mm_set1_epi32(static_cast<int>(background));
+			const __m128i allOnes = _mm_set1_epi32(-1);
+			__m128i rowBackground = allOnes;
+			__m128i rowEdges = _mm_setzero_si128();
+			for (; x + 4 <= width; x += 4)
+			{
+				const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+
+				const __m128i isBackground = _mm_cmpeq_epi32(pixels, backgroundColor);
+				rowBackground = _mm_and_si128(rowBackground, isBackground);
+
+				__m128i* maskBlock = reinterpret_cast<__m128i*>(mask + x);
+				_mm_storeu_si128(maskBlock, _mm_and_si128(_mm_loadu_si128(maskBlock), isBackground));
+
+				// ͬͨΪ -1һ
+				const __m128i sameAsLeft = _mm_cmpeq_epi32(pixels, _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x - 1)));
+				__m128i* edgeBlock = reinterpret_cast<__m128i*>(columnEdges + x);
+				_mm_storeu_si128(edgeBlock, _mm_sub_epi32(_mm_loadu_si128(edgeBlock), _mm_xor_si128(sameAsLeft, allOnes)));
+
+				if (previous)
+				{
+					const __m128i sameAsAbove = _mm_cmpeq_epi32(pixels, _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + x)));
+					rowEdges = _mm_sub_epi32(rowEdges, _mm_xor_si128(sameAsAbove, allOnes));
+				}
+			}
+
+			if (_mm_movemask_ps(_mm_castsi128_ps(rowBackground)) != 0xF)
+				uniform = false;
+
+			alignas(16) quint32 lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), rowEdges);
+			edges += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+			for (; x < width; ++x)
+			{
+				if (line[x] != background)
+				{
+					uniform = false;
+					mask[x] = 0;
+				}
+				if (line[x] != line[x - 1])
+					++columnEdges[x];
+				if (previous && line[x] != previous[x])
+					++edges;
+			}
+
+			profiles.rowGutter[y] = uniform;
+			profiles.rowEdges[y] = edges;
+		}
+
+		profiles.columnGutter.resize(width);
+		for (int x = 0; x < width; ++x)
+			profiles.columnGutter[x] = mask[x] != 0;
+
+		return profiles;
+	}
+
+	//  position λΪ phase λãһƬ㣩
+	// ߾಻ΪͼƬʱ˳һ
+	int alignDown(int position, int phase, int period)
+	{
+		const int start = position - (((position - phase) % period) + period) % period;
+		return start < 0 ? start + period : start;
+	}
+
+	// мߣ [first, last] ۵ҳÿڶǼλ
+	// λɵĻζԽԽãڻֶΣͬȡ
+	bool detectByGutters(const QVector<bool>& gutter, int first, int last, AxisGrid& out)
+	{
+		const int span = last - first + 1;
+		int bestArcs = INT_MAX;
+		QVector<char> alwaysGutter;
+
+		for (int period = MIN_GRID_TILE + 1; period <= span; ++period)
+		{
+			alwaysGutter.fill(1, period);
+			for (int i = first, phase = first % period; i <= last; ++i)
+			{
+				if (!gutter[i])
+					alwaysGutter[phase] = 0;
+				if (++phase == period)
+					phase = 0;
+			}
+
+			// ͳƻζΣ¼һΪ
+			int arcs = 0;
+			int arcStart = 0;
+			int arcLength = 0;
+			for (int phase = 0; phase < period; ++phase)
+			{
+				if (!alwaysGutter[phase] || alwaysGutter[(phase + period - 1) % period])
+					continue;
+
+				++arcs;
+				int length = 0;
+				while (length < period && alwaysGutter[(phase + length) % period])
+					++length;
+				if (length > arcLength)
+				{
+					arcStart = phase;
+					arcLength = length;
+				}
+			}
+
+			if (arcs == 0 || period - arcLength < MIN_GRID_TILE || arcs >= bestArcs)
+				continue;
+
+			bestArcs = arcs;
+			out.tile = period - arcLength;
+			out.spacing = arcLength;
+			out.margin = alignDown(first, (arcStart + arcLength) % period, period);
+
+			if (arcs == 1)
+				break;
+		}
+
+		return bestArcs != INT_MAX;
+	}
+
+	// У水۵Ƭ߽λƽ
+	// ڵĵ÷ʵͬȡ÷ֽӽֵ
+	AxisGrid detectByEdges(const QVector<quint32>& edges, int first, int last)
+	{
+		const int span = last - first + 1;
+		AxisGrid out{ first, span, 0 };
+		if (span < MIN_GRID_TILE * 2)
+			return out;
+
+		const int maxPeriod = std::min(span / 2, MAX_GRID_TILE);
+		QVector<double> scores(maxPeriod + 1, 0.0);
+		QVector<int> phases(maxPeriod + 1, 0);
+		QVector<quint64> sums;
+		QVector<int> counts;
+		double bestScore = 0.0;
+
+		for (int period = MIN_GRID_TILE; period <= maxPeriod; ++period)
+		{
+			sums.fill(0, period);
+			counts.fill(0, period);
+			for (int i = first + 1, phase = (first + 1) % period; i <= last; ++i)
+			{
+				sums[phase] += edges[i];
+				++counts[phase];
+				if (++phase == period)
+					phase = 0;
+			}
+
+			for (int phase = 0; phase < period; ++phase)
+			{
+				if (counts[phase] == 0)
+					continue;
+				const double mean = static_cast<double>(sums[phase]) / counts[phase];
+				if (mean > scores[period])
+				{
+					scores[period] = mean;
+					phases[period] = phase;
+				}
+			}
+			bestScore = std::max(bestScore, scores[period]);
+		}
+
+		if (bestScore <= 0.0)
+			return out;
+
+		for (int period = MIN_GRID_TILE; period <= maxPeriod; ++period)
+		{
+			if (scores[period] >= bestScore * 0.9)
+			{
+				out.tile = period;
+				out.margin = alignDown(first, phases[period], period);
+				break;
+			}
+		}
+		return out;
+	}
+
+	AxisGrid detectAxis(const QVector<bool>& gutter, const QVector<quint32>& edges)
+	{
+		const int length = gutter.size();
+		int first = 0;
+		while (first < length && gutter[first])
+			++first;
+		if (first == length)
+			return AxisGrid();
+
+		int last = length - 1;
+		while (gutter[last])
+			--last;
+
+		const bool hasInteriorGutter = std::find(gutter.begin() + first, gutter.begin() + last + 1, true) != gutter.begin() + last + 1;
+
+		AxisGrid grid;
+		if (hasInteriorGutter && detectByGutters(gutter, first, last, grid))
+			return grid;
+		return detectByEdges(edges, first, last);
+	}
+
+	// ========== ظƬ ==========
+
+	// ľ루u * u + v * vͬȨͬת/תϣ
+	quint32 ringWeight(int distance)
+	{
+		quint32 h = static_cast<quint32>(distance) * 0x9E3779B1u;
+		h ^= h >> 16;
+		h *= 0x85EBCA6Bu;
+		h ^= h >> 13;
+		return h;
+	}
+
+	// ΪԭŴ֤Ϊ
+	QVector<quint32> ringWeights(int width, int height)
+	{
+		QVector<quint32> weights(width * height);
+		for (int y = 0; y < height; ++y)
+		{
+			const int v = 2 * y + 1 - height;
+			for (int x = 0; x < width; ++x)
+			{
+				const int u = 2 * x + 1 - width;
+				weights[y * width + x] = ringWeight(u * u + v * v);
+			}
+		}
+		return weights;
+	}
+
+	inline quint32 mixPixel(quint32 pixel)
+	{
+		pixel ^= pixel >> 15;
+		pixel += pixel << 7;
+		pixel ^= pixel >> 11;
+		return pixel;
+	}
+
+	// ػֵλȨͣ˳޹أ
+	quint32 invariantHash(const QImage& image, const QRect& rect, const quint32* weights)
+	{
+		const int width = rect.width();
+		quint32 sum = 0;
+
+#ifdef MEDITOR_SSE2
+		__m128i accumulator = _mm_setzero_si128();
+#endif
+
+		for (int y = 0; y < rect.height(); ++y)
+		{
+			const quint32* line = reinterpret_cast<const quint32*>(image.constScanLine(rect.y() + y)) + rect.x();
+			const quint32* weightLine = weights + y * width;
+			int x = 0;
+
+#ifdef MEDITOR_SSE2
+			for (; x + 4 <= width; x += 4)
+			{
+				__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+				pixels = _mm_xor_si128(pixels, _mm_srli_epi32(pixels, 15));
+				pixels = _mm_add_epi32(pixels, _mm_slli_epi32(pixels, 7));
+				pixels = _mm_xor_si128(pixels, _mm_srli_epi32(pixels, 11));
+				const __m128i weighted = _mm_xor_si128(pixels, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weightLine + x)));
+				accumulator = _mm_add_epi32(accumulator, weighted);
+			}
+#endif
+
+			for (; x < width; ++x)
+				sum += mixPixel(line[x]) ^ weightLine[x];
+		}
+
+#ifdef MEDITOR_SSE2
+		alignas(16) quint32 lanes[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+		sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+		return sum;
+	}
+
+	// target Ƿ source  bits 任Ľȷϣ
+	bool matchesTransformed(const QImage& image, const QRect& source, const QRect& target, quint8 bits)
+	{
+		const int width = source.width();
+		const int height = source.height();
+
+		if (bits == 0)
+		{
+			for (int y = 0; y < height; ++y)
+			{
+				const quint32* a = reinterpret_cast<const quint32*>(image.constScanLine(source.y() + y)) + source.x();
+				const quint32* b = reinterpret_cast<const quint32*>(image.constScanLine(target.y() + y)) + target.x();
+				if (std::memcmp(a, b, width * sizeof(quint32)) != 0)
+					return false;
+			}
+			return true;
+		}
+
+		const TileTransformBits::Matrix m = TileTransformBits::matrix(bits);
+		const int targetWidth = target.width();
+		const int targetHeight = target.height();
+		for (int y = 0; y < height; ++y)
+		{
+			const quint32* line = reinterpret_cast<const quint32*>(image.constScanLine(source.y() + y)) + source.x();
+			const int v = 2 * y + 1 - height;
+			for (int x = 0; x < width; ++x)
+			{
+				const int u = 2 * x + 1 - width;
+				const int tx = (u * m.m11 + v * m.m21 + targetWidth - 1) / 2;
+				const int ty = (u * m.m12 + v * m.m22 + targetHeight - 1) / 2;
+				const quint32* targetLine = reinterpret_cast<const quint32*>(image.constScanLine(target.y() + ty)) + target.x();
+				if (targetLine[tx] != line[x])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// ========== ͸߲ü ==========
+
+	// [from, to) еһ͸أû򷵻 to
+	int firstOpaque(const quint32* line, int from, int to, quint32 threshold)
+	{
+		int x = from;
+#ifdef MEDITOR_SSE2
+		const __m128i limit = _mm_set1_epi32(static_cast<int>(threshold));
+		for (; x + 4 <= to; x += 4)
+		{
+			const __m128i alpha = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x)), 24);
+			const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(alpha, limit)));
+			if (mask != 0)
+				return x + std::countr_zero(static_cast<unsigned>(mask));
+		}
+#endif
+		for (; x < to; ++x)
+		{
+			if ((line[x] >> 24) > threshold)
+				return x;
+		}
+		return to;
+	}
+
+	// [from, to) һ͸أû򷵻 from - 1
+	int lastOpaque(const quint32* line, int from, int to, quint32 threshold)
+	{
+		int x = to;
+#ifdef MEDITOR_SSE2
+		const __m128i limit = _mm_set1_epi32(static_cast<int>(threshold));
+		for (; x - 4 >= from; x -= 4)
+		{
+			const __m128i alpha = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x - 4)), 24);
+			const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(alpha, limit)));
+			if (mask != 0)
+				return x - 4 + (31 - std::countl_zero(static_cast<unsigned>(mask)));
+		}
+#endif
+		for (; x > from; --x)
+		{
+			if ((line[x - 1] >> 24) > threshold)
+				return x - 1;
+		}
+		return from - 1;
+	}
+
+	QRect tightBounds(const QImage& image, const QRect& rect, quint32 threshold)
+	{
+		auto lineAt = [&image](int y) {
+			return reinterpret_cast<const quint32*>(image.constScanLine(y));
+		};
+
+		const int left = rect.left();
+		const int right = rect.right() + 1;
+
+		int top = rect.top();
+		while (top <= rect.bottom() && firstOpaque(lineAt(top), left, right, threshold) == right)
+			++top;
+		if (top > rect.bottom())
+			return QRect();
+
+		int bottom = rect.bottom();
+		while (firstOpaque(lineAt(bottom), left, right, threshold) == right)
+			--bottom;
+
+		// ұֻ߽δǵĲ
+		int minX = right;
+		int maxX = left - 1;
+		for (int y = top; y <= bottom; ++y)
+		{
+			const quint32* line = lineAt(y);
+			minX = std::min(minX, firstOpaque(line, left, minX, threshold));
+			maxX = std::max(maxX, lastOpaque(line, maxX + 1, right, threshold));
+			if (minX == left && maxX == right - 1)
+				break;
+		}
+
+		return QRect(QPoint(minX, top), QPoint(maxX, bottom));
+	}
+
+}
+
+// ============== ͸ ==============
+
+QVector<QRect> SpriteSheetAnalyzer::findOpaqueRegions(const QImage& image, int alphaThreshold, int mergeDistance)
+{
+	if (image.isNull())
+		return QVector<QRect>();
+
+	// ԤԤ˵ alpha λͬʽͳһת
+	QImage argb = image;
+	if (argb.format() != QImage::Format_ARGB32 && argb.format() != QImage::Format_ARGB32_Premultiplied)
+		argb = argb.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+	const int width = argb.width();
+	const int height = argb.height();
+	const quint32 threshold = static_cast<quint32>(std::clamp(alphaThreshold, 0, 255));
+
+	// ---------- һ飺ȡ͸βʱǩ ----------
+	QVector<int> parent;
+	QVector<LabelBox> boxes;
+	QVector<OpaqueRun> previous;
+	QVector<OpaqueRun> current;
+
+	for (int y = 0; y < height; ++y)
+	{
+		scanOpaqueRuns(reinterpret_cast<const quint32*>(argb.constScanLine(y)), width, threshold, current);
+
+		int first = 0;
+		for (OpaqueRun& run : current)
+		{
+			// 8 ͨһеĶ [start - 1, end + 1] н
+			while (first < previous.size() && previous[first].end < run.start - 1)
+				++first;
+
+			int label = -1;
+			for (int k = first; k < previous.size() && previous[k].start <= run.end + 1; ++k)
+				label = label < 0 ? findRoot(parent, previous[k].label) : uniteLabels(parent, label, previous[k].label);
+
+			if (label < 0)
+			{
+				label = parent.size();
+				parent.append(label);
+				boxes.append({ run.start, y, run.end, y });
+			}
+			else
+			{
+				boxes[label].unite({ run.start, y, run.end, y });
+			}
+			run.label = label;
+		}
+
+		std::swap(previous, current);
+	}
+
+	// ---------- ڶ飺ѵȼ۱ǩİΧй鲢ǩ ----------
+	QVector<int> slotOfRoot(parent.size(), -1);
+	QVector<LabelBox> merged;
+	for (int label = 0; label < parent.size(); ++label)
+	{
+		const int root = findRoot(parent, label);
+		if (slotOfRoot[root] < 0)
+		{
+			slotOfRoot[root] = merged.size();
+			merged.append(boxes[label]);
+		}
+		else
+		{
+			merged[slotOfRoot[root]].unite(boxes[label]);
+		}
+	}
+
+	QVector<QRect> regions;
+	regions.reserve(merged.size());
+	for (const LabelBox& box : merged)
+		regions.append(QRect(QPoint(box.left, box.top), QPoint(box.right, box.bottom)));
+
+	if (mergeDistance > 0)
+		return mergeNearby(std::move(regions), mergeDistance);
+
+	std::sort(regions.begin(), regions.end(), readingOrder);
+	return regions;
+}
+
+QVector<QRect> SpriteSheetAnalyzer::mergeNearby(QVector<QRect> rects, int distance)
+{
+	// ಻ distance ɺϲ൱ڰѾչ distance + 1 ཻ
+	const int reach = distance + 1;
+
+	// ɨ裺ֻڵǰչΧڵĲſཻ
+	bool changed = true;
+	while (changed && rects.size() > 1)
+	{
+		changed = false;
+		std::sort(rects.begin(), rects.end(), [](const QRect& a, const QRect& b) {
+			return a.left() < b.left();
+			});
+
+		QVector<bool> removed(rects.size(), false);
+		for (int i = 0; i < rects.size(); ++i)
+		{
+			if (removed[i])
+				continue;
+
+			for (int j = i + 1; j < rects.size() && rects[j].left() <= rects[i].right() + reach; ++j)
+			{
+				if (removed[j])
+					continue;
+
+				if (rects[i].adjusted(-reach, -reach, reach, reach).intersects(rects[j]))
+				{
+					rects[i] = rects[i].united(rects[j]);
+					removed[j] = true;
+					changed = true;
+				}
+			}
+		}
+
+		QVector<QRect> kept;
+		kept.reserve(rects.size());
+		for (int i = 0; i < rects.size(); ++i)
+		{
+			if (!removed[i])
+				kept.append(rects[i]);
+		}
+		rects = std::move(kept);
+	}
+
+	std::sort(rects.begin(), rects.end(), readingOrder);
+	return rects;
+}
+
+// ============== ʶ ==============
+
+SpriteGridParams SpriteSheetAnalyzer::detectGrid(const QImage& image)
+{
+	if (image.isNull())
+		return SpriteGridParams();
+
+	// Ԥ˸ʽȫ͸ͳһΪ 0RGB32  alpha Ϊ 0xFF߶ֱӱȽ
+	QImage pixels = image;
+	if (pixels.format() != QImage::Format_ARGB32_Premultiplied && pixels.format() != QImage::Format_RGB32)
+		pixels = pixels.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+	const GridProfiles profiles = buildProfiles(pixels, pickBackground(pixels));
+	const AxisGrid columns = detectAxis(profiles.columnGutter, profiles.columnEdges);
+	const AxisGrid rows = detectAxis(profiles.rowGutter, profiles.rowEdges);
+
+	SpriteGridParams params;
+	if (columns.tile <= 0 || rows.tile <= 0)
+		return params;
+
+	params.tileWidth = columns.tile;
+	params.tileHeight = rows.tile;
+	params.marginX = columns.margin;
+	params.marginY = rows.margin;
+	params.spacingX = columns.spacing;
+	params.spacingY = rows.spacing;
+	return params;
+}
+
+// ============== ظƬ ==============
+
+QVector<SliceDuplicate> SpriteSheetAnalyzer::findDuplicates(const QImage& image, const QVector<QRect>& rects)
+{
+	QVector<SliceDuplicate> duplicates;
+	if (image.isNull())
+		return duplicates;
+
+	// Ԥ˸ʽȫ͸ͳһΪ 0ͬƬŻΪͬ
+	QImage pixels = image;
+	if (pixels.format() != QImage::Format_ARGB32_Premultiplied && pixels.format() != QImage::Format_RGB32)
+		pixels = pixels.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+	// γԵı任ԭٷתת
+	QVector<quint8> squareTransforms;
+	QVector<quint8> flatTransforms;
+	for (int degrees = 0; degrees < 360; degrees += 90)
+	{
+		for (bool flip : { false, true })
+		{
+			const quint8 bits = TileTransformBits::pack(flip, false, degrees);
+			squareTransforms.append(bits);
+			if (degrees % 180 == 0)
+				flatTransforms.append(bits);
+		}
+	}
+
+	const QRect bounds = pixels.rect();
+	QHash<quint64, QVector<quint32>> weightTables;   // ߴ -> λȨ
+	QHash<quint64, QVector<int>> canonicals;         // ϣ + ߴ -> 淶Ƭ
+
+	for (int i = 0; i < rects.size(); ++i)
+	{
+		const QRect& rect = rects[i];
+		if (rect.isEmpty() || !bounds.contains(rect))
+			continue;
+
+		const quint64 sizeKey = (static_cast<quint64>(rect.width()) << 32) | static_cast<quint32>(rect.height());
+		auto table = weightTables.find(sizeKey);
+		if (table == weightTables.end())
+			table = weightTables.insert(sizeKey, ringWeights(rect.width(), rect.height()));
+
+		const quint32 hash = invariantHash(pixels, rect, table->constData());
+		QVector<int>& candidates = canonicals[(static_cast<quint64>(hash) << 32) ^ sizeKey];
+
+		const QVector<quint8>& transforms = rect.width() == rect.height() ? squareTransforms : flatTransforms;
+		bool found = false;
+		for (int canonical : candidates)
+		{
+			if (rects[canonical].size() != rect.size())
+				continue;
+
+			for (quint8 bits : transforms)
+			{
+				if (matchesTransformed(pixels, rects[canonical], rect, bits))
+				{
+					duplicates.append({ i, canonical, bits });
+					found = true;
+					break;
+				}
+			}
+			if (found)
+				break;
+		}
+
+		if (!found)
+			candidates.append(i);
+	}
+
+	return duplicates;
+}
+
+// ============== ͸߲ü ==============
+
+QVector<QRect> SpriteSheetAnalyzer::findTightBounds(const QImage& image, const QVector<QRect>& rects, int alphaThreshold)
+{
+	QVector<QRect> bounds(rects.size());
+	if (image.isNull() || rects.isEmpty())
+		return bounds;
+
+	QImage argb = image;
+	if (argb.format() != QImage::Format_ARGB32 && argb.format() != QImage::Format_ARGB32_Premultiplied)
+		argb = argb.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+	const QRect imageRect = argb.rect();
+	const quint32 threshold = static_cast<quint32>(std::clamp(alphaThreshold, 0, 255));
+	QRect* out = bounds.data();   // ȷһΣֻ߳дԼ±
+
+	// ÿɸΣԼΪ߳ļڸؾ
+	QThreadPool pool;
+	const int batchCount = std::max(1, std::min<int>(rects.size(), pool.maxThreadCount() * 4));
+	const int batchSize = (rects.size() + batchCount - 1) / batchCount;
+
+	for (int begin = 0; begin < rects.size(); begin += batchSize)
+	{
+		const int end = std::min<int>(rects.size(), begin + batchSize);
+		pool.start([&argb, &rects, out, imageRect, threshold, begin, end]() {
+			for (int i = begin; i < end; ++i)
+			{
+				if (!rects[i].isEmpty() && imageRect.contains(rects[i]))
+					out[i] = tightBounds(argb, rects[i], threshold);
+			}
+			});
+	}
+	pool.waitForDone();
+
+	return bounds;
+}
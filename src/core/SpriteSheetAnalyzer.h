@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QImage>
+#include <QRect>
+#include <QVector>
+
+// Ƭ༭һһӦ
+struct SpriteGridParams
+{
+	int tileWidth = 0;
+	int tileHeight = 0;
+	int marginX = 0;
+	int marginY = 0;
+	int spacingX = 0;
+	int spacingY = 0;
+
+	bool isValid() const { return tileWidth > 0 && tileHeight > 0; }
+};
+
+// ظƬrects[index] ص rects[canonical]  transformTileTransformBits任Ľ
+struct SliceDuplicate
+{
+	int index = -1;
+	int canonical = -1;
+	quint8 transform = 0;
+};
+
+// ͼƬ༭ԶƬʶظƬ⣩
+// ֱӶȡ ARGB32 ɨУ QColor/pixel()ͼҲһ
+class SpriteSheetAnalyzer
+{
+public:
+	// ========== ͸ ==========
+	//  alpha > alphaThreshold  8 ͨǣÿͨİΧ
+	// - һȡ͸ΣSSE2 һαȽ 16 أһصĶκϲǩ
+	// - ڶѵȼ۱ǩ鲢ǩõΧ
+	// mergeDistance > 0 ʱ಻ֵİΧлᱻϲСΪһƬ
+	// ϵ¡
+	static QVector<QRect> findOpaqueRegions(const QImage& image, int alphaThreshold, int mergeDistance);
+
+	// ϲ಻ distance ľΣֱûпɺϲΪֹ
+	static QVector<QRect> mergeNearby(QVector<QRect> rects, int distance);
+
+	// ========== ʶ ==========
+	// һɨõ/棺УУǱɫļߣԼУУĲ
+	// - ڲʱҳÿڶǼλõƬߴ硢ͱ߾
+	// - ƬУûмʱƬ߽磬Ϊ 0
+	// ɫȡĸгɫ͸ͼһΪȫ͸
+	static SpriteGridParams detectGrid(const QImage& image);
+
+	// ========== ظƬ ==========
+	// ÿһ뷭ת/ת޹صĹϣػֵĵľȨͣSSE2
+	// ϣͳߴ綼ͬĺѡȷϣֻȽϲıߴı任
+	// ͼƬľβȽϣcanonical  index ֮ǰظ
+	static QVector<SliceDuplicate> findDuplicates(const QImage& image, const QVector<QRect>& rects);
+
+	// ========== ͸߲ü ==========
+	// ÿ alpha > alphaThreshold صСΧУȫ͸򳬳ͼƬʱΪվΣ
+	// ȴҵһв͸ֻʣұ߽磨SSE2 һж 4 أ
+	// ΰָ̳߳زм
+	static QVector<QRect> findTightBounds(const QImage& image, const QVector<QRect>& rects, int alphaThreshold = 0);
+};
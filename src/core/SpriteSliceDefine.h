@@ -1,7 +1,12 @@
 #pragma once
 #include <QUuid>
 #include <QPoint>
+#include <QRect>
+#include <QSize>
 #include <QPixmap>
+#include <QPainter>
+#include <QVector>
+#include <QMetaType>
 
 // ============== ײö ==============
 enum class CollisionType
@@ -11,6 +16,13 @@ enum class CollisionType
 	Trigger         // 
 };
 
+// ============== ֡ ==============
+struct SpriteSliceFrame
+{
+	QRect rect;							// ֡ھͼеƬͬߴ磩
+	int duration = 100;					// ʱ䣨룩
+};
+
 // ============== Ƭݽṹ ==============
 struct SpriteSlice
 {
@@ -20,16 +32,56 @@ struct SpriteSlice
 	int y = 0;							// Y ꣨QtϵϽԭ㣩
 	int width = 32;						// 
 	int height = 32;					// ߶
+	QPoint trimOffset;					// üԭʼеƫ
+	QSize sourceSize;					// üǰԭʼߴ磨Чʾδü
 	QString group = "Tiles";			// 
 	QString tags;						// ǩŷָ
 	bool isCollision = false;			// ǷײƬ
 	bool isDecorationOnly = false;		// Ƿװ
-	QPointF anchor = { 0.5, 0.5 };		// ê㣨һ 0~1
+	QPointF anchor = { 0.5, 0.5 };		// ê㣨һ 0~1ԭʼӣ
 	CollisionType collisionType = CollisionType::None;  // ײ
+	QVector<SpriteSliceFrame> frames;	// ֡һ֡Ƭ֡Ϊ̬Ƭ
+
+	// ǷΪƬ
+	bool isAnimated() const { return frames.size() > 1; }
+
+	// Ƿü͸
+	bool isTrimmed() const { return sourceSize.isValid(); }
+
+	// ԭʼӳߴ磨ͼռõĸӡê㶼ԭʼߴ㣩
+	int sourceWidth() const { return isTrimmed() ? sourceSize.width() : width; }
+	int sourceHeight() const { return isTrimmed() ? sourceSize.height() : height; }
+
+	// ԭʼھͼе򣨲üƬͼпƬصȡͼӦʹ cellPixmap
+	QRect sourceRect() const {
+		return QRect(x - trimOffset.x(), y - trimOffset.y(), sourceWidth(), sourceHeight());
+	}
+
+	// ͼȡ rectƬͬߴĶ֡أüƫƷŻԭʼӴС͸ͼ
+	QPixmap cellPixmap(const QPixmap& atlas, const QRect& rect) const {
+		if (!isTrimmed())
+			return atlas.copy(rect);
+
+		QPixmap cell(sourceWidth(), sourceHeight());
+		cell.fill(Qt::transparent);
+		QPainter painter(&cell);
+		painter.drawPixmap(trimOffset, atlas, rect);
+		return cell;
+	}
+	QPixmap cellPixmap(const QPixmap& atlas) const { return cellPixmap(atlas, QRect(x, y, width, height)); }
+
+	// һѭʱ룩
+	int animationLength() const {
+		int length = 0;
+		for (const SpriteSliceFrame& frame : frames)
+			length += qMax(1, frame.duration);
+		return length;
+	}
 
 	// ê
 	QPointF anchorPixelPos() const {
-		return QPointF(x + width * anchor.x(), y + height * anchor.y());
+		const QRect source = sourceRect();
+		return QPointF(source.x() + source.width() * anchor.x(), source.y() + source.height() * anchor.y());
 	}
 
 	// תΪϵ Y ֵ½Ϊԭ㣩
@@ -101,6 +153,15 @@ namespace SliceTableRole
 
 	// ͼ ID
 	constexpr int TilesetId = Base + 16;
+
+	// ֡ (QVector<SpriteSliceFrame>)
+	constexpr int Frames = Base + 17;
+
+	// üƫ (QPoint)
+	constexpr int TrimOffset = Base + 18;
+
+	// ԭʼߴ (QSizeЧʾδü)
+	constexpr int SourceSize = Base + 19;
 }
 
 // 
@@ -118,6 +179,16 @@ namespace SliceTableColumn
 	constexpr int Count = 8;      // 
 }
 
+Q_DECLARE_METATYPE(QVector<SpriteSliceFrame>)
+
+// ϲظƬضʹ fromId Ƭ toId transformTileTransformBits
+struct SliceRemap
+{
+	QUuid fromId;
+	QUuid toId;
+	quint8 transform = 0;
+};
+
 // ============== ͼݽṹ ==============
 struct SpriteSheetData
 {
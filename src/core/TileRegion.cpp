@@ -0,0 +1,254 @@
+#include "TileRegion.h"
+
+#include <QMimeData>
+#include <limits>
+
+namespace
+{
+	// ͷħ + 汾
+	constexpr char REGION_MAGIC[4] = { 'M', 'T', 'R', 'G' };
+	constexpr quint8 REGION_VERSION = 1;
+
+	// ļ/겻ܳ int Χؿ̣
+	constexpr quint32 MAX_INT_VALUE = static_cast<quint32>(std::numeric_limits<int>::max());
+
+	// ========== д ==========
+
+	void writeVarUInt(QByteArray& out, quint32 value)
+	{
+		while (value >= 0x80)
+		{
+			out.append(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		out.append(static_cast<char>(value));
+	}
+
+	void writeString(QByteArray& out, const QString& text)
+	{
+		const QByteArray utf8 = text.toUtf8();
+		writeVarUInt(out, static_cast<quint32>(utf8.size()));
+		out.append(utf8);
+	}
+
+	// ========== ȡԽ飩 ==========
+
+	struct Reader
+	{
+		const char* data = nullptr;
+		qsizetype size = 0;
+		qsizetype pos = 0;
+		bool ok = true;
+
+		quint8 readByte()
+		{
+			if (pos >= size)
+			{
+				ok = false;
+				return 0;
+			}
+			return static_cast<quint8>(data[pos++]);
+		}
+
+		quint32 readVarUInt()
+		{
+			quint32 value = 0;
+			for (int shift = 0; shift < 35; shift += 7)
+			{
+				const quint8 byte = readByte();
+				if (!ok)
+					return 0;
+				value |= static_cast<quint32>(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+					return value;
+			}
+			ok = false;
+			return 0;
+		}
+
+		QByteArray readBytes(qsizetype count)
+		{
+			if (count < 0 || pos + count > size)
+			{
+				ok = false;
+				return QByteArray();
+			}
+			QByteArray bytes(data + pos, count);
+			pos += count;
+			return bytes;
+		}
+
+		QString readString()
+		{
+			const quint32 length = readVarUInt();
+			return ok ? QString::fromUtf8(readBytes(length)) : QString();
+		}
+	};
+}
+
+int TileRegionData::replaceSlice(const QUuid& fromSliceId, const TileRegionSliceRef& to, quint8 transform)
+{
+	QVector<bool> matched(slices.size(), false);
+	bool any = false;
+	for (int i = 0; i < slices.size(); ++i)
+	{
+		if (slices[i].sliceId != fromSliceId)
+			continue;
+		slices[i] = to;
+		matched[i] = true;
+		any = true;
+	}
+	if (!any)
+		return 0;
+
+	int replaced = 0;
+	for (TileRegionCell& cell : cells)
+	{
+		if (!matched[cell.sliceRef])
+			continue;
+		if (transform != 0)
+			cell.transform = TileTransformBits::compose(transform, cell.transform);
+		++replaced;
+	}
+	return replaced;
+}
+
+QByteArray TileRegionCodec::encode(const TileRegionData& region)
+{
+	QByteArray out;
+	// ÿƬͨ 6~8 ֽڣԤռⷴ
+	out.reserve(64 + region.slices.size() * 48 + region.cells.size() * 8);
+
+	out.append(REGION_MAGIC, sizeof(REGION_MAGIC));
+	out.append(static_cast<char>(REGION_VERSION));
+	writeVarUInt(out, static_cast<quint32>(region.width));
+	writeVarUInt(out, static_cast<quint32>(region.height));
+
+	// Ƭ
+	writeVarUInt(out, static_cast<quint32>(region.slices.size()));
+	for (const TileRegionSliceRef& ref : region.slices)
+	{
+		writeString(out, ref.tilesetId);
+		out.append(ref.sliceId.toRfc4122());
+	}
+
+	// Ա
+	writeVarUInt(out, static_cast<quint32>(region.attributes.size()));
+	for (const TileRegionAttributes& attr : region.attributes)
+	{
+		writeString(out, attr.displayName);
+		writeString(out, attr.tags);
+		out.append(static_cast<char>(attr.collisionType));
+	}
+
+	// Ƭ
+	writeVarUInt(out, static_cast<quint32>(region.cells.size()));
+	for (const TileRegionCell& cell : region.cells)
+	{
+		writeVarUInt(out, static_cast<quint32>(cell.x));
+		writeVarUInt(out, static_cast<quint32>(cell.y));
+		writeVarUInt(out, static_cast<quint32>(cell.layer));
+		out.append(static_cast<char>(cell.transform));
+		writeVarUInt(out, static_cast<quint32>(cell.sliceRef));
+		writeVarUInt(out, static_cast<quint32>(cell.attributeRef + 1));  // 0 ʾ
+	}
+
+	return out;
+}
+
+bool TileRegionCodec::decode(const QByteArray& bytes, TileRegionData& outRegion)
+{
+	Reader reader{ bytes.constData(), bytes.size() };
+
+	if (reader.readBytes(sizeof(REGION_MAGIC)) != QByteArray(REGION_MAGIC, sizeof(REGION_MAGIC)))
+		return false;
+	if (reader.readByte() != REGION_VERSION)
+		return false;
+
+	TileRegionData region;
+	const quint32 width = reader.readVarUInt();
+	const quint32 height = reader.readVarUInt();
+	if (!reader.ok || width > MAX_INT_VALUE || height > MAX_INT_VALUE)
+		return false;
+	region.width = static_cast<int>(width);
+	region.height = static_cast<int>(height);
+
+	const quint32 sliceCount = reader.readVarUInt();
+	if (!reader.ok || sliceCount > static_cast<quint32>(bytes.size()))
+		return false;
+	region.slices.reserve(sliceCount);
+	for (quint32 i = 0; i < sliceCount && reader.ok; ++i)
+	{
+		TileRegionSliceRef ref;
+		ref.tilesetId = reader.readString();
+		ref.sliceId = QUuid::fromRfc4122(reader.readBytes(16));
+		region.slices.append(ref);
+	}
+
+	const quint32 attributeCount = reader.readVarUInt();
+	if (!reader.ok || attributeCount > static_cast<quint32>(bytes.size()))
+		return false;
+	region.attributes.reserve(attributeCount);
+	for (quint32 i = 0; i < attributeCount && reader.ok; ++i)
+	{
+		TileRegionAttributes attr;
+		attr.displayName = reader.readString();
+		attr.tags = reader.readString();
+		const quint8 collisionType = reader.readByte();
+		if (collisionType > static_cast<quint8>(CollisionType::Trigger))
+			return false;
+		attr.collisionType = static_cast<CollisionType>(collisionType);
+		region.attributes.append(attr);
+	}
+
+	const quint32 cellCount = reader.readVarUInt();
+	if (!reader.ok || cellCount > static_cast<quint32>(bytes.size()))
+		return false;
+	region.cells.resize(cellCount);
+	for (quint32 i = 0; i < cellCount && reader.ok; ++i)
+	{
+		const quint32 x = reader.readVarUInt();
+		const quint32 y = reader.readVarUInt();
+		const quint32 layer = reader.readVarUInt();
+		const quint8 transform = reader.readByte();
+		const quint32 sliceRef = reader.readVarUInt();
+		const quint32 attributeRef = reader.readVarUInt();   // 0 ʾ
+		if (!reader.ok)
+			return false;
+
+		// Ȱ޷ԭֵתڣòԽ
+		if (x >= width || y >= height || layer > MAX_INT_VALUE
+			|| sliceRef >= static_cast<quint32>(region.slices.size())
+			|| attributeRef > static_cast<quint32>(region.attributes.size()))
+			return false;
+
+		TileRegionCell& cell = region.cells[i];
+		cell.x = static_cast<int>(x);
+		cell.y = static_cast<int>(y);
+		cell.layer = static_cast<int>(layer);
+		cell.transform = transform;
+		cell.sliceRef = static_cast<int>(sliceRef);
+		cell.attributeRef = static_cast<int>(attributeRef) - 1;
+	}
+
+	if (!reader.ok)
+		return false;
+
+	outRegion = std::move(region);
+	return true;
+}
+
+QMimeData* TileRegionCodec::toMimeData(const TileRegionData& region)
+{
+	auto* mimeData = new QMimeData;
+	mimeData->setData(TILE_REGION_MIME_TYPE, encode(region));
+	return mimeData;
+}
+
+bool TileRegionCodec::fromMimeData(const QMimeData* mimeData, TileRegionData& outRegion)
+{
+	if (!mimeData || !mimeData->hasFormat(TILE_REGION_MIME_TYPE))
+		return false;
+
+	return decode(mimeData->data(TILE_REGION_MIME_TYPE), outRegion);
+}
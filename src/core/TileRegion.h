@@ -0,0 +1,140 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QUuid>
+#include <QVector>
+#include "SpriteSliceDefine.h"
+
+class QMimeData;
+
+// /ճ MIME ͣնƸأЯݣ
+inline const char* TILE_REGION_MIME_TYPE = "application/x-maptile-region";
+
+// ============== 任λ ==============
+namespace TileTransformBits
+{
+	constexpr quint8 FlipX = 0x01;
+	constexpr quint8 FlipY = 0x02;
+	constexpr quint8 RotationShift = 2;      // bit 2-3תǶ / 90
+	constexpr quint8 RotationMask = 0x0C;
+
+	inline quint8 pack(bool flipX, bool flipY, int rotation)
+	{
+		quint8 bits = 0;
+		if (flipX) bits |= FlipX;
+		if (flipY) bits |= FlipY;
+		bits |= static_cast<quint8>((((rotation % 360 + 360) % 360) / 90) << RotationShift) & RotationMask;
+		return bits;
+	}
+
+	inline bool flipX(quint8 bits) { return bits & FlipX; }
+	inline bool flipY(quint8 bits) { return bits & FlipY; }
+	inline int rotation(quint8 bits) { return ((bits & RotationMask) >> RotationShift) * 90; }
+
+	// 任 p' = p * MƬ QTransform  scale  rotate һ£תת
+	struct Matrix
+	{
+		int m11 = 1, m12 = 0, m21 = 0, m22 = 1;
+
+		bool operator==(const Matrix& other) const {
+			return m11 == other.m11 && m12 == other.m12 && m21 == other.m21 && m22 == other.m22;
+		}
+	};
+
+	inline Matrix matrix(quint8 bits)
+	{
+		static constexpr int cosTable[4] = { 1, 0, -1, 0 };
+		static constexpr int sinTable[4] = { 0, 1, 0, -1 };
+		const int step = (bits & RotationMask) >> RotationShift;
+		const int c = cosTable[step];
+		const int s = sinTable[step];
+		const int sx = (bits & FlipX) ? -1 : 1;
+		const int sy = (bits & FlipY) ? -1 : 1;
+		return { c * sx, s * sy, -s * sx, c * sy };
+	}
+
+	// Ӧ first Ӧ second ĵЧ任 FlipYֱתȼˮƽת + ת 180
+	inline quint8 compose(quint8 first, quint8 second)
+	{
+		const Matrix a = matrix(first);
+		const Matrix b = matrix(second);
+		const Matrix product{
+			a.m11 * b.m11 + a.m12 * b.m21, a.m11 * b.m12 + a.m12 * b.m22,
+			a.m21 * b.m11 + a.m22 * b.m21, a.m21 * b.m12 + a.m22 * b.m22 };
+
+		for (int degrees = 0; degrees < 360; degrees += 90)
+		{
+			for (bool flip : { false, true })
+			{
+				const quint8 bits = pack(flip, false, degrees);
+				if (matrix(bits) == product)
+					return bits;
+			}
+		}
+		return 0;
+	}
+}
+
+// õƬͼ ID + Ƭ UUID
+struct TileRegionSliceRef
+{
+	QString tilesetId;
+	QUuid sliceId;
+
+	bool operator==(const TileRegionSliceRef& other) const {
+		return sliceId == other.sliceId && tilesetId == other.tilesetId;
+	}
+};
+
+// ƬĬֵͬƬԣԱƬɹͬһ
+struct TileRegionAttributes
+{
+	QString displayName;
+	QString tags;
+	CollisionType collisionType = CollisionType::None;
+
+	bool operator==(const TileRegionAttributes& other) const {
+		return collisionType == other.collisionType
+			&& displayName == other.displayName
+			&& tags == other.tags;
+	}
+};
+
+// еĵƬ
+struct TileRegionCell
+{
+	int x = 0;                  // Ͻǵĸ
+	int y = 0;
+	int layer = 0;
+	quint8 transform = 0;       // TileTransformBits
+	int sliceRef = 0;           // Ƭ
+	int attributeRef = -1;      // Ա-1 ʾƬĬֵ
+};
+
+// ݣͼ㣩
+struct TileRegionData
+{
+	int width = 0;              // ߴ磨ӣ
+	int height = 0;
+	QVector<TileRegionSliceRef> slices;
+	QVector<TileRegionAttributes> attributes;
+	QVector<TileRegionCell> cells;
+
+	bool isEmpty() const { return cells.isEmpty(); }
+
+	//  fromSliceId ƬΪ totransform ԭб任֮ǰظдƬ
+	int replaceSlice(const QUuid& fromSliceId, const TileRegionSliceRef& to, quint8 transform);
+};
+
+// ==============  ==============
+class TileRegionCodec
+{
+public:
+	static QByteArray encode(const TileRegionData& region);
+	static bool decode(const QByteArray& bytes, TileRegionData& outRegion);
+
+	// 帨
+	static QMimeData* toMimeData(const TileRegionData& region);
+	static bool fromMimeData(const QMimeData* mimeData, TileRegionData& outRegion);
+};
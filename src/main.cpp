@@ -7,6 +7,7 @@ int main(int argc, char* argv[])
 	QApplication app(argc, argv);
 
 	AppContext ctx;
+	ctx.loadSettings();
 
 	// ʱû qss ļпע͵
 	ctx.loadStyle(":/mac_light.qss");
@@ -32,11 +32,7 @@ void InspectorPanel::initComboBoxes()
 	ui.comboTileset->clear();
 
 	// 图层下拉框
-	ui.comboLayer->clear();
-	ui.comboLayer->addItem(QStringLiteral("图层 0 (背景)"), 0);
-	ui.comboLayer->addItem(QStringLiteral("图层 1 (地面)"), 1);
-	ui.comboLayer->addItem(QStringLiteral("图层 2 (装饰)"), 2);
-	ui.comboLayer->addItem(QStringLiteral("图层 3 (前景)"), 3);
+	setLayers(MapDocument::defaultLayers());
 
 	// 碰撞类型下拉框 - 只保留 None、Ground、Trigger
 	ui.comboCollision->clear();
@@ -45,6 +41,23 @@ void InspectorPanel::initComboBoxes()
 	ui.comboCollision->addItem(QStringLiteral("触发器 (Trigger)"), static_cast<int>(CollisionType::Trigger));
 }
 
+void InspectorPanel::setLayers(const QVector<MapLayerInfo>& layers)
+{
+	// 与主窗口的图层下拉框一致：按叠放顺序从下到上
+	m_updating = true;
+	ui.comboLayer->clear();
+	for (const MapLayerInfo& layer : layers)
+		ui.comboLayer->addItem(layer.name, layer.id);
+
+	if (m_currentTile)
+	{
+		const int index = ui.comboLayer->findData(m_currentTile->layer());
+		if (index >= 0)
+			ui.comboLayer->setCurrentIndex(index);
+	}
+	m_updating = false;
+}
+
 void InspectorPanel::setupConnections()
 {
 	// 位置变化
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/SpriteSliceDefine.h"
+#include "core/MapDocument.h"
 
 #include <QWidget>
 #include "ui_InspectorPanel.h"
@@ -23,6 +24,9 @@ public:
 	// Ƿñ༭
 	void setEditEnabled(bool enabled);
 
+	// ͼͼɾã
+	void setLayers(const QVector<MapLayerInfo>& layers);
+
 signals:
 	// Ա仯źţͬ MapTileItem
 	void positionChanged(int x, int y);
@@ -4,6 +4,9 @@
 #include "MapTileItem.h"
 #include "TitleBarWidget.h"
 #include "InspectorPanel.h"
+#include "SliceReplaceDialog.h"
+#include "MapResizeDialog.h"
+#include "MinimapWidget.h"
 
 #include "app/AppContext.h"
 #include "app/DocumentManager.h"
@@ -20,6 +23,9 @@
 #include <QGraphicsDropShadowEffect>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QInputDialog>
+#include <QLineEdit>
+#include <QMenu>
 
 MainWindow::MainWindow(AppContext* ctx, QWidget* parent)
 	: QMainWindow(parent)
@@ -46,13 +52,14 @@ MainWindow::MainWindow(AppContext* ctx, QWidget* parent)
 void MainWindow::SetupUi()
 {
 	ui->mapViewWidget->SetContext(m_ctx);
+	ui->mapViewWidget->setLodThresholds(m_ctx->lodMipBelow, m_ctx->lodColorBelow);
+	ui->TilesetsPanelWidget->setThumbnailService(&m_ctx->thumbnailService);
+	ui->spriteSliceEditorWidget->setThumbnailService(&m_ctx->thumbnailService);
+	ui->minimapWidget->setMapView(ui->mapViewWidget);
 
-	// ʼͼ
-	ui->comboBoxLayer->clear();
-	ui->comboBoxLayer->addItem(QStringLiteral("ͼ 0 ()"), 0);
-	ui->comboBoxLayer->addItem(QStringLiteral("ͼ 1 ()"), 1);
-	ui->comboBoxLayer->addItem(QStringLiteral("ͼ 2 (װ)"), 2);
-	ui->comboBoxLayer->addItem(QStringLiteral("ͼ 3 (ǰ)"), 3);
+	// ʼͼҼͼ㣩
+	ui->comboBoxLayer->setContextMenuPolicy(Qt::CustomContextMenu);
+	onLayersChanged();
 
 	// Ĭʾդ
 	ui->checkBoxGrid->setChecked(true);
@@ -75,14 +82,136 @@ void MainWindow::SetupConnections()
 		OnNewMap();
 		});
 
+	// ½޵ͼ Ctrl+Shift+N
+	auto newInfiniteShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_N), this);
+	QObject::connect(newInfiniteShortcut, &QShortcut::activated, this, &MainWindow::OnNewInfiniteMap);
+
 	// ݼ Ctrl+E
 	auto exportShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_E), this);
 	QObject::connect(exportShortcut, &QShortcut::activated, this, &MainWindow::onExportMap);
 
+	// /滻Ƭ Ctrl+H
+	auto replaceShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_H), this);
+	QObject::connect(replaceShortcut, &QShortcut::activated, this, &MainWindow::onFindReplaceSlice);
+
+	// ײԤ Ctrl+Shift+C
+	auto collisionShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_C), this);
+	QObject::connect(collisionShortcut, &QShortcut::activated, this, [this]() {
+		const bool visible = !ui->mapViewWidget->isCollisionOverlayVisible();
+		ui->mapViewWidget->setCollisionOverlayVisible(visible);
+		ui->label->setText(visible ? QStringLiteral("ײԤ: ") : QStringLiteral("ײԤ: "));
+		});
+	QObject::connect(ui->mapViewWidget, &MapViewWidget::collisionBaked, this, [this](int rectCount) {
+		ui->label->setText(QStringLiteral("ײ: %1").arg(rectCount));
+		});
+
+	// Ѱ·ԤAlt + /Ҽ/յ㣬Ctrl+Shift+G 
+	auto navClearShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_G), this);
+	QObject::connect(navClearShortcut, &QShortcut::activated, this, [this]() {
+		ui->mapViewWidget->clearNavigationPreview();
+		ui->label->setText(QStringLiteral("Ѱ·Ԥ"));
+		});
+	QObject::connect(ui->mapViewWidget, &MapViewWidget::navigationPathFound, this,
+		[this](bool found, double cost, int exploredCount, double elapsedMs) {
+			ui->label->setText(found
+				? QStringLiteral("·: %1  : %2  ʱ: %3 ms").arg(cost, 0, 'f', 1).arg(exploredCount).arg(elapsedMs, 0, 'f', 2)
+				: QStringLiteral("޷  : %1  ʱ: %2 ms").arg(exploredCount).arg(elapsedMs, 0, 'f', 2));
+		});
+
+	// طȾ Ctrl+Shift+Aĵ棩
+	auto pixelArtShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_A), this);
+	QObject::connect(pixelArtShortcut, &QShortcut::activated, this, [this]() {
+		const bool pixelArt = ui->mapViewWidget->renderProfile() != MapRenderProfile::PixelArt;
+		ui->mapViewWidget->setRenderProfile(pixelArt ? MapRenderProfile::PixelArt : MapRenderProfile::Smooth);
+		ui->label->setText(pixelArt ? QStringLiteral("طȾ: ") : QStringLiteral("طȾ: "));
+		});
+
+	// ǰͼ״̬Ctrl+Shift+V ʾ/أCtrl+Shift+L /Ctrl+Shift+O л͸
+	auto layerVisibleShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_V), this);
+	QObject::connect(layerVisibleShortcut, &QShortcut::activated, this, [this]() {
+		const int layer = ui->mapViewWidget->currentLayer();
+		const bool visible = !ui->mapViewWidget->layerState(layer).visible;
+		ui->mapViewWidget->setLayerVisible(layer, visible);
+		ui->label->setText(QStringLiteral("ͼ %1: %2").arg(layer).arg(visible ? QStringLiteral("ʾ") : QStringLiteral("")));
+		});
+	auto layerLockShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_L), this);
+	QObject::connect(layerLockShortcut, &QShortcut::activated, this, [this]() {
+		const int layer = ui->mapViewWidget->currentLayer();
+		const bool locked = !ui->mapViewWidget->isLayerLocked(layer);
+		ui->mapViewWidget->setLayerLocked(layer, locked);
+		ui->label->setText(QStringLiteral("ͼ %1: %2").arg(layer).arg(locked ? QStringLiteral("") : QStringLiteral("")));
+		});
+	auto layerOpacityShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_O), this);
+	QObject::connect(layerOpacityShortcut, &QShortcut::activated, this, [this]() {
+		// 100% -> 75% -> 50% -> 25% -> 100%
+		const int layer = ui->mapViewWidget->currentLayer();
+		const double current = ui->mapViewWidget->layerState(layer).opacity;
+		const double next = current > 0.3 ? qRound((current - 0.25) * 4) / 4.0 : 1.0;
+		ui->mapViewWidget->setLayerOpacity(layer, next);
+		ui->label->setText(QStringLiteral("ͼ %1 ͸: %2%").arg(layer).arg(qRound(next * 100)));
+		});
+
+	// Сͼϸڲ㼶 Ctrl+Shift+Dڸ//ֵл浽ûã
+	auto lodShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_D), this);
+	QObject::connect(lodShortcut, &QShortcut::activated, this, [this]() {
+		struct LodPreset { double mipBelow; double colorBelow; QString name; };
+		static const QVector<LodPreset> presets = {
+			{ 0.15, 0.08, QStringLiteral("") },
+			{ 0.3, 0.15, QStringLiteral("") },
+			{ 0.5, 0.25, QStringLiteral("") },
+		};
+		const int count = presets.size();
+
+		// ǰֵԤʱӵһʼ
+		int next = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			if (qFuzzyCompare(presets[i].mipBelow, m_ctx->lodMipBelow))
+				next = (i + 1) % count;
+		}
+
+		m_ctx->lodMipBelow = presets[next].mipBelow;
+		m_ctx->lodColorBelow = presets[next].colorBelow;
+		m_ctx->saveSettings();
+		ui->mapViewWidget->setLodThresholds(m_ctx->lodMipBelow, m_ctx->lodColorBelow);
+		ui->label->setText(QStringLiteral("Сͼϸ: %1 %2% Сͼ")
+			.arg(presets[next].name).arg(qRound(m_ctx->lodMipBelow * 100)));
+		});
+
+	// ͼ̻ Ctrl+Shift+T浽ûã
+	auto thumbnailCacheShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_T), this);
+	QObject::connect(thumbnailCacheShortcut, &QShortcut::activated, this, [this]() {
+		const bool enabled = !m_ctx->thumbnailService.isDiskCacheEnabled();
+		m_ctx->thumbnailService.setDiskCacheEnabled(enabled);
+		m_ctx->saveSettings();
+		ui->label->setText(enabled
+			? QStringLiteral("ͼ̻:  %1 MB").arg(m_ctx->thumbnailService.diskCacheLimit() / (1024 * 1024))
+			: QStringLiteral("ͼ̻: "));
+		});
+
+	// ͼߴ Ctrl+Shift+R
+	auto resizeShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_R), this);
+	QObject::connect(resizeShortcut, &QShortcut::activated, this, &MainWindow::onResizeMap);
+
+	// Ԥ壺Ctrl+Shift+P ѡCtrl+Shift+I ãCtrl+Shift+U ѡ
+	auto createPrefabShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_P), this);
+	QObject::connect(createPrefabShortcut, &QShortcut::activated, this, &MainWindow::onCreatePrefab);
+	auto placePrefabShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_I), this);
+	QObject::connect(placePrefabShortcut, &QShortcut::activated, this, &MainWindow::onPlacePrefab);
+	auto updatePrefabShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_U), this);
+	QObject::connect(updatePrefabShortcut, &QShortcut::activated, this, &MainWindow::onUpdatePrefab);
+
 	connect(ui->TilesetsPanelWidget, &TilesetsPanel::addTilesetRequested, this, &MainWindow::SlotSwitchSpriteSliceWidget);
 	connect(ui->spriteSliceEditorWidget, &SpriteSliceEditorWidget::SignalReturnToMainPanel, this, &MainWindow::SlotSwitchMainWidget);
 	connect(ui->spriteSliceEditorWidget, &SpriteSliceEditorWidget::SignalSpriteSheetConfirmed, ui->TilesetsPanelWidget, &TilesetsPanel::onSpriteSheetConfirmed);
 
+	// ͼϲظƬͼϵƬѻķֿԤ壩ñƬ
+	connect(ui->spriteSliceEditorWidget, &SpriteSliceEditorWidget::SignalSlicesRemapped, this,
+		[this](const QString& tilesetId, const QVector<SliceRemap>& remaps) {
+			const int remapped = ui->mapViewWidget->remapSlices(tilesetId, remaps);
+			qDebug() << "Remapped" << remapped << "tiles after merging" << remaps.size() << "duplicate slices";
+		});
+
 	//  MapView 
 	SetupMapViewConnections();
 
@@ -103,6 +232,16 @@ void MainWindow::SetupTitleBarConnections()
 
 void MainWindow::SetupMapViewConnections()
 {
+	// ճʱͨͼƬ
+	ui->mapViewWidget->setSliceResolver([this](const QString& tilesetId, const QUuid& sliceId,
+		SpriteSlice& outSlice, QPixmap& outPixmap) {
+			return ui->TilesetsPanelWidget->findSliceById(tilesetId, sliceId, outSlice, outPixmap);
+		});
+	ui->mapViewWidget->setFrameResolver([this](const QString& tilesetId, const QUuid& sliceId,
+		QVector<QPixmap>& outFrames) {
+			return ui->TilesetsPanelWidget->findSliceFrames(tilesetId, sliceId, outFrames);
+		});
+
 	// ========== UI ؼ -> MapViewWidget ==========
 
 	// դʾ
@@ -119,8 +258,10 @@ void MainWindow::SetupMapViewConnections()
 	// Ż
 	connect(ui->zoomSlider, &QSlider::valueChanged, this, &MainWindow::onZoomSliderChanged);
 
-	// ͼѡ
+	// ͼѡ
 	connect(ui->comboBoxLayer, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onLayerChanged);
+	connect(ui->comboBoxLayer, &QWidget::customContextMenuRequested, this, &MainWindow::onLayerContextMenu);
+	connect(ui->mapViewWidget, &MapViewWidget::layersChanged, this, &MainWindow::onLayersChanged);
 
 	// ========== MapViewWidget -> UI ؼ ==========
 	connect(ui->mapViewWidget, &MapViewWidget::zoomChanged, this, [this](int percent) {
@@ -133,6 +274,16 @@ void MainWindow::SetupMapViewConnections()
 	// Ƭѡź
 	connect(ui->mapViewWidget, &MapViewWidget::tileSelected, this, &MainWindow::onTileSelected);
 	connect(ui->mapViewWidget, &MapViewWidget::tileDeselected, this, &MainWindow::onTileDeselected);
+
+	// Ƭʹô -> ͼ
+	connect(ui->mapViewWidget, &MapViewWidget::sliceUsageChanged, ui->TilesetsPanelWidget, &TilesetsPanel::applySliceUsageDelta);
+
+	// ѡź
+	connect(ui->mapViewWidget, &MapViewWidget::regionSelectionChanged, this, [this](const QRect& region) {
+		if (!region.isEmpty())
+			ui->label->setText(QStringLiteral("ѡ: (%1, %2) %3x%4")
+				.arg(region.x()).arg(region.y()).arg(region.width()).arg(region.height()));
+		});
 }
 
 void MainWindow::SetupInspectorConnections()
@@ -217,6 +368,104 @@ void MainWindow::onLayerChanged(int index)
 	ui->mapViewWidget->setCurrentLayer(layer);
 }
 
+void MainWindow::onLayersChanged()
+{
+	const QVector<MapLayerInfo>& layers = ui->mapViewWidget->layers();
+
+	// ˳µϣֵǰͼѡ
+	ui->comboBoxLayer->blockSignals(true);
+	ui->comboBoxLayer->clear();
+	for (const MapLayerInfo& layer : layers)
+		ui->comboBoxLayer->addItem(layer.name, layer.id);
+	ui->comboBoxLayer->setCurrentIndex(ui->comboBoxLayer->findData(ui->mapViewWidget->currentLayer()));
+	ui->comboBoxLayer->blockSignals(false);
+
+	ui->inspectorPanel->setLayers(layers);
+}
+
+void MainWindow::onLayerContextMenu(const QPoint& pos)
+{
+	MapViewWidget* mapView = ui->mapViewWidget;
+	const int layer = mapView->currentLayer();
+	const int index = mapView->layerOrder(layer);
+	const int count = mapView->layers().size();
+	if (index < 0)
+		return;
+
+	const QString name = mapView->layers()[index].name;
+
+	QMenu menu(this);
+	QAction* addAction = menu.addAction(QStringLiteral("½ͼ"));
+	QAction* duplicateAction = menu.addAction(QStringLiteral("ͼ"));
+	QAction* renameAction = menu.addAction(QStringLiteral(""));
+	menu.addSeparator();
+	QAction* upAction = menu.addAction(QStringLiteral(""));
+	QAction* downAction = menu.addAction(QStringLiteral(""));
+	QAction* mergeAction = menu.addAction(QStringLiteral("ºϲ"));
+	menu.addSeparator();
+	QAction* removeAction = menu.addAction(QStringLiteral("ɾͼ"));
+
+	upAction->setEnabled(index < count - 1);
+	downAction->setEnabled(index > 0);
+	mergeAction->setEnabled(index > 0);
+	removeAction->setEnabled(count > 1);
+
+	QAction* chosen = menu.exec(ui->comboBoxLayer->mapToGlobal(pos));
+	if (!chosen)
+		return;
+
+	if (chosen == addAction)
+	{
+		bool ok = false;
+		const QString newName = QInputDialog::getText(this, QStringLiteral("½ͼ"), QStringLiteral("ͼ:"),
+			QLineEdit::Normal, QStringLiteral("ͼ %1").arg(count + 1), &ok).trimmed();
+		if (!ok || newName.isEmpty())
+			return;
+
+		// ͼڵǰͼ֮ϲлȥ
+		const int newLayer = mapView->addLayer(newName, index + 1);
+		ui->comboBoxLayer->setCurrentIndex(ui->comboBoxLayer->findData(newLayer));
+		ui->label->setText(QStringLiteral("½ͼ: %1").arg(newName));
+	}
+	else if (chosen == duplicateAction)
+	{
+		const int newLayer = mapView->duplicateLayer(layer);
+		ui->comboBoxLayer->setCurrentIndex(ui->comboBoxLayer->findData(newLayer));
+		ui->label->setText(QStringLiteral("Ѹͼ: %1").arg(name));
+	}
+	else if (chosen == renameAction)
+	{
+		bool ok = false;
+		const QString newName = QInputDialog::getText(this, QStringLiteral("ͼ"), QStringLiteral("ͼ:"),
+			QLineEdit::Normal, name, &ok);
+		if (ok && mapView->renameLayer(layer, newName))
+			ui->label->setText(QStringLiteral("ͼ: %1").arg(newName.trimmed()));
+	}
+	else if (chosen == upAction || chosen == downAction)
+	{
+		mapView->moveLayer(layer, chosen == upAction ? index + 1 : index - 1);
+	}
+	else if (chosen == mergeAction)
+	{
+		const MapLayerInfo below = mapView->layers()[index - 1];
+		if (mapView->mergeLayer(layer, below.id))
+			ui->label->setText(QStringLiteral("Ѻϲͼ: %1").arg(below.name));
+		else
+			ui->label->setText(QStringLiteral("ϲʧ: ͼ"));
+	}
+	else if (chosen == removeAction)
+	{
+		const int tileCount = mapView->layerTileCount(layer);
+		if (tileCount > 0 && QMessageBox::question(this, QStringLiteral("ɾͼ"),
+			QStringLiteral("ͼ㡰%1 %2 Ƭȷɾ").arg(name).arg(tileCount),
+			QMessageBox::Yes | QMessageBox::No) != QMessageBox::Yes)
+			return;
+
+		if (mapView->removeLayer(layer))
+			ui->label->setText(QStringLiteral("ɾͼ: %1").arg(name));
+	}
+}
+
 // ========== Ƭѡ ==========
 
 void MainWindow::onTileSelected(MapTileItem* tile)
@@ -258,12 +507,8 @@ void MainWindow::onInspectorPositionChanged(int x, int y)
 		return;
 	}
 
-	// Ƭλ
-	tile->setGridPos(x, y);
-
-	int tileWidth = ui->mapViewWidget->tileWidth();
-	int tileHeight = ui->mapViewWidget->tileHeight();
-	tile->setPos(x * tileWidth, y * tileHeight);
+	// Ƭλãͬ
+	ui->mapViewWidget->moveTile(tile, x, y);
 
 	ui->label->setText(QString("ƶ: (%1, %2)").arg(x).arg(y));
 }
@@ -274,9 +519,8 @@ void MainWindow::onInspectorLayerChanged(int layer)
 	if (!tile)
 		return;
 
-	// Ƭͼ
-	tile->setLayer(layer);
-	tile->setZValue(10 + layer);
+	// Ƭͼ㣨ͬ
+	ui->mapViewWidget->setTileLayer(tile, layer);
 
 	// ͼ仯ҪȡѡУΪǰͼܲƥˣ
 	int currentLayer = ui->mapViewWidget->currentLayer();
@@ -305,7 +549,8 @@ void MainWindow::onInspectorCollisionTypeChanged(CollisionType type)
 	if (!tile)
 		return;
 
-	tile->setCollisionType(type);
+	// ɵͼͼ޸ģײԤ֮
+	ui->mapViewWidget->setTileCollisionType(tile, type);
 
 	QString typeName;
 	switch (type)
@@ -343,9 +588,13 @@ void MainWindow::onExportMap()
 		return;
 	}
 
-	// ȡƬ
-	const auto& tiles = ui->mapViewWidget->placedTiles();
-	if (tiles.isEmpty())
+	// ȡͼƬԤʵڴչ
+	const QVector<MapExportLayer> layers = ui->mapViewWidget->exportLayers();
+	int tileCount = 0;
+	for (const MapExportLayer& layer : layers)
+		tileCount += layer.tiles.size();
+
+	if (tileCount == 0)
 	{
 		QMessageBox::StandardButton reply = QMessageBox::question(
 			this,
@@ -389,7 +638,7 @@ void MainWindow::onExportMap()
 	bool success = MapExporter::exportToJson(
 		filePath,
 		doc,
-		tiles,
+		layers,
 		tilesets,  // ͼ
 		ui->mapViewWidget->tileWidth(),
 		ui->mapViewWidget->tileHeight(),
@@ -404,7 +653,7 @@ void MainWindow::onExportMap()
 			QStringLiteral("ɹ"),
 			QStringLiteral("ͼѳɹ:\n%1\n\n %2 Ƭ%3 ͼ")
 			.arg(filePath)
-			.arg(tiles.size())
+			.arg(tileCount)
 			.arg(tilesets.size())
 		);
 	}
@@ -419,6 +668,135 @@ void MainWindow::onExportMap()
 	}
 }
 
+void MainWindow::onFindReplaceSlice()
+{
+	SliceReplaceDialog dialog(ui->mapViewWidget, ui->TilesetsPanelWidget->getAllTilesetData(),
+		ui->mapViewWidget->layers(), this);
+	dialog.exec();
+}
+
+void MainWindow::onResizeMap()
+{
+	MapResizeDialog dialog(ui->mapViewWidget->mapWidth(), ui->mapViewWidget->mapHeight(), this);
+	if (dialog.exec() != QDialog::Accepted)
+		return;
+
+	ui->mapViewWidget->resizeMap(dialog.mapWidth(), dialog.mapHeight(),
+		dialog.anchor(), dialog.dropOutOfBounds());
+
+	// ͬײߴ
+	InitMapViewUI();
+	ui->label->setText(QStringLiteral("ͼߴ: %1 x %2").arg(dialog.mapWidth()).arg(dialog.mapHeight()));
+}
+
+void MainWindow::onCreatePrefab()
+{
+	const QRect region = ui->mapViewWidget->selectedRegion();
+	if (region.isEmpty())
+	{
+		ui->label->setText(QStringLiteral("Ȱס Ctrl ѡ"));
+		return;
+	}
+
+	// ͼڵͼϣԤ
+	if (ui->mapViewWidget->copyRegion(region, nullptr, nullptr, true).isEmpty())
+	{
+		ui->label->setText(QStringLiteral("ѡûпõƬͼ⣩"));
+		return;
+	}
+
+	bool ok = false;
+	const QString defaultName = QStringLiteral("Prefab %1").arg(m_ctx->prefabLibrary.prefabs().size() + 1);
+	const QString name = QInputDialog::getText(this, QStringLiteral("Ԥ"),
+		QStringLiteral(":"), QLineEdit::Normal, defaultName, &ok);
+	if (!ok || name.trimmed().isEmpty())
+		return;
+
+	// ԻڼֿܱȷϺ¸ƣֻɾʵʸ˵Ƭ滻ΪԤʵ
+	QVector<MapTileItem*> tiles;
+	QVector<QUuid> instances;
+	const TileRegionData content = ui->mapViewWidget->copyRegion(region, &tiles, &instances, true);
+	if (content.isEmpty())
+	{
+		ui->label->setText(QStringLiteral("ѡûпõƬͼ⣩"));
+		return;
+	}
+
+	const QUuid prefabId = m_ctx->prefabLibrary.addPrefab(name.trimmed(), content);
+	ui->mapViewWidget->deleteCopied(tiles, instances);
+	ui->mapViewWidget->placePrefab(prefabId, region.topLeft());
+	ui->mapViewWidget->clearRegionSelection();
+
+	ui->label->setText(QStringLiteral("ѴԤ: %1").arg(name.trimmed()));
+}
+
+void MainWindow::onPlacePrefab()
+{
+	const QVector<PrefabDefinition> prefabs = m_ctx->prefabLibrary.prefabs();
+	if (prefabs.isEmpty())
+	{
+		ui->label->setText(QStringLiteral("ûпõԤ"));
+		return;
+	}
+
+	// ȼ¼λãԻ򵯳λû仯
+	const QPoint anchor = ui->mapViewWidget->pasteAnchor();
+
+	QStringList names;
+	for (const PrefabDefinition& prefab : prefabs)
+		names.append(prefab.name);
+
+	bool ok = false;
+	const QString name = QInputDialog::getItem(this, QStringLiteral("Ԥ"),
+		QStringLiteral("Ԥ:"), names, 0, false, &ok);
+	if (!ok)
+		return;
+
+	const int index = names.indexOf(name);
+	if (ui->mapViewWidget->placePrefab(prefabs[index].id, anchor).isNull())
+		ui->label->setText(QStringLiteral("޷: ͼΧ"));
+}
+
+void MainWindow::onUpdatePrefab()
+{
+	const QRect region = ui->mapViewWidget->selectedRegion();
+	const QVector<PrefabDefinition> prefabs = m_ctx->prefabLibrary.prefabs();
+	if (region.isEmpty() || prefabs.isEmpty())
+	{
+		ui->label->setText(QStringLiteral("ȿѡȷԤ"));
+		return;
+	}
+
+	QStringList names;
+	for (const PrefabDefinition& prefab : prefabs)
+		names.append(prefab.name);
+
+	bool ok = false;
+	const QString name = QInputDialog::getItem(this, QStringLiteral("Ԥ"),
+		QStringLiteral("ѡ滻:"), names, 0, false, &ok);
+	if (!ok)
+		return;
+
+	// ѡΪʱ£ʵᱻ
+	QVector<MapTileItem*> tiles;
+	QVector<QUuid> instances;
+	const TileRegionData content = ui->mapViewWidget->copyRegion(region, &tiles, &instances, true);
+	if (content.isEmpty())
+	{
+		ui->label->setText(QStringLiteral("ѡûпõƬͼ⣩Ԥδ"));
+		return;
+	}
+
+	// ¶ʵԶˢ£ѡҲʵֻɾʵʸ˵Ƭ
+	const QUuid prefabId = prefabs[names.indexOf(name)].id;
+	m_ctx->prefabLibrary.updatePrefab(prefabId, content);
+	ui->mapViewWidget->deleteCopied(tiles, instances);
+	ui->mapViewWidget->placePrefab(prefabId, region.topLeft());
+	ui->mapViewWidget->clearRegionSelection();
+
+	ui->label->setText(QStringLiteral("ѸԤ: %1").arg(name));
+}
+
 void MainWindow::onImportMap()
 {
 	// ļѡԻ
@@ -433,8 +811,7 @@ void MainWindow::onImportMap()
 		return;
 
 	// ǷҪǰͼ
-	const auto& currentTiles = ui->mapViewWidget->placedTiles();
-	if (!currentTiles.isEmpty())
+	if (ui->mapViewWidget->placedTileCount() > 0)
 	{
 		QMessageBox::StandardButton reply = QMessageBox::question(
 			this,
@@ -595,19 +972,35 @@ void MainWindow::onSaveMap()
 
 void MainWindow::OnNewMap()
 {
+	// վɵͼ޵ͼĻֱֿӶضأ
+	if (ui->mapViewWidget)
+		ui->mapViewWidget->clearAllTiles();
+
 	m_ctx->documentManager.newDefaultDocument();
 	if (ui->label)
 		ui->label->setText(QStringLiteral("New map created"));
 	if (ui->mapViewWidget)
-	{
-		ui->mapViewWidget->clearAllTiles();
 		ui->mapViewWidget->updateMap();
-	}
 
 	//  Inspector
 	ui->inspectorPanel->clearInfo();
 }
 
+void MainWindow::OnNewInfiniteMap()
+{
+	// վɵͼ޵ͼĻֱֿӶضأ
+	if (ui->mapViewWidget)
+		ui->mapViewWidget->clearAllTiles();
+
+	m_ctx->documentManager.newInfiniteDocument();
+	if (ui->label)
+		ui->label->setText(QStringLiteral("New infinite map created"));
+	if (ui->mapViewWidget)
+		ui->mapViewWidget->updateMap();
+
+	ui->inspectorPanel->clearInfo();
+}
+
 // ---------------------  SLOT  ---------------------
 
 void MainWindow::SlotSwitchSpriteSliceWidget()
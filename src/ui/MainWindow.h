@@ -28,6 +28,7 @@ private:
 	void SetupStatusBar();
 
 	void OnNewMap();
+	void OnNewInfiniteMap();
 	void InitMapViewUI();
 
 private slots:
@@ -41,6 +42,10 @@ private slots:
 	void onZoomSliderChanged(int value);
 	void onLayerChanged(int index);
 
+	// ͼͼҼ˵
+	void onLayersChanged();
+	void onLayerContextMenu(const QPoint& pos);
+
 	// Ƭѡ
 	void onTileSelected(MapTileItem* tile);
 	void onTileDeselected();
@@ -58,6 +63,17 @@ private slots:
 	void onSaveMap();
 	void onImportMap();
 
+	// Ƭ/滻
+	void onFindReplaceSlice();
+
+	// ͼߴ磨ê㣩
+	void onResizeMap();
+
+	// Ԥ
+	void onCreatePrefab();
+	void onPlacePrefab();
+	void onUpdatePrefab();
+
 	// ļ
 	void applyImportResult(const MapImportResult& result);
 
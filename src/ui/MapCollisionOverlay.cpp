@@ -0,0 +1,76 @@
+#include "MapCollisionOverlay.h"
+#include "core/CollisionBaker.h"
+#include "core/MapChunkCache.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+MapCollisionOverlay::MapCollisionOverlay(const CollisionBaker* baker, QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+	, m_baker(baker)
+{
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+	setAcceptedMouseButtons(Qt::NoButton);
+	setZValue(996);
+}
+
+void MapCollisionOverlay::setTileSize(int tileWidth, int tileHeight)
+{
+	if (m_tileWidth == tileWidth && m_tileHeight == tileHeight)
+		return;
+
+	prepareGeometryChange();
+	m_tileWidth = tileWidth;
+	m_tileHeight = tileHeight;
+	m_bounds = QRectF();
+}
+
+void MapCollisionOverlay::chunkChanged(const QRectF& sceneRect)
+{
+	if (!m_bounds.contains(sceneRect))
+	{
+		prepareGeometryChange();
+		m_bounds = m_bounds.united(sceneRect);
+	}
+	update(sceneRect);
+}
+
+void MapCollisionOverlay::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	Q_UNUSED(widget);
+
+	if (!m_baker)
+		return;
+
+	const QRectF exposed = option->exposedRect;
+	const qreal chunkW = static_cast<qreal>(MapChunkCache::CHUNK_SIZE) * m_tileWidth;
+	const qreal chunkH = static_cast<qreal>(MapChunkCache::CHUNK_SIZE) * m_tileHeight;
+
+	painter->save();
+	painter->setRenderHint(QPainter::Antialiasing, false);
+
+	const auto& chunks = m_baker->chunks();
+	for (auto it = chunks.constBegin(); it != chunks.constEnd(); ++it)
+	{
+		if (it->isEmpty())
+			continue;
+
+		// ÷ֿڵһֿ鷶Χֲü
+		const QPoint chunk = MapChunkCache::chunkOf(it->first().cells.x(), it->first().cells.y());
+		const QRectF chunkScene(chunk.x() * chunkW, chunk.y() * chunkH, chunkW, chunkH);
+		if (!chunkScene.intersects(exposed))
+			continue;
+
+		for (const CollisionRect& rect : *it)
+		{
+			const QColor color = rect.type == CollisionType::Trigger
+				? QColor(255, 170, 40) : QColor(230, 70, 70);
+			painter->setPen(QPen(color, 0));
+			painter->setBrush(QColor(color.red(), color.green(), color.blue(), 70));
+			painter->drawRect(QRectF(rect.cells.x() * m_tileWidth, rect.cells.y() * m_tileHeight,
+				rect.cells.width() * m_tileWidth, rect.cells.height() * m_tileHeight));
+		}
+	}
+
+	painter->restore();
+}
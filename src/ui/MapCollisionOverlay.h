@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QGraphicsItem>
+
+class CollisionBaker;
+
+// ײԤӲ㣺ɫƺ決ײ
+// ֱӶȡ CollisionBaker ķֻֿػཻķֿ
+class MapCollisionOverlay : public QGraphicsItem
+{
+public:
+	enum { Type = UserType + 2 };
+
+	explicit MapCollisionOverlay(const CollisionBaker* baker, QGraphicsItem* parent = nullptr);
+
+	int type() const override { return Type; }
+
+	void setTileSize(int tileWidth, int tileHeight);
+
+	// ֿ仯ã꣩
+	void chunkChanged(const QRectF& sceneRect);
+
+	QRectF boundingRect() const override { return m_bounds; }
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	const CollisionBaker* m_baker = nullptr;
+	int m_tileWidth = 32;
+	int m_tileHeight = 32;
+	QRectF m_bounds;                 // ֹײķΧֻ
+};
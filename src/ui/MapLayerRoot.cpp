@@ -0,0 +1,96 @@
+#include "MapLayerRoot.h"
+#include "MapLodLayer.h"
+
+#include <QGraphicsOpacityEffect>
+
+MapLayerRoot::MapLayerRoot(int layer, QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+	, m_layer(layer)
+{
+	setFlag(QGraphicsItem::ItemHasNoContents, true);
+}
+
+void MapLayerRoot::setGridOrigin(const QPoint& origin, int tileWidth, int tileHeight)
+{
+	m_gridOrigin = origin;
+	setPos(origin.x() * tileWidth, origin.y() * tileHeight);
+}
+
+void MapLayerRoot::setLayerVisible(bool visible)
+{
+	if (m_layerVisible == visible)
+		return;
+
+	m_layerVisible = visible;
+	updateVisibility();
+}
+
+void MapLayerRoot::setLodHidden(bool hidden)
+{
+	if (m_lodHidden == hidden)
+		return;
+
+	m_lodHidden = hidden;
+	updateVisibility();
+}
+
+void MapLayerRoot::updateVisibility()
+{
+	//  setVisibleͼԪĿɼǡ
+	// ڵȫ͸ͼԪ̳䲻͸ʱڸڵ㴦ֱӷأ
+	// ơвԣƬ޹
+	setOpacity(m_layerVisible && !m_lodHidden ? 1.0 : 0.0);
+}
+
+void MapLayerRoot::setLayerOpacity(qreal opacity)
+{
+	opacity = qBound<qreal>(0.0, opacity, 1.0);
+	if (qFuzzyCompare(m_layerOpacity, opacity))
+		return;
+
+	m_layerOpacity = opacity;
+
+	// ͸ʱҪϳ
+	if (qFuzzyCompare(opacity, 1.0))
+	{
+		setGraphicsEffect(nullptr);
+		setFlag(QGraphicsItem::ItemHasNoContents, true);
+		return;
+	}
+
+	// Ч㣨ֻȡӿڲ֣ƵͼͳһԲ͸ȣ
+	// صƬụ͸ͼݱ仯ʱԶʧЧ
+	auto* effect = qobject_cast<QGraphicsOpacityEffect*>(graphicsEffect());
+	if (!effect)
+	{
+		setFlag(QGraphicsItem::ItemHasNoContents, false);
+		effect = new QGraphicsOpacityEffect;
+		setGraphicsEffect(effect);
+	}
+	effect->setOpacity(opacity);
+}
+
+bool MapLayerRoot::isItemLocked(const QGraphicsItem* item)
+{
+	if (!item)
+		return false;
+
+	auto* root = qgraphicsitem_cast<const MapLayerRoot*>(item->parentItem());
+	return root && root->isLocked();
+}
+
+bool MapLayerRoot::isItemRasterized(const QGraphicsItem* item)
+{
+	if (!item)
+		return false;
+
+	auto* root = qgraphicsitem_cast<const MapLayerRoot*>(item->parentItem());
+	return root && root->m_chunkRaster && root->m_chunkRaster->coversSceneRect(item->sceneBoundingRect());
+}
+
+void MapLayerRoot::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	Q_UNUSED(painter);
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+}
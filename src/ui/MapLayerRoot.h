@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QPoint>
+
+class MapLodLayer;
+class MapTileEvents;
+
+// ͼڵ㣺ͬһͼƬ
+// - ͼĵ˳ɸڵ Z ֵͼͼбã˳ҪĶƬ
+// - ԭƽƣͼ/չֻƶڵ㣬ƶƬ
+// - ͼ״̬ʾ͸ȣֻڸڵϣлʱƬ
+class MapLayerRoot : public QGraphicsItem
+{
+public:
+	enum { Type = UserType + 1 };
+
+	explicit MapLayerRoot(int layer, QGraphicsItem* parent = nullptr);
+
+	int type() const override { return Type; }
+	int layer() const { return m_layer; }
+
+	// ԭ㣨߼ = ظ + ԭ㣩
+	QPoint gridOrigin() const { return m_gridOrigin; }
+	void setGridOrigin(const QPoint& origin, int tileWidth, int tileHeight);
+
+	// ͼʾʱڵȫ͸ƺвڸڵ㴦ֱ
+	bool isLayerVisible() const { return m_layerVisible; }
+	void setLayerVisible(bool visible);
+
+	// Сͼɷֿͼ
+	void setLodHidden(bool hidden);
+
+	// ͼµķֿդդѸǵͼԪԼƣֻвԺͱ༭
+	void setChunkRaster(const MapLodLayer* raster) { m_chunkRaster = raster; }
+
+	// ƬĽźž˶󷢳ͼһֻһΣ
+	MapTileEvents* tileEvents() const { return m_tileEvents; }
+	void setTileEvents(MapTileEvents* events) { m_tileEvents = events; }
+
+	// ͼͼԪӦ༭ͼ
+	bool isLocked() const { return m_locked; }
+	void setLocked(bool locked) { m_locked = locked; }
+
+	// ͼ㲻͸ȣС 1 ʱȺϳɵͼٰ͸Ȼһ
+	qreal layerOpacity() const { return m_layerOpacity; }
+	void setLayerOpacity(qreal opacity);
+
+	// ͼƬ Z ΧƬ棻ϲͼʱŵĿͼ֮ϻ֮
+	qreal bottomZ() const { return m_bottomZ; }
+	qreal topZ() const { return m_topZ; }
+	void setZRange(qreal bottom, qreal top) { m_bottomZ = bottom; m_topZ = top; }
+
+	// ͼԪͼǷ
+	static bool isItemLocked(const QGraphicsItem* item);
+
+	// ͼԪڵķֿǷɷֿդ
+	static bool isItemRasterized(const QGraphicsItem* item);
+
+	QRectF boundingRect() const override { return QRectF(); }
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	void updateVisibility();
+
+private:
+	int m_layer = 0;
+	QPoint m_gridOrigin;
+	bool m_layerVisible = true;
+	bool m_lodHidden = false;
+	bool m_locked = false;
+	const MapLodLayer* m_chunkRaster = nullptr;
+	MapTileEvents* m_tileEvents = nullptr;
+	qreal m_layerOpacity = 1.0;
+	qreal m_bottomZ = 0.0;
+	qreal m_topZ = 0.0;
+};
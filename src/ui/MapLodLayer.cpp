@@ -0,0 +1,415 @@
+#include "MapLodLayer.h"
+#include "core/MapChunkCache.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QThread>
+#include <QtMath>
+#include <algorithm>
+
+MapLodLayer::MapLodLayer(QGraphicsItem* parent)
+	: QGraphicsObject(parent)
+{
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+	setAcceptedMouseButtons(Qt::NoButton);
+	setZValue(5);
+
+	// һĸ߳
+	m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+MapLodLayer::~MapLodLayer()
+{
+	m_pool.clear();
+	m_pool.waitForDone();
+}
+
+void MapLodLayer::setTileSize(int tileWidth, int tileHeight)
+{
+	if (m_tileWidth == tileWidth && m_tileHeight == tileHeight)
+		return;
+
+	m_tileWidth = tileWidth;
+	m_tileHeight = tileHeight;
+	clear();
+}
+
+void MapLodLayer::setSceneBounds(const QRectF& bounds)
+{
+	if (m_bounds == bounds)
+		return;
+
+	prepareGeometryChange();
+	m_bounds = bounds;
+}
+
+void MapLodLayer::setLevel(MapLodLevel level)
+{
+	if (m_level == level)
+		return;
+
+	// ͼСͼʹòͬͼͼԪǷԼҲ֮仯ػ
+	m_level = level;
+	update();
+}
+
+QRectF MapLodLayer::chunkSceneRect(const QPoint& chunk) const
+{
+	const QRect area = MapChunkCache::chunkRect(chunk);
+	return QRectF(area.x() * m_tileWidth, area.y() * m_tileHeight,
+		area.width() * m_tileWidth, area.height() * m_tileHeight);
+}
+
+void MapLodLayer::invalidateChunk(const QPoint& chunk)
+{
+	auto it = m_chunks.find(MapChunkCache::chunkKey(chunk));
+	if (it == m_chunks.end())
+		return;
+
+	// ͼ½ڼΪռλ
+	it->version = ++m_versionCounter;
+	it->ready = false;
+
+	// ͼ²ƹڵĹդͼԪֱӻƵ½
+	it->fullReady = false;
+	releaseFull(*it);
+
+	if (isVisible())
+		update(chunkSceneRect(chunk));
+}
+
+void MapLodLayer::clear()
+{
+	// δɵ񰴰汾Ŷ
+	m_pool.clear();
+	m_chunks.clear();
+	m_mipCount = 0;
+	m_fullBytes = 0;
+	update();
+}
+
+void MapLodLayer::translate(const QPoint& delta)
+{
+	if (delta.isNull())
+		return;
+
+	const int size = MapChunkCache::CHUNK_SIZE;
+	if (delta.x() % size != 0 || delta.y() % size != 0)
+	{
+		clear();
+		return;
+	}
+
+	// ͼݲ䣬°汾ýе񰴾ɼ
+	const QPoint chunkDelta(delta.x() / size, delta.y() / size);
+	QHash<quint64, ChunkImages> chunks;
+	chunks.reserve(m_chunks.size());
+	for (ChunkImages& images : m_chunks)
+	{
+		images.chunk += chunkDelta;
+		images.version = ++m_versionCounter;
+		if (!images.ready)
+			images.requested = 0;
+		if (!images.fullReady)
+			images.fullRequested = 0;
+		chunks.insert(MapChunkCache::chunkKey(images.chunk), std::move(images));
+	}
+	m_chunks = std::move(chunks);
+	update();
+}
+
+bool MapLodLayer::coversSceneRect(const QRectF& rect) const
+{
+	if (m_level != MapLodLevel::Full || rect.isEmpty())
+		return false;
+
+	const qreal chunkW = static_cast<qreal>(MapChunkCache::CHUNK_SIZE) * m_tileWidth;
+	const qreal chunkH = static_cast<qreal>(MapChunkCache::CHUNK_SIZE) * m_tileHeight;
+	const int firstX = qFloor(rect.left() / chunkW);
+	const int lastX = qCeil(rect.right() / chunkW) - 1;
+	const int firstY = qFloor(rect.top() / chunkH);
+	const int lastY = qCeil(rect.bottom() / chunkH) - 1;
+
+	for (int cy = firstY; cy <= lastY; ++cy)
+	{
+		for (int cx = firstX; cx <= lastX; ++cx)
+		{
+			auto it = m_chunks.constFind(MapChunkCache::chunkKey(QPoint(cx, cy)));
+			if (it == m_chunks.constEnd() || !it->fullReady || it->live)
+				return false;
+		}
+	}
+	return true;
+}
+
+MapLodLayer::ChunkImages& MapLodLayer::chunkImages(const QPoint& chunk)
+{
+	const quint64 key = MapChunkCache::chunkKey(chunk);
+	auto it = m_chunks.find(key);
+	if (it == m_chunks.end())
+	{
+		ChunkImages images;
+		images.chunk = chunk;
+		images.version = ++m_versionCounter;
+		it = m_chunks.insert(key, images);
+	}
+	return it.value();
+}
+
+void MapLodLayer::requestChunk(ChunkImages& images)
+{
+	images.requested = images.version;
+
+	const MapLodSnapshot snapshot = m_provider ? m_provider(images.chunk, MIP_DIVISOR) : MapLodSnapshot();
+	if (snapshot.isEmpty())
+	{
+		if (!images.mip.isNull())
+			--m_mipCount;
+		images.mip = QImage();
+		images.cells = QImage();
+		images.empty = true;
+		images.ready = true;
+		return;
+	}
+
+	const quint64 key = MapChunkCache::chunkKey(images.chunk);
+	const quint64 version = images.version;
+	m_pool.start([this, snapshot, key, version]() {
+		const QImage mip = rasterize(snapshot);
+
+		// ÿƽɫСͼһƽŵõ
+		const QImage cells = mip.scaled(MapChunkCache::CHUNK_SIZE, MapChunkCache::CHUNK_SIZE,
+			Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+		QMetaObject::invokeMethod(this, [this, key, version, mip, cells]() {
+			onChunkRasterized(key, version, mip, cells);
+			}, Qt::QueuedConnection);
+		});
+}
+
+void MapLodLayer::requestFull(ChunkImages& images)
+{
+	images.fullRequested = images.version;
+
+	const MapLodSnapshot snapshot = m_provider ? m_provider(images.chunk, 1) : MapLodSnapshot();
+	if (snapshot.animated || snapshot.isEmpty())
+	{
+		// շֿ鲻ҪդƬķֿ֡仯ͼԪ
+		releaseFull(images);
+		images.live = snapshot.animated;
+		images.fullReady = true;
+		return;
+	}
+
+	images.fullSmooth = snapshot.smooth;
+	const quint64 key = MapChunkCache::chunkKey(images.chunk);
+	const quint64 version = images.version;
+	m_pool.start([this, snapshot, key, version]() {
+		const QImage full = rasterize(snapshot);
+
+		QMetaObject::invokeMethod(this, [this, key, version, full]() {
+			onFullRasterized(key, version, full);
+			}, Qt::QueuedConnection);
+		});
+}
+
+QImage MapLodLayer::rasterize(const MapLodSnapshot& snapshot)
+{
+	QImage image(snapshot.size, QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::transparent);
+
+	auto drawItems = [&snapshot](QPainter& painter, int from, int to) {
+		painter.setRenderHint(QPainter::SmoothPixmapTransform, snapshot.smooth);
+		for (int i = from; i < to; ++i)
+		{
+			const MapLodSnapshot::Item& item = snapshot.items[i];
+			painter.setTransform(item.transform);
+			painter.drawImage(item.offset, item.image);
+		}
+	};
+
+	QPainter painter(&image);
+	const int count = snapshot.items.size();
+	for (int from = 0; from < count;)
+	{
+		// ͬһͼͼԪ
+		int to = from + 1;
+		while (to < count && snapshot.items[to].layer == snapshot.items[from].layer)
+			++to;
+
+		const qreal opacity = snapshot.items[from].opacity;
+		if (opacity >= 1.0)
+		{
+			drawItems(painter, from, to);
+		}
+		else if (opacity > 0.0)
+		{
+			// ͸ͼȵϳɣһ
+			QImage layerImage(snapshot.size, QImage::Format_ARGB32_Premultiplied);
+			layerImage.fill(Qt::transparent);
+			{
+				QPainter layerPainter(&layerImage);
+				drawItems(layerPainter, from, to);
+			}
+			painter.resetTransform();
+			painter.setOpacity(opacity);
+			painter.drawImage(0, 0, layerImage);
+			painter.setOpacity(1.0);
+		}
+		from = to;
+	}
+	return image;
+}
+
+void MapLodLayer::onChunkRasterized(quint64 key, quint64 version, const QImage& mip, const QImage& cells)
+{
+	// ڼֿ鱻༭գѹ
+	auto it = m_chunks.find(key);
+	if (it == m_chunks.end() || it->version != version)
+		return;
+
+	if (it->mip.isNull())
+		++m_mipCount;
+	it->mip = mip;
+	it->cells = cells;
+	it->empty = false;
+	it->ready = true;
+
+	update(chunkSceneRect(it->chunk));
+	trimMipCache();
+}
+
+void MapLodLayer::onFullRasterized(quint64 key, quint64 version, const QImage& full)
+{
+	auto it = m_chunks.find(key);
+	if (it == m_chunks.end() || it->version != version)
+		return;
+
+	releaseFull(*it);
+	it->full = full;
+	it->live = false;
+	it->fullReady = true;
+	m_fullBytes += full.sizeInBytes();
+
+	// ֿڵͼԪػΪԼĻ
+	update(chunkSceneRect(it->chunk));
+	trimFullCache();
+}
+
+void MapLodLayer::releaseFull(ChunkImages& images)
+{
+	m_fullBytes -= images.full.sizeInBytes();
+	images.full = QImage();
+}
+
+void MapLodLayer::trimFullCache()
+{
+	if (m_fullBytes <= MAX_FULL_BYTES)
+		return;
+
+	// ͷδƵĹդЩֿٴοɼʱ
+	QVector<QPair<quint64, quint64>> candidates;
+	for (auto it = m_chunks.constBegin(); it != m_chunks.constEnd(); ++it)
+	{
+		if (!it->full.isNull() && it->lastUsed != m_paintSerial)
+			candidates.append(qMakePair(it->lastUsed, it.key()));
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	for (const auto& candidate : candidates)
+	{
+		if (m_fullBytes <= MAX_FULL_BYTES)
+			break;
+		ChunkImages& images = m_chunks[candidate.second];
+		releaseFull(images);
+		images.fullReady = false;
+		images.fullRequested = 0;
+	}
+}
+
+void MapLodLayer::trimMipCache()
+{
+	if (m_mipCount <= MAX_CACHED_MIPS)
+		return;
+
+	// ͷδƵСͼƽɫ
+	QVector<QPair<quint64, quint64>> candidates;
+	for (auto it = m_chunks.constBegin(); it != m_chunks.constEnd(); ++it)
+	{
+		if (!it->mip.isNull() && it->lastUsed != m_paintSerial)
+			candidates.append(qMakePair(it->lastUsed, it.key()));
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	for (const auto& candidate : candidates)
+	{
+		if (m_mipCount <= MAX_CACHED_MIPS)
+			break;
+		m_chunks[candidate.second].mip = QImage();
+		--m_mipCount;
+	}
+}
+
+void MapLodLayer::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	Q_UNUSED(widget);
+
+	++m_paintSerial;
+
+	const QRectF exposed = option->exposedRect.intersected(m_bounds);
+	if (exposed.isEmpty())
+		return;
+
+	// ɼΧڵķֿ
+	const qreal chunkW = static_cast<qreal>(MapChunkCache::CHUNK_SIZE) * m_tileWidth;
+	const qreal chunkH = static_cast<qreal>(MapChunkCache::CHUNK_SIZE) * m_tileHeight;
+	const int firstX = qFloor(exposed.left() / chunkW);
+	const int lastX = qFloor(exposed.right() / chunkW);
+	const int firstY = qFloor(exposed.top() / chunkH);
+	const int lastY = qFloor(exposed.bottom() / chunkH);
+
+	const bool full = (m_level == MapLodLevel::Full);
+	const bool useMip = (m_level == MapLodLevel::Mip);
+	const QColor placeholder(225, 227, 232);
+
+	painter->save();
+	painter->setRenderHint(QPainter::SmoothPixmapTransform, useMip);
+	for (int cy = firstY; cy <= lastY; ++cy)
+	{
+		for (int cx = firstX; cx <= lastX; ++cx)
+		{
+			ChunkImages& images = chunkImages(QPoint(cx, cy));
+			images.lastUsed = m_paintSerial;
+
+			// ͼդΪԭߴ磬δʱͼͼԪԼ
+			if (full)
+			{
+				if (!images.fullReady && images.fullRequested != images.version)
+					requestFull(images);
+				if (images.fullReady && !images.full.isNull())
+				{
+					painter->setRenderHint(QPainter::SmoothPixmapTransform, images.fullSmooth);
+					painter->drawImage(QPointF(cx * chunkW, cy * chunkH), images.full);
+				}
+				continue;
+			}
+
+			// СͼͷŹķֿҪ
+			if (useMip && images.ready && !images.empty && images.mip.isNull())
+			{
+				images.version = ++m_versionCounter;
+				images.ready = false;
+			}
+			if (!images.ready && images.requested != images.version)
+				requestChunk(images);
+
+			const QRectF target(cx * chunkW, cy * chunkH, chunkW, chunkH);
+			const QImage& image = (useMip && !images.mip.isNull()) ? images.mip : images.cells;
+			if (!image.isNull())
+				painter->drawImage(target, image);
+			else if (!images.ready)
+				painter->fillRect(target, placeholder);
+		}
+	}
+	painter->restore();
+}
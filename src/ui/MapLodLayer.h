@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QGraphicsObject>
+#include <QHash>
+#include <QImage>
+#include <QPoint>
+#include <QThreadPool>
+#include <QTransform>
+#include <QVector>
+#include <functional>
+
+// ϸڲ㼶űл
+enum class MapLodLevel
+{
+	Full,       // ԭߴķֿդդδ򺬶ķֿƬͼԪԼƣ
+	Mip,        // ԤСķֿͼ
+	Color       // ÿһƽɫ
+};
+
+// ֿգڽ߳ռֻ QImageɽ̻߳
+struct MapLodSnapshot
+{
+	struct Item
+	{
+		QImage image;
+		QTransform transform;       // ͼԪ -> Сͼ
+		QPointF offset;
+		int layer = 0;
+		qreal opacity = 1.0;        // ͼĲ͸ȣϳɺӦã
+	};
+
+	QSize size;                     // Сͼߴ
+	QVector<Item> items;            // ͼ˳
+	bool smooth = true;
+	bool animated = false;          // ֿжƬͼ²ɹդ
+
+	bool isEmpty() const { return items.isEmpty(); }
+};
+
+// ֿͼ㣺Сͼ´صƬͼƣͼ»ԭߴķֿդ
+// ƬͼԪڳивԺͱ༭ڷֿĹդԼ
+// - ֿ״οɼʱڽ߳ռգ̳߳դ񻯣ɺص߳
+// - ÿֿݰ汾ţ༭汾仯ɰ汾ĽֱӶ
+// - Сͼ½δʱƾͼռλɫ飻ͼδķֿͼԪ
+// - ֻȡڿɼķֿƬ޹
+class MapLodLayer : public QGraphicsObject
+{
+public:
+	enum { Type = UserType + 4 };
+
+	// ֿСͼԭʼأ
+	static constexpr int MIP_DIVISOR = 4;
+
+	// ռֿգֿΪʱؿտգdivisor ΪԭʼصС
+	using SnapshotProvider = std::function<MapLodSnapshot(const QPoint& chunk, int divisor)>;
+
+	explicit MapLodLayer(QGraphicsItem* parent = nullptr);
+	~MapLodLayer();
+
+	int type() const override { return Type; }
+
+	void setSnapshotProvider(SnapshotProvider provider) { m_provider = std::move(provider); }
+	void setTileSize(int tileWidth, int tileHeight);
+	void setSceneBounds(const QRectF& bounds);
+
+	MapLodLevel level() const { return m_level; }
+	void setLevel(MapLodLevel level);
+
+	void invalidateChunk(const QPoint& chunk);
+	void clear();
+
+	// ԭƽƣƫֿʱֻķֿͼԭգɼֿ鰴
+	void translate(const QPoint& delta);
+
+	// ͼ£漰ķֿǷɹդƣͼԪݴԼĻƣ
+	bool coversSceneRect(const QRectF& rect) const;
+
+	// ִ߳УջСͼ
+	static QImage rasterize(const MapLodSnapshot& snapshot);
+
+	QRectF boundingRect() const override { return m_bounds; }
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	struct ChunkImages
+	{
+		QPoint chunk;
+		quint64 version = 0;        // ݰ汾
+		quint64 requested = 0;      // ύդ񻯵İ汾
+		bool ready = false;         // ͼ뵱ǰ汾һ
+		bool empty = false;
+		QImage mip;                 // СͼʱͷţҪʱɣ
+		QImage cells;               // ÿһ
+		quint64 lastUsed = 0;
+
+		// ͼԭߴդ汾Сͼã
+		quint64 fullRequested = 0;
+		bool fullReady = false;     // դ뵱ǰ汾һ
+		bool live = false;          // ƬͼԪ
+		bool fullSmooth = true;     // ͼʱƬĲʽ
+		QImage full;
+	};
+
+	ChunkImages& chunkImages(const QPoint& chunk);
+	void requestChunk(ChunkImages& images);
+	void requestFull(ChunkImages& images);
+	void onChunkRasterized(quint64 key, quint64 version, const QImage& mip, const QImage& cells);
+	void onFullRasterized(quint64 key, quint64 version, const QImage& full);
+	void releaseFull(ChunkImages& images);
+	QRectF chunkSceneRect(const QPoint& chunk) const;
+	void trimMipCache();
+	void trimFullCache();
+
+private:
+	static constexpr int MAX_CACHED_MIPS = 256;
+	static constexpr qint64 MAX_FULL_BYTES = 256ll * 1024 * 1024;
+
+	SnapshotProvider m_provider;
+	MapLodLevel m_level = MapLodLevel::Full;
+	int m_tileWidth = 32;
+	int m_tileHeight = 32;
+	QRectF m_bounds;
+	QHash<quint64, ChunkImages> m_chunks;
+	quint64 m_versionCounter = 0;
+	int m_mipCount = 0;
+	qint64 m_fullBytes = 0;
+	quint64 m_paintSerial = 0;
+	QThreadPool m_pool;
+};
@@ -0,0 +1,120 @@
+#include "MapNavOverlay.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
+
+MapNavOverlay::MapNavOverlay(QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+{
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+	setAcceptedMouseButtons(Qt::NoButton);
+	setZValue(995);
+}
+
+void MapNavOverlay::setTileSize(int tileWidth, int tileHeight)
+{
+	if (m_tileWidth == tileWidth && m_tileHeight == tileHeight)
+		return;
+
+	m_tileWidth = tileWidth;
+	m_tileHeight = tileHeight;
+	updateBounds();
+}
+
+void MapNavOverlay::setEndpoints(const std::optional<QPoint>& start, const std::optional<QPoint>& goal)
+{
+	m_start = start;
+	m_goal = goal;
+	updateBounds();
+}
+
+void MapNavOverlay::setResult(const QVector<QPoint>& path, const QVector<QPoint>& explored)
+{
+	m_path = path;
+	m_explored = explored;
+	updateBounds();
+}
+
+void MapNavOverlay::clear()
+{
+	m_start.reset();
+	m_goal.reset();
+	m_path.clear();
+	m_explored.clear();
+	updateBounds();
+}
+
+QPointF MapNavOverlay::cellCenter(const QPoint& cell) const
+{
+	return QPointF((cell.x() + 0.5) * m_tileWidth, (cell.y() + 0.5) * m_tileHeight);
+}
+
+QRectF MapNavOverlay::cellRect(const QPoint& cell) const
+{
+	return QRectF(cell.x() * m_tileWidth, cell.y() * m_tileHeight, m_tileWidth, m_tileHeight);
+}
+
+void MapNavOverlay::updateBounds()
+{
+	QRectF bounds;
+	auto include = [&](const QPoint& cell) { bounds = bounds.united(cellRect(cell)); };
+
+	if (m_start) include(*m_start);
+	if (m_goal) include(*m_goal);
+	for (const QPoint& cell : m_path) include(cell);
+	for (const QPoint& cell : m_explored) include(cell);
+
+	prepareGeometryChange();
+	m_bounds = bounds.adjusted(-2, -2, 2, 2);
+	update();
+}
+
+void MapNavOverlay::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	Q_UNUSED(widget);
+
+	const QRectF exposed = option->exposedRect;
+
+	painter->save();
+
+	// չ
+	painter->setRenderHint(QPainter::Antialiasing, false);
+	painter->setPen(Qt::NoPen);
+	painter->setBrush(QColor(90, 160, 255, 60));
+	for (const QPoint& cell : m_explored)
+	{
+		const QRectF rect = cellRect(cell);
+		if (rect.intersects(exposed))
+			painter->drawRect(rect);
+	}
+
+	// ·ֱ֮߻ 45 бߣֱӸ
+	painter->setRenderHint(QPainter::Antialiasing, true);
+	if (m_path.size() > 1)
+	{
+		QPainterPath line(cellCenter(m_path.first()));
+		for (int i = 1; i < m_path.size(); ++i)
+			line.lineTo(cellCenter(m_path[i]));
+
+		painter->setBrush(Qt::NoBrush);
+		painter->setPen(QPen(QColor(40, 120, 255), qMax(2, m_tileWidth / 8), Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+		painter->drawPath(line);
+	}
+
+	//  / յ
+	const qreal radius = qMin(m_tileWidth, m_tileHeight) * 0.3;
+	painter->setPen(QPen(Qt::white, 2));
+	if (m_start)
+	{
+		painter->setBrush(QColor(60, 180, 90));
+		painter->drawEllipse(cellCenter(*m_start), radius, radius);
+	}
+	if (m_goal)
+	{
+		painter->setBrush(QColor(220, 70, 70));
+		painter->drawEllipse(cellCenter(*m_goal), radius, radius);
+	}
+
+	painter->restore();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QPoint>
+#include <QVector>
+#include <optional>
+
+// Ѱ·ԤӲ㣺/յ㡢չ·
+// Ϊ߼꣬ʱΪ
+class MapNavOverlay : public QGraphicsItem
+{
+public:
+	enum { Type = UserType + 3 };
+
+	explicit MapNavOverlay(QGraphicsItem* parent = nullptr);
+
+	int type() const override { return Type; }
+
+	void setTileSize(int tileWidth, int tileHeight);
+
+	// ˵㣨δʱֵ
+	void setEndpoints(const std::optional<QPoint>& start, const std::optional<QPoint>& goal);
+
+	// path Ϊձʾδҵ
+	void setResult(const QVector<QPoint>& path, const QVector<QPoint>& explored);
+	void clear();
+
+	QRectF boundingRect() const override { return m_bounds; }
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	QPointF cellCenter(const QPoint& cell) const;
+	QRectF cellRect(const QPoint& cell) const;
+	void updateBounds();
+
+private:
+	int m_tileWidth = 32;
+	int m_tileHeight = 32;
+	std::optional<QPoint> m_start;
+	std::optional<QPoint> m_goal;
+	QVector<QPoint> m_path;
+	QVector<QPoint> m_explored;
+	QRectF m_bounds;
+};
@@ -0,0 +1,42 @@
+#include "MapPrefabItem.h"
+#include "MapLayerRoot.h"
+#include <QPainter>
+
+MapPrefabItem::MapPrefabItem(const QUuid& instanceId, int layer, QGraphicsItem* parent)
+	: QGraphicsPixmapItem(parent)
+	, m_instanceId(instanceId)
+	, m_layer(layer)
+{
+	setTransformationMode(Qt::SmoothTransformation);
+	setAcceptedMouseButtons(Qt::LeftButton);
+	setFlag(QGraphicsItem::ItemIsSelectable, false);
+}
+
+void MapPrefabItem::setHighlighted(bool highlighted)
+{
+	if (m_highlighted == highlighted)
+		return;
+
+	m_highlighted = highlighted;
+	update();
+}
+
+void MapPrefabItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	// ڷֿɷֿդʱٻƣѡеʵդ
+	if (!m_highlighted)
+	{
+		if (!MapLayerRoot::isItemRasterized(this))
+			QGraphicsPixmapItem::paint(painter, option, widget);
+		return;
+	}
+
+	QGraphicsPixmapItem::paint(painter, option, widget);
+
+	// ѡʱɫͨƬ֣
+	QPen pen(QColor(160, 90, 255), 2, Qt::DashLine);
+	pen.setCosmetic(true);
+	painter->setPen(pen);
+	painter->setBrush(Qt::NoBrush);
+	painter->drawRect(boundingRect().adjusted(1, 1, -1, -1));
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QGraphicsPixmapItem>
+#include <QUuid>
+
+// ԤʵĳͼϵͼԪ
+// ͬһԤʵһŹդQPixmap ʽƬ
+class MapPrefabItem : public QGraphicsPixmapItem
+{
+public:
+	MapPrefabItem(const QUuid& instanceId, int layer, QGraphicsItem* parent = nullptr);
+
+	const QUuid& instanceId() const { return m_instanceId; }
+	int layer() const { return m_layer; }
+
+	// ѡи
+	bool isHighlighted() const { return m_highlighted; }
+	void setHighlighted(bool highlighted);
+
+protected:
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	QUuid m_instanceId;
+	int m_layer = 0;
+	bool m_highlighted = false;
+};
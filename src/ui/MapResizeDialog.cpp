@@ -0,0 +1,91 @@
+#include "MapResizeDialog.h"
+
+#include <QButtonGroup>
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QGridLayout>
+#include <QSpinBox>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+namespace
+{
+	// 9 ê㣨У
+	const Qt::Alignment ANCHORS[9] = {
+		Qt::AlignLeft | Qt::AlignTop,       Qt::AlignHCenter | Qt::AlignTop,       Qt::AlignRight | Qt::AlignTop,
+		Qt::AlignLeft | Qt::AlignVCenter,   Qt::AlignHCenter | Qt::AlignVCenter,   Qt::AlignRight | Qt::AlignVCenter,
+		Qt::AlignLeft | Qt::AlignBottom,    Qt::AlignHCenter | Qt::AlignBottom,    Qt::AlignRight | Qt::AlignBottom
+	};
+}
+
+MapResizeDialog::MapResizeDialog(int currentWidth, int currentHeight, QWidget* parent)
+	: QDialog(parent)
+{
+	setWindowTitle(QStringLiteral("ͼߴ"));
+	setupUi(currentWidth, currentHeight);
+}
+
+void MapResizeDialog::setupUi(int currentWidth, int currentHeight)
+{
+	m_spinWidth = new QSpinBox(this);
+	m_spinWidth->setRange(1, 100000);
+	m_spinWidth->setValue(currentWidth);
+
+	m_spinHeight = new QSpinBox(this);
+	m_spinHeight->setRange(1, 100000);
+	m_spinHeight->setValue(currentHeight);
+
+	// ê㣺ѡеĸӱʾԭݱڸñ/
+	auto* anchorLayout = new QGridLayout;
+	anchorLayout->setSpacing(2);
+	m_anchorGroup = new QButtonGroup(this);
+	m_anchorGroup->setExclusive(true);
+	for (int i = 0; i < 9; ++i)
+	{
+		auto* button = new QToolButton(this);
+		button->setCheckable(true);
+		button->setFixedSize(24, 24);
+		m_anchorGroup->addButton(button, i);
+		anchorLayout->addWidget(button, i / 3, i % 3);
+	}
+	m_anchorGroup->button(0)->setChecked(true);
+
+	m_checkDrop = new QCheckBox(QStringLiteral("ɾΧƬ"), this);
+	m_checkDrop->setChecked(true);
+
+	auto* form = new QFormLayout;
+	form->addRow(QStringLiteral(""), m_spinWidth);
+	form->addRow(QStringLiteral("߶"), m_spinHeight);
+	form->addRow(QStringLiteral("ê"), anchorLayout);
+	form->addRow(QString(), m_checkDrop);
+
+	auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+	connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+	connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+	auto* root = new QVBoxLayout(this);
+	root->addLayout(form);
+	root->addWidget(buttons);
+}
+
+int MapResizeDialog::mapWidth() const
+{
+	return m_spinWidth->value();
+}
+
+int MapResizeDialog::mapHeight() const
+{
+	return m_spinHeight->value();
+}
+
+Qt::Alignment MapResizeDialog::anchor() const
+{
+	const int id = m_anchorGroup->checkedId();
+	return (id >= 0 && id < 9) ? ANCHORS[id] : (Qt::AlignLeft | Qt::AlignTop);
+}
+
+bool MapResizeDialog::dropOutOfBounds() const
+{
+	return m_checkDrop->isChecked();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QDialog>
+
+class QButtonGroup;
+class QCheckBox;
+class QSpinBox;
+
+// ͼߴԻ³ߴ + ê㣨9  + ΧƬʽ
+class MapResizeDialog : public QDialog
+{
+	Q_OBJECT
+public:
+	MapResizeDialog(int currentWidth, int currentHeight, QWidget* parent = nullptr);
+
+	int mapWidth() const;
+	int mapHeight() const;
+	Qt::Alignment anchor() const;
+	bool dropOutOfBounds() const;
+
+private:
+	void setupUi(int currentWidth, int currentHeight);
+
+private:
+	QSpinBox* m_spinWidth = nullptr;
+	QSpinBox* m_spinHeight = nullptr;
+	QButtonGroup* m_anchorGroup = nullptr;
+	QCheckBox* m_checkDrop = nullptr;
+};
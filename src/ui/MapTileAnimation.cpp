@@ -0,0 +1,56 @@
+#include "MapTileAnimation.h"
+
+#include <QTransform>
+#include <algorithm>
+
+MapTileAnimation::MapTileAnimation(const QVector<QPixmap>& frames, const QVector<int>& durations)
+	: m_frames(frames)
+{
+	m_frameEnds.reserve(m_frames.size());
+	for (int i = 0; i < m_frames.size(); ++i)
+	{
+		m_length += qMax(1, durations.value(i, 100));
+		m_frameEnds.append(m_length);
+	}
+}
+
+bool MapTileAnimation::advanceTo(qint64 elapsedMs)
+{
+	if (m_length <= 0)
+		return false;
+
+	// ѭڵʱһֲ֡ң
+	const qint64 time = elapsedMs % m_length;
+	const int frame = static_cast<int>(std::upper_bound(m_frameEnds.cbegin(), m_frameEnds.cend(), time) - m_frameEnds.cbegin());
+	if (frame == m_current)
+		return false;
+
+	m_current = frame;
+	return true;
+}
+
+const QPixmap& MapTileAnimation::currentPixmap(bool flipX, bool flipY, int rotation, Qt::TransformationMode mode) const
+{
+	const QPixmap& frame = m_frames[m_current];
+	if (!flipX && !flipY && rotation == 0)
+		return frame;
+
+	const int key = (flipX ? 1 : 0) | (flipY ? 2 : 0) | ((rotation / 90) << 2)
+		| (mode == Qt::SmoothTransformation ? 16 : 0);
+	QVector<QPixmap>& frames = m_transformed[key];
+	if (frames.isEmpty())
+		frames.resize(m_frames.size());
+
+	//  MapTileItem::updateDisplayPixmap ʹͬı任
+	QPixmap& pixmap = frames[m_current];
+	if (pixmap.isNull())
+	{
+		QTransform transform;
+		if (flipX || flipY)
+			transform.scale(flipX ? -1 : 1, flipY ? -1 : 1);
+		if (rotation != 0)
+			transform.rotate(rotation);
+		pixmap = frame.transformed(transform, mode);
+	}
+	return pixmap;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QHash>
+#include <QPixmap>
+#include <QVector>
+
+// ƬڵͼϵĹ֡
+// - ͬһƬƬһݣƬָֻ룬֡ʱ޸Ƭ
+// - ֡ͼȫʱӰƬƽÿƬÿֻһ
+class MapTileAnimation
+{
+public:
+	// frames ŵƬߴ磬durations Ϊ֡ĳʱ䣨룩
+	MapTileAnimation(const QVector<QPixmap>& frames, const QVector<int>& durations);
+
+	int frameCount() const { return m_frames.size(); }
+	int currentFrame() const { return m_current; }
+
+	// ȫʱӶλǰ֡֡仯ʱ true
+	bool advanceTo(qint64 elapsedMs);
+
+	// ǰ֡ͼ񣺷ת/תĸɲ棨ͬһ任Ƭ
+	const QPixmap& currentPixmap(bool flipX, bool flipY, int rotation, Qt::TransformationMode mode) const;
+
+private:
+	QVector<QPixmap> m_frames;
+	QVector<qint64> m_frameEnds;    // ֡һѭڵĽʱ̣ۼƺ룩
+	qint64 m_length = 0;
+	int m_current = 0;
+
+	mutable QHash<int, QVector<QPixmap>> m_transformed;    // 任 -> ֡
+};
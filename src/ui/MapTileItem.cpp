@@ -1,4 +1,6 @@
 #include "MapTileItem.h"
+#include "MapLayerRoot.h"
+#include "MapTileAnimation.h"
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
 #include <QStyleOptionGraphicsItem>
@@ -25,8 +27,38 @@ MapTileItem::MapTileItem(const QPixmap& pixmap, const SpriteSlice& slice,
 
 void MapTileItem::setGridPos(int x, int y)
 {
-	m_gridX = x;
-	m_gridY = y;
+	const QPoint origin = gridOrigin();
+	m_gridX = x - origin.x();
+	m_gridY = y - origin.y();
+}
+
+QPoint MapTileItem::gridOrigin() const
+{
+	if (auto* root = qgraphicsitem_cast<const MapLayerRoot*>(parentItem()))
+		return root->gridOrigin();
+	return QPoint();
+}
+
+MapTileEvents* MapTileItem::tileEvents() const
+{
+	if (auto* root = qgraphicsitem_cast<const MapLayerRoot*>(parentItem()))
+		return root->tileEvents();
+	return nullptr;
+}
+
+void MapTileItem::setSlice(const SpriteSlice& slice, const QPixmap& pixmap)
+{
+	// ƬĬֵƬ£޸Ĺı
+	if (m_displayName == m_slice.name)
+		m_displayName = slice.name;
+	if (m_tags == m_slice.tags)
+		m_tags = slice.tags;
+	if (m_collisionType == m_slice.collisionType)
+		m_collisionType = slice.collisionType;
+
+	m_slice = slice;
+	m_originalPixmap = pixmap;
+	updateDisplayPixmap();
 }
 
 void MapTileItem::setSelected(bool selected)
@@ -36,7 +68,8 @@ void MapTileItem::setSelected(bool selected)
 
 	m_selected = selected;
 	update();
-	emit selectionChanged(this, selected);
+	if (MapTileEvents* events = tileEvents())
+		emit events->selectionChanged(this, selected);
 }
 
 CornerZone MapTileItem::detectCornerZone(const QPointF& localPos) const
@@ -120,8 +153,10 @@ void MapTileItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
 
 		if (zone != m_currentCornerZone)
 		{
+			// ֻػ仯
+			updateCorner(m_currentCornerZone);
 			m_currentCornerZone = zone;
-			update();  // »ʾ
+			updateCorner(zone);
 		}
 		updateCursorForZone(zone, shiftPressed);
 	}
@@ -130,14 +165,21 @@ void MapTileItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
 
 void MapTileItem::hoverLeaveEvent(QGraphicsSceneHoverEvent* event)
 {
+	updateCorner(m_currentCornerZone);
 	m_currentCornerZone = CornerZone::None;
 	unsetCursor();
-	update();
 	QGraphicsPixmapItem::hoverLeaveEvent(event);
 }
 
 void MapTileItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
 {
+	// ͼƬӦ¼ͼԪ
+	if (MapLayerRoot::isItemLocked(this))
+	{
+		event->ignore();
+		return;
+	}
+
 	if (event->button() == Qt::LeftButton)
 	{
 		m_dragStartPos = event->scenePos();
@@ -154,20 +196,23 @@ void MapTileItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
 				// Shift + ϶ = ɾģʽ
 				m_deleteDragging = true;
 				m_deleteStartCorner = zone;
-				emit deleteDragStarted(this, zone);
+				if (MapTileEvents* events = tileEvents())
+					emit events->deleteDragStarted(this, zone);
 			}
 			else
 			{
 				// ͨ϶ = ģʽ
 				m_copyDragging = true;
 				m_copyStartCorner = zone;
-				emit copyDragStarted(this, zone);
+				if (MapTileEvents* events = tileEvents())
+					emit events->copyDragStarted(this, zone);
 			}
 			event->accept();
 			return;
 		}
 
-		emit clicked(this);
+		if (MapTileEvents* events = tileEvents())
+			emit events->clicked(this);
 		event->accept();
 		return;
 	}
@@ -179,7 +224,8 @@ void MapTileItem::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
 	// ɾ϶
 	if (m_deleteDragging)
 	{
-		emit deleteDragMoved(this, event->scenePos());
+		if (MapTileEvents* events = tileEvents())
+			emit events->deleteDragMoved(this, event->scenePos());
 		event->accept();
 		return;
 	}
@@ -187,7 +233,8 @@ void MapTileItem::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
 	// 临϶
 	if (m_copyDragging)
 	{
-		emit copyDragMoved(this, event->scenePos());
+		if (MapTileEvents* events = tileEvents())
+			emit events->copyDragMoved(this, event->scenePos());
 		event->accept();
 		return;
 	}
@@ -206,7 +253,8 @@ void MapTileItem::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
 		if (!m_dragging && delta.manhattanLength() >= QApplication::startDragDistance())
 		{
 			m_dragging = true;
-			emit dragStarted(this);
+			if (MapTileEvents* events = tileEvents())
+				emit events->dragStarted(this);
 			setOpacity(0.7);  // ϶ʱ͸
 		}
 
@@ -228,7 +276,8 @@ void MapTileItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 		{
 			m_deleteDragging = false;
 			m_deleteStartCorner = CornerZone::None;
-			emit deleteDragFinished(this);
+			if (MapTileEvents* events = tileEvents())
+				emit events->deleteDragFinished(this);
 			event->accept();
 			return;
 		}
@@ -238,7 +287,8 @@ void MapTileItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 		{
 			m_copyDragging = false;
 			m_copyStartCorner = CornerZone::None;
-			emit copyDragFinished(this);
+			if (MapTileEvents* events = tileEvents())
+				emit events->copyDragFinished(this);
 			event->accept();
 			return;
 		}
@@ -248,7 +298,8 @@ void MapTileItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 		{
 			m_dragging = false;
 			setOpacity(1.0);  // ָ͸
-			emit dragFinished(this, event->scenePos());
+			if (MapTileEvents* events = tileEvents())
+				emit events->dragFinished(this, event->scenePos());
 			event->accept();
 			return;
 		}
@@ -258,8 +309,20 @@ void MapTileItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 
 void MapTileItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
 {
-	// ȻԭʼͼƬ
-	QGraphicsPixmapItem::paint(painter, option, widget);
+	// ȻԭʼͼƬƬƹĵǰ֡һ֡ͼԪԼ pixmap
+	// ڷֿɷֿդʱѡеƬդʼԼƣ
+	if (m_selected || !MapLayerRoot::isItemRasterized(this))
+	{
+		if (m_animation && m_animation->currentFrame() != 0)
+		{
+			painter->setRenderHint(QPainter::SmoothPixmapTransform, transformationMode() == Qt::SmoothTransformation);
+			painter->drawPixmap(offset(), m_animation->currentPixmap(m_flipX, m_flipY, m_rotation, transformationMode()));
+		}
+		else
+		{
+			QGraphicsPixmapItem::paint(painter, option, widget);
+		}
+	}
 
 	// ѡУƸ߿
 	if (m_selected)
@@ -276,11 +339,10 @@ void MapTileItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* optio
 		painter->drawRect(rect);
 
 		// ĽǱ
-		const qreal cornerSize = CORNER_DRAW_SIZE;
 		painter->setPen(Qt::NoPen);
 
 		// ݵǰͣĽòͬɫ
-		auto drawCorner = [&](QRectF cornerRect, CornerZone zone) {
+		auto drawCorner = [&](CornerZone zone) {
 			if (m_currentCornerZone == zone)
 			{
 				// ͣʱʹøɫ
@@ -290,22 +352,45 @@ void MapTileItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* optio
 			{
 				painter->setBrush(QBrush(QColor(80, 140, 255)));
 			}
-			painter->drawRect(cornerRect);
+			painter->drawRect(cornerRect(zone));
 			};
 
-		// Ͻ
-		drawCorner(QRectF(rect.left(), rect.top(), cornerSize, cornerSize), CornerZone::TopLeft);
-		// Ͻ
-		drawCorner(QRectF(rect.right() - cornerSize, rect.top(), cornerSize, cornerSize), CornerZone::TopRight);
-		// ½
-		drawCorner(QRectF(rect.left(), rect.bottom() - cornerSize, cornerSize, cornerSize), CornerZone::BottomLeft);
-		// ½
-		drawCorner(QRectF(rect.right() - cornerSize, rect.bottom() - cornerSize, cornerSize, cornerSize), CornerZone::BottomRight);
+		drawCorner(CornerZone::TopLeft);
+		drawCorner(CornerZone::TopRight);
+		drawCorner(CornerZone::BottomLeft);
+		drawCorner(CornerZone::BottomRight);
 
 		painter->restore();
 	}
 }
 
+QRectF MapTileItem::cornerRect(CornerZone zone) const
+{
+	const QRectF rect = boundingRect().adjusted(0.5, 0.5, -0.5, -0.5);
+	const qreal size = CORNER_DRAW_SIZE;
+
+	switch (zone)
+	{
+	case CornerZone::TopLeft:
+		return QRectF(rect.left(), rect.top(), size, size);
+	case CornerZone::TopRight:
+		return QRectF(rect.right() - size, rect.top(), size, size);
+	case CornerZone::BottomLeft:
+		return QRectF(rect.left(), rect.bottom() - size, size, size);
+	case CornerZone::BottomRight:
+		return QRectF(rect.right() - size, rect.bottom() - size, size, size);
+	default:
+		return QRectF();
+	}
+}
+
+void MapTileItem::updateCorner(CornerZone zone)
+{
+	// update() վλػͼԪҪ
+	if (zone != CornerZone::None)
+		update(cornerRect(zone));
+}
+
 // ============== ת ==============
 
 void MapTileItem::setFlipX(bool flip)
@@ -362,7 +447,7 @@ void MapTileItem::updateDisplayPixmap()
 			transform.rotate(m_rotation);
 		}
 
-		displayPixmap = m_originalPixmap.transformed(transform, Qt::SmoothTransformation);
+		displayPixmap = m_originalPixmap.transformed(transform, transformationMode());
 	}
 
 	setPixmap(displayPixmap);
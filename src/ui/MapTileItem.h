@@ -5,6 +5,7 @@
 #include "core/SpriteSliceDefine.h"
 
 class MapViewWidget;
+class MapTileAnimation;
 
 // ö
 enum class CornerZone
@@ -16,7 +17,34 @@ enum class CornerZone
 	BottomRight
 };
 
-// ͼϵƬͼԪ
+class MapTileItem;
+
+// ƬźţͬһͼƬһ󣨹ͼڵϣͼֻһΣ
+// ƬʱҪź
+class MapTileEvents : public QObject
+{
+	Q_OBJECT
+public:
+	using QObject::QObject;
+
+signals:
+	void clicked(MapTileItem* item);
+	void selectionChanged(MapTileItem* item, bool selected);
+	void dragStarted(MapTileItem* item);
+	void dragFinished(MapTileItem* item, const QPointF& scenePos);
+
+	// 临ź
+	void copyDragStarted(MapTileItem* item, CornerZone corner);
+	void copyDragMoved(MapTileItem* item, const QPointF& scenePos);
+	void copyDragFinished(MapTileItem* item);
+
+	// ɾźţShift + ק
+	void deleteDragStarted(MapTileItem* item, CornerZone corner);
+	void deleteDragMoved(MapTileItem* item, const QPointF& scenePos);
+	void deleteDragFinished(MapTileItem* item);
+};
+
+// ͼϵƬͼԪźžͼڵ MapTileEvents 
 class MapTileItem : public QObject, public QGraphicsPixmapItem
 {
 	Q_OBJECT
@@ -24,16 +52,25 @@ public:
 	MapTileItem(const QPixmap& pixmap, const SpriteSlice& slice,
 		int gridX, int gridY, int layer, QGraphicsItem* parent = nullptr);
 
-	// 
-	int gridX() const { return m_gridX; }
-	int gridY() const { return m_gridY; }
+	// ꣨߼ =  + ͼڵԭ㣩
+	int gridX() const { return m_gridX + gridOrigin().x(); }
+	int gridY() const { return m_gridY + gridOrigin().y(); }
 	void setGridPos(int x, int y);
 
+	// ͼڵı꣨ʹãԭƽʱ䣩
+	int localGridX() const { return m_gridX; }
+	int localGridY() const { return m_gridY; }
+
 	// Ƭ
 	const SpriteSlice& slice() const { return m_slice; }
+	void setSlice(const SpriteSlice& slice, const QPixmap& pixmap);   // 滻Ƭ/滻ã
 	QString tilesetId() const { return m_tilesetId; }
 	void setTilesetId(const QString& id) { m_tilesetId = id; }
 
+	// ƬĹ֡ͼУ̬ƬΪգ
+	const MapTileAnimation* animation() const { return m_animation; }
+	void setAnimation(const MapTileAnimation* animation) { m_animation = animation; }
+
 	// ռõ
 	int gridWidth() const { return m_gridWidth; }
 	int gridHeight() const { return m_gridHeight; }
@@ -86,22 +123,6 @@ public:
 	// ȡԭʼ pixmapڸƣ
 	QPixmap originalPixmap() const { return m_originalPixmap; }
 
-signals:
-	void clicked(MapTileItem* item);
-	void selectionChanged(MapTileItem* item, bool selected);
-	void dragStarted(MapTileItem* item);
-	void dragFinished(MapTileItem* item, const QPointF& scenePos);
-
-	// 临ź
-	void copyDragStarted(MapTileItem* item, CornerZone corner);
-	void copyDragMoved(MapTileItem* item, const QPointF& scenePos);
-	void copyDragFinished(MapTileItem* item);
-
-	// ɾźţShift + ק
-	void deleteDragStarted(MapTileItem* item, CornerZone corner);
-	void deleteDragMoved(MapTileItem* item, const QPointF& scenePos);
-	void deleteDragFinished(MapTileItem* item);
-
 protected:
 	void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
 	void mouseMoveEvent(QGraphicsSceneMouseEvent* event) override;
@@ -112,9 +133,19 @@ protected:
 	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
 
 private:
+	// ͼڵԭ
+	QPoint gridOrigin() const;
+
+	// ͼڵźŶδҵڵʱΪգ
+	MapTileEvents* tileEvents() const;
+
 	// λöӦĽ
 	CornerZone detectCornerZone(const QPointF& localPos) const;
 
+	// ǵĻƷΧͣ仯ʱֻػһ飩
+	QRectF cornerRect(CornerZone zone) const;
+	void updateCorner(CornerZone zone);
+
 	// 
 	void updateCursorForZone(CornerZone zone, bool shiftPressed = false);
 
@@ -124,7 +155,8 @@ private:
 private:
 	SpriteSlice m_slice;
 	QString m_tilesetId;
-	int m_gridX = 0;
+	const MapTileAnimation* m_animation = nullptr;
+	int m_gridX = 0;                // 
 	int m_gridY = 0;
 	int m_gridWidth = 1;
 	int m_gridHeight = 1;
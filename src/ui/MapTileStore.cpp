@@ -0,0 +1,236 @@
+#include "MapTileStore.h"
+#include "MapTileItem.h"
+
+#include <algorithm>
+
+quint64 MapTileStore::cellKey(int gridX, int gridY)
+{
+	//  32 λ X 32 λ Yз갴λ棩
+	return (static_cast<quint64>(static_cast<quint32>(gridX)) << 32)
+		| static_cast<quint64>(static_cast<quint32>(gridY));
+}
+
+void MapTileStore::insert(MapTileItem* tile)
+{
+	if (!tile)
+		return;
+
+	LayerTiles& layer = m_layers[tile->layer()];
+	if (layer.indexOf.contains(tile))
+		return;
+
+	layer.indexOf.insert(tile, layer.tiles.size());
+	layer.tiles.append(tile);
+	indexCells(layer, tile);
+	m_sliceUsers[tile->slice().id].insert(tile);
+	++m_usageDelta[tile->slice().id];
+	++m_size;
+}
+
+void MapTileStore::remove(MapTileItem* tile)
+{
+	auto layerIt = m_layers.find(tile->layer());
+	if (layerIt == m_layers.end())
+		return;
+
+	LayerTiles& layer = layerIt.value();
+	auto it = layer.indexOf.find(tile);
+	if (it == layer.indexOf.end())
+		return;
+
+	// ĩβɾƶ
+	const int index = it.value();
+	layer.indexOf.erase(it);
+
+	MapTileItem* last = layer.tiles.takeLast();
+	if (last != tile)
+	{
+		layer.tiles[index] = last;
+		layer.indexOf[last] = index;
+	}
+
+	unindexCells(layer, tile);
+	unlinkSlice(tile);
+	--m_size;
+
+	if (layer.tiles.isEmpty())
+		m_layers.erase(layerIt);
+}
+
+void MapTileStore::clear()
+{
+	for (auto it = m_sliceUsers.constBegin(); it != m_sliceUsers.constEnd(); ++it)
+		m_usageDelta[it.key()] -= it->size();
+
+	m_layers.clear();
+	m_sliceUsers.clear();
+	m_size = 0;
+}
+
+bool MapTileStore::contains(MapTileItem* tile) const
+{
+	auto it = m_layers.constFind(tile->layer());
+	return it != m_layers.constEnd() && it->indexOf.contains(tile);
+}
+
+QVector<MapTileItem*> MapTileStore::tiles() const
+{
+	QVector<MapTileItem*> result;
+	result.reserve(m_size);
+	for (int layer : layers())
+		result += m_layers.constFind(layer)->tiles;
+	return result;
+}
+
+const QVector<MapTileItem*>& MapTileStore::layerTiles(int layer) const
+{
+	static const QVector<MapTileItem*> empty;
+	auto it = m_layers.constFind(layer);
+	return it == m_layers.constEnd() ? empty : it->tiles;
+}
+
+int MapTileStore::layerSize(int layer) const
+{
+	auto it = m_layers.constFind(layer);
+	return it == m_layers.constEnd() ? 0 : it->tiles.size();
+}
+
+QVector<MapTileItem*> MapTileStore::takeLayer(int layer)
+{
+	auto it = m_layers.find(layer);
+	if (it == m_layers.end())
+		return QVector<MapTileItem*>();
+
+	QVector<MapTileItem*> tiles = std::move(it->tiles);
+	m_layers.erase(it);
+
+	// ƬֻעͼƬ
+	for (MapTileItem* tile : tiles)
+		unlinkSlice(tile);
+	m_size -= tiles.size();
+	return tiles;
+}
+
+MapTileItem* MapTileStore::tileAt(int layer, int gridX, int gridY) const
+{
+	auto it = m_layers.constFind(layer);
+	if (it == m_layers.constEnd())
+		return nullptr;
+	return it->cells.value(cellKey(gridX - m_origin.x(), gridY - m_origin.y()), nullptr);
+}
+
+QSet<MapTileItem*> MapTileStore::tilesInRect(const QRect& gridRect, int layer) const
+{
+	QSet<MapTileItem*> result;
+	if (gridRect.isEmpty())
+		return result;
+
+	const QRect localRect = gridRect.translated(-m_origin);
+	auto collect = [&result, &localRect](const LayerTiles& tiles) {
+		for (int gy = localRect.top(); gy <= localRect.bottom(); ++gy)
+		{
+			for (int gx = localRect.left(); gx <= localRect.right(); ++gx)
+			{
+				auto range = tiles.cells.equal_range(cellKey(gx, gy));
+				for (auto it = range.first; it != range.second; ++it)
+					result.insert(it.value());
+			}
+		}
+	};
+
+	if (layer >= 0)
+	{
+		auto it = m_layers.constFind(layer);
+		if (it != m_layers.constEnd())
+			collect(it.value());
+	}
+	else
+	{
+		for (const LayerTiles& tiles : m_layers)
+			collect(tiles);
+	}
+	return result;
+}
+
+QVector<MapTileItem*> MapTileStore::tilesAnchoredInRect(const QRect& gridRect) const
+{
+	QVector<MapTileItem*> result;
+	if (gridRect.isEmpty())
+		return result;
+
+	for (MapTileItem* tile : tilesInRect(gridRect))
+	{
+		if (gridRect.contains(tile->gridX(), tile->gridY()))
+			result.append(tile);
+	}
+
+	// ͼ㡢С򣬱֤ȶ
+	std::sort(result.begin(), result.end(), [](const MapTileItem* a, const MapTileItem* b) {
+		if (a->layer() != b->layer()) return a->layer() < b->layer();
+		if (a->gridY() != b->gridY()) return a->gridY() < b->gridY();
+		return a->gridX() < b->gridX();
+		});
+	return result;
+}
+
+QVector<int> MapTileStore::layers() const
+{
+	QVector<int> result = m_layers.keys();
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+int MapTileStore::sliceUsageCount(const QUuid& sliceId) const
+{
+	auto it = m_sliceUsers.constFind(sliceId);
+	return it == m_sliceUsers.constEnd() ? 0 : it->size();
+}
+
+QHash<QUuid, int> MapTileStore::takeUsageDelta()
+{
+	QHash<QUuid, int> delta = std::move(m_usageDelta);
+	m_usageDelta.clear();
+	return delta;
+}
+
+QHash<QUuid, int> MapTileStore::sliceUsage() const
+{
+	QHash<QUuid, int> usage;
+	usage.reserve(m_sliceUsers.size());
+	for (auto it = m_sliceUsers.constBegin(); it != m_sliceUsers.constEnd(); ++it)
+		usage.insert(it.key(), it->size());
+	return usage;
+}
+
+void MapTileStore::indexCells(LayerTiles& layer, MapTileItem* tile)
+{
+	for (int dy = 0; dy < tile->gridHeight(); ++dy)
+	{
+		for (int dx = 0; dx < tile->gridWidth(); ++dx)
+		{
+			layer.cells.insert(cellKey(tile->localGridX() + dx, tile->localGridY() + dy), tile);
+		}
+	}
+}
+
+void MapTileStore::unindexCells(LayerTiles& layer, MapTileItem* tile)
+{
+	for (int dy = 0; dy < tile->gridHeight(); ++dy)
+	{
+		for (int dx = 0; dx < tile->gridWidth(); ++dx)
+		{
+			layer.cells.remove(cellKey(tile->localGridX() + dx, tile->localGridY() + dy), tile);
+		}
+	}
+}
+
+void MapTileStore::unlinkSlice(MapTileItem* tile)
+{
+	auto users = m_sliceUsers.find(tile->slice().id);
+	if (users != m_sliceUsers.end() && users->remove(tile))
+	{
+		--m_usageDelta[tile->slice().id];
+		if (users->isEmpty())
+			m_sliceUsers.erase(users);
+	}
+}
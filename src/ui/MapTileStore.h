@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QHash>
+#include <QMultiHash>
+#include <QPoint>
+#include <QRect>
+#include <QSet>
+#include <QUuid>
+#include <QVector>
+
+class MapTileItem;
+
+// ѷƬĴ洢
+// - ÿͼһƽб + ռͼɾϲֻͼԼƬ
+// - ռ -> Ƭɨ
+// - ƬƬ ID -> ʹƬ/滻ʹü
+class MapTileStore
+{
+public:
+	// ԭ㣺걣棬ѯʱԭ㻻㣬ԭƽؽ
+	QPoint origin() const { return m_origin; }
+	void setOrigin(const QPoint& origin) { m_origin = origin; }
+
+	// Ǽ / עƬƬλáߴ硢ͼڵǰúã
+	void insert(MapTileItem* tile);
+	void remove(MapTileItem* tile);
+	void clear();
+
+	bool contains(MapTileItem* tile) const;
+	int size() const { return m_size; }
+	bool isEmpty() const { return m_size == 0; }
+
+	// ͼƬͼƴӣһб
+	QVector<MapTileItem*> tiles() const;
+
+	// ͼƬбڼ䲻ɾƬ
+	template<typename Visitor>
+	void forEachTile(Visitor&& visitor) const
+	{
+		for (const LayerTiles& layer : m_layers)
+		{
+			for (MapTileItem* tile : layer.tiles)
+				visitor(tile);
+		}
+	}
+
+	// ͼƬ
+	const QVector<MapTileItem*>& layerTiles(int layer) const;
+	int layerSize(int layer) const;
+
+	// Ƴͼ㣩ظͼƬ
+	QVector<MapTileItem*> takeLayer(int layer);
+
+	// ²ѯʹ߼
+	// ָϵƬصʱõģ
+	MapTileItem* tileAt(int layer, int gridX, int gridY) const;
+
+	// ָεƬlayer < 0 ʾͼ㣩
+	QSet<MapTileItem*> tilesInRect(const QRect& gridRect, int layer = -1) const;
+
+	// ԭλھڵƬãظ
+	QVector<MapTileItem*> tilesAnchoredInRect(const QRect& gridRect) const;
+
+	// ǰƬͼ
+	QVector<int> layers() const;
+
+	// ʹָƬƬ
+	QSet<MapTileItem*> tilesUsingSlice(const QUuid& sliceId) const { return m_sliceUsers.value(sliceId); }
+	int sliceUsageCount(const QUuid& sliceId) const;
+
+	// Ƭʹô
+	QHash<QUuid, int> sliceUsage() const;
+
+	// ϴȡƬʹôı仯Ǽ / עʱ淴һۼƣƬ
+	QHash<QUuid, int> takeUsageDelta();
+
+private:
+	// ͼ
+	struct LayerTiles
+	{
+		QVector<MapTileItem*> tiles;
+		QHash<MapTileItem*, int> indexOf;           // Ƭ -> ƽб±꣨O(1) ɾ
+		QMultiHash<quint64, MapTileItem*> cells;    //  -> Ƭ
+	};
+
+	static quint64 cellKey(int gridX, int gridY);
+
+	void indexCells(LayerTiles& layer, MapTileItem* tile);
+	void unindexCells(LayerTiles& layer, MapTileItem* tile);
+	void unlinkSlice(MapTileItem* tile);
+
+private:
+	QHash<int, LayerTiles> m_layers;              // ͼ -> 
+	QHash<QUuid, QSet<MapTileItem*>> m_sliceUsers; // Ƭ -> ʹƬ
+	QHash<QUuid, int> m_usageDelta;               // δȡʹô仯
+	int m_size = 0;
+	QPoint m_origin;                              // ߼ =  + ԭ
+};
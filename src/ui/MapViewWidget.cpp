@@ -1,15 +1,28 @@
 #include "MapViewWidget.h"
 #include "MapTileItem.h"
+#include "MapPrefabItem.h"
+#include "MapLayerRoot.h"
+#include "MapCollisionOverlay.h"
+#include "MapNavOverlay.h"
 #include "app/AppContext.h"
 #include "app/DocumentManager.h"
 #include "core/TileDragData.h"
 
+#include <QClipboard>
+#include <QCursor>
 #include <QDragEnterEvent>
 #include <QDragMoveEvent>
 #include <QDropEvent>
+#include <QElapsedTimer>
+#include <QGuiApplication>
 #include <QKeyEvent>
+#include <QMimeData>
+#include <QPainter>
+#include <QResizeEvent>
 #include <QScrollBar>
+#include <QTimer>
 #include <QtMath>
+#include <algorithm>
 
 MapViewWidget::MapViewWidget(QWidget* parent)
 	: QGraphicsView(parent)
@@ -25,7 +38,12 @@ MapViewWidget::MapViewWidget(QWidget* parent)
 
 	// Ⱦѡ
 	setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
-	setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+
+	// ֻػͼԪʧЧƽʱأֻ¶
+	// ޵ͼ񣩻һƶʱԶؽ
+	setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+	setCacheMode(QGraphicsView::CacheBackground);
+	viewport()->setAttribute(Qt::WA_OpaquePaintEvent, true);
 	setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
 	setResizeAnchor(QGraphicsView::AnchorViewCenter);
 
@@ -33,7 +51,26 @@ MapViewWidget::MapViewWidget(QWidget* parent)
 	setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 	setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 
+	// Ƭĵ϶źžͼڵ㹲õĶ󷢳ֻһΣͼڵ㴴ǰ
+	m_tileEvents = new MapTileEvents(this);
+	connect(m_tileEvents, &MapTileEvents::clicked, this, &MapViewWidget::onTileClicked);
+	connect(m_tileEvents, &MapTileEvents::dragStarted, this, &MapViewWidget::onTileDragStarted);
+	connect(m_tileEvents, &MapTileEvents::dragFinished, this, &MapViewWidget::onTileDragFinished);
+	connect(m_tileEvents, &MapTileEvents::copyDragStarted, this, &MapViewWidget::onCopyDragStarted);
+	connect(m_tileEvents, &MapTileEvents::copyDragMoved, this, &MapViewWidget::onCopyDragMoved);
+	connect(m_tileEvents, &MapTileEvents::copyDragFinished, this, &MapViewWidget::onCopyDragFinished);
+	connect(m_tileEvents, &MapTileEvents::deleteDragStarted, this, &MapViewWidget::onDeleteDragStarted);
+	connect(m_tileEvents, &MapTileEvents::deleteDragMoved, this, &MapViewWidget::onDeleteDragMoved);
+	connect(m_tileEvents, &MapTileEvents::deleteDragFinished, this, &MapViewWidget::onDeleteDragFinished);
+
 	setupScene();
+	syncLayers();
+
+	// ƬȫʱӣжƬʱУ
+	m_animationTimer.setInterval(ANIMATION_TICK_MS);
+	connect(&m_animationTimer, &QTimer::timeout, this, &MapViewWidget::advanceAnimations);
+
+	connect(&m_chunkCache, &MapChunkCache::chunkLoaded, this, &MapViewWidget::onChunkLoaded);
 }
 
 MapViewWidget::~MapViewWidget()
@@ -56,6 +93,28 @@ void MapViewWidget::setupScene()
 	m_dropHighlight->setVisible(false);
 	m_scene->addItem(m_dropHighlight);
 
+	// ѡʼأ
+	m_regionHighlight = new QGraphicsRectItem();
+	m_regionHighlight->setPen(QPen(QColor(80, 140, 255), 1, Qt::DashLine));
+	m_regionHighlight->setBrush(QBrush(QColor(80, 140, 255, 30)));
+	m_regionHighlight->setZValue(997);
+	m_regionHighlight->setVisible(false);
+	m_scene->addItem(m_regionHighlight);
+
+	// ײԤʼأ
+	m_collisionOverlay = new MapCollisionOverlay(&m_collisionBaker);
+	m_collisionOverlay->setVisible(false);
+	m_scene->addItem(m_collisionOverlay);
+
+	// Ѱ·Ԥ
+	m_navOverlay = new MapNavOverlay();
+	m_scene->addItem(m_navOverlay);
+
+	// Сͼķֿͼ㣨ʼأ
+	m_lodLayer = new MapLodLayer();
+	m_lodLayer->setSnapshotProvider([this](const QPoint& chunk, int divisor) { return snapshotLodChunk(chunk, divisor); });
+	m_scene->addItem(m_lodLayer);
+
 	// ʼ
 	drawGrid();
 }
@@ -74,12 +133,29 @@ void MapViewWidget::updateMap()
 	m_tileHeight = doc->tileHeight;
 	m_mapWidth = doc->width;
 	m_mapHeight = doc->height;
+	setInfiniteMode(doc->infinite);
+	setRenderProfile(doc->renderProfile);
+
+	// ͼбǰͼ㲻ĵʱеײ
+	m_layers = doc->layers;
+	m_nextLayerId = doc->nextLayerId;
+	m_layerTargets.clear();
+	m_layerIndex.clear();
+	for (int i = 0; i < m_layers.size(); ++i)
+		m_layerIndex.insert(m_layers[i].id, i);
+	if (!hasLayer(m_currentLayer) && !m_layers.isEmpty())
+		setCurrentLayer(m_layers.first().id);
+	syncLayers();
+	for (MapLayerRoot* root : m_layerRoots)
+		applyLayerState(root);
+	m_lodLayer->clear();
 
 	// ػ
 	drawGrid();
 
 	// óС
-	m_scene->setSceneRect(0, 0, m_mapWidth * m_tileWidth, m_mapHeight * m_tileHeight);
+	if (!m_infinite)
+		m_scene->setSceneRect(0, 0, m_mapWidth * m_tileWidth, m_mapHeight * m_tileHeight);
 
 	// ź֪ͨ UI 
 	emit gridSizeChanged(m_tileWidth, m_tileHeight);
@@ -90,12 +166,23 @@ void MapViewWidget::drawGrid()
 {
 	clearGrid();
 
+	// ޵ͼ drawBackground аɼΧƣ㹻Աƽ
+	if (m_infinite)
+	{
+		const qreal extent = INFINITE_SCENE_EXTENT;
+		m_scene->setSceneRect(-extent, -extent, extent * 2, extent * 2);
+		m_lodLayer->setSceneBounds(m_scene->sceneRect());
+		resetCachedContent();
+		return;
+	}
+
 	int totalWidth = m_mapWidth * m_tileWidth;
 	int totalHeight = m_mapHeight * m_tileHeight;
 
 	if (m_gridVisible)
 	{
 		QPen gridPen(QColor(220, 220, 225), 1);
+		gridPen.setCosmetic(m_renderProfile == MapRenderProfile::PixelArt);
 
 		// ֱ
 		for (int col = 0; col <= m_mapWidth; ++col)
@@ -124,6 +211,7 @@ void MapViewWidget::drawGrid()
 
 	// ³
 	m_scene->setSceneRect(-50, -50, totalWidth + 100, totalHeight + 100);
+	m_lodLayer->setSceneBounds(QRectF(0, 0, totalWidth, totalHeight));
 }
 
 void MapViewWidget::clearGrid()
@@ -178,18 +266,94 @@ void MapViewWidget::setGridSize(int width, int height)
 		}
 	}
 
+	// ڵλðµĸӳߴ绻
+	setGridOrigin(m_gridOrigin);
+	m_collisionOverlay->setTileSize(width, height);
+	m_navOverlay->setTileSize(width, height);
+	m_lodLayer->setTileSize(width, height);
+
 	drawGrid();
 	emit gridSizeChanged(width, height);
 }
 
 void MapViewWidget::setMapSize(int width, int height)
 {
-	if (m_mapWidth == width && m_mapHeight == height)
+	// ײߴ룺ϽǲƬ
+	resizeMap(width, height, Qt::AlignLeft | Qt::AlignTop, false);
+}
+
+void MapViewWidget::resizeMap(int width, int height, Qt::Alignment anchor, bool dropOutOfBounds)
+{
+	// ޵ͼûб߽
+	if (m_infinite)
 		return;
 
+	width = qMax(1, width);
+	height = qMax(1, height);
+
+	// êݵƽ
+	int dx = 0;
+	int dy = 0;
+	if (anchor & Qt::AlignRight)
+		dx = width - m_mapWidth;
+	else if (anchor & Qt::AlignHCenter)
+		dx = (width - m_mapWidth) / 2;
+
+	if (anchor & Qt::AlignBottom)
+		dy = height - m_mapHeight;
+	else if (anchor & Qt::AlignVCenter)
+		dy = (height - m_mapHeight) / 2;
+
+	if (dx == 0 && dy == 0 && width == m_mapWidth && height == m_mapHeight)
+		return;
+
+	const QRect oldBounds(dx, dy, m_mapWidth, m_mapHeight);
+	const QRect newBounds(0, 0, width, height);
+
+	// ƽԭ㣺ÿͼڵֻƶһΣƬҪĶ
+	if (dx != 0 || dy != 0)
+		setGridOrigin(m_gridOrigin + QPoint(dx, dy));
+
 	m_mapWidth = width;
 	m_mapHeight = height;
 
+	// ֻԭݿܳ·ΧʱҪ
+	int dropped = 0;
+	if (dropOutOfBounds && !newBounds.contains(oldBounds))
+	{
+		QVector<MapTileItem*> outside;
+		m_tileStore.forEachTile([&](MapTileItem* tile) {
+			if (!newBounds.contains(QRect(tile->gridX(), tile->gridY(), tile->gridWidth(), tile->gridHeight())))
+				outside.append(tile);
+			});
+		for (MapTileItem* tile : outside)
+			destroyTileItem(tile);
+		dropped = outside.size();
+
+		if (m_ctx)
+		{
+			QVector<QUuid> outsideInstances;
+			for (auto it = m_prefabInstances.constBegin(); it != m_prefabInstances.constEnd(); ++it)
+			{
+				const PrefabDefinition* prefab = m_ctx->prefabLibrary.prefab(it->prefabId);
+				if (prefab && !newBounds.contains(QRect(instanceOrigin(*it),
+					QSize(prefab->content.width, prefab->content.height))))
+					outsideInstances.append(it.key());
+			}
+			for (const QUuid& instanceId : outsideInstances)
+				removePrefabInstance(instanceId);
+			dropped += outsideInstances.size();
+		}
+	}
+
+	// Խ¾ɱ߽ʵΧƬʹôͳ
+	for (auto it = m_prefabInstances.constBegin(); it != m_prefabInstances.constEnd(); ++it)
+	{
+		const QRect rect = instanceRect(*it);
+		if (!oldBounds.contains(rect) || !newBounds.contains(rect))
+			refreshInstanceUsage(it.key());
+	}
+
 	//  MapDocument
 	if (m_ctx)
 	{
@@ -201,860 +365,3525 @@ void MapViewWidget::setMapSize(int width, int height)
 		}
 	}
 
+	// ѡƽ
+	if (!m_selectedRegion.isEmpty())
+		setSelectedRegion(m_selectedRegion.translated(dx, dy));
+
 	drawGrid();
-	m_scene->setSceneRect(-50, -50, m_mapWidth * m_tileWidth + 100, m_mapHeight * m_tileHeight + 100);
 	emit mapSizeChanged(width, height);
+
+	qDebug() << "Map resized to:" << width << "x" << height
+		<< "shift:" << dx << "," << dy << "dropped:" << dropped;
 }
 
-void MapViewWidget::setCurrentLayer(int layer)
+MapLayerRoot* MapViewWidget::layerRoot(int layer)
 {
-	if (m_currentLayer == layer)
+	auto it = m_layerRoots.find(layer);
+	if (it != m_layerRoots.end())
+		return it.value();
+
+	auto* root = new MapLayerRoot(layer);
+	root->setGridOrigin(m_gridOrigin, m_tileWidth, m_tileHeight);
+	root->setLodHidden(m_lodLevel != MapLodLevel::Full);
+	root->setChunkRaster(m_lodLayer);
+	root->setTileEvents(m_tileEvents);
+	root->setZValue(10 + layerOrder(layer));
+	applyLayerState(root);
+	m_scene->addItem(root);
+	m_layerRoots.insert(layer, root);
+	return root;
+}
+
+// ============== ͼ״̬ ==============
+
+void MapViewWidget::setLayerVisible(int layer, bool visible)
+{
+	if (!hasLayer(layer))
 		return;
 
-	m_currentLayer = layer;
+	MapLayerState state = layerState(layer);
+	if (state.visible == visible)
+		return;
 
-	// лͼʱǰѡеƬͼ㣬ȡѡ
-	if (m_selectedTile && m_selectedTile->layer() != layer)
-	{
-		clearSelection();
-	}
+	state.visible = visible;
+	storeLayerState(layer, state);
+	if (!visible)
+		releaseLayerSelection(layer);
 
-	qDebug() << "Current layer changed to:" << layer;
+	qDebug() << "Layer" << layer << (visible ? "shown" : "hidden");
 }
 
-int MapViewWidget::zoomPercent() const
+void MapViewWidget::setLayerLocked(int layer, bool locked)
 {
-	return static_cast<int>(m_currentScale * 100);
+	if (!hasLayer(layer))
+		return;
+
+	MapLayerState state = layerState(layer);
+	if (state.locked == locked)
+		return;
+
+	state.locked = locked;
+	storeLayerState(layer, state);
+	if (locked)
+		releaseLayerSelection(layer);
+
+	qDebug() << "Layer" << layer << (locked ? "locked" : "unlocked");
 }
 
-void MapViewWidget::setZoomPercent(int percent)
+void MapViewWidget::setLayerOpacity(int layer, double opacity)
 {
-	double newScale = percent / 100.0;
-	if (qFuzzyCompare(m_currentScale, newScale))
+	if (!hasLayer(layer))
 		return;
 
-	resetTransform();
-	m_currentScale = newScale;
-	scale(m_currentScale, m_currentScale);
+	MapLayerState state = layerState(layer);
+	opacity = qBound(0.0, opacity, 1.0);
+	if (qFuzzyCompare(state.opacity, opacity))
+		return;
+
+	state.opacity = opacity;
+	storeLayerState(layer, state);
 
-	emit zoomChanged(percent);
+	qDebug() << "Layer" << layer << "opacity:" << opacity;
 }
 
-void MapViewWidget::applyZoom(double scaleFactor)
+MapLayerState MapViewWidget::layerState(int layer) const
+{
+	const int index = layerOrder(layer);
+	return index >= 0 ? m_layers[index].state : MapLayerState();
+}
+
+void MapViewWidget::storeLayerState(int layer, const MapLayerState& state)
 {
-	m_currentScale *= scaleFactor;
-	m_currentScale = qBound(0.1, m_currentScale, 4.0);
+	m_layers[layerOrder(layer)].state = state;
+	syncLayers();
 
-	resetTransform();
-	scale(m_currentScale, m_currentScale);
+	// ֻĸڵ㣬Ƭ
+	applyLayerState(layerRoot(layer));
 
-	emit zoomChanged(static_cast<int>(m_currentScale * 100));
+	// Сͼͼ״̬ϳɣҪ
+	m_lodLayer->clear();
 }
 
-// ============== ѡ ==============
-
-void MapViewWidget::clearSelection()
+void MapViewWidget::applyLayerState(MapLayerRoot* root)
 {
-	if (m_selectedTile)
-	{
-		m_selectedTile->setSelected(false);
-		m_selectedTile = nullptr;
-		emit tileDeselected();
-	}
+	const MapLayerState state = layerState(root->layer());
+	root->setLayerVisible(state.visible);
+	root->setLocked(state.locked);
+	root->setLayerOpacity(state.opacity);
 }
 
-void MapViewWidget::selectTile(MapTileItem* tile)
+void MapViewWidget::releaseLayerSelection(int layer)
 {
-	if (m_selectedTile == tile)
+	if (m_selectedTile && m_selectedTile->layer() == layer)
+		clearSelection();
+
+	auto it = m_prefabInstances.constFind(m_selectedPrefabInstance);
+	if (it == m_prefabInstances.constEnd())
 		return;
 
-	// ȡ֮ǰѡ
-	if (m_selectedTile)
+	for (const MapPrefabItem* item : it->items)
 	{
-		m_selectedTile->setSelected(false);
+		if (item->layer() == layer)
+		{
+			selectPrefabInstance(QUuid());
+			return;
+		}
 	}
+}
 
-	m_selectedTile = tile;
-
-	if (tile)
-	{
-		tile->setSelected(true);
-		emit tileSelected(tile);
-		qDebug() << "Selected tile:" << tile->slice().name
-			<< "at grid:" << tile->gridX() << "," << tile->gridY()
-			<< "layer:" << tile->layer();
-	}
-	else
+QGraphicsItem* MapViewWidget::editableItemAt(const QPointF& scenePos) const
+{
+	// ֻ鸸ڵϵı
+	const QList<QGraphicsItem*> hits = m_scene->items(scenePos, Qt::IntersectsItemShape, Qt::DescendingOrder, transform());
+	for (QGraphicsItem* item : hits)
 	{
-		emit tileDeselected();
+		if (!MapLayerRoot::isItemLocked(item))
+			return item;
 	}
+	return nullptr;
 }
 
-void MapViewWidget::onTileClicked(MapTileItem* tile)
+// ============== ͼ ==============
+// ÿͼԼƬ͸ڵ㣺ɾ򡢺ϲƶֻ漰ͼ
+
+int MapViewWidget::addLayer(const QString& name, int index)
 {
-	if (!tile)
-		return;
+	if (index < 0 || index > m_layers.size())
+		index = m_layers.size();
 
-	// ͼ㣺ֻеǰͼƬܱѡ
-	if (tile->layer() != m_currentLayer)
-	{
-		qDebug() << "Cannot select tile: tile layer" << tile->layer()
-			<< "!= current layer" << m_currentLayer;
-		return;
-	}
+	MapLayerInfo info;
+	info.id = m_nextLayerId++;
+	info.name = name;
+	m_layers.insert(index, info);
+	syncLayers();
 
-	selectTile(tile);
+	qDebug() << "Added layer:" << info.id << name << "at:" << index;
+	return info.id;
 }
 
-void MapViewWidget::deleteSelectedTile()
+bool MapViewWidget::removeLayer(int layer)
 {
-	if (!m_selectedTile)
-		return;
+	const int index = layerOrder(layer);
+	if (index < 0 || m_layers.size() <= 1)
+		return false;
 
-	// бƳ
-	m_placedTiles.removeOne(m_selectedTile);
+	releaseLayerSelection(layer);
 
-	// ӳƳ
-	m_scene->removeItem(m_selectedTile);
+	// ķֿԤеĸͼ㲻ٻָ
+	retargetLayer(layer, QVector<int>());
+	rebuildPrefabInstancesOnLayer(layer);
 
-	// ɾ
-	m_selectedTile->deleteLater();
-	m_selectedTile = nullptr;
+	const QVector<MapTileItem*> tiles = m_tileStore.takeLayer(layer);
+	for (const MapTileItem* tile : tiles)
+		markTileDirty(tile);
+	destroyLayerRoot(layer);
 
-	emit tileDeselected();
+	m_layers.removeAt(index);
+	if (m_currentLayer == layer)
+		setCurrentLayer(m_layers[qMax(0, index - 1)].id);
+	syncLayers();
+	scheduleUsageNotify();
 
-	qDebug() << "Deleted selected tile";
+	qDebug() << "Removed layer:" << layer << "tiles:" << tiles.size();
+	return true;
 }
 
-// ============== Ƭ϶ ==============
-
-void MapViewWidget::onTileDragStarted(MapTileItem* tile)
+bool MapViewWidget::moveLayer(int layer, int index)
 {
-	if (!tile || tile != m_selectedTile)
-		return;
+	const int from = layerOrder(layer);
+	if (from < 0)
+		return false;
 
-	// ߴǷƥ
-	if (!validateTileSize(tile->slice().width, tile->slice().height))
-	{
-		qDebug() << "Cannot drag tile: size mismatch";
-		return;
-	}
+	index = qBound(0, index, m_layers.size() - 1);
+	if (index == from)
+		return false;
 
-	m_tileDragging = true;
-	m_tileOriginalPos = tile->pos();
-	m_tileOriginalGridX = tile->gridX();
-	m_tileOriginalGridY = tile->gridY();
+	// ֻĸڵ Z ֵ
+	m_layers.move(from, index);
+	syncLayers();
+	invalidateLayerOrder();
 
-	qDebug() << "Tile drag started";
+	qDebug() << "Moved layer:" << layer << "from:" << from << "to:" << index;
+	return true;
 }
 
-void MapViewWidget::onTileDragFinished(MapTileItem* tile, const QPointF& scenePos)
+bool MapViewWidget::renameLayer(int layer, const QString& name)
 {
-	if (!tile || !m_tileDragging)
-	{
-		// û϶״ָ̬λ
-		if (tile)
-		{
-			tile->setPos(gridToScene(tile->gridX(), tile->gridY()));
-		}
-		return;
-	}
+	const int index = layerOrder(layer);
+	const QString trimmed = name.trimmed();
+	if (index < 0 || trimmed.isEmpty() || m_layers[index].name == trimmed)
+		return false;
 
-	m_tileDragging = false;
+	m_layers[index].name = trimmed;
+	syncLayers();
+	return true;
+}
 
-	// ߴǷƥ
-	if (!validateTileSize(tile->slice().width, tile->slice().height))
+bool MapViewWidget::mergeLayer(int layer, int intoLayer)
+{
+	const int fromIndex = layerOrder(layer);
+	const int intoIndex = layerOrder(intoLayer);
+	if (fromIndex < 0 || intoIndex < 0 || layer == intoLayer)
+		return false;
+
+	if (isLayerLocked(layer) || isLayerLocked(intoLayer))
 	{
-		// ߴ粻ƥ䣬ָԭλ
-		tile->setPos(m_tileOriginalPos);
-		qDebug() << "Tile drag failed: size mismatch, restoring position";
-		return;
+		qDebug() << "Cannot merge locked layer:" << layer << "into:" << intoLayer;
+		return false;
 	}
 
-	// µλ
-	QPoint newGridPos = sceneToGrid(scenePos);
+	releaseLayerSelection(layer);
+	retargetLayer(layer, { intoLayer });
+	rebuildPrefabInstancesOnLayer(layer);
 
-	// ߽
-	int gridW = tile->gridWidth();
-	int gridH = tile->gridHeight();
+	MapLayerRoot* source = layerRoot(layer);
+	MapLayerRoot* target = layerRoot(intoLayer);
+
+	// ϲƬƽ Z ֵԭ¹ϵ
+	const bool above = fromIndex > intoIndex;
+	const qreal offset = above ? target->topZ() + 1 - source->bottomZ()
+		: target->bottomZ() - 1 - source->topZ();
+	if (above)
+		target->setZRange(target->bottomZ(), source->topZ() + offset);
+	else
+		target->setZRange(source->bottomZ() + offset, target->topZ());
 
-	if (newGridPos.x() < 0 || newGridPos.y() < 0 ||
-		newGridPos.x() + gridW > m_mapWidth || newGridPos.y() + gridH > m_mapHeight)
+	// ͼԪб˳򻻸ڵ㣺ÿߵĶбͷҪ
+	const QList<QGraphicsItem*> children = source->childItems();
+	for (QGraphicsItem* child : children)
 	{
-		// ߽磬ָԭλ
-		tile->setPos(m_tileOriginalPos);
-		tile->setGridPos(m_tileOriginalGridX, m_tileOriginalGridY);
-		qDebug() << "Tile drag failed: out of bounds";
+		child->setParentItem(target);
+		child->setZValue(child->zValue() + offset);
 	}
-	else
+
+	const QVector<MapTileItem*> tiles = m_tileStore.takeLayer(layer);
+	for (MapTileItem* tile : tiles)
 	{
-		// õλã
-		tile->setGridPos(newGridPos.x(), newGridPos.y());
-		tile->setPos(gridToScene(newGridPos.x(), newGridPos.y()));
-		qDebug() << "Tile moved to grid:" << newGridPos;
+		tile->setLayer(intoLayer);
+		m_tileStore.insert(tile);
+		markTileDirty(tile);
 	}
+	destroyLayerRoot(layer);
 
-	clearDropHighlight();
+	m_layers.removeAt(fromIndex);
+	if (m_currentLayer == layer)
+		setCurrentLayer(intoLayer);
+	syncLayers();
+	m_lodLayer->clear();
+	scheduleUsageNotify();
+
+	qDebug() << "Merged layer:" << layer << "into:" << intoLayer << "tiles:" << tiles.size();
+	return true;
 }
 
-void MapViewWidget::updateMoveHighlight(const QPointF& scenePos, MapTileItem* tile)
+int MapViewWidget::duplicateLayer(int layer)
 {
-	if (!tile)
+	const int index = layerOrder(layer);
+	if (index < 0)
+		return -1;
+
+	MapLayerInfo info = m_layers[index];
+	info.id = m_nextLayerId++;
+	info.name = QStringLiteral("%1 ").arg(info.name);
+	m_layers.insert(index + 1, info);
+	syncLayers();
+
+	// ķֿԤеԭͼͬʱָ
+	retargetLayer(layer, { layer, info.id });
+
+	MapLayerRoot* source = layerRoot(layer);
+	layerRoot(info.id)->setZRange(source->bottomZ(), source->topZ());
+
+	// ȸбͼǼƬĶ洢
+	const QVector<MapTileItem*> tiles = m_tileStore.layerTiles(layer);
+	for (const MapTileItem* tile : tiles)
 	{
-		clearDropHighlight();
-		return;
+		auto* copy = createTileItem(tile->originalPixmap(), tile->slice(), tile->tilesetId(),
+			tile->gridX(), tile->gridY(), tile->gridWidth(), tile->gridHeight(), info.id);
+		copy->setDisplayName(tile->displayName());
+		copy->setTags(tile->tags());
+		copy->setCollisionType(tile->collisionType());
+		if (tile->isFlippedX())
+			copy->setFlipX(true);
+		if (tile->isFlippedY())
+			copy->setFlipY(true);
+		if (tile->rotation() != 0)
+			copy->setRotation(tile->rotation());
+		copy->setZValue(tile->zValue());
 	}
+	rebuildPrefabInstancesOnLayer(layer);
 
-	QPoint gridPos = sceneToGrid(scenePos);
+	qDebug() << "Duplicated layer:" << layer << "as:" << info.id << "tiles:" << tiles.size();
+	return info.id;
+}
 
-	int gridW = tile->gridWidth();
-	int gridH = tile->gridHeight();
+void MapViewWidget::syncLayers()
+{
+	m_layerIndex.clear();
+	for (int i = 0; i < m_layers.size(); ++i)
+		m_layerIndex.insert(m_layers[i].id, i);
 
-	// ߽
-	if (gridPos.x() < 0 || gridPos.y() < 0 ||
-		gridPos.x() + gridW > m_mapWidth || gridPos.y() + gridH > m_mapHeight)
+	// ͼ֮ĵ˳ֻɸڵ Z ֵ
+	for (MapLayerRoot* root : m_layerRoots)
+		root->setZValue(10 + layerOrder(root->layer()));
+
+	if (m_ctx)
 	{
-		clearDropHighlight();
-		return;
+		if (MapDocument* doc = m_ctx->documentManager.document())
+		{
+			doc->layers = m_layers;
+			doc->nextLayerId = m_nextLayerId;
+		}
 	}
 
-	// ɵĸ
-	for (auto* rect : m_coverageHighlights)
+	emit layersChanged();
+}
+
+void MapViewWidget::invalidateLayerOrder()
+{
+	// ײͼȡֵֻײεķֿܱ仯
+	for (const QVector<CollisionRect>& rects : m_collisionBaker.chunks())
 	{
-		m_scene->removeItem(rect);
-		delete rect;
+		for (const CollisionRect& rect : rects)
+			m_collisionBaker.markDirty(rect.cells);
 	}
-	m_coverageHighlights.clear();
+	scheduleCollisionBake();
 
-	// Ŀλø
-	for (int dy = 0; dy < gridH; ++dy)
-	{
-		for (int dx = 0; dx < gridW; ++dx)
-		{
-			int gx = gridPos.x() + dx;
-			int gy = gridPos.y() + dy;
+	// ڼײԤ決Ѱ·ؽ
+	m_navGrid.markAllDirty();
+	scheduleNavigation();
 
-			if (gx >= m_mapWidth || gy >= m_mapHeight)
-				continue;
+	m_lodLayer->clear();
+	emit layerOrderChanged();
+}
 
-			QPointF topLeft = gridToScene(gx, gy);
-			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
+void MapViewWidget::destroyLayerRoot(int layer)
+{
+	MapLayerRoot* root = m_layerRoots.take(layer);
+	if (!root)
+		return;
 
-			if (dx == 0 && dy == 0)
-			{
-				rect->setPen(QPen(QColor(100, 200, 100), 2));
-				rect->setBrush(QBrush(QColor(100, 200, 100, 60)));
-			}
-			else
+	// ͼԪƬڵһɾ
+	m_scene->removeItem(root);
+	delete root;
+}
+
+void MapViewWidget::rebuildPrefabInstancesOnLayer(int layer)
+{
+	QVector<QUuid> affected;
+	for (auto it = m_prefabInstances.cbegin(); it != m_prefabInstances.cend(); ++it)
+	{
+		for (const MapPrefabItem* item : it->items)
+		{
+			if (item->layer() == layer)
 			{
-				rect->setPen(QPen(QColor(100, 200, 100), 1));
-				rect->setBrush(QBrush(QColor(100, 200, 100, 40)));
+				affected.append(it.key());
+				break;
 			}
-
-			rect->setZValue(999);
-			m_scene->addItem(rect);
-			m_coverageHighlights.append(rect);
 		}
 	}
+
+	for (const QUuid& instanceId : affected)
+		rebuildPrefabInstanceItems(instanceId);
 }
 
-// ============== Ƭ ==============
+QVector<int> MapViewWidget::resolveLayers(int storedLayer) const
+{
+	auto it = m_layerTargets.constFind(storedLayer);
+	if (it != m_layerTargets.constEnd())
+		return it.value();
+	if (hasLayer(storedLayer))
+		return { storedLayer };
+
+	// ͼͼţŵǰͼ
+	return { m_currentLayer };
+}
 
-bool MapViewWidget::hasPlacedTileAt(int gridX, int gridY, int layer) const
+void MapViewWidget::retargetLayer(int layer, const QVector<int>& targets)
 {
-	for (const auto* tile : m_placedTiles)
+	// еӳָͼĸΪָµĿ
+	for (auto it = m_layerTargets.begin(); it != m_layerTargets.end(); ++it)
 	{
-		if (tile->layer() != layer)
+		QVector<int>& live = it.value();
+		if (!live.removeAll(layer))
 			continue;
+		for (int target : targets)
+		{
+			if (!live.contains(target))
+				live.append(target);
+		}
+	}
 
-		// Ƭǵ
-		int tx = tile->gridX();
-		int ty = tile->gridY();
-		int tw = tile->gridWidth();
-		int th = tile->gridHeight();
+	if (!m_layerTargets.contains(layer))
+		m_layerTargets.insert(layer, targets);
+}
 
-		if (gridX >= tx && gridX < tx + tw && gridY >= ty && gridY < ty + th)
-			return true;
-	}
-	return false;
+// ============== ϸڲ㼶 ==============
+
+void MapViewWidget::setLodThresholds(double mipBelow, double colorBelow)
+{
+	m_lodMipBelow = mipBelow;
+	m_lodColorBelow = qMin(colorBelow, mipBelow);
+	updateLodLevel();
 }
 
-MapTileItem* MapViewWidget::copyTileToGrid(MapTileItem* sourceTile, int gridX, int gridY)
+void MapViewWidget::updateLodLevel()
 {
-	if (!sourceTile)
-		return nullptr;
+	MapLodLevel level = MapLodLevel::Full;
+	if (m_currentScale < m_lodColorBelow)
+		level = MapLodLevel::Color;
+	else if (m_currentScale < m_lodMipBelow)
+		level = MapLodLevel::Mip;
 
-	// ߽
-	int gridW = sourceTile->gridWidth();
-	int gridH = sourceTile->gridHeight();
+	if (level == m_lodLevel)
+		return;
+	m_lodLevel = level;
 
-	if (gridX < 0 || gridY < 0 ||
-		gridX + gridW > m_mapWidth || gridY + gridH > m_mapHeight)
-	{
-		return nullptr;
-	}
+	// СͼƬͼ㣬ɷֿͼƣҲҪƽźͿ
+	const bool full = (level == MapLodLevel::Full);
+	for (MapLayerRoot* root : m_layerRoots)
+		root->setLodHidden(!full);
+	applyRenderHints();
+	m_lodLayer->setLevel(level);
+
+	qDebug() << "LOD level:" << static_cast<int>(level) << "at scale" << m_currentScale;
+}
+
+void MapViewWidget::invalidateLodArea(const QRect& gridRect)
+{
+	if (gridRect.isEmpty())
+		return;
+
+	const QPoint first = MapChunkCache::chunkOf(gridRect.left(), gridRect.top());
+	const QPoint last = MapChunkCache::chunkOf(gridRect.right(), gridRect.bottom());
+	for (int cy = first.y(); cy <= last.y(); ++cy)
+	{
+		for (int cx = first.x(); cx <= last.x(); ++cx)
+			m_lodLayer->invalidateChunk(QPoint(cx, cy));
+	}
+}
+
+void MapViewWidget::invalidateLodItem(const QGraphicsItem* item)
+{
+	const QRectF rect = item->sceneBoundingRect();
+	const QPoint topLeft = sceneToGrid(rect.topLeft());
+	const QPoint bottomRight = sceneToGrid(rect.bottomRight() - QPointF(0.5, 0.5));
+	invalidateLodArea(QRect(topLeft, bottomRight));
+}
+
+MapLodSnapshot MapViewWidget::snapshotLodChunk(const QPoint& chunk, int divisor)
+{
+	const QRect area = MapChunkCache::chunkRect(chunk);
+	const QRectF sceneArea(gridToScene(area.x(), area.y()),
+		QSizeF(area.width() * m_tileWidth, area.height() * m_tileHeight));
+	const bool full = (divisor == 1);
+
+	// ֿཻƬԤͼԪͼ˳ƣصͼ㣩
+	MapLodSnapshot snapshot;
+	QVector<QPair<int, const QGraphicsPixmapItem*>> items;
+	for (const MapTileItem* tile : m_tileStore.tilesInRect(area))
+	{
+		if (!layerState(tile->layer()).visible || (full && tile == m_selectedTile))
+			continue;
+
+		// ͼ¶֡仯ֿͼԪ
+		if (full && tile->animation())
+		{
+			snapshot.animated = true;
+			return snapshot;
+		}
+		items.append(qMakePair(tile->layer(), static_cast<const QGraphicsPixmapItem*>(tile)));
+	}
+	for (const QUuid& instanceId : prefabInstancesInRect(area))
+	{
+		for (const MapPrefabItem* item : m_prefabInstances.constFind(instanceId)->items)
+		{
+			if (full && item->isHighlighted())
+				continue;
+			if (layerState(item->layer()).visible && item->sceneBoundingRect().intersects(sceneArea))
+				items.append(qMakePair(item->layer(), static_cast<const QGraphicsPixmapItem*>(item)));
+		}
+	}
+	if (items.isEmpty())
+		return snapshot;
+
+	std::stable_sort(items.begin(), items.end(), [this](const auto& a, const auto& b) {
+		const int orderA = layerOrder(a.first);
+		const int orderB = layerOrder(b.first);
+		if (orderA != orderB)
+			return orderA < orderB;
+		return a.second->zValue() < b.second->zValue();
+		});
+
+	snapshot.size = QSize(qMax(1, qCeil(sceneArea.width() / divisor)), qMax(1, qCeil(sceneArea.height() / divisor)));
+	snapshot.smooth = (m_renderProfile == MapRenderProfile::Smooth);
+
+	//  -> Сͼ
+	QTransform toImage;
+	toImage.scale(1.0 / divisor, 1.0 / divisor);
+	toImage.translate(-sceneArea.x(), -sceneArea.y());
+
+	// QPixmap ֻڽ߳ʹã cacheKey ת QImageͬһƬƬ
+	if (m_lodSourceImages.size() > MAX_LOD_SOURCE_IMAGES)
+		m_lodSourceImages.clear();
+
+	snapshot.items.reserve(items.size());
+	for (const auto& entry : items)
+	{
+		const QGraphicsPixmapItem* item = entry.second;
+		const QPixmap& pixmap = item->pixmap();
+		auto it = m_lodSourceImages.constFind(pixmap.cacheKey());
+		if (it == m_lodSourceImages.constEnd())
+			it = m_lodSourceImages.insert(pixmap.cacheKey(), pixmap.toImage());
+
+		snapshot.items.append(MapLodSnapshot::Item{ it.value(), item->sceneTransform() * toImage, item->offset(),
+			entry.first, layerState(entry.first).opacity });
+	}
+	return snapshot;
+}
+
+void MapViewWidget::setGridOrigin(const QPoint& origin)
+{
+	const QPoint delta = origin - m_gridOrigin;
+
+	m_gridOrigin = origin;
+	m_tileStore.setOrigin(origin);
+
+	for (MapLayerRoot* root : m_layerRoots)
+		root->setGridOrigin(origin, m_tileWidth, m_tileHeight);
+
+	if (delta.isNull())
+		return;
+
+	// ߼ƽƣֿ黺水ƫļƬ±
+	m_collisionBaker.translate(delta);
+	m_collisionOverlay->update();
+	m_navGrid.translate(delta);
+	m_lodLayer->translate(delta);
+
+	// δ֪ͨı仯ֿͬƫ
+	const QHash<quint64, QPoint> changed = std::move(m_changedChunks);
+	m_changedChunks.clear();
+	for (const QPoint& chunk : changed)
+	{
+		const QRect area = MapChunkCache::chunkRect(chunk).translated(delta);
+		const QPoint first = MapChunkCache::chunkOf(area.left(), area.top());
+		const QPoint last = MapChunkCache::chunkOf(area.right(), area.bottom());
+		for (int cy = first.y(); cy <= last.y(); ++cy)
+		{
+			for (int cx = first.x(); cx <= last.x(); ++cx)
+				m_changedChunks.insert(MapChunkCache::chunkKey(QPoint(cx, cy)), QPoint(cx, cy));
+		}
+	}
+
+	// ķֿбռ
+	for (auto it = m_animations.begin(); it != m_animations.end(); ++it)
+		it->chunksDirty = true;
+
+	emit gridOriginShifted(delta);
+}
+
+bool MapViewWidget::isInsideMap(int gridX, int gridY, int gridW, int gridH) const
+{
+	if (m_infinite)
+		return true;
+
+	return gridX >= 0 && gridY >= 0 && gridX + gridW <= m_mapWidth && gridY + gridH <= m_mapHeight;
+}
+
+// ============== ޵ͼֿʽأ ==============
+
+void MapViewWidget::setInfiniteMode(bool infinite)
+{
+	if (m_infinite == infinite)
+		return;
+
+	// л޵ͼǰѻķֿȫ
+	if (m_infinite)
+	{
+		for (const QPoint& chunk : m_chunkCache.evictedChunks())
+			ensureChunkResident(chunk);
+	}
+
+	m_infinite = infinite;
+	m_chunkCache.clear();
+	m_residentChunks.clear();
+
+	// ƬڷֿǼ
+	if (m_infinite)
+	{
+		m_tileStore.forEachTile([this](const MapTileItem* tile) {
+			const QPoint chunk = MapChunkCache::chunkOf(tile->gridX(), tile->gridY());
+			m_residentChunks.insert(MapChunkCache::chunkKey(chunk), chunk);
+			});
+	}
+
+	drawGrid();
+	if (m_infinite)
+	{
+		centerOn(0, 0);
+		scheduleStreaming();
+	}
+
+	qDebug() << "Infinite mode:" << m_infinite;
+}
+
+void MapViewWidget::scheduleStreaming()
+{
+	if (!m_infinite || m_streamingPending)
+		return;
+
+	m_streamingPending = true;
+	QTimer::singleShot(0, this, [this]() {
+		m_streamingPending = false;
+		updateStreaming();
+		});
+}
+
+void MapViewWidget::updateStreaming()
+{
+	if (!m_infinite || (m_tileStore.isEmpty() && m_chunkCache.evictedCount() == 0))
+		return;
+
+	// ϶вɿٴ
+	if (m_tileDragging || m_copyDragging || m_deleteDragging || m_prefabDragging || m_regionSelecting)
+		return;
+
+	const QRectF visible = mapToScene(viewport()->rect()).boundingRect();
+	const QPoint topLeftGrid = sceneToGrid(visible.topLeft());
+	const QPoint bottomRightGrid = sceneToGrid(visible.bottomRight());
+	const QRect visibleChunks(MapChunkCache::chunkOf(topLeftGrid.x(), topLeftGrid.y()),
+		MapChunkCache::chunkOf(bottomRightGrid.x(), bottomRightGrid.y()));
+
+	// ԤһȦֿ飻ΧٴһȦڱ߽ƽʱд
+	const QRect loadRange = visibleChunks.adjusted(-STREAM_PRELOAD_CHUNKS, -STREAM_PRELOAD_CHUNKS,
+		STREAM_PRELOAD_CHUNKS, STREAM_PRELOAD_CHUNKS);
+	const QRect keepRange = loadRange.adjusted(-1, -1, 1, 1);
+
+	// أΧѻбнСһ
+	const qint64 rangeArea = static_cast<qint64>(loadRange.width()) * loadRange.height();
+	if (rangeArea <= m_chunkCache.evictedCount())
+	{
+		for (int cy = loadRange.top(); cy <= loadRange.bottom(); ++cy)
+		{
+			for (int cx = loadRange.left(); cx <= loadRange.right(); ++cx)
+				m_chunkCache.requestLoad(QPoint(cx, cy));
+		}
+	}
+	else
+	{
+		for (const QPoint& chunk : m_chunkCache.evictedChunks())
+		{
+			if (loadRange.contains(chunk))
+				m_chunkCache.requestLoad(chunk);
+		}
+	}
+
+	// Զӿڵķֿ飨ѡеƬѡڷֿ鱣
+	const QPoint selectedChunk = m_selectedTile
+		? MapChunkCache::chunkOf(m_selectedTile->gridX(), m_selectedTile->gridY()) : QPoint();
+	QVector<QPoint> toEvict;
+	for (const QPoint& chunk : m_residentChunks)
+	{
+		if (keepRange.contains(chunk))
+			continue;
+		if (m_selectedTile && chunk == selectedChunk)
+			continue;
+		if (!m_selectedRegion.isEmpty() && MapChunkCache::chunkRect(chunk).intersects(m_selectedRegion))
+			continue;
+		toEvict.append(chunk);
+	}
+
+	for (const QPoint& chunk : toEvict)
+		evictChunk(chunk);
+
+	if (!toEvict.isEmpty())
+	{
+		qDebug() << "Streaming: evicted" << toEvict.size() << "chunks, resident:" << m_residentChunks.size()
+			<< "on disk:" << m_chunkCache.evictedCount();
+	}
+}
+
+void MapViewWidget::evictChunk(const QPoint& chunk)
+{
+	const QRect rect = MapChunkCache::chunkRect(chunk);
+	const QVector<MapTileItem*> tiles = m_tileStore.tilesAnchoredInRect(rect);
+
+	// ֻдƬԤʵдļں̨У޷ʱڴУ´
+	if (!tiles.isEmpty() && !m_chunkCache.store(chunk, encodeRegion(rect, tiles, QVector<QUuid>())))
+		return;
+
+	for (MapTileItem* tile : tiles)
+		destroyTileItem(tile);
+
+	m_residentChunks.remove(MapChunkCache::chunkKey(chunk));
+}
+
+void MapViewWidget::ensureChunkResident(const QPoint& chunk)
+{
+	const quint64 key = MapChunkCache::chunkKey(chunk);
+	if (m_residentChunks.contains(key))
+		return;
+
+	// ȵǼǣָƬʱ createTileItem ٴν
+	m_residentChunks.insert(key, chunk);
+
+	TileRegionData region;
+	if (m_chunkCache.isEvicted(chunk) && m_chunkCache.take(chunk, region))
+		placeRegionCells(region, MapChunkCache::chunkRect(chunk).topLeft(), false);
+}
+
+void MapViewWidget::ensureRegionResident(const QRect& gridRect)
+{
+	if (!m_infinite || gridRect.isEmpty())
+		return;
+
+	// ƬԭϷڷֿУȡһֿ
+	const QPoint first = MapChunkCache::chunkOf(gridRect.left(), gridRect.top()) - QPoint(1, 1);
+	const QPoint last = MapChunkCache::chunkOf(gridRect.right(), gridRect.bottom());
+	for (int cy = first.y(); cy <= last.y(); ++cy)
+	{
+		for (int cx = first.x(); cx <= last.x(); ++cx)
+		{
+			const QPoint chunk(cx, cy);
+			if (m_chunkCache.isEvicted(chunk))
+				ensureChunkResident(chunk);
+		}
+	}
+}
+
+void MapViewWidget::onChunkLoaded(const QPoint& chunk, const TileRegionData& region)
+{
+	if (!m_infinite)
+		return;
+
+	m_residentChunks.insert(MapChunkCache::chunkKey(chunk), chunk);
+	placeRegionCells(region, MapChunkCache::chunkRect(chunk).topLeft(), false);
+}
+
+QHash<QUuid, int> MapViewWidget::sliceUsage() const
+{
+	QHash<QUuid, int> usage = m_tileStore.sliceUsage();
+
+	// ԤʵеƬ뵼һ£
+	forEachPrefabTile(QRect(), [&usage](const MapExportTile& tile, const QPixmap&) {
+		++usage[tile.slice.id];
+		});
+
+	if (!m_infinite || m_chunkCache.evictedCount() == 0)
+		return usage;
+
+	// ѻֿеʹô
+	const QHash<QUuid, int> evicted = m_chunkCache.sliceUsage();
+	for (auto it = evicted.constBegin(); it != evicted.constEnd(); ++it)
+		usage[it.key()] += it.value();
+	return usage;
+}
+
+void MapViewWidget::drawBackground(QPainter* painter, const QRectF& rect)
+{
+	QGraphicsView::drawBackground(painter, rect);
+
+	if (!m_infinite || !m_gridVisible || m_tileWidth <= 0 || m_tileHeight <= 0)
+		return;
+
+	// Ļ̫Сʱֻֿ߽
+	const qreal scale = transform().m11();
+	const bool drawCells = m_tileWidth * scale >= 4.0 && m_tileHeight * scale >= 4.0;
+	const int stepX = drawCells ? m_tileWidth : m_tileWidth * MapChunkCache::CHUNK_SIZE;
+	const int stepY = drawCells ? m_tileHeight : m_tileHeight * MapChunkCache::CHUNK_SIZE;
+	const int chunkW = m_tileWidth * MapChunkCache::CHUNK_SIZE;
+	const int chunkH = m_tileHeight * MapChunkCache::CHUNK_SIZE;
+
+	const qint64 left = static_cast<qint64>(qFloor(rect.left() / stepX)) * stepX;
+	const qint64 top = static_cast<qint64>(qFloor(rect.top() / stepY)) * stepY;
+
+	QVector<QLineF> cellLines;
+	QVector<QLineF> chunkLines;
+	for (qint64 x = left; x <= rect.right(); x += stepX)
+		(x % chunkW == 0 ? chunkLines : cellLines).append(QLineF(x, rect.top(), x, rect.bottom()));
+	for (qint64 y = top; y <= rect.bottom(); y += stepY)
+		(y % chunkH == 0 ? chunkLines : cellLines).append(QLineF(rect.left(), y, rect.right(), y));
+
+	painter->save();
+	painter->setRenderHint(QPainter::Antialiasing, false);
+	painter->setPen(QPen(QColor(220, 220, 225), 0));
+	painter->drawLines(cellLines);
+	painter->setPen(QPen(QColor(190, 190, 195), 0));
+	painter->drawLines(chunkLines);
+	painter->restore();
+}
+
+void MapViewWidget::scrollContentsBy(int dx, int dy)
+{
+	QGraphicsView::scrollContentsBy(dx, dy);
+	scheduleStreaming();
+	emit viewportChanged();
+}
+
+void MapViewWidget::resizeEvent(QResizeEvent* event)
+{
+	QGraphicsView::resizeEvent(event);
+	scheduleStreaming();
+	emit viewportChanged();
+}
+
+QRectF MapViewWidget::visibleGridRect() const
+{
+	const QRectF sceneRect = mapToScene(viewport()->rect()).boundingRect();
+	return QRectF(sceneRect.x() / m_tileWidth, sceneRect.y() / m_tileHeight,
+		sceneRect.width() / m_tileWidth, sceneRect.height() / m_tileHeight);
+}
+
+void MapViewWidget::centerOnGrid(const QPointF& gridPos)
+{
+	centerOn(gridPos.x() * m_tileWidth, gridPos.y() * m_tileHeight);
+}
+
+void MapViewWidget::setCurrentLayer(int layer)
+{
+	if (m_currentLayer == layer || !hasLayer(layer))
+		return;
+
+	m_currentLayer = layer;
+
+	// лͼʱǰѡеƬͼ㣬ȡѡ
+	if (m_selectedTile && m_selectedTile->layer() != layer)
+	{
+		clearSelection();
+	}
+
+	qDebug() << "Current layer changed to:" << layer;
+}
+
+int MapViewWidget::zoomPercent() const
+{
+	return static_cast<int>(m_currentScale * 100);
+}
+
+void MapViewWidget::setZoomPercent(int percent)
+{
+	double newScale = percent / 100.0;
+	if (m_renderProfile == MapRenderProfile::PixelArt)
+		newScale = pixelArtScale(newScale, 0);
+	if (qFuzzyCompare(m_currentScale, newScale))
+		return;
+
+	setViewScale(newScale);
+}
+
+void MapViewWidget::applyZoom(double scaleFactor)
+{
+	// ط簴λţ򰴱
+	if (m_renderProfile == MapRenderProfile::PixelArt)
+		setViewScale(pixelArtScale(m_currentScale, scaleFactor > 1.0 ? 1 : -1));
+	else
+		setViewScale(qBound(0.1, m_currentScale * scaleFactor, 4.0));
+}
+
+void MapViewWidget::setViewScale(double scale)
+{
+	m_currentScale = scale;
+
+	resetTransform();
+	QGraphicsView::scale(m_currentScale, m_currentScale);
+	updateLodLevel();
+	scheduleStreaming();
+	emit viewportChanged();
+
+	emit zoomChanged(qRound(m_currentScale * 100));
+}
+
+double MapViewWidget::pixelArtScale(double scale, int direction) const
+{
+	// 豸ȡŴΪ 1, 2, 3...СΪ 1/2, 1/3...ÿԴظ豸
+	const double ratio = devicePixelRatioF();
+	const double deviceScale = scale * ratio;
+
+	int step = deviceScale >= 1.0 ? qRound(deviceScale) : -qRound(1.0 / deviceScale);
+	if (step == -1)
+		step = 1;
+	if (direction > 0)
+		step = (step == -2) ? 1 : step + 1;
+	else if (direction < 0)
+		step = (step == 1) ? -2 : step - 1;
+
+	const double result = (step > 0 ? step : 1.0 / -step) / ratio;
+	if (result < 0.1 || result > 4.0)
+		return direction == 0 ? qBound(0.1, result, 4.0) : m_currentScale;
+	return result;
+}
+
+// ============== Ⱦʽ ==============
+
+void MapViewWidget::setRenderProfile(MapRenderProfile profile)
+{
+	if (m_ctx)
+	{
+		if (MapDocument* doc = m_ctx->documentManager.document())
+			doc->renderProfile = profile;
+	}
+
+	if (m_renderProfile == profile)
+		return;
+	m_renderProfile = profile;
+
+	applyRenderHints();
+
+	// פƬ pixmap Ͷ֡ڷʱɵĲʽŹͼ
+	// ÿƬֻһΣͬһƬƬɵĶƬ
+	const Qt::TransformationMode mode = pixmapTransformMode();
+	const QHash<QUuid, SliceAnimation> oldAnimations = m_animations;
+	m_animations.clear();
+	m_lodSourceImages.clear();
+
+	struct Rescaled
+	{
+		QPixmap pixmap;
+		const MapTileAnimation* animation = nullptr;
+	};
+	QHash<QUuid, Rescaled> rescaled;
+	m_tileStore.forEachTile([&](MapTileItem* tile) {
+		const QUuid sliceId = tile->slice().id;
+		auto it = rescaled.constFind(sliceId);
+		if (it == rescaled.constEnd())
+		{
+			Rescaled entry;
+			SpriteSlice slice;
+			QPixmap source;
+			if (m_sliceResolver && m_sliceResolver(tile->tilesetId(), sliceId, slice, source))
+			{
+				entry.pixmap = source.scaled(tile->gridWidth() * m_tileWidth, tile->gridHeight() * m_tileHeight,
+					Qt::IgnoreAspectRatio, mode);
+				if (slice.isAnimated())
+					entry.animation = tileAnimation(tile->tilesetId(), slice, tile->gridWidth(), tile->gridHeight());
+			}
+
+			// Ķþɵ֡
+			if (!entry.animation && oldAnimations.contains(sliceId))
+			{
+				m_animations.insert(sliceId, oldAnimations.value(sliceId));
+				entry.animation = m_animations.value(sliceId).animation.data();
+			}
+			it = rescaled.insert(sliceId, entry);
+		}
+
+		tile->setTransformationMode(mode);
+		if (tile->animation())
+			tile->setAnimation(it->animation);
+		if (!it->pixmap.isNull())
+			tile->setSlice(tile->slice(), it->pixmap);
+		});
+
+	// ԤդµĲʽؽ
+	m_prefabRasters.clear();
+	for (const QUuid& instanceId : m_prefabInstances.keys())
+		rebuildPrefabInstanceItems(instanceId);
+
+	// лطʱѵǰŶ뵽λ
+	if (profile == MapRenderProfile::PixelArt)
+		setViewScale(pixelArtScale(m_currentScale, 0));
+
+	drawGrid();
+	m_lodLayer->clear();
+	resetCachedContent();
+}
+
+void MapViewWidget::applyRenderHints()
+{
+	const bool smooth = (m_renderProfile == MapRenderProfile::Smooth && m_lodLevel == MapLodLevel::Full);
+	setRenderHint(QPainter::Antialiasing, smooth);
+	setRenderHint(QPainter::SmoothPixmapTransform, smooth);
+
+	// ʱػҪ
+	setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing, !smooth);
+}
+
+Qt::TransformationMode MapViewWidget::pixmapTransformMode() const
+{
+	return m_renderProfile == MapRenderProfile::PixelArt ? Qt::FastTransformation : Qt::SmoothTransformation;
+}
+
+// ============== ѡ ==============
+
+void MapViewWidget::clearSelection()
+{
+	if (m_selectedTile)
+	{
+		m_selectedTile->setSelected(false);
+		invalidateLodItem(m_selectedTile);
+		m_selectedTile = nullptr;
+		emit tileDeselected();
+	}
+}
+
+void MapViewWidget::selectTile(MapTileItem* tile)
+{
+	if (m_selectedTile == tile)
+		return;
+
+	// ȡ֮ǰѡУѡеƬͼķֿդѡ״̬仯ʱɣ
+	if (m_selectedTile)
+	{
+		m_selectedTile->setSelected(false);
+		invalidateLodItem(m_selectedTile);
+	}
+
+	m_selectedTile = tile;
+
+	if (tile)
+	{
+		tile->setSelected(true);
+		invalidateLodItem(tile);
+		emit tileSelected(tile);
+		qDebug() << "Selected tile:" << tile->slice().name
+			<< "at grid:" << tile->gridX() << "," << tile->gridY()
+			<< "layer:" << tile->layer();
+	}
+	else
+	{
+		emit tileDeselected();
+	}
+}
+
+void MapViewWidget::onTileClicked(MapTileItem* tile)
+{
+	if (!tile)
+		return;
+
+	// ͼ㣺ֻеǰͼƬܱѡ
+	if (tile->layer() != m_currentLayer)
+	{
+		qDebug() << "Cannot select tile: tile layer" << tile->layer()
+			<< "!= current layer" << m_currentLayer;
+		return;
+	}
+
+	selectTile(tile);
+}
+
+void MapViewWidget::deleteSelectedTile()
+{
+	if (!m_selectedTile)
+		return;
+
+	MapTileItem* tile = m_selectedTile;
+	m_selectedTile = nullptr;
+	destroyTileItem(tile);
+
+	emit tileDeselected();
+
+	qDebug() << "Deleted selected tile";
+}
+
+// ============== Ƭ϶ ==============
+
+void MapViewWidget::onTileDragStarted(MapTileItem* tile)
+{
+	if (!tile || tile != m_selectedTile)
+		return;
+
+	// ߴǷƥ
+	if (!validateTileSize(tile->slice().sourceWidth(), tile->slice().sourceHeight()))
+	{
+		qDebug() << "Cannot drag tile: size mismatch";
+		return;
+	}
+
+	m_tileDragging = true;
+	m_tileOriginalPos = tile->pos();
+	m_tileOriginalGridX = tile->gridX();
+	m_tileOriginalGridY = tile->gridY();
+
+	qDebug() << "Tile drag started";
+}
+
+void MapViewWidget::onTileDragFinished(MapTileItem* tile, const QPointF& scenePos)
+{
+	if (!tile || !m_tileDragging)
+	{
+		// û϶״ָ̬λ
+		if (tile)
+		{
+			tile->setPos(gridToScene(tile->localGridX(), tile->localGridY()));
+		}
+		return;
+	}
+
+	m_tileDragging = false;
+
+	// ߴǷƥ
+	if (!validateTileSize(tile->slice().sourceWidth(), tile->slice().sourceHeight()))
+	{
+		// ߴ粻ƥ䣬ָԭλ
+		tile->setPos(m_tileOriginalPos);
+		qDebug() << "Tile drag failed: size mismatch, restoring position";
+		return;
+	}
+
+	// µλ
+	QPoint newGridPos = sceneToGrid(scenePos);
+
+	// ߽
+	int gridW = tile->gridWidth();
+	int gridH = tile->gridHeight();
+
+	if (!isInsideMap(newGridPos.x(), newGridPos.y(), gridW, gridH))
+	{
+		// ߽磬ָԭλ
+		tile->setPos(m_tileOriginalPos);
+		qDebug() << "Tile drag failed: out of bounds";
+	}
+	else
+	{
+		// õλã
+		moveTile(tile, newGridPos.x(), newGridPos.y());
+		qDebug() << "Tile moved to grid:" << newGridPos;
+	}
+
+	clearDropHighlight();
+}
+
+void MapViewWidget::updateMoveHighlight(const QPointF& scenePos, MapTileItem* tile)
+{
+	if (!tile)
+	{
+		clearDropHighlight();
+		return;
+	}
+
+	QPoint gridPos = sceneToGrid(scenePos);
+
+	int gridW = tile->gridWidth();
+	int gridH = tile->gridHeight();
+
+	// ߽
+	if (!isInsideMap(gridPos.x(), gridPos.y(), gridW, gridH))
+	{
+		clearDropHighlight();
+		return;
+	}
+
+	// ɵĸ
+	for (auto* rect : m_coverageHighlights)
+	{
+		m_scene->removeItem(rect);
+		delete rect;
+	}
+	m_coverageHighlights.clear();
+
+	// Ŀλø
+	for (int dy = 0; dy < gridH; ++dy)
+	{
+		for (int dx = 0; dx < gridW; ++dx)
+		{
+			int gx = gridPos.x() + dx;
+			int gy = gridPos.y() + dy;
+
+			if (!isInsideMap(gx, gy))
+				continue;
+
+			QPointF topLeft = gridToScene(gx, gy);
+			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
+
+			if (dx == 0 && dy == 0)
+			{
+				rect->setPen(QPen(QColor(100, 200, 100), 2));
+				rect->setBrush(QBrush(QColor(100, 200, 100, 60)));
+			}
+			else
+			{
+				rect->setPen(QPen(QColor(100, 200, 100), 1));
+				rect->setBrush(QBrush(QColor(100, 200, 100, 40)));
+			}
+
+			rect->setZValue(999);
+			m_scene->addItem(rect);
+			m_coverageHighlights.append(rect);
+		}
+	}
+}
+
+// ============== Ƭ ==============
+
+bool MapViewWidget::hasPlacedTileAt(int gridX, int gridY, int layer) const
+{
+	return m_tileStore.tileAt(layer, gridX, gridY) != nullptr;
+}
+
+MapTileItem* MapViewWidget::copyTileToGrid(MapTileItem* sourceTile, int gridX, int gridY)
+{
+	if (!sourceTile)
+		return nullptr;
+
+	// ߽
+	int gridW = sourceTile->gridWidth();
+	int gridH = sourceTile->gridHeight();
+
+	if (!isInsideMap(gridX, gridY, gridW, gridH))
+	{
+		return nullptr;
+	}
 
 	// λǷƬ
 	if (hasPlacedTileAt(gridX, gridY, m_currentLayer))
 	{
-		return nullptr;
+		return nullptr;
+	}
+
+	// Ƭ
+	auto* newTile = createTileItem(sourceTile->originalPixmap(), sourceTile->slice(),
+		sourceTile->tilesetId(), gridX, gridY, gridW, gridH, m_currentLayer);
+
+	// ƿɱ༭
+	newTile->setCollisionType(sourceTile->collisionType());
+	newTile->setTags(sourceTile->tags());
+	newTile->setDisplayName(sourceTile->displayName());
+
+	// Ʒתת״̬
+	newTile->setFlipX(sourceTile->isFlippedX());
+	newTile->setFlipY(sourceTile->isFlippedY());
+	newTile->setRotation(sourceTile->rotation());
+
+	qDebug() << "Copied tile to grid:" << gridX << "," << gridY;
+
+	return newTile;
+}
+
+void MapViewWidget::onCopyDragStarted(MapTileItem* tile, CornerZone corner)
+{
+	if (!tile || tile != m_selectedTile)
+		return;
+
+	m_copyDragging = true;
+	m_copyStartGrid = QPoint(tile->gridX(), tile->gridY());
+	m_copyLastGrid = m_copyStartGrid;
+	m_copyPlacedPositions.clear();
+
+	// ¼ԴƬλãظã
+	m_copyPlacedPositions.insert(qMakePair(tile->gridX(), tile->gridY()));
+
+	qDebug() << "Copy drag started from corner:" << static_cast<int>(corner)
+		<< "at grid:" << m_copyStartGrid;
+}
+
+void MapViewWidget::onCopyDragMoved(MapTileItem* tile, const QPointF& scenePos)
+{
+	if (!m_copyDragging || !tile)
+		return;
+
+	QPoint currentGrid = sceneToGrid(scenePos);
+
+	// λû䣬
+	if (currentGrid == m_copyLastGrid)
+		return;
+
+	m_copyLastGrid = currentGrid;
+
+	// Ҫľ
+	int startX = qMin(m_copyStartGrid.x(), currentGrid.x());
+	int startY = qMin(m_copyStartGrid.y(), currentGrid.y());
+	int endX = qMax(m_copyStartGrid.x(), currentGrid.x());
+	int endY = qMax(m_copyStartGrid.y(), currentGrid.y());
+
+	// ¸ʾ
+	updateCopyHighlight(QPoint(startX, startY), QPoint(endX, endY));
+
+	// ̬Ƭ򣬷ûûзùλ
+	int gridW = tile->gridWidth();
+	int gridH = tile->gridHeight();
+
+	for (int gy = startY; gy <= endY; gy += gridH)
+	{
+		for (int gx = startX; gx <= endX; gx += gridW)
+		{
+			QPair<int, int> pos = qMakePair(gx, gy);
+
+			// Ѿùλ
+			if (m_copyPlacedPositions.contains(pos))
+				continue;
+
+			// ߽
+			if (!isInsideMap(gx, gy, gridW, gridH))
+				continue;
+
+			// Է
+			MapTileItem* newTile = copyTileToGrid(tile, gx, gy);
+			if (newTile)
+			{
+				m_copyPlacedPositions.insert(pos);
+			}
+		}
+	}
+}
+
+void MapViewWidget::onCopyDragFinished(MapTileItem* tile)
+{
+	Q_UNUSED(tile);
+
+	m_copyDragging = false;
+	m_copyPlacedPositions.clear();
+	clearCopyHighlight();
+
+	qDebug() << "Copy drag finished";
+}
+
+void MapViewWidget::updateCopyHighlight(const QPoint& startGrid, const QPoint& endGrid)
+{
+	clearCopyHighlight();
+
+	// ĸ
+	for (int gy = startGrid.y(); gy <= endGrid.y(); ++gy)
+	{
+		for (int gx = startGrid.x(); gx <= endGrid.x(); ++gx)
+		{
+			if (!isInsideMap(gx, gy))
+				continue;
+
+			QPointF topLeft = gridToScene(gx, gy);
+			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
+
+			// ʹòͬɫѷúʹ
+			if (hasPlacedTileAt(gx, gy, m_currentLayer))
+			{
+				rect->setPen(QPen(QColor(200, 200, 200), 1));
+				rect->setBrush(QBrush(QColor(200, 200, 200, 30)));
+			}
+			else
+			{
+				rect->setPen(QPen(QColor(100, 200, 100), 1));
+				rect->setBrush(QBrush(QColor(100, 200, 100, 40)));
+			}
+
+			rect->setZValue(998);
+			m_scene->addItem(rect);
+			m_copyHighlights.append(rect);
+		}
+	}
+}
+
+void MapViewWidget::clearCopyHighlight()
+{
+	for (auto* rect : m_copyHighlights)
+	{
+		m_scene->removeItem(rect);
+		delete rect;
+	}
+	m_copyHighlights.clear();
+}
+
+// ============== ɾƬ ==============
+
+MapTileItem* MapViewWidget::getTileAtGrid(int gridX, int gridY, int layer) const
+{
+	return m_tileStore.tileAt(layer, gridX, gridY);
+}
+
+void MapViewWidget::deleteTileAtGrid(int gridX, int gridY)
+{
+	MapTileItem* tile = getTileAtGrid(gridX, gridY, m_currentLayer);
+	if (!tile)
+		return;
+
+	// ǵǰѡеƬɾԴƬ
+	if (tile == m_selectedTile)
+		return;
+
+	destroyTileItem(tile);
+
+	qDebug() << "Deleted tile at grid:" << gridX << "," << gridY;
+}
+
+void MapViewWidget::onDeleteDragStarted(MapTileItem* tile, CornerZone corner)
+{
+	if (!tile || tile != m_selectedTile)
+		return;
+
+	m_deleteDragging = true;
+	m_deleteStartGrid = QPoint(tile->gridX(), tile->gridY());
+	m_deleteLastGrid = m_deleteStartGrid;
+	m_deleteRemovedPositions.clear();
+
+	// ¼ԴƬλãɾԴƬ
+	m_deleteRemovedPositions.insert(qMakePair(tile->gridX(), tile->gridY()));
+
+	qDebug() << "Delete drag started from corner:" << static_cast<int>(corner)
+		<< "at grid:" << m_deleteStartGrid;
+}
+
+void MapViewWidget::onDeleteDragMoved(MapTileItem* tile, const QPointF& scenePos)
+{
+	if (!m_deleteDragging || !tile)
+		return;
+
+	QPoint currentGrid = sceneToGrid(scenePos);
+
+	// λû䣬
+	if (currentGrid == m_deleteLastGrid)
+		return;
+
+	m_deleteLastGrid = currentGrid;
+
+	// Ҫɾľ
+	int startX = qMin(m_deleteStartGrid.x(), currentGrid.x());
+	int startY = qMin(m_deleteStartGrid.y(), currentGrid.y());
+	int endX = qMax(m_deleteStartGrid.x(), currentGrid.x());
+	int endY = qMax(m_deleteStartGrid.y(), currentGrid.y());
+
+	// ¸ʾ
+	updateDeleteHighlight(QPoint(startX, startY), QPoint(endX, endY));
+
+	// ̬ɾƬ
+	for (int gy = startY; gy <= endY; ++gy)
+	{
+		for (int gx = startX; gx <= endX; ++gx)
+		{
+			QPair<int, int> pos = qMakePair(gx, gy);
+
+			// Ѿλ
+			if (m_deleteRemovedPositions.contains(pos))
+				continue;
+
+			// ߽
+			if (!isInsideMap(gx, gy))
+				continue;
+
+			// ɾ
+			deleteTileAtGrid(gx, gy);
+			m_deleteRemovedPositions.insert(pos);
+		}
+	}
+}
+
+void MapViewWidget::onDeleteDragFinished(MapTileItem* tile)
+{
+	Q_UNUSED(tile);
+
+	m_deleteDragging = false;
+	m_deleteRemovedPositions.clear();
+	clearDeleteHighlight();
+
+	qDebug() << "Delete drag finished";
+}
+
+void MapViewWidget::updateDeleteHighlight(const QPoint& startGrid, const QPoint& endGrid)
+{
+	clearDeleteHighlight();
+
+	// ɾĸɫ
+	for (int gy = startGrid.y(); gy <= endGrid.y(); ++gy)
+	{
+		for (int gx = startGrid.x(); gx <= endGrid.x(); ++gx)
+		{
+			if (!isInsideMap(gx, gy))
+				continue;
+
+			QPointF topLeft = gridToScene(gx, gy);
+			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
+
+			// ǷԴƬλ
+			bool isSourceTile = (gx == m_deleteStartGrid.x() && gy == m_deleteStartGrid.y());
+
+			if (isSourceTile)
+			{
+				// ԴƬλɫǣᱻɾ
+				rect->setPen(QPen(QColor(80, 140, 255), 2));
+				rect->setBrush(QBrush(QColor(80, 140, 255, 40)));
+			}
+			else if (hasPlacedTileAt(gx, gy, m_currentLayer))
+			{
+				// Ƭλúɫǣɾ
+				rect->setPen(QPen(QColor(255, 100, 100), 2));
+				rect->setBrush(QBrush(QColor(255, 100, 100, 60)));
+			}
+			else
+			{
+				// λǳɫ
+				rect->setPen(QPen(QColor(255, 150, 150), 1));
+				rect->setBrush(QBrush(QColor(255, 150, 150, 30)));
+			}
+
+			rect->setZValue(998);
+			m_scene->addItem(rect);
+			m_deleteHighlights.append(rect);
+		}
+	}
+}
+
+void MapViewWidget::clearDeleteHighlight()
+{
+	for (auto* rect : m_deleteHighlights)
+	{
+		m_scene->removeItem(rect);
+		delete rect;
+	}
+	m_deleteHighlights.clear();
+}
+
+// ============== Ϸ¼ ==============
+
+void MapViewWidget::dragEnterEvent(QDragEnterEvent* event)
+{
+	if (event->mimeData()->hasFormat(TILE_MIME_TYPE))
+	{
+		auto* tileMime = qobject_cast<const TileMimeData*>(event->mimeData());
+		if (tileMime && tileMime->tileData().isValid())
+		{
+			// ֤ߴ
+			const auto& slice = tileMime->tileData().slice;
+			if (validateTileSize(slice.sourceWidth(), slice.sourceHeight()))
+			{
+				event->acceptProposedAction();
+				return;
+			}
+		}
+	}
+	event->ignore();
+}
+
+void MapViewWidget::dragMoveEvent(QDragMoveEvent* event)
+{
+	if (!event->mimeData()->hasFormat(TILE_MIME_TYPE))
+	{
+		event->ignore();
+		return;
+	}
+
+	auto* tileMime = qobject_cast<const TileMimeData*>(event->mimeData());
+	if (!tileMime)
+	{
+		event->ignore();
+		return;
+	}
+
+	// ֤ߴ
+	const auto& slice = tileMime->tileData().slice;
+	if (!validateTileSize(slice.sourceWidth(), slice.sourceHeight()))
+	{
+		clearDropHighlight();
+		event->ignore();
+		return;
+	}
+
+	QPointF scenePos = mapToScene(event->position().toPoint());
+	updateDropHighlight(scenePos, tileMime->tileData());
+
+	event->acceptProposedAction();
+}
+
+void MapViewWidget::dragLeaveEvent(QDragLeaveEvent* event)
+{
+	Q_UNUSED(event);
+	clearDropHighlight();
+}
+
+void MapViewWidget::dropEvent(QDropEvent* event)
+{
+	if (!event->mimeData()->hasFormat(TILE_MIME_TYPE))
+	{
+		event->ignore();
+		return;
+	}
+
+	auto* tileMime = qobject_cast<const TileMimeData*>(event->mimeData());
+	if (!tileMime || !tileMime->tileData().isValid())
+	{
+		event->ignore();
+		return;
+	}
+
+	// ֤ߴ
+	const auto& slice = tileMime->tileData().slice;
+	if (!validateTileSize(slice.sourceWidth(), slice.sourceHeight()))
+	{
+		clearDropHighlight();
+		event->ignore();
+		qDebug() << "Drop rejected: tile size" << slice.sourceWidth() << "x" << slice.sourceHeight()
+			<< "doesn't match grid size" << m_tileWidth << "x" << m_tileHeight;
+		return;
+	}
+
+	if (isLayerLocked(m_currentLayer))
+	{
+		clearDropHighlight();
+		event->ignore();
+		qDebug() << "Drop rejected: layer" << m_currentLayer << "is locked";
+		return;
+	}
+
+	QPointF scenePos = mapToScene(event->position().toPoint());
+	QPoint gridPos = sceneToGrid(scenePos);
+
+	if (isInsideMap(gridPos.x(), gridPos.y()))
+	{
+		placeTile(tileMime->tileData(), gridPos);
+		event->acceptProposedAction();
+	}
+	else
+	{
+		event->ignore();
+	}
+
+	clearDropHighlight();
+}
+
+void MapViewWidget::updateDropHighlight(const QPointF& scenePos, const TileDragData& tileData)
+{
+	QPoint gridPos = sceneToGrid(scenePos);
+
+	if (!isInsideMap(gridPos.x(), gridPos.y()))
+	{
+		clearDropHighlight();
+		return;
+	}
+
+	int gridW = tileData.slice.sourceWidth() / m_tileWidth;
+	int gridH = tileData.slice.sourceHeight() / m_tileHeight;
+
+	for (auto* rect : m_coverageHighlights)
+	{
+		m_scene->removeItem(rect);
+		delete rect;
+	}
+	m_coverageHighlights.clear();
+
+	for (int dy = 0; dy < gridH; ++dy)
+	{
+		for (int dx = 0; dx < gridW; ++dx)
+		{
+			int gx = gridPos.x() + dx;
+			int gy = gridPos.y() + dy;
+
+			if (!isInsideMap(gx, gy))
+				continue;
+
+			QPointF topLeft = gridToScene(gx, gy);
+			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
+
+			if (dx == 0 && dy == 0)
+			{
+				rect->setPen(QPen(QColor(80, 140, 255), 2));
+				rect->setBrush(QBrush(QColor(80, 140, 255, 60)));
+			}
+			else
+			{
+				rect->setPen(QPen(QColor(255, 180, 80), 1));
+				rect->setBrush(QBrush(QColor(255, 180, 80, 40)));
+			}
+
+			rect->setZValue(999);
+			m_scene->addItem(rect);
+			m_coverageHighlights.append(rect);
+		}
+	}
+
+	QPointF topLeft = gridToScene(gridPos.x(), gridPos.y());
+	m_dropHighlight->setRect(topLeft.x(), topLeft.y(),
+		gridW * m_tileWidth, gridH * m_tileHeight);
+	m_dropHighlight->setVisible(false);
+}
+
+void MapViewWidget::clearDropHighlight()
+{
+	m_dropHighlight->setVisible(false);
+
+	for (auto* rect : m_coverageHighlights)
+	{
+		m_scene->removeItem(rect);
+		delete rect;
+	}
+	m_coverageHighlights.clear();
+}
+
+QPoint MapViewWidget::sceneToGrid(const QPointF& scenePos) const
+{
+	int gridX = static_cast<int>(qFloor(scenePos.x() / m_tileWidth));
+	int gridY = static_cast<int>(qFloor(scenePos.y() / m_tileHeight));
+	return QPoint(gridX, gridY);
+}
+
+QPointF MapViewWidget::gridToScene(int gridX, int gridY) const
+{
+	return QPointF(gridX * m_tileWidth, gridY * m_tileHeight);
+}
+
+void MapViewWidget::placeTile(const TileDragData& tileData, const QPoint& gridPos)
+{
+	if (!tileData.isValid())
+		return;
+
+	// ΪѾֱ֤
+	int gridW = tileData.slice.sourceWidth() / m_tileWidth;
+	int gridH = tileData.slice.sourceHeight() / m_tileHeight;
+
+	QPixmap scaledPixmap = tileData.pixmap.scaled(
+		gridW * m_tileWidth,
+		gridH * m_tileHeight,
+		Qt::IgnoreAspectRatio,
+		pixmapTransformMode()
+	);
+
+	// ƬͼԪ뵱ǰͼ
+	createTileItem(scaledPixmap, tileData.slice, tileData.tilesetId,
+		gridPos.x(), gridPos.y(), gridW, gridH, m_currentLayer);
+
+	qDebug() << "Placed tile:" << tileData.slice.name
+		<< "at grid:" << gridPos
+		<< "size:" << gridW << "x" << gridH
+		<< "layer:" << m_currentLayer;
+}
+
+// ============== ƬͼԪ ==============
+
+MapTileItem* MapViewWidget::createTileItem(const QPixmap& pixmap, const SpriteSlice& slice, const QString& tilesetId,
+	int gridX, int gridY, int gridW, int gridH, int layer)
+{
+	// ޵ͼдѻķֿǰͬ
+	if (m_infinite)
+		ensureChunkResident(MapChunkCache::chunkOf(gridX, gridY));
+
+	auto* tileItem = insertTileItem(pixmap, slice, tilesetId, gridX, gridY, gridW, gridH, layer);
+	markTileDirty(tileItem);
+	scheduleUsageNotify();
+
+	return tileItem;
+}
+
+MapTileItem* MapViewWidget::insertTileItem(const QPixmap& pixmap, const SpriteSlice& slice, const QString& tilesetId,
+	int gridX, int gridY, int gridW, int gridH, int layer)
+{
+	auto* tileItem = new MapTileItem(pixmap, slice, gridX, gridY, layer);
+	tileItem->setTilesetId(tilesetId);
+	tileItem->setGridSize(gridW, gridH);
+	tileItem->setTransformationMode(pixmapTransformMode());
+	if (slice.isAnimated())
+		tileItem->setAnimation(tileAnimation(tilesetId, slice, gridW, gridH));
+
+	// ҵͼڵ£λʹñ꣨ԭɸڵе
+	// Ƭͼڲ棨ϲͼ Z ֵΧ
+	MapLayerRoot* root = layerRoot(layer);
+	tileItem->setParentItem(root);
+	tileItem->setGridPos(gridX, gridY);
+	tileItem->setPos(gridToScene(tileItem->localGridX(), tileItem->localGridY()));
+	tileItem->setZValue(root->topZ());
+
+	m_tileStore.insert(tileItem);
+	return tileItem;
+}
+
+void MapViewWidget::destroyTileItem(MapTileItem* tile)
+{
+	if (!tile)
+		return;
+
+	if (tile == m_selectedTile)
+	{
+		m_selectedTile = nullptr;
+		emit tileDeselected();
+	}
+
+	markTileDirty(tile);
+	m_tileStore.remove(tile);
+	m_scene->removeItem(tile);
+	scheduleUsageNotify();
+
+	// ܴźŻصУӳɾ
+	tile->deleteLater();
+}
+
+bool MapViewWidget::moveTile(MapTileItem* tile, int gridX, int gridY)
+{
+	if (!tile)
+		return false;
+
+	if (!isInsideMap(gridX, gridY, tile->gridWidth(), tile->gridHeight()))
+	{
+		tile->setPos(gridToScene(tile->localGridX(), tile->localGridY()));
+		return false;
+	}
+
+	if (m_infinite)
+		ensureChunkResident(MapChunkCache::chunkOf(gridX, gridY));
+
+	// עλõٵǼλ
+	markTileDirty(tile);
+	m_tileStore.remove(tile);
+	tile->setGridPos(gridX, gridY);
+	tile->setPos(gridToScene(tile->localGridX(), tile->localGridY()));
+	m_tileStore.insert(tile);
+	markTileDirty(tile);
+	return true;
+}
+
+void MapViewWidget::setTileLayer(MapTileItem* tile, int layer)
+{
+	if (!tile || tile->layer() == layer)
+		return;
+
+	// ͼڵԭͬڵ㲻Ӱλ
+	m_tileStore.remove(tile);
+	tile->setLayer(layer);
+	MapLayerRoot* root = layerRoot(layer);
+	tile->setParentItem(root);
+	tile->setZValue(root->topZ());
+	m_tileStore.insert(tile);
+	markTileDirty(tile);
+}
+
+void MapViewWidget::setTileCollisionType(MapTileItem* tile, CollisionType type)
+{
+	if (!tile || tile->collisionType() == type)
+		return;
+
+	tile->setCollisionType(type);
+	markTileDirty(tile);
+}
+
+// ============== Ƭ ==============
+
+const MapTileAnimation* MapViewWidget::tileAnimation(const QString& tilesetId, const SpriteSlice& slice, int gridW, int gridH)
+{
+	auto it = m_animations.constFind(slice.id);
+	if (it != m_animations.constEnd())
+		return it->animation.data();
+
+	QVector<QPixmap> sources;
+	if (!m_frameResolver || !m_frameResolver(tilesetId, slice.id, sources) || sources.size() < 2)
+		return nullptr;
+
+	// ÿֻ֡һΣƬ
+	QVector<QPixmap> frames;
+	QVector<int> durations;
+	frames.reserve(sources.size());
+	durations.reserve(sources.size());
+	for (int i = 0; i < sources.size(); ++i)
+	{
+		frames.append(sources[i].scaled(gridW * m_tileWidth, gridH * m_tileHeight,
+			Qt::IgnoreAspectRatio, pixmapTransformMode()));
+		durations.append(slice.frames.value(i).duration);
+	}
+
+	if (!m_animationClock.isValid())
+		m_animationClock.start();
+
+	SliceAnimation entry;
+	entry.animation = QSharedPointer<MapTileAnimation>::create(frames, durations);
+	entry.animation->advanceTo(m_animationClock.elapsed());
+	m_animations.insert(slice.id, entry);
+
+	if (!m_animationTimer.isActive())
+		m_animationTimer.start();
+
+	qDebug() << "Animated slice:" << slice.name << "frames:" << frames.size();
+	return entry.animation.data();
+}
+
+void MapViewWidget::advanceAnimations()
+{
+	const qint64 now = m_animationClock.elapsed();
+
+	QHash<quint64, QPoint> changed;
+	for (auto it = m_animations.begin(); it != m_animations.end();)
+	{
+		SliceAnimation& entry = it.value();
+
+		// Ƭ仯ؽֿбûƬʹõƬͷ֡
+		if (entry.chunksDirty)
+		{
+			QHash<quint64, QPoint> chunks;
+			for (const MapTileItem* tile : m_tileStore.tilesUsingSlice(it.key()))
+			{
+				const QPoint first = MapChunkCache::chunkOf(tile->gridX(), tile->gridY());
+				const QPoint last = MapChunkCache::chunkOf(tile->gridX() + tile->gridWidth() - 1,
+					tile->gridY() + tile->gridHeight() - 1);
+				for (int cy = first.y(); cy <= last.y(); ++cy)
+				{
+					for (int cx = first.x(); cx <= last.x(); ++cx)
+						chunks.insert(MapChunkCache::chunkKey(QPoint(cx, cy)), QPoint(cx, cy));
+				}
+			}
+
+			if (chunks.isEmpty())
+			{
+				it = m_animations.erase(it);
+				continue;
+			}
+
+			entry.chunks = QVector<QPoint>(chunks.cbegin(), chunks.cend());
+			entry.chunksDirty = false;
+		}
+
+		// ֡ƬƽʹƬ޹
+		if (entry.animation->advanceTo(now))
+		{
+			for (const QPoint& chunk : entry.chunks)
+				changed.insert(MapChunkCache::chunkKey(chunk), chunk);
+		}
+		++it;
+	}
+
+	if (m_animations.isEmpty())
+	{
+		m_animationTimer.stop();
+		return;
 	}
 
-	// Ƭ
-	auto* newTile = new MapTileItem(
-		sourceTile->originalPixmap(),
-		sourceTile->slice(),
-		gridX,
-		gridY,
-		m_currentLayer
-	);
+	// Сͼɷֿͼƣʾһ֡ҪػƬ
+	if (changed.isEmpty() || m_lodLevel != MapLodLevel::Full || !isVisible())
+		return;
 
-	newTile->setTilesetId(sourceTile->tilesetId());
-	newTile->setGridSize(gridW, gridH);
-	newTile->setPos(gridToScene(gridX, gridY));
-	newTile->setZValue(10 + m_currentLayer);
+	// ֻػӿڻ֡ķֿ飬ͼԪ
+	const QRectF visible = visibleGridRect();
+	for (const QPoint& chunk : changed)
+	{
+		const QRect area = MapChunkCache::chunkRect(chunk);
+		if (!visible.intersects(QRectF(area)))
+			continue;
 
-	// ƿɱ༭
-	newTile->setCollisionType(sourceTile->collisionType());
-	newTile->setTags(sourceTile->tags());
-	newTile->setDisplayName(sourceTile->displayName());
+		m_scene->update(QRectF(gridToScene(area.x(), area.y()),
+			QSizeF(area.width() * m_tileWidth, area.height() * m_tileHeight)));
+	}
+}
 
-	// Ʒתת״̬
-	newTile->setFlipX(sourceTile->isFlippedX());
-	newTile->setFlipY(sourceTile->isFlippedY());
-	newTile->setRotation(sourceTile->rotation());
+void MapViewWidget::markAnimationDirty(const QUuid& sliceId)
+{
+	auto it = m_animations.find(sliceId);
+	if (it != m_animations.end())
+		it->chunksDirty = true;
+}
 
-	// ź
-	connect(newTile, &MapTileItem::clicked, this, &MapViewWidget::onTileClicked);
-	connect(newTile, &MapTileItem::dragStarted, this, &MapViewWidget::onTileDragStarted);
-	connect(newTile, &MapTileItem::dragFinished, this, &MapViewWidget::onTileDragFinished);
-	connect(newTile, &MapTileItem::copyDragStarted, this, &MapViewWidget::onCopyDragStarted);
-	connect(newTile, &MapTileItem::copyDragMoved, this, &MapViewWidget::onCopyDragMoved);
-	connect(newTile, &MapTileItem::copyDragFinished, this, &MapViewWidget::onCopyDragFinished);
-	connect(newTile, &MapTileItem::deleteDragStarted, this, &MapViewWidget::onDeleteDragStarted);
-	connect(newTile, &MapTileItem::deleteDragMoved, this, &MapViewWidget::onDeleteDragMoved);
-	connect(newTile, &MapTileItem::deleteDragFinished, this, &MapViewWidget::onDeleteDragFinished);
+void MapViewWidget::clearAnimations()
+{
+	m_animations.clear();
+	m_animationTimer.stop();
+}
 
-	m_scene->addItem(newTile);
-	m_placedTiles.append(newTile);
+// ============== ײ決Ԥ ==============
 
-	qDebug() << "Copied tile to grid:" << gridX << "," << gridY;
+void MapViewWidget::setCollisionOverlayVisible(bool visible)
+{
+	if (m_collisionOverlay->isVisible() == visible)
+		return;
 
-	return newTile;
+	m_collisionOverlay->setVisible(visible);
+
+	// ڼۻֿʾʱһ
+	if (visible)
+		scheduleCollisionBake();
 }
 
-void MapViewWidget::onCopyDragStarted(MapTileItem* tile, CornerZone corner)
+bool MapViewWidget::isCollisionOverlayVisible() const
 {
-	if (!tile || tile != m_selectedTile)
+	return m_collisionOverlay->isVisible();
+}
+
+void MapViewWidget::markTileDirty(const MapTileItem* tile)
+{
+	if (tile->animation())
+		markAnimationDirty(tile->slice().id);
+
+	markAreaDirty(QRect(tile->gridX(), tile->gridY(), tile->gridWidth(), tile->gridHeight()));
+}
+
+void MapViewWidget::markAreaDirty(const QRect& footprint)
+{
+	if (footprint.isEmpty())
 		return;
 
-	m_copyDragging = true;
-	m_copyStartGrid = QPoint(tile->gridX(), tile->gridY());
-	m_copyLastGrid = m_copyStartGrid;
-	m_copyPlacedPositions.clear();
+	m_collisionBaker.markDirty(footprint);
+	m_navGrid.markDirty(footprint);
+	scheduleCollisionBake();
+	scheduleNavigation();
 
-	// ¼ԴƬλãظã
-	m_copyPlacedPositions.insert(qMakePair(tile->gridX(), tile->gridY()));
+	const QPoint first = MapChunkCache::chunkOf(footprint.left(), footprint.top());
+	const QPoint last = MapChunkCache::chunkOf(footprint.right(), footprint.bottom());
+	for (int cy = first.y(); cy <= last.y(); ++cy)
+	{
+		for (int cx = first.x(); cx <= last.x(); ++cx)
+		{
+			m_changedChunks.insert(MapChunkCache::chunkKey(QPoint(cx, cy)), QPoint(cx, cy));
+			m_lodLayer->invalidateChunk(QPoint(cx, cy));
+		}
+	}
+	scheduleChunkNotify();
+}
 
-	qDebug() << "Copy drag started from corner:" << static_cast<int>(corner)
-		<< "at grid:" << m_copyStartGrid;
+void MapViewWidget::scheduleChunkNotify()
+{
+	if (m_chunkNotifyPending)
+		return;
+
+	m_chunkNotifyPending = true;
+	QTimer::singleShot(0, this, [this]() {
+		m_chunkNotifyPending = false;
+		if (m_changedChunks.isEmpty())
+			return;
+
+		const QVector<QPoint> chunks(m_changedChunks.cbegin(), m_changedChunks.cend());
+		m_changedChunks.clear();
+		emit chunksChanged(chunks);
+		});
 }
 
-void MapViewWidget::onCopyDragMoved(MapTileItem* tile, const QPointF& scenePos)
+void MapViewWidget::scheduleCollisionBake()
 {
-	if (!m_copyDragging || !tile)
+	if (m_collisionBakePending || !m_collisionOverlay->isVisible() || !m_collisionBaker.hasDirty())
 		return;
 
-	QPoint currentGrid = sceneToGrid(scenePos);
+	m_collisionBakePending = true;
+	QTimer::singleShot(0, this, [this]() {
+		m_collisionBakePending = false;
+		bakeCollision();
+		});
+}
 
-	// λû䣬
-	if (currentGrid == m_copyLastGrid)
+QVector<CollisionFootprint> MapViewWidget::collisionFootprints(const QRect& area, bool scanAll) const
+{
+	QVector<CollisionFootprint> footprints;
+
+	// Ǹ÷ΧƬԭڷΧĶƬ
+	auto collect = [&](const MapTileItem* tile) {
+		if (tile->collisionType() == CollisionType::None)
+			return;
+		footprints.append(CollisionFootprint{
+			QRect(tile->gridX(), tile->gridY(), tile->gridWidth(), tile->gridHeight()),
+			layerOrder(tile->layer()), tile->collisionType() });
+	};
+	if (scanAll)
+	{
+		m_tileStore.forEachTile(collect);
+	}
+	else
+	{
+		for (const MapTileItem* tile : m_tileStore.tilesInRect(area))
+			collect(tile);
+	}
+
+	// Ԥʵ뵼ͬչ
+	forEachPrefabTile(area, [&](const MapExportTile& tile, const QPixmap&) {
+		if (tile.collisionType == CollisionType::None)
+			return;
+		footprints.append(CollisionFootprint{
+			QRect(tile.gridX, tile.gridY, tile.gridWidth, tile.gridHeight),
+			layerOrder(tile.layer), tile.collisionType });
+		});
+
+	return footprints;
+}
+
+void MapViewWidget::bakeCollision()
+{
+	const QVector<QPoint> chunks = m_collisionBaker.takeDirtyChunks();
+	if (chunks.isEmpty())
 		return;
 
-	m_copyLastGrid = currentGrid;
+	for (const QPoint& chunk : chunks)
+	{
+		const QRect area = MapChunkCache::chunkRect(chunk);
+		const QVector<CollisionFootprint> footprints = collisionFootprints(area, false);
 
-	// Ҫľ
-	int startX = qMin(m_copyStartGrid.x(), currentGrid.x());
-	int startY = qMin(m_copyStartGrid.y(), currentGrid.y());
-	int endX = qMax(m_copyStartGrid.x(), currentGrid.x());
-	int endY = qMax(m_copyStartGrid.y(), currentGrid.y());
+		m_collisionBaker.setChunkRects(chunk, footprints.isEmpty() ? QVector<CollisionRect>()
+			: CollisionBaker::greedyMesh(CollisionBaker::rasterize(area, footprints), area));
 
-	// ¸ʾ
-	updateCopyHighlight(QPoint(startX, startY), QPoint(endX, endY));
+		const QPointF topLeft = gridToScene(area.x(), area.y());
+		m_collisionOverlay->chunkChanged(QRectF(topLeft,
+			QSizeF(area.width() * m_tileWidth, area.height() * m_tileHeight)));
+	}
+
+	emit collisionBaked(m_collisionBaker.rectCount());
+}
+
+// ============== Ѱ·Ԥ ==============
+
+void MapViewWidget::setNavigationEndpoints(const QPoint& start, const QPoint& goal)
+{
+	m_navStart = start;
+	m_navGoal = goal;
+	m_navOverlay->setEndpoints(m_navStart, m_navGoal);
+	scheduleNavigation();
+}
+
+void MapViewWidget::setNavigationEndpoint(const QPoint& cell, bool isStart)
+{
+	if (isStart)
+		m_navStart = cell;
+	else
+		m_navGoal = cell;
+
+	m_navOverlay->setEndpoints(m_navStart, m_navGoal);
+	scheduleNavigation();
+}
+
+void MapViewWidget::clearNavigationPreview()
+{
+	m_navStart.reset();
+	m_navGoal.reset();
+	m_navOverlay->clear();
+
+	// ͷ´Ԥʱ·Χؽ
+	m_navGrid.setBounds(QRect());
+}
+
+void MapViewWidget::scheduleNavigation()
+{
+	if (m_navPending || !m_navStart || !m_navGoal)
+		return;
+
+	m_navPending = true;
+	QTimer::singleShot(0, this, [this]() {
+		m_navPending = false;
+		updateNavigation();
+		});
+}
+
+void MapViewWidget::updateNavigation()
+{
+	if (!m_navStart || !m_navGoal)
+		return;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	refreshNavGrid();
+	const NavPathResult result = m_navGrid.findPath(*m_navStart, *m_navGoal);
+
+	const double elapsedMs = timer.nsecsElapsed() / 1000000.0;
+	m_navOverlay->setResult(result.waypoints, result.explored);
+
+	qDebug() << "Navigation:" << (result.found ? "found" : "no path") << "cost" << result.cost
+		<< "jump points" << result.explored.size() << "scanned" << result.scannedCells
+		<< "in" << elapsedMs << "ms";
+	emit navigationPathFound(result.found, result.cost, result.explored.size(), elapsedMs);
+}
+
+QRect MapViewWidget::navigationBounds() const
+{
+	if (!m_infinite)
+		return QRect(0, 0, m_mapWidth, m_mapHeight);
+
+	QRect bounds;
+	for (const QPoint& chunk : m_residentChunks)
+		bounds = bounds.united(MapChunkCache::chunkRect(chunk));
+	if (m_navStart)
+		bounds = bounds.united(QRect(*m_navStart, QSize(1, 1)));
+	if (m_navGoal)
+		bounds = bounds.united(QRect(*m_navGoal, QSize(1, 1)));
+
+	const int margin = MapChunkCache::CHUNK_SIZE;
+	return bounds.adjusted(-margin, -margin, margin, margin);
+}
+
+void MapViewWidget::refreshNavGrid()
+{
+	// Χ仯ʱؽֻֿ
+	m_navGrid.setBounds(navigationBounds());
+
+	const bool rebuildAll = m_navGrid.isAllDirty();
+	const QVector<QRect> rects = m_navGrid.takeDirtyRects();
+	for (const QRect& rect : rects)
+	{
+		// ײԤͬһԴؽʱֱӱƬȰӲѯö
+		const QVector<CollisionFootprint> footprints = collisionFootprints(rect, rebuildAll);
+
+		// ײԤһ£ÿȡϲײͣGround 
+		m_navGrid.clearRect(rect);
+		if (!footprints.isEmpty())
+		{
+			const QVector<CollisionType> cells = CollisionBaker::rasterize(rect, footprints);
+			for (int y = 0; y < rect.height(); ++y)
+			{
+				const CollisionType* row = cells.constData() + y * rect.width();
+				for (int x = 0; x < rect.width();)
+				{
+					if (row[x] != CollisionType::Ground)
+					{
+						++x;
+						continue;
+					}
+
+					const int runStart = x;
+					while (x < rect.width() && row[x] == CollisionType::Ground)
+						++x;
+					m_navGrid.blockRect(QRect(rect.left() + runStart, rect.top() + y, x - runStart, 1));
+				}
+			}
+		}
+
+		// ѻķֿδ֪ߴ
+		if (m_infinite)
+		{
+			for (const QPoint& chunk : m_chunkCache.evictedChunks())
+				m_navGrid.blockRect(MapChunkCache::chunkRect(chunk).intersected(rect));
+		}
+	}
+}
+
+void MapViewWidget::scheduleUsageNotify()
+{
+	if (m_usageNotifyPending)
+		return;
+
+	m_usageNotifyPending = true;
+	QTimer::singleShot(0, this, [this]() {
+		m_usageNotifyPending = false;
+
+		// ԴɾʱۼƱ仯ֻϲͳŵͼ
+		QHash<QUuid, int> delta = m_tileStore.takeUsageDelta();
+		auto merge = [&delta](const QHash<QUuid, int>& part) {
+			for (auto it = part.constBegin(); it != part.constEnd(); ++it)
+				delta[it.key()] += it.value();
+		};
+		merge(m_chunkCache.takeUsageDelta());
+		merge(m_prefabUsageDelta);
+		m_prefabUsageDelta.clear();
+
+		//  / طֿʱƬ뻺ı仯
+		for (auto it = delta.begin(); it != delta.end();)
+			it = it.value() == 0 ? delta.erase(it) : std::next(it);
+
+		if (!delta.isEmpty())
+			emit sliceUsageChanged(delta);
+		});
+}
+
+void MapViewWidget::refreshInstanceUsage(const QUuid& instanceId)
+{
+	auto it = m_prefabInstances.constFind(instanceId);
+	if (it == m_prefabInstances.constEnd())
+		return;
+
+	//  sliceUsage ͳƷʽһ£ͼΧƬͼ㰴ǰչ
+	QHash<QUuid, int> usage;
+	const PrefabTemplate* prefab = prefabTemplate(it->prefabId);
+	if (prefab)
+	{
+		const QPoint origin = instanceOrigin(*it);
+		for (const MapExportTile& tile : prefab->tiles)
+		{
+			if (isInsideMap(tile.gridX + origin.x(), tile.gridY + origin.y(), tile.gridWidth, tile.gridHeight))
+				usage[tile.slice.id] += resolveLayers(tile.layer).size();
+		}
+	}
+
+	QHash<QUuid, int>& previous = m_instanceUsage[instanceId];
+	for (auto usageIt = previous.constBegin(); usageIt != previous.constEnd(); ++usageIt)
+		m_prefabUsageDelta[usageIt.key()] -= usageIt.value();
+	for (auto usageIt = usage.constBegin(); usageIt != usage.constEnd(); ++usageIt)
+		m_prefabUsageDelta[usageIt.key()] += usageIt.value();
+	previous = std::move(usage);
+	scheduleUsageNotify();
+}
+
+void MapViewWidget::forgetInstanceUsage(const QUuid& instanceId)
+{
+	auto it = m_instanceUsage.find(instanceId);
+	if (it == m_instanceUsage.end())
+		return;
+
+	for (auto usageIt = it->constBegin(); usageIt != it->constEnd(); ++usageIt)
+		m_prefabUsageDelta[usageIt.key()] -= usageIt.value();
+	m_instanceUsage.erase(it);
+	scheduleUsageNotify();
+}
+
+// ============== Ƭ/滻 ==============
+
+QVector<MapTileItem*> MapViewWidget::findSliceUsages(const QUuid& sliceId, int layer, const QRect& region) const
+{
+	QVector<MapTileItem*> result;
+	for (MapTileItem* tile : m_tileStore.tilesUsingSlice(sliceId))
+	{
+		if (layer >= 0 && tile->layer() != layer)
+			continue;
+		if (!region.isEmpty() && !region.contains(tile->gridX(), tile->gridY()))
+			continue;
+		result.append(tile);
+	}
+	return result;
+}
+
+int MapViewWidget::prefabSliceUsageCount(const QUuid& sliceId, int layer, const QRect& region) const
+{
+	int count = 0;
+	forEachPrefabTile(region.isEmpty() ? QRect() : region, [&](const MapExportTile& tile, const QPixmap&) {
+		if (tile.slice.id != sliceId)
+			return;
+		if (layer >= 0 && tile.layer != layer)
+			return;
+		if (!region.isEmpty() && !region.contains(tile.gridX, tile.gridY))
+			return;
+		++count;
+		});
+	return count;
+}
+
+int MapViewWidget::replaceSlice(const QUuid& fromSliceId, const QString& toTilesetId, const QUuid& toSliceId,
+	int layer, const QRect& region, quint8 transform)
+{
+	return replaceSliceTiles(fromSliceId, toTilesetId, toSliceId, layer, region, transform, false);
+}
+
+int MapViewWidget::remapSlices(const QString& tilesetId, const QVector<SliceRemap>& remaps)
+{
+	if (remaps.isEmpty())
+		return 0;
+
+	int remapped = 0;
+
+	// ѻķֿ飺ֻõЩƬķֿ飬дддʧʱڴУ
+	if (m_infinite)
+	{
+		for (const QPoint& chunk : m_chunkCache.evictedChunks())
+		{
+			const bool used = std::any_of(remaps.begin(), remaps.end(), [this, &chunk](const SliceRemap& remap) {
+				return m_chunkCache.chunkUsesSlice(chunk, remap.fromId);
+				});
+			if (!used)
+				continue;
+
+			TileRegionData region;
+			if (!m_chunkCache.take(chunk, region))
+			{
+				qWarning() << "remapSlices: failed to read chunk" << chunk;
+				continue;
+			}
+
+			for (const SliceRemap& remap : remaps)
+				remapped += region.replaceSlice(remap.fromId, TileRegionSliceRef{ tilesetId, remap.toId }, remap.transform);
+
+			if (!m_chunkCache.store(chunk, region))
+			{
+				m_residentChunks.insert(MapChunkCache::chunkKey(chunk), chunk);
+				placeRegionCells(region, MapChunkCache::chunkRect(chunk).topLeft(), false);
+			}
+		}
+		scheduleStreaming();
+	}
+
+	// ڴеƬԭƬѲڣͼҲҪģԤ
+	for (const SliceRemap& remap : remaps)
+		remapped += replaceSliceTiles(remap.fromId, tilesetId, remap.toId, -1, QRect(), remap.transform, true);
+
+	scheduleUsageNotify();
+	return remapped;
+}
+
+int MapViewWidget::replaceSliceTiles(const QUuid& fromSliceId, const QString& toTilesetId, const QUuid& toSliceId,
+	int layer, const QRect& region, quint8 transform, bool includeLocked)
+{
+	if (fromSliceId == toSliceId)
+		return 0;
+
+	// ԤʵֻŵͼΧŸд
+	const bool includePrefabs = (layer < 0 && region.isEmpty() && m_ctx);
+	const QVector<MapTileItem*> targets = findSliceUsages(fromSliceId, layer, region);
+	if (targets.isEmpty() && !includePrefabs)
+		return 0;
+
+	if (!m_sliceResolver)
+	{
+		qWarning() << "replaceSlice: no slice resolver set";
+		return 0;
+	}
+
+	// ĿƬֻһΣƬͬһ pixmap
+	SpriteSlice toSlice;
+	QPixmap source;
+	if (!m_sliceResolver(toTilesetId, toSliceId, toSlice, source))
+	{
+		qWarning() << "replaceSlice: slice not found:" << toTilesetId << toSliceId;
+		return 0;
+	}
+
+	const int gridW = qMax(1, toSlice.sourceWidth() / m_tileWidth);
+	const int gridH = qMax(1, toSlice.sourceHeight() / m_tileHeight);
+	const QPixmap scaledPixmap = source.scaled(gridW * m_tileWidth, gridH * m_tileHeight,
+		Qt::IgnoreAspectRatio, pixmapTransformMode());
+	const MapTileAnimation* animation = toSlice.isAnimated()
+		? tileAnimation(toTilesetId, toSlice, gridW, gridH) : nullptr;
+	markAnimationDirty(fromSliceId);
+
+	int replaced = 0;
+	if (includePrefabs)
+	{
+		replaced += replacePrefabSlice(fromSliceId, TileRegionSliceRef{ toTilesetId, toSliceId },
+			QSize(gridW, gridH), transform);
+	}
+
+	for (MapTileItem* tile : targets)
+	{
+		// ߴ粻ͬıռøӣͼ㲻޸
+		if (tile->gridWidth() != gridW || tile->gridHeight() != gridH || (!includeLocked && isLayerLocked(tile->layer())))
+			continue;
+
+		m_tileStore.remove(tile);
+		tile->setTilesetId(toTilesetId);
+		tile->setSlice(toSlice, scaledPixmap);
+		tile->setAnimation(animation);
+		if (transform != 0)
+		{
+			const quint8 bits = TileTransformBits::compose(transform,
+				TileTransformBits::pack(tile->isFlippedX(), tile->isFlippedY(), tile->rotation()));
+			tile->setFlipX(TileTransformBits::flipX(bits));
+			tile->setFlipY(TileTransformBits::flipY(bits));
+			tile->setRotation(TileTransformBits::rotation(bits));
+		}
+		m_tileStore.insert(tile);
+		markTileDirty(tile);
+		++replaced;
+	}
+
+	if (replaced > 0)
+	{
+		scheduleUsageNotify();
+
+		// ˢ
+		if (m_selectedTile && targets.contains(m_selectedTile))
+			emit tileSelected(m_selectedTile);
+	}
+
+	qDebug() << "Replaced slice" << fromSliceId << "with" << toSliceId
+		<< "tiles:" << replaced << "/" << targets.size();
+
+	return replaced;
+}
+
+int MapViewWidget::replacePrefabSlice(const QUuid& fromSliceId, const TileRegionSliceRef& to, const QSize& gridSize,
+	quint8 transform)
+{
+	int replaced = 0;
+	const QVector<PrefabDefinition> prefabs = m_ctx->prefabLibrary.prefabs();
+	for (const PrefabDefinition& prefab : prefabs)
+	{
+		const bool used = std::any_of(prefab.content.slices.begin(), prefab.content.slices.end(),
+			[&fromSliceId](const TileRegionSliceRef& ref) { return ref.sliceId == fromSliceId; });
+		if (!used)
+			continue;
+
+		// ͼϵƬͬߴ粻ͬıռøӣԤ
+		bool sameSize = true;
+		if (const PrefabTemplate* expanded = prefabTemplate(prefab.id))
+		{
+			for (const MapExportTile& tile : expanded->tiles)
+			{
+				if (tile.slice.id == fromSliceId && QSize(tile.gridWidth, tile.gridHeight) != gridSize)
+				{
+					sameSize = false;
+					break;
+				}
+			}
+		}
+		if (!sameSize)
+			continue;
+
+		TileRegionData content = prefab.content;
+		const int cells = content.replaceSlice(fromSliceId, to, transform);
+
+		// ʵԤ仯Զˢ
+		m_ctx->prefabLibrary.updatePrefab(prefab.id, content);
+		replaced += cells * m_prefabUsers.count(prefab.id);
+	}
+	return replaced;
+}
+
+// ============== Ԥʵ ==============
+
+void MapViewWidget::SetContext(AppContext* p)
+{
+	m_ctx = p;
+	if (!m_ctx)
+		return;
+
+	connect(&m_ctx->prefabLibrary, &PrefabLibrary::prefabChanged, this, &MapViewWidget::onPrefabChanged);
+	connect(&m_ctx->prefabLibrary, &PrefabLibrary::prefabsCleared, this, [this]() {
+		clearAllPrefabInstances();
+		m_prefabRasters.clear();
+		m_prefabTemplates.clear();
+		});
+}
+
+const MapViewWidget::PrefabTemplate* MapViewWidget::prefabTemplate(const QUuid& prefabId) const
+{
+	if (!m_ctx)
+		return nullptr;
+
+	const PrefabDefinition* prefab = m_ctx->prefabLibrary.prefab(prefabId);
+	if (!prefab)
+		return nullptr;
+
+	PrefabTemplate& entry = m_prefabTemplates[prefabId];
+	if (entry.revision == prefab->revision && entry.tileWidth == m_tileWidth && entry.tileHeight == m_tileHeight)
+		return &entry;
+
+	entry.revision = prefab->revision;
+	entry.tileWidth = m_tileWidth;
+	entry.tileHeight = m_tileHeight;
+	entry.tiles = regionExportTiles(prefab->content, &entry.sources);
+	return &entry;
+}
+
+void MapViewWidget::indexPrefabInstance(const QUuid& instanceId, bool insert)
+{
+	auto it = m_prefabInstances.constFind(instanceId);
+	if (it == m_prefabInstances.constEnd() || it->size.isEmpty())
+		return;
+
+	// 겻ԭƽƸı䣬ҲҪ
+	const QRect local(it->localX, it->localY, it->size.width(), it->size.height());
+	const QPoint first = MapChunkCache::chunkOf(local.left(), local.top());
+	const QPoint last = MapChunkCache::chunkOf(local.right(), local.bottom());
+	for (int cy = first.y(); cy <= last.y(); ++cy)
+	{
+		for (int cx = first.x(); cx <= last.x(); ++cx)
+		{
+			const quint64 key = MapChunkCache::chunkKey(QPoint(cx, cy));
+			if (insert)
+			{
+				m_prefabChunks[key].append(instanceId);
+				continue;
+			}
+
+			auto bucket = m_prefabChunks.find(key);
+			if (bucket == m_prefabChunks.end())
+				continue;
+			bucket->removeAll(instanceId);
+			if (bucket->isEmpty())
+				m_prefabChunks.erase(bucket);
+		}
+	}
+}
+
+QVector<QUuid> MapViewWidget::prefabInstancesInRect(const QRect& gridRect) const
+{
+	QVector<QUuid> result;
+	if (gridRect.isEmpty() || m_prefabInstances.isEmpty())
+		return result;
 
-	// ̬Ƭ򣬷ûûзùλ
-	int gridW = tile->gridWidth();
-	int gridH = tile->gridHeight();
+	const QRect local = gridRect.translated(-m_gridOrigin);
+	const QPoint first = MapChunkCache::chunkOf(local.left(), local.top());
+	const QPoint last = MapChunkCache::chunkOf(local.right(), local.bottom());
 
-	for (int gy = startY; gy <= endY; gy += gridH)
+	// Χǵķֿʵķֿ黹ʱֱӱʵ
+	const qint64 chunkCount = qint64(last.x() - first.x() + 1) * (last.y() - first.y() + 1);
+	if (chunkCount > m_prefabChunks.size())
 	{
-		for (int gx = startX; gx <= endX; gx += gridW)
+		for (auto it = m_prefabInstances.constBegin(); it != m_prefabInstances.constEnd(); ++it)
 		{
-			QPair<int, int> pos = qMakePair(gx, gy);
-
-			// Ѿùλ
-			if (m_copyPlacedPositions.contains(pos))
-				continue;
+			if (instanceRect(*it).intersects(gridRect))
+				result.append(it.key());
+		}
+		return result;
+	}
 
-			// ߽
-			if (gx < 0 || gy < 0 || gx + gridW > m_mapWidth || gy + gridH > m_mapHeight)
+	QSet<QUuid> visited;
+	for (int cy = first.y(); cy <= last.y(); ++cy)
+	{
+		for (int cx = first.x(); cx <= last.x(); ++cx)
+		{
+			auto bucket = m_prefabChunks.constFind(MapChunkCache::chunkKey(QPoint(cx, cy)));
+			if (bucket == m_prefabChunks.constEnd())
 				continue;
 
-			// Է
-			MapTileItem* newTile = copyTileToGrid(tile, gx, gy);
-			if (newTile)
+			for (const QUuid& instanceId : *bucket)
 			{
-				m_copyPlacedPositions.insert(pos);
+				if (visited.contains(instanceId))
+					continue;
+				visited.insert(instanceId);
+
+				auto it = m_prefabInstances.constFind(instanceId);
+				if (it != m_prefabInstances.constEnd() && instanceRect(*it).intersects(gridRect))
+					result.append(instanceId);
 			}
 		}
 	}
+	return result;
 }
 
-void MapViewWidget::onCopyDragFinished(MapTileItem* tile)
+void MapViewWidget::forEachPrefabTile(const QRect& gridRect, const PrefabTileVisitor& visitor) const
 {
-	Q_UNUSED(tile);
-
-	m_copyDragging = false;
-	m_copyPlacedPositions.clear();
-	clearCopyHighlight();
-
-	qDebug() << "Copy drag finished";
-}
+	if (m_prefabInstances.isEmpty())
+		return;
 
-void MapViewWidget::updateCopyHighlight(const QPoint& startGrid, const QPoint& endGrid)
-{
-	clearCopyHighlight();
+	const QVector<QUuid> instances = gridRect.isNull()
+		? QVector<QUuid>(m_prefabInstances.keyBegin(), m_prefabInstances.keyEnd())
+		: prefabInstancesInRect(gridRect);
 
-	// ĸ
-	for (int gy = startGrid.y(); gy <= endGrid.y(); ++gy)
+	for (const QUuid& instanceId : instances)
 	{
-		for (int gx = startGrid.x(); gx <= endGrid.x(); ++gx)
+		auto it = m_prefabInstances.constFind(instanceId);
+		const PrefabTemplate* prefab = prefabTemplate(it->prefabId);
+		if (!prefab)
+			continue;
+
+		const QPoint origin = instanceOrigin(*it);
+		for (int i = 0; i < prefab->tiles.size(); ++i)
 		{
-			if (gx < 0 || gy < 0 || gx >= m_mapWidth || gy >= m_mapHeight)
+			const MapExportTile& source = prefab->tiles[i];
+			const QRect footprint(source.gridX + origin.x(), source.gridY + origin.y(), source.gridWidth, source.gridHeight);
+			if (!isInsideMap(footprint.x(), footprint.y(), footprint.width(), footprint.height()))
+				continue;
+			if (!gridRect.isNull() && !gridRect.intersects(footprint))
 				continue;
 
-			QPointF topLeft = gridToScene(gx, gy);
-			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
-
-			// ʹòͬɫѷúʹ
-			if (hasPlacedTileAt(gx, gy, m_currentLayer))
-			{
-				rect->setPen(QPen(QColor(200, 200, 200), 1));
-				rect->setBrush(QBrush(QColor(200, 200, 200, 30)));
-			}
-			else
+			// Ԥ屣ͼɾϲ
+			MapExportTile record = source;
+			record.gridX = footprint.x();
+			record.gridY = footprint.y();
+			for (int layer : resolveLayers(source.layer))
 			{
-				rect->setPen(QPen(QColor(100, 200, 100), 1));
-				rect->setBrush(QBrush(QColor(100, 200, 100, 40)));
+				record.layer = layer;
+				visitor(record, prefab->sources[i]);
 			}
-
-			rect->setZValue(998);
-			m_scene->addItem(rect);
-			m_copyHighlights.append(rect);
 		}
 	}
 }
 
-void MapViewWidget::clearCopyHighlight()
+bool MapViewWidget::isPrefabInstanceLocked(const QUuid& instanceId) const
 {
-	for (auto* rect : m_copyHighlights)
+	auto it = m_prefabInstances.constFind(instanceId);
+	if (it == m_prefabInstances.constEnd())
+		return false;
+
+	for (const MapPrefabItem* item : it->items)
 	{
-		m_scene->removeItem(rect);
-		delete rect;
+		if (isLayerLocked(item->layer()))
+			return true;
 	}
-	m_copyHighlights.clear();
+	return false;
 }
 
-// ============== ɾƬ ==============
-
-MapTileItem* MapViewWidget::getTileAtGrid(int gridX, int gridY, int layer) const
+const MapViewWidget::PrefabRaster* MapViewWidget::prefabRaster(const QUuid& prefabId)
 {
-	for (auto* tile : m_placedTiles)
+	if (!m_ctx)
+		return nullptr;
+
+	const PrefabDefinition* prefab = m_ctx->prefabLibrary.prefab(prefabId);
+	if (!prefab)
+		return nullptr;
+
+	PrefabRaster& raster = m_prefabRasters[prefabId];
+	if (raster.revision == prefab->revision && raster.tileWidth == m_tileWidth && raster.tileHeight == m_tileHeight)
+		return &raster;
+
+	raster = PrefabRaster();
+	raster.revision = prefab->revision;
+	raster.tileWidth = m_tileWidth;
+	raster.tileHeight = m_tileHeight;
+
+	const TileRegionData& content = prefab->content;
+	const QSize rasterSize(content.width * m_tileWidth, content.height * m_tileHeight);
+	if (rasterSize.isEmpty() || !m_sliceResolver)
+		return &raster;
+
+	// ÿƬֻһ
+	QVector<QPixmap> slicePixmaps(content.slices.size());
+	for (int i = 0; i < content.slices.size(); ++i)
+	{
+		SpriteSlice slice;
+		QPixmap source;
+		if (!m_sliceResolver(content.slices[i].tilesetId, content.slices[i].sliceId, slice, source))
+			continue;
+
+		const int gridW = qMax(1, slice.sourceWidth() / m_tileWidth);
+		const int gridH = qMax(1, slice.sourceHeight() / m_tileHeight);
+		slicePixmaps[i] = source.scaled(gridW * m_tileWidth, gridH * m_tileHeight,
+			Qt::IgnoreAspectRatio, pixmapTransformMode());
+	}
+
+	// ͼƵԵĹդϣͼڰ˳ʱĵһ£
+	QMap<int, QPainter*> painters;
+	QHash<int, QPixmap> transformed;   // (Ƭ, 任) -> 任 pixmap
+	for (const TileRegionCell& cell : content.cells)
 	{
-		if (tile->layer() != layer)
+		const QPixmap& base = slicePixmaps[cell.sliceRef];
+		if (base.isNull())
 			continue;
 
-		int tx = tile->gridX();
-		int ty = tile->gridY();
-		int tw = tile->gridWidth();
-		int th = tile->gridHeight();
+		QPixmap pixmap = base;
+		if (cell.transform != 0)
+		{
+			const int key = cell.sliceRef * 16 + cell.transform;
+			auto it = transformed.constFind(key);
+			if (it == transformed.constEnd())
+			{
+				//  MapTileItem::updateDisplayPixmap ͬı任
+				QTransform transform;
+				transform.scale(TileTransformBits::flipX(cell.transform) ? -1 : 1,
+					TileTransformBits::flipY(cell.transform) ? -1 : 1);
+				transform.rotate(TileTransformBits::rotation(cell.transform));
+				it = transformed.insert(key, base.transformed(transform, pixmapTransformMode()));
+			}
+			pixmap = it.value();
+		}
 
-		if (gridX >= tx && gridX < tx + tw && gridY >= ty && gridY < ty + th)
-			return tile;
+		QPainter* painter = painters.value(cell.layer, nullptr);
+		if (!painter)
+		{
+			QPixmap& layerPixmap = raster.layers[cell.layer];
+			layerPixmap = QPixmap(rasterSize);
+			layerPixmap.fill(Qt::transparent);
+			painter = new QPainter(&layerPixmap);
+			painters.insert(cell.layer, painter);
+		}
+
+		painter->drawPixmap(cell.x * m_tileWidth, cell.y * m_tileHeight, pixmap);
 	}
-	return nullptr;
+
+	for (QPainter* painter : painters)
+	{
+		painter->end();
+		delete painter;
+	}
+
+	return &raster;
 }
 
-void MapViewWidget::deleteTileAtGrid(int gridX, int gridY)
+void MapViewWidget::rebuildPrefabInstanceItems(const QUuid& instanceId)
 {
-	MapTileItem* tile = getTileAtGrid(gridX, gridY, m_currentLayer);
-	if (!tile)
+	auto it = m_prefabInstances.find(instanceId);
+	if (it == m_prefabInstances.end())
 		return;
 
-	// ǵǰѡеƬɾԴƬ
-	if (tile == m_selectedTile)
+	PrefabInstance& instance = it.value();
+	for (MapPrefabItem* item : instance.items)
+	{
+		invalidateLodItem(item);
+		m_scene->removeItem(item);
+		delete item;
+	}
+	instance.items.clear();
+
+	// ݻͼ仯¾ռ÷ΧײѰ·ʹü
+	markAreaDirty(instanceRect(instance));
+	indexPrefabInstance(instanceId, false);
+	const PrefabDefinition* prefab = m_ctx ? m_ctx->prefabLibrary.prefab(instance.prefabId) : nullptr;
+	instance.size = prefab ? QSize(prefab->content.width, prefab->content.height) : QSize();
+	indexPrefabInstance(instanceId, true);
+	markAreaDirty(instanceRect(instance));
+	refreshInstanceUsage(instanceId);
+
+	const PrefabRaster* raster = prefabRaster(instance.prefabId);
+	if (!raster)
 		return;
 
-	// бƳ
-	m_placedTiles.removeOne(tile);
+	const QPointF pos = gridToScene(instance.localX, instance.localY);
+	const bool highlighted = (instanceId == m_selectedPrefabInstance);
+	for (auto layerIt = raster->layers.constBegin(); layerIt != raster->layers.constEnd(); ++layerIt)
+	{
+		// Ԥ屣ͼɾϲ
+		for (int layer : resolveLayers(layerIt.key()))
+		{
+			auto* item = new MapPrefabItem(instanceId, layer);
+			item->setPixmap(layerIt.value());     // ʽ
+			item->setParentItem(layerRoot(layer));
+			item->setPos(pos);
+			item->setHighlighted(highlighted);
+			item->setTransformationMode(pixmapTransformMode());
+			instance.items.append(item);
+			invalidateLodItem(item);
+		}
+	}
+}
 
-	// ӳƳ
-	m_scene->removeItem(tile);
+QUuid MapViewWidget::placePrefab(const QUuid& prefabId, const QPoint& topLeft)
+{
+	if (!m_ctx)
+		return QUuid();
 
-	// ɾ
-	tile->deleteLater();
+	const PrefabDefinition* prefab = m_ctx->prefabLibrary.prefab(prefabId);
+	if (!prefab)
+		return QUuid();
 
-	qDebug() << "Deleted tile at grid:" << gridX << "," << gridY;
-}
+	if (!isInsideMap(topLeft.x(), topLeft.y(), prefab->content.width, prefab->content.height))
+	{
+		qDebug() << "Cannot place prefab: out of bounds at grid:" << topLeft;
+		return QUuid();
+	}
 
-void MapViewWidget::onDeleteDragStarted(MapTileItem* tile, CornerZone corner)
-{
-	if (!tile || tile != m_selectedTile)
-		return;
+	const QUuid instanceId = QUuid::createUuid();
 
-	m_deleteDragging = true;
-	m_deleteStartGrid = QPoint(tile->gridX(), tile->gridY());
-	m_deleteLastGrid = m_deleteStartGrid;
-	m_deleteRemovedPositions.clear();
+	PrefabInstance instance;
+	instance.prefabId = prefabId;
+	instance.localX = topLeft.x() - m_gridOrigin.x();
+	instance.localY = topLeft.y() - m_gridOrigin.y();
+	m_prefabInstances.insert(instanceId, instance);
+	m_prefabUsers.insert(prefabId, instanceId);
 
-	// ¼ԴƬλãɾԴƬ
-	m_deleteRemovedPositions.insert(qMakePair(tile->gridX(), tile->gridY()));
+	rebuildPrefabInstanceItems(instanceId);
 
-	qDebug() << "Delete drag started from corner:" << static_cast<int>(corner)
-		<< "at grid:" << m_deleteStartGrid;
+	qDebug() << "Placed prefab:" << prefab->name << "at grid:" << topLeft;
+	return instanceId;
 }
 
-void MapViewWidget::onDeleteDragMoved(MapTileItem* tile, const QPointF& scenePos)
+bool MapViewWidget::movePrefabInstance(const QUuid& instanceId, const QPoint& topLeft)
 {
-	if (!m_deleteDragging || !tile)
-		return;
+	auto it = m_prefabInstances.find(instanceId);
+	if (it == m_prefabInstances.end() || !m_ctx)
+		return false;
 
-	QPoint currentGrid = sceneToGrid(scenePos);
+	PrefabInstance& instance = it.value();
+	const PrefabDefinition* prefab = m_ctx->prefabLibrary.prefab(instance.prefabId);
 
-	// λû䣬
-	if (currentGrid == m_deleteLastGrid)
-		return;
+	bool inBounds = prefab && isInsideMap(topLeft.x(), topLeft.y(), prefab->content.width, prefab->content.height);
 
-	m_deleteLastGrid = currentGrid;
+	if (inBounds)
+	{
+		markAreaDirty(instanceRect(instance));
+		indexPrefabInstance(instanceId, false);
+		instance.localX = topLeft.x() - m_gridOrigin.x();
+		instance.localY = topLeft.y() - m_gridOrigin.y();
+		indexPrefabInstance(instanceId, true);
+		markAreaDirty(instanceRect(instance));
+	}
 
-	// Ҫɾľ
-	int startX = qMin(m_deleteStartGrid.x(), currentGrid.x());
-	int startY = qMin(m_deleteStartGrid.y(), currentGrid.y());
-	int endX = qMax(m_deleteStartGrid.x(), currentGrid.x());
-	int endY = qMax(m_deleteStartGrid.y(), currentGrid.y());
+	// Խʱָԭλ
+	const QPointF pos = gridToScene(instance.localX, instance.localY);
+	for (MapPrefabItem* item : instance.items)
+		item->setPos(pos);
 
-	// ¸ʾ
-	updateDeleteHighlight(QPoint(startX, startY), QPoint(endX, endY));
+	return inBounds;
+}
 
-	// ̬ɾƬ
-	for (int gy = startY; gy <= endY; ++gy)
+void MapViewWidget::removePrefabInstance(const QUuid& instanceId)
+{
+	auto it = m_prefabInstances.find(instanceId);
+	if (it == m_prefabInstances.end())
+		return;
+
+	for (MapPrefabItem* item : it->items)
 	{
-		for (int gx = startX; gx <= endX; ++gx)
-		{
-			QPair<int, int> pos = qMakePair(gx, gy);
+		invalidateLodItem(item);
+		m_scene->removeItem(item);
+		delete item;
+	}
 
-			// Ѿλ
-			if (m_deleteRemovedPositions.contains(pos))
-				continue;
+	markAreaDirty(instanceRect(*it));
+	indexPrefabInstance(instanceId, false);
+	forgetInstanceUsage(instanceId);
 
-			// ߽
-			if (gx < 0 || gy < 0 || gx >= m_mapWidth || gy >= m_mapHeight)
-				continue;
+	m_prefabUsers.remove(it->prefabId, instanceId);
+	m_prefabInstances.erase(it);
 
-			// ɾ
-			deleteTileAtGrid(gx, gy);
-			m_deleteRemovedPositions.insert(pos);
-		}
-	}
+	if (m_selectedPrefabInstance == instanceId)
+		m_selectedPrefabInstance = QUuid();
 }
 
-void MapViewWidget::onDeleteDragFinished(MapTileItem* tile)
+bool MapViewWidget::unpackPrefabInstance(const QUuid& instanceId)
 {
-	Q_UNUSED(tile);
+	auto it = m_prefabInstances.constFind(instanceId);
+	if (it == m_prefabInstances.constEnd() || !m_ctx)
+		return false;
 
-	m_deleteDragging = false;
-	m_deleteRemovedPositions.clear();
-	clearDeleteHighlight();
+	const PrefabDefinition* prefab = m_ctx->prefabLibrary.prefab(it->prefabId);
+	if (!prefab)
+		return false;
 
-	qDebug() << "Delete drag finished";
+	const QPoint topLeft = instanceOrigin(*it);
+	removePrefabInstance(instanceId);
+	pasteRegion(prefab->content, topLeft);
+
+	qDebug() << "Unpacked prefab:" << prefab->name << "at grid:" << topLeft;
+	return true;
 }
 
-void MapViewWidget::updateDeleteHighlight(const QPoint& startGrid, const QPoint& endGrid)
+void MapViewWidget::selectPrefabInstance(const QUuid& instanceId)
 {
-	clearDeleteHighlight();
+	if (m_selectedPrefabInstance == instanceId)
+		return;
 
-	// ɾĸɫ
-	for (int gy = startGrid.y(); gy <= endGrid.y(); ++gy)
-	{
-		for (int gx = startGrid.x(); gx <= endGrid.x(); ++gx)
+	auto setHighlighted = [this](const QUuid& id, bool highlighted) {
+		auto it = m_prefabInstances.constFind(id);
+		if (it == m_prefabInstances.constEnd())
+			return;
+		for (MapPrefabItem* item : it->items)
 		{
-			if (gx < 0 || gy < 0 || gx >= m_mapWidth || gy >= m_mapHeight)
-				continue;
+			item->setHighlighted(highlighted);
+			invalidateLodItem(item);
+		}
+	};
 
-			QPointF topLeft = gridToScene(gx, gy);
-			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
+	setHighlighted(m_selectedPrefabInstance, false);
+	m_selectedPrefabInstance = instanceId;
+	setHighlighted(m_selectedPrefabInstance, true);
+}
 
-			// ǷԴƬλ
-			bool isSourceTile = (gx == m_deleteStartGrid.x() && gy == m_deleteStartGrid.y());
+void MapViewWidget::onPrefabChanged(const QUuid& prefabId)
+{
+	// դֻؽһΣʵֻ滻ͼԪ漰Ƭ
+	m_prefabRasters.remove(prefabId);
+	m_prefabTemplates.remove(prefabId);
 
-			if (isSourceTile)
-			{
-				// ԴƬλɫǣᱻɾ
-				rect->setPen(QPen(QColor(80, 140, 255), 2));
-				rect->setBrush(QBrush(QColor(80, 140, 255, 40)));
-			}
-			else if (hasPlacedTileAt(gx, gy, m_currentLayer))
-			{
-				// Ƭλúɫǣɾ
-				rect->setPen(QPen(QColor(255, 100, 100), 2));
-				rect->setBrush(QBrush(QColor(255, 100, 100, 60)));
-			}
-			else
-			{
-				// λǳɫ
-				rect->setPen(QPen(QColor(255, 150, 150), 1));
-				rect->setBrush(QBrush(QColor(255, 150, 150, 30)));
-			}
+	const QList<QUuid> instances = m_prefabUsers.values(prefabId);
+	for (const QUuid& instanceId : instances)
+		rebuildPrefabInstanceItems(instanceId);
 
-			rect->setZValue(998);
-			m_scene->addItem(rect);
-			m_deleteHighlights.append(rect);
+	qDebug() << "Prefab changed:" << prefabId << "instances:" << instances.size();
+}
+
+void MapViewWidget::clearAllPrefabInstances()
+{
+	for (const PrefabInstance& instance : m_prefabInstances)
+	{
+		for (MapPrefabItem* item : instance.items)
+		{
+			invalidateLodItem(item);
+			m_scene->removeItem(item);
+			delete item;
 		}
+		markAreaDirty(instanceRect(instance));
 	}
+	for (auto it = m_instanceUsage.constBegin(); it != m_instanceUsage.constEnd(); ++it)
+	{
+		for (auto usageIt = it->constBegin(); usageIt != it->constEnd(); ++usageIt)
+			m_prefabUsageDelta[usageIt.key()] -= usageIt.value();
+	}
+	if (!m_instanceUsage.isEmpty())
+		scheduleUsageNotify();
+
+	m_instanceUsage.clear();
+	m_prefabInstances.clear();
+	m_prefabUsers.clear();
+	m_prefabChunks.clear();
+	m_selectedPrefabInstance = QUuid();
+	m_prefabDragging = false;
 }
 
-void MapViewWidget::clearDeleteHighlight()
+QVector<MapExportLayer> MapViewWidget::exportLayers() const
 {
-	for (auto* rect : m_deleteHighlights)
+	QVector<MapExportLayer> result;
+	result.reserve(m_layers.size());
+	for (const MapLayerInfo& info : m_layers)
 	{
-		m_scene->removeItem(rect);
-		delete rect;
+		MapExportLayer layer;
+		layer.id = info.id;
+		layer.name = info.name;
+		layer.state = info.state;
+		result.append(layer);
 	}
-	m_deleteHighlights.clear();
-}
 
-// ============== Ϸ¼ ==============
+	// ͨƬֱȡͼԼ
+	for (MapExportLayer& layer : result)
+	{
+		const QVector<MapTileItem*>& tiles = m_tileStore.layerTiles(layer.id);
+		layer.tiles.reserve(tiles.size());
+		for (const MapTileItem* tile : tiles)
+		{
+			MapExportTile record;
+			record.gridX = tile->gridX();
+			record.gridY = tile->gridY();
+			record.gridWidth = tile->gridWidth();
+			record.gridHeight = tile->gridHeight();
+			record.layer = tile->layer();
+			record.tilesetId = tile->tilesetId();
+			record.slice = tile->slice();
+			record.displayName = tile->displayName();
+			record.tags = tile->tags();
+			record.collisionType = tile->collisionType();
+			record.flipX = tile->isFlippedX();
+			record.flipY = tile->isFlippedY();
+			record.rotation = tile->rotation();
+			layer.tiles.append(record);
+		}
+	}
 
-void MapViewWidget::dragEnterEvent(QDragEnterEvent* event)
-{
-	if (event->mimeData()->hasFormat(TILE_MIME_TYPE))
+	if (!m_sliceResolver)
+		return result;
+
+	// չƬͼŷֵǰͼ
+	auto append = [this, &result](const MapExportTile& record) {
+		for (int layer : resolveLayers(record.layer))
+		{
+			const int index = layerOrder(layer);
+			if (index < 0)
+				continue;
+
+			MapExportTile copy = record;
+			copy.layer = layer;
+			result[index].tiles.append(copy);
+		}
+	};
+
+	// ޵ͼѻķֱֿӴӻ룬ͼԪ
+	if (m_infinite)
 	{
-		auto* tileMime = qobject_cast<const TileMimeData*>(event->mimeData());
-		if (tileMime && tileMime->tileData().isValid())
+		for (const QPoint& chunk : m_chunkCache.evictedChunks())
 		{
-			// ֤ߴ
-			const auto& slice = tileMime->tileData().slice;
-			if (validateTileSize(slice.width, slice.height))
+			TileRegionData region;
+			if (!m_chunkCache.peek(chunk, region))
 			{
-				event->acceptProposedAction();
-				return;
+				qWarning() << "exportLayers: failed to read chunk" << chunk;
+				continue;
+			}
+
+			const QPoint origin = MapChunkCache::chunkRect(chunk).topLeft();
+			for (MapExportTile record : regionExportTiles(region))
+			{
+				record.gridX += origin.x();
+				record.gridY += origin.y();
+				append(record);
 			}
 		}
 	}
-	event->ignore();
+
+	// Ԥ壺ײԤѰ·ͬһչģ尴Ԥ建棬ͼѽ
+	forEachPrefabTile(QRect(), [this, &result](const MapExportTile& record, const QPixmap&) {
+		const int index = layerOrder(record.layer);
+		if (index >= 0)
+			result[index].tiles.append(record);
+		});
+
+	return result;
 }
 
-void MapViewWidget::dragMoveEvent(QDragMoveEvent* event)
+QVector<MapExportTile> MapViewWidget::regionExportTiles(const TileRegionData& region, QVector<QPixmap>* outSources) const
 {
-	if (!event->mimeData()->hasFormat(TILE_MIME_TYPE))
-	{
-		event->ignore();
-		return;
+	QVector<MapExportTile> result;
+	if (!m_sliceResolver)
+		return result;
+
+	QVector<SpriteSlice> slices(region.slices.size());
+	QVector<QPixmap> pixmaps(region.slices.size());
+	QVector<bool> resolved(region.slices.size(), false);
+	for (int i = 0; i < region.slices.size(); ++i)
+		resolved[i] = m_sliceResolver(region.slices[i].tilesetId, region.slices[i].sliceId, slices[i], pixmaps[i]);
+
+	result.reserve(region.cells.size());
+	if (outSources)
+	{
+		outSources->clear();
+		outSources->reserve(region.cells.size());
 	}
-
-	auto* tileMime = qobject_cast<const TileMimeData*>(event->mimeData());
-	if (!tileMime)
+	for (const TileRegionCell& cell : region.cells)
 	{
-		event->ignore();
-		return;
+		if (!resolved[cell.sliceRef])
+			continue;
+
+		const SpriteSlice& slice = slices[cell.sliceRef];
+
+		MapExportTile record;
+		record.gridX = cell.x;
+		record.gridY = cell.y;
+		record.gridWidth = qMax(1, slice.sourceWidth() / m_tileWidth);
+		record.gridHeight = qMax(1, slice.sourceHeight() / m_tileHeight);
+		record.layer = cell.layer;
+		record.tilesetId = region.slices[cell.sliceRef].tilesetId;
+		record.slice = slice;
+		record.displayName = slice.name;
+		record.tags = slice.tags;
+		record.collisionType = slice.collisionType;
+		if (cell.attributeRef >= 0)
+		{
+			const TileRegionAttributes& attr = region.attributes[cell.attributeRef];
+			record.displayName = attr.displayName;
+			record.tags = attr.tags;
+			record.collisionType = attr.collisionType;
+		}
+		record.flipX = TileTransformBits::flipX(cell.transform);
+		record.flipY = TileTransformBits::flipY(cell.transform);
+		record.rotation = TileTransformBits::rotation(cell.transform);
+		result.append(record);
+		if (outSources)
+			outSources->append(pixmaps[cell.sliceRef]);
 	}
+	return result;
+}
 
-	// ֤ߴ
-	const auto& slice = tileMime->tileData().slice;
-	if (!validateTileSize(slice.width, slice.height))
-	{
-		clearDropHighlight();
-		event->ignore();
+// ============== ѡ ==============
+
+void MapViewWidget::setSelectedRegion(const QRect& region)
+{
+	// üͼΧڣ޵ͼü
+	QRect clipped = m_infinite ? region.normalized()
+		: region.normalized().intersected(QRect(0, 0, m_mapWidth, m_mapHeight));
+	if (clipped == m_selectedRegion)
 		return;
-	}
 
-	QPointF scenePos = mapToScene(event->position().toPoint());
-	updateDropHighlight(scenePos, tileMime->tileData());
+	// ѡڵķֿ鱣ֳפ/ɾ/滻ֻ账ڴеƬ
+	ensureRegionResident(clipped);
 
-	event->acceptProposedAction();
+	m_selectedRegion = clipped;
+	updateRegionHighlight();
+	emit regionSelectionChanged(m_selectedRegion);
 }
 
-void MapViewWidget::dragLeaveEvent(QDragLeaveEvent* event)
+void MapViewWidget::clearRegionSelection()
 {
-	Q_UNUSED(event);
-	clearDropHighlight();
+	m_regionSelecting = false;
+	if (m_selectedRegion.isNull())
+		return;
+
+	m_selectedRegion = QRect();
+	updateRegionHighlight();
+	emit regionSelectionChanged(m_selectedRegion);
 }
 
-void MapViewWidget::dropEvent(QDropEvent* event)
+void MapViewWidget::updateRegionHighlight()
 {
-	if (!event->mimeData()->hasFormat(TILE_MIME_TYPE))
+	if (m_selectedRegion.isEmpty())
 	{
-		event->ignore();
+		m_regionHighlight->setVisible(false);
 		return;
 	}
 
-	auto* tileMime = qobject_cast<const TileMimeData*>(event->mimeData());
-	if (!tileMime || !tileMime->tileData().isValid())
+	QPointF topLeft = gridToScene(m_selectedRegion.x(), m_selectedRegion.y());
+	m_regionHighlight->setRect(topLeft.x(), topLeft.y(),
+		m_selectedRegion.width() * m_tileWidth, m_selectedRegion.height() * m_tileHeight);
+	m_regionHighlight->setVisible(true);
+}
+
+TileRegionData MapViewWidget::copyRegion(const QRect& region, QVector<MapTileItem*>* outTiles,
+	QVector<QUuid>* outInstances, bool unlockedOnly) const
+{
+	if (region.isEmpty())
+		return TileRegionData();
+
+	QVector<MapTileItem*> tiles = m_tileStore.tilesAnchoredInRect(region);
+	if (unlockedOnly)
 	{
-		event->ignore();
-		return;
+		tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+			[this](const MapTileItem* tile) { return isLayerLocked(tile->layer()); }), tiles.end());
 	}
 
-	// ֤ߴ
-	const auto& slice = tileMime->tileData().slice;
-	if (!validateTileSize(slice.width, slice.height))
+	// ȫλڵԤʵ
+	QVector<QUuid> instances;
+	for (const QUuid& instanceId : prefabInstancesInRect(region))
 	{
-		clearDropHighlight();
-		event->ignore();
-		qDebug() << "Drop rejected: tile size" << slice.width << "x" << slice.height
-			<< "doesn't match grid size" << m_tileWidth << "x" << m_tileHeight;
-		return;
+		if (unlockedOnly && isPrefabInstanceLocked(instanceId))
+			continue;
+		if (region.contains(instanceRect(m_prefabInstances.constFind(instanceId).value())))
+			instances.append(instanceId);
 	}
 
-	QPointF scenePos = mapToScene(event->position().toPoint());
-	QPoint gridPos = sceneToGrid(scenePos);
+	if (outTiles)
+		*outTiles = tiles;
+	if (outInstances)
+		*outInstances = instances;
+	return encodeRegion(region, tiles, instances);
+}
 
-	if (gridPos.x() >= 0 && gridPos.y() >= 0 &&
-		gridPos.x() < m_mapWidth && gridPos.y() < m_mapHeight)
+TileRegionData MapViewWidget::encodeRegion(const QRect& region, const QVector<MapTileItem*>& tiles,
+	const QVector<QUuid>& instances) const
+{
+	TileRegionData data;
+	if (region.isEmpty())
+		return data;
+
+	data.width = region.width();
+	data.height = region.height();
+
+	// ƬȥأƬֻ
+	QHash<QUuid, int> sliceIndex;
+	QHash<QString, int> attributeIndex;
+
+	auto sliceRefOf = [&data, &sliceIndex](const TileRegionSliceRef& ref) {
+		auto it = sliceIndex.constFind(ref.sliceId);
+		if (it == sliceIndex.constEnd())
+		{
+			it = sliceIndex.insert(ref.sliceId, data.slices.size());
+			data.slices.append(ref);
+		}
+		return it.value();
+	};
+
+	auto attributeRefOf = [&data, &attributeIndex](const TileRegionAttributes& attr) {
+		const QString key = attr.displayName + QChar(0x1F) + attr.tags
+			+ QChar(0x1F) + QString::number(static_cast<int>(attr.collisionType));
+
+		auto it = attributeIndex.constFind(key);
+		if (it == attributeIndex.constEnd())
+		{
+			it = attributeIndex.insert(key, data.attributes.size());
+			data.attributes.append(attr);
+		}
+		return it.value();
+	};
+
+	data.cells.reserve(tiles.size());
+	for (const MapTileItem* tile : tiles)
 	{
-		placeTile(tileMime->tileData(), gridPos);
-		event->acceptProposedAction();
+		const SpriteSlice& slice = tile->slice();
+
+		TileRegionCell cell;
+		cell.x = tile->gridX() - region.x();
+		cell.y = tile->gridY() - region.y();
+		cell.layer = tile->layer();
+		cell.transform = TileTransformBits::pack(tile->isFlippedX(), tile->isFlippedY(), tile->rotation());
+		cell.sliceRef = sliceRefOf(TileRegionSliceRef{ tile->tilesetId(), slice.id });
+
+		// ֻƬĬֵͬƬдԱ
+		if (tile->displayName() != slice.name || tile->tags() != slice.tags
+			|| tile->collisionType() != slice.collisionType)
+		{
+			cell.attributeRef = attributeRefOf(TileRegionAttributes{ tile->displayName(), tile->tags(), tile->collisionType() });
+		}
+
+		data.cells.append(cell);
 	}
-	else
+
+	// ԤʵչΪͨƬͼΪԤ屣ıţճʱٽ
+	for (const QUuid& instanceId : instances)
 	{
-		event->ignore();
+		const PrefabInstance& instance = m_prefabInstances.constFind(instanceId).value();
+		const PrefabDefinition* prefab = m_ctx ? m_ctx->prefabLibrary.prefab(instance.prefabId) : nullptr;
+		if (!prefab)
+			continue;
+
+		const QPoint offset = instanceOrigin(instance) - region.topLeft();
+		const TileRegionData& content = prefab->content;
+		for (const TileRegionCell& source : content.cells)
+		{
+			TileRegionCell cell = source;
+			cell.x += offset.x();
+			cell.y += offset.y();
+			cell.sliceRef = sliceRefOf(content.slices[source.sliceRef]);
+			if (source.attributeRef >= 0)
+				cell.attributeRef = attributeRefOf(content.attributes[source.attributeRef]);
+			data.cells.append(cell);
+		}
 	}
 
-	clearDropHighlight();
+	return data;
 }
 
-void MapViewWidget::updateDropHighlight(const QPointF& scenePos, const TileDragData& tileData)
+int MapViewWidget::pasteRegion(const TileRegionData& region, const QPoint& topLeft)
 {
-	QPoint gridPos = sceneToGrid(scenePos);
+	if (region.isEmpty())
+		return 0;
+
+	// Ŀ귶Χѻķֿȶأ֤ж
+	ensureRegionResident(QRect(topLeft, QSize(region.width, region.height)));
+
+	return placeRegionCells(region, topLeft, true);
+}
 
-	if (gridPos.x() < 0 || gridPos.y() < 0 ||
-		gridPos.x() >= m_mapWidth || gridPos.y() >= m_mapHeight)
+int MapViewWidget::placeRegionCells(const TileRegionData& region, const QPoint& topLeft, bool replaceExisting)
+{
+	if (!m_sliceResolver)
 	{
-		clearDropHighlight();
-		return;
+		qWarning() << "pasteRegion: no slice resolver set";
+		return 0;
 	}
 
-	int gridW = tileData.slice.width / m_tileWidth;
-	int gridH = tileData.slice.height / m_tileHeight;
+	// ÿƬֻһΣŵߴ
+	struct ResolvedSlice
+	{
+		bool valid = false;
+		SpriteSlice slice;
+		QPixmap pixmap;
+		int gridW = 1;
+		int gridH = 1;
+	};
+
+	QVector<ResolvedSlice> resolved(region.slices.size());
+	for (int i = 0; i < region.slices.size(); ++i)
+	{
+		const TileRegionSliceRef& ref = region.slices[i];
+		ResolvedSlice& entry = resolved[i];
 
-	for (auto* rect : m_coverageHighlights)
+		QPixmap source;
+		if (!m_sliceResolver(ref.tilesetId, ref.sliceId, entry.slice, source))
+		{
+			qWarning() << "pasteRegion: slice not found:" << ref.tilesetId << ref.sliceId;
+			continue;
+		}
+
+		entry.gridW = qMax(1, entry.slice.sourceWidth() / m_tileWidth);
+		entry.gridH = qMax(1, entry.slice.sourceHeight() / m_tileHeight);
+		entry.pixmap = source.scaled(entry.gridW * m_tileWidth, entry.gridH * m_tileHeight,
+			Qt::IgnoreAspectRatio, pixmapTransformMode());
+		entry.valid = true;
+	}
+
+	// бͼ -> ǰͼ㣨ÿֻһΣ
+	QHash<int, QVector<int>> targets;
+	auto targetsOf = [this, &targets](int storedLayer) -> const QVector<int>& {
+		auto it = targets.find(storedLayer);
+		if (it == targets.end())
+			it = targets.insert(storedLayer, resolveLayers(storedLayer));
+		return it.value();
+	};
+
+	// ȥƬЧ򳬳ͼĸӣǲãҲܸеƬ
+	int skipped = 0;
+	QVector<const TileRegionCell*> cells;
+	cells.reserve(region.cells.size());
+	QHash<quint64, QPoint> anchorChunks;
+	for (const TileRegionCell& cell : region.cells)
 	{
-		m_scene->removeItem(rect);
-		delete rect;
+		const ResolvedSlice& entry = resolved[cell.sliceRef];
+		const int gridX = topLeft.x() + cell.x;
+		const int gridY = topLeft.y() + cell.y;
+		if (!entry.valid || !isInsideMap(gridX, gridY, entry.gridW, entry.gridH))
+		{
+			++skipped;
+			continue;
+		}
+
+		cells.append(&cell);
+		if (m_infinite)
+		{
+			const QPoint chunk = MapChunkCache::chunkOf(gridX, gridY);
+			anchorChunks.insert(MapChunkCache::chunkKey(chunk), chunk);
+		}
 	}
-	m_coverageHighlights.clear();
 
-	for (int dy = 0; dy < gridH; ++dy)
+	// ޵ͼÿ漰ķֻֿǼ / һΣƬ飩
+	for (const QPoint& chunk : anchorChunks)
+		ensureChunkResident(chunk);
+
+	// ռĿλϱǵľƬһƳ
+	QSet<MapTileItem*> replaced;
+	if (replaceExisting)
 	{
-		for (int dx = 0; dx < gridW; ++dx)
+		for (const TileRegionCell* cell : cells)
 		{
-			int gx = gridPos.x() + dx;
-			int gy = gridPos.y() + dy;
+			const ResolvedSlice& entry = resolved[cell->sliceRef];
+			QRect footprint(topLeft.x() + cell->x, topLeft.y() + cell->y, entry.gridW, entry.gridH);
+			for (int layer : targetsOf(cell->layer))
+			{
+				if (!isLayerLocked(layer))
+					replaced.unite(m_tileStore.tilesInRect(footprint, layer));
+			}
+		}
 
-			if (gx >= m_mapWidth || gy >= m_mapHeight)
-				continue;
+		for (MapTileItem* tile : replaced)
+			destroyTileItem(tile);
+	}
 
-			QPointF topLeft = gridToScene(gx, gy);
-			auto* rect = new QGraphicsRectItem(topLeft.x(), topLeft.y(), m_tileWidth, m_tileHeight);
+	// Ƭ÷ΧϲһΣƬһ
+	int placed = 0;
+	QRect placedArea;
+	QSet<QUuid> animatedSlices;
+	for (const TileRegionCell* cellPtr : cells)
+	{
+		const TileRegionCell& cell = *cellPtr;
+		const ResolvedSlice& entry = resolved[cell.sliceRef];
+		const int gridX = topLeft.x() + cell.x;
+		const int gridY = topLeft.y() + cell.y;
 
-			if (dx == 0 && dy == 0)
+		for (int layer : targetsOf(cell.layer))
+		{
+			// ճдͼ
+			if (replaceExisting && isLayerLocked(layer))
 			{
-				rect->setPen(QPen(QColor(80, 140, 255), 2));
-				rect->setBrush(QBrush(QColor(80, 140, 255, 60)));
+				++skipped;
+				continue;
 			}
-			else
+
+			// ָķֿʱȡڼдƬ
+			if (!replaceExisting && !m_tileStore.tilesInRect(QRect(gridX, gridY, entry.gridW, entry.gridH), layer).isEmpty())
 			{
-				rect->setPen(QPen(QColor(255, 180, 80), 1));
-				rect->setBrush(QBrush(QColor(255, 180, 80, 40)));
+				++skipped;
+				continue;
 			}
 
-			rect->setZValue(999);
-			m_scene->addItem(rect);
-			m_coverageHighlights.append(rect);
+			auto* tileItem = insertTileItem(entry.pixmap, entry.slice, region.slices[cell.sliceRef].tilesetId,
+				gridX, gridY, entry.gridW, entry.gridH, layer);
+			placedArea = placedArea.united(QRect(gridX, gridY, entry.gridW, entry.gridH));
+			if (tileItem->animation())
+				animatedSlices.insert(entry.slice.id);
+
+			if (cell.attributeRef >= 0)
+			{
+				const TileRegionAttributes& attr = region.attributes[cell.attributeRef];
+				tileItem->setDisplayName(attr.displayName);
+				tileItem->setTags(attr.tags);
+				tileItem->setCollisionType(attr.collisionType);
+			}
+
+			if (TileTransformBits::flipX(cell.transform))
+				tileItem->setFlipX(true);
+			if (TileTransformBits::flipY(cell.transform))
+				tileItem->setFlipY(true);
+			if (TileTransformBits::rotation(cell.transform) != 0)
+				tileItem->setRotation(TileTransformBits::rotation(cell.transform));
+
+			++placed;
 		}
 	}
 
-	QPointF topLeft = gridToScene(gridPos.x(), gridPos.y());
-	m_dropHighlight->setRect(topLeft.x(), topLeft.y(),
-		gridW * m_tileWidth, gridH * m_tileHeight);
-	m_dropHighlight->setVisible(false);
+	if (placed > 0)
+	{
+		for (const QUuid& sliceId : animatedSlices)
+			markAnimationDirty(sliceId);
+		markAreaDirty(placedArea);
+		scheduleUsageNotify();
+	}
+
+	if (replaceExisting)
+	{
+		qDebug() << "Pasted region:" << placed << "tiles at grid:" << topLeft
+			<< "replaced:" << replaced.size() << "skipped:" << skipped;
+	}
+
+	return placed;
 }
 
-void MapViewWidget::clearDropHighlight()
+int MapViewWidget::deleteRegion(const QRect& region)
 {
-	m_dropHighlight->setVisible(false);
+	int deleted = 0;
+	for (MapTileItem* tile : m_tileStore.tilesInRect(region))
+	{
+		if (isLayerLocked(tile->layer()))
+			continue;
 
-	for (auto* rect : m_coverageHighlights)
+		destroyTileItem(tile);
+		++deleted;
+	}
+
+	// Ԥʵֻȫλʱɾ븴һ£
+	for (const QUuid& instanceId : prefabInstancesInRect(region))
 	{
-		m_scene->removeItem(rect);
-		delete rect;
+		const PrefabInstance& instance = m_prefabInstances.constFind(instanceId).value();
+		if (!region.contains(instanceRect(instance)) || isPrefabInstanceLocked(instanceId))
+			continue;
+
+		removePrefabInstance(instanceId);
+		++deleted;
 	}
-	m_coverageHighlights.clear();
+
+	qDebug() << "Deleted region:" << region << "tiles:" << deleted;
+	return deleted;
 }
 
-QPoint MapViewWidget::sceneToGrid(const QPointF& scenePos) const
+int MapViewWidget::deleteCopied(const QVector<MapTileItem*>& tiles, const QVector<QUuid>& instances)
 {
-	int gridX = static_cast<int>(qFloor(scenePos.x() / m_tileWidth));
-	int gridY = static_cast<int>(qFloor(scenePos.y() / m_tileHeight));
-	return QPoint(gridX, gridY);
+	int deleted = 0;
+	for (MapTileItem* tile : tiles)
+	{
+		if (isLayerLocked(tile->layer()))
+			continue;
+
+		destroyTileItem(tile);
+		++deleted;
+	}
+	for (const QUuid& instanceId : instances)
+	{
+		if (isPrefabInstanceLocked(instanceId))
+			continue;
+
+		removePrefabInstance(instanceId);
+		++deleted;
+	}
+	return deleted;
 }
 
-QPointF MapViewWidget::gridToScene(int gridX, int gridY) const
+QPoint MapViewWidget::pasteAnchor() const
 {
-	return QPointF(gridX * m_tileWidth, gridY * m_tileHeight);
+	// ͼʱճڸ
+	const QPoint viewPos = viewport()->mapFromGlobal(QCursor::pos());
+	if (viewport()->rect().contains(viewPos))
+		return sceneToGrid(mapToScene(viewPos));
+
+	if (!m_selectedRegion.isEmpty())
+		return m_selectedRegion.topLeft();
+
+	return QPoint(0, 0);
 }
 
-void MapViewWidget::placeTile(const TileDragData& tileData, const QPoint& gridPos)
+void MapViewWidget::copySelectedRegion()
 {
-	if (!tileData.isValid())
+	if (m_selectedRegion.isEmpty())
 		return;
 
-	// ΪѾֱ֤
-	int gridW = tileData.slice.width / m_tileWidth;
-	int gridH = tileData.slice.height / m_tileHeight;
+	TileRegionData data = copyRegion(m_selectedRegion);
+	if (data.isEmpty())
+		return;
 
-	QPixmap scaledPixmap = tileData.pixmap.scaled(
-		gridW * m_tileWidth,
-		gridH * m_tileHeight,
-		Qt::IgnoreAspectRatio,
-		Qt::SmoothTransformation
-	);
+	QGuiApplication::clipboard()->setMimeData(TileRegionCodec::toMimeData(data));
+	qDebug() << "Copied region:" << m_selectedRegion << "tiles:" << data.cells.size();
+}
 
-	// ƬͼԪ뵱ǰͼ
-	auto* tileItem = new MapTileItem(scaledPixmap, tileData.slice, gridPos.x(), gridPos.y(), m_currentLayer);
-	tileItem->setTilesetId(tileData.tilesetId);
-	tileItem->setGridSize(gridW, gridH);
-	tileItem->setPos(gridToScene(gridPos.x(), gridPos.y()));
-	tileItem->setZValue(10 + m_currentLayer);
-
-	// ӵ϶ź
-	connect(tileItem, &MapTileItem::clicked, this, &MapViewWidget::onTileClicked);
-	connect(tileItem, &MapTileItem::dragStarted, this, &MapViewWidget::onTileDragStarted);
-	connect(tileItem, &MapTileItem::dragFinished, this, &MapViewWidget::onTileDragFinished);
-	connect(tileItem, &MapTileItem::copyDragStarted, this, &MapViewWidget::onCopyDragStarted);
-	connect(tileItem, &MapTileItem::copyDragMoved, this, &MapViewWidget::onCopyDragMoved);
-	connect(tileItem, &MapTileItem::copyDragFinished, this, &MapViewWidget::onCopyDragFinished);
-	connect(tileItem, &MapTileItem::deleteDragStarted, this, &MapViewWidget::onDeleteDragStarted);
-	connect(tileItem, &MapTileItem::deleteDragMoved, this, &MapViewWidget::onDeleteDragMoved);
-	connect(tileItem, &MapTileItem::deleteDragFinished, this, &MapViewWidget::onDeleteDragFinished);
-
-	m_scene->addItem(tileItem);
-	m_placedTiles.append(tileItem);
+void MapViewWidget::cutSelectedRegion()
+{
+	if (m_selectedRegion.isEmpty())
+		return;
 
-	qDebug() << "Placed tile:" << tileData.slice.name
-		<< "at grid:" << gridPos
-		<< "size:" << gridW << "x" << gridH
-		<< "layer:" << m_currentLayer;
+	// ֻɾʵʸ˵Ƭ븴ͬΪԭڣʲôûʱɾ
+	QVector<MapTileItem*> copied;
+	QVector<QUuid> copiedInstances;
+	TileRegionData data = copyRegion(m_selectedRegion, &copied, &copiedInstances);
+	if (data.isEmpty())
+		return;
+
+	QGuiApplication::clipboard()->setMimeData(TileRegionCodec::toMimeData(data));
+
+	const int deleted = deleteCopied(copied, copiedInstances);
+	qDebug() << "Cut region:" << m_selectedRegion << "copied:" << data.cells.size() << "deleted:" << deleted;
+}
+
+void MapViewWidget::pasteFromClipboard()
+{
+	TileRegionData data;
+	if (!TileRegionCodec::fromMimeData(QGuiApplication::clipboard()->mimeData(), data))
+		return;
+
+	const QPoint anchor = pasteAnchor();
+	if (pasteRegion(data, anchor) > 0)
+	{
+		// ѡճ򣬱ڼ
+		setSelectedRegion(QRect(anchor, QSize(data.width, data.height)));
+	}
 }
 
 // ============== ̺¼ ==============
@@ -1069,7 +3898,44 @@ void MapViewWidget::keyPressEvent(QKeyEvent* event)
 		return;
 	}
 
-	// Delete ɾѡеƬ
+	// 壺 /  / ճѡ
+	if (event->matches(QKeySequence::Copy))
+	{
+		copySelectedRegion();
+		return;
+	}
+	if (event->matches(QKeySequence::Cut))
+	{
+		cutSelectedRegion();
+		return;
+	}
+	if (event->matches(QKeySequence::Paste))
+	{
+		pasteFromClipboard();
+		return;
+	}
+
+	// ԤʵDelete ɾU չΪͨƬ
+	if (!m_selectedPrefabInstance.isNull())
+	{
+		if (event->key() == Qt::Key_Delete)
+		{
+			removePrefabInstance(m_selectedPrefabInstance);
+			return;
+		}
+		if (event->key() == Qt::Key_U)
+		{
+			unpackPrefabInstance(m_selectedPrefabInstance);
+			return;
+		}
+	}
+
+	// Delete ɾѡеƬ
+	if (event->key() == Qt::Key_Delete && !m_selectedRegion.isEmpty())
+	{
+		deleteRegion(m_selectedRegion);
+		return;
+	}
 	if (event->key() == Qt::Key_Delete && m_selectedTile)
 	{
 		deleteSelectedTile();
@@ -1077,9 +3943,12 @@ void MapViewWidget::keyPressEvent(QKeyEvent* event)
 	}
 
 	// Escape ȡѡ
-	if (event->key() == Qt::Key_Escape && m_selectedTile)
+	if (event->key() == Qt::Key_Escape &&
+		(m_selectedTile || !m_selectedRegion.isEmpty() || !m_selectedPrefabInstance.isNull()))
 	{
 		clearSelection();
+		clearRegionSelection();
+		selectPrefabInstance(QUuid());
 		return;
 	}
 
@@ -1087,6 +3956,7 @@ void MapViewWidget::keyPressEvent(QKeyEvent* event)
 	if (event->key() == Qt::Key_H && m_selectedTile)
 	{
 		m_selectedTile->toggleFlipX();
+		invalidateLodItem(m_selectedTile);
 		return;
 	}
 
@@ -1094,6 +3964,7 @@ void MapViewWidget::keyPressEvent(QKeyEvent* event)
 	if (event->key() == Qt::Key_V && m_selectedTile)
 	{
 		m_selectedTile->toggleFlipY();
+		invalidateLodItem(m_selectedTile);
 		return;
 	}
 
@@ -1110,6 +3981,7 @@ void MapViewWidget::keyPressEvent(QKeyEvent* event)
 			// R: ˳ʱת
 			m_selectedTile->rotateClockwise();
 		}
+		invalidateLodItem(m_selectedTile);
 		return;
 	}
 
@@ -1138,11 +4010,32 @@ void MapViewWidget::mousePressEvent(QMouseEvent* event)
 		return;
 	}
 
+	// Alt +  / ҼѰ· / յ
+	if ((event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
+		&& (event->modifiers() & Qt::AltModifier))
+	{
+		setNavigationEndpoint(sceneToGrid(mapToScene(event->pos())), event->button() == Qt::LeftButton);
+		return;
+	}
+
+	// Ctrl + ϶ѡ
+	if (event->button() == Qt::LeftButton && (event->modifiers() & Qt::ControlModifier))
+	{
+		clearSelection();
+		m_regionSelecting = true;
+		m_regionStartGrid = sceneToGrid(mapToScene(event->pos()));
+		setSelectedRegion(QRect(m_regionStartGrid, QSize(1, 1)));
+		return;
+	}
+
 	// հȡѡ
 	if (event->button() == Qt::LeftButton && !m_spacePressed)
 	{
+		// ѡ⵲סͼԪ
+		clearRegionSelection();
+
 		QPointF scenePos = mapToScene(event->pos());
-		QGraphicsItem* item = m_scene->itemAt(scenePos, transform());
+		QGraphicsItem* item = editableItemAt(scenePos);
 
 		// Ĳ MapTileItemǲڵǰͼƬȡѡ
 		MapTileItem* tileItem = dynamic_cast<MapTileItem*>(item);
@@ -1150,6 +4043,17 @@ void MapViewWidget::mousePressEvent(QMouseEvent* event)
 		{
 			clearSelection();
 		}
+
+		// Ԥʵѡвʼ϶
+		if (auto* prefabItem = dynamic_cast<MapPrefabItem*>(item))
+		{
+			const PrefabInstance& instance = m_prefabInstances[prefabItem->instanceId()];
+			selectPrefabInstance(prefabItem->instanceId());
+			m_prefabDragging = true;
+			m_prefabDragOffset = sceneToGrid(scenePos) - instanceOrigin(instance);
+			return;
+		}
+		selectPrefabInstance(QUuid());
 	}
 
 	QGraphicsView::mousePressEvent(event);
@@ -1167,6 +4071,26 @@ void MapViewWidget::mouseMoveEvent(QMouseEvent* event)
 		return;
 	}
 
+	if (m_regionSelecting)
+	{
+		QPoint currentGrid = sceneToGrid(mapToScene(event->pos()));
+		setSelectedRegion(QRect(m_regionStartGrid, currentGrid));
+		return;
+	}
+
+	// ϶ԤʵֻƶͼͼԪɿʱȷλ
+	if (m_prefabDragging)
+	{
+		auto it = m_prefabInstances.constFind(m_selectedPrefabInstance);
+		if (it != m_prefabInstances.constEnd())
+		{
+			QPoint local = sceneToGrid(mapToScene(event->pos())) - m_prefabDragOffset - m_gridOrigin;
+			for (MapPrefabItem* item : it->items)
+				item->setPos(gridToScene(local.x(), local.y()));
+		}
+		return;
+	}
+
 	// Ƭ϶¸
 	if (m_tileDragging && m_selectedTile)
 	{
@@ -1179,6 +4103,9 @@ void MapViewWidget::mouseMoveEvent(QMouseEvent* event)
 
 void MapViewWidget::mouseReleaseEvent(QMouseEvent* event)
 {
+	// ϶ڼͣĻɿ
+	scheduleStreaming();
+
 	if (event->button() == Qt::LeftButton && m_panning)
 	{
 		m_panning = false;
@@ -1188,6 +4115,20 @@ void MapViewWidget::mouseReleaseEvent(QMouseEvent* event)
 			unsetCursor();
 		return;
 	}
+
+	if (event->button() == Qt::LeftButton && m_regionSelecting)
+	{
+		m_regionSelecting = false;
+		qDebug() << "Region selected:" << m_selectedRegion;
+		return;
+	}
+
+	if (event->button() == Qt::LeftButton && m_prefabDragging)
+	{
+		m_prefabDragging = false;
+		movePrefabInstance(m_selectedPrefabInstance, sceneToGrid(mapToScene(event->pos())) - m_prefabDragOffset);
+		return;
+	}
 	QGraphicsView::mouseReleaseEvent(event);
 }
 
@@ -1209,13 +4150,29 @@ void MapViewWidget::clearAllTiles()
 	// ѡ
 	clearSelection();
 
+	clearRegionSelection();
+	clearAllPrefabInstances();
+
 	// ɾƬ
-	for (auto* tile : m_placedTiles)
+	for (auto* tile : m_tileStore.tiles())
 	{
 		m_scene->removeItem(tile);
 		delete tile;
 	}
-	m_placedTiles.clear();
+	m_tileStore.clear();
+	clearAnimations();
+	m_chunkCache.clear();
+	m_residentChunks.clear();
+	m_layerTargets.clear();
+	m_collisionBaker.clear();
+	m_collisionOverlay->update();
+	clearNavigationPreview();
+	m_lodLayer->clear();
+	m_lodSourceImages.clear();
+	m_changedChunks.clear();
+	emit tilesReset();
+	setGridOrigin(QPoint());
+	scheduleUsageNotify();
 
 	qDebug() << "Cleared all tiles";
 }
@@ -1227,14 +4184,13 @@ void MapViewWidget::placeTileAt(int gridX, int gridY, const QString& tilesetId,
 	bool flipX, bool flipY, int rotation)
 {
 	// ߽
-	int gridW = slice.width / m_tileWidth;
-	int gridH = slice.height / m_tileHeight;
+	int gridW = slice.sourceWidth() / m_tileWidth;
+	int gridH = slice.sourceHeight() / m_tileHeight;
 
 	if (gridW <= 0) gridW = 1;
 	if (gridH <= 0) gridH = 1;
 
-	if (gridX < 0 || gridY < 0 ||
-		gridX + gridW > m_mapWidth || gridY + gridH > m_mapHeight)
+	if (!isInsideMap(gridX, gridY, gridW, gridH))
 	{
 		qWarning() << "placeTileAt: out of bounds - grid:" << gridX << "," << gridY
 			<< "size:" << gridW << "x" << gridH
@@ -1242,20 +4198,27 @@ void MapViewWidget::placeTileAt(int gridX, int gridY, const QString& tilesetId,
 		return;
 	}
 
+	// ļеͼŲбʱͼ
+	if (!hasLayer(layer))
+	{
+		MapLayerInfo info;
+		info.id = layer;
+		info.name = QStringLiteral("Layer %1").arg(layer);
+		m_layers.append(info);
+		m_nextLayerId = qMax(m_nextLayerId, layer + 1);
+		syncLayers();
+	}
+
 	//  pixmap ƥߴ
 	QPixmap scaledPixmap = pixmap.scaled(
 		gridW * m_tileWidth,
 		gridH * m_tileHeight,
 		Qt::IgnoreAspectRatio,
-		Qt::SmoothTransformation
+		pixmapTransformMode()
 	);
 
 	// ƬͼԪ
-	auto* tileItem = new MapTileItem(scaledPixmap, slice, gridX, gridY, layer);
-	tileItem->setTilesetId(tilesetId);
-	tileItem->setGridSize(gridW, gridH);
-	tileItem->setPos(gridToScene(gridX, gridY));
-	tileItem->setZValue(10 + layer);
+	auto* tileItem = createTileItem(scaledPixmap, slice, tilesetId, gridX, gridY, gridW, gridH, layer);
 
 	// ö
 	if (!displayName.isEmpty())
@@ -1281,20 +4244,6 @@ void MapViewWidget::placeTileAt(int gridX, int gridY, const QString& tilesetId,
 		tileItem->setRotation(rotation);
 	}
 
-	// ź
-	connect(tileItem, &MapTileItem::clicked, this, &MapViewWidget::onTileClicked);
-	connect(tileItem, &MapTileItem::dragStarted, this, &MapViewWidget::onTileDragStarted);
-	connect(tileItem, &MapTileItem::dragFinished, this, &MapViewWidget::onTileDragFinished);
-	connect(tileItem, &MapTileItem::copyDragStarted, this, &MapViewWidget::onCopyDragStarted);
-	connect(tileItem, &MapTileItem::copyDragMoved, this, &MapViewWidget::onCopyDragMoved);
-	connect(tileItem, &MapTileItem::copyDragFinished, this, &MapViewWidget::onCopyDragFinished);
-	connect(tileItem, &MapTileItem::deleteDragStarted, this, &MapViewWidget::onDeleteDragStarted);
-	connect(tileItem, &MapTileItem::deleteDragMoved, this, &MapViewWidget::onDeleteDragMoved);
-	connect(tileItem, &MapTileItem::deleteDragFinished, this, &MapViewWidget::onDeleteDragFinished);
-
-	m_scene->addItem(tileItem);
-	m_placedTiles.append(tileItem);
-
 	qDebug() << "Imported tile:" << slice.name
 		<< "at grid:" << gridX << "," << gridY
 		<< "size:" << gridW << "x" << gridH
@@ -3,9 +3,29 @@
 #include <QGraphicsView>
 #include <QGraphicsScene>
 #include <QGraphicsRectItem>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <QTimer>
+#include <functional>
+#include <optional>
+#include <utility>
 #include "core/MapDocument.h"
 #include "core/TileDragData.h"
+#include "core/TileRegion.h"
+#include "core/PrefabDefine.h"
+#include "core/MapExporter.h"
+#include "core/MapChunkCache.h"
+#include "core/CollisionBaker.h"
+#include "core/NavGrid.h"
 #include "MapTileItem.h"
+#include "MapTileStore.h"
+#include "MapLodLayer.h"
+#include "MapTileAnimation.h"
+
+class MapPrefabItem;
+class MapLayerRoot;
+class MapCollisionOverlay;
+class MapNavOverlay;
 
 class AppContext;
 
@@ -16,7 +36,7 @@ public:
 	explicit MapViewWidget(QWidget* parent = nullptr);
 	~MapViewWidget();
 
-	void SetContext(AppContext* p) { m_ctx = p; }
+	void SetContext(AppContext* p);
 
 	// µͼʾ
 	void updateMap();
@@ -30,11 +50,63 @@ public:
 	int currentLayer() const { return m_currentLayer; }
 	int zoomPercent() const;
 
+	// ϸڲ㼶ŵ mipBelow ʱƷֿСͼ colorBelow ʱÿֻƽɫ
+	void setLodThresholds(double mipBelow, double colorBelow);
+	double lodMipBelow() const { return m_lodMipBelow; }
+	double lodColorBelow() const { return m_lodColorBelow; }
+	MapLodLevel lodLevel() const { return m_lodLevel; }
+
+	// Ⱦʽĵ棩طʹڲֻȡ֮һ豸أ
+	void setRenderProfile(MapRenderProfile profile);
+	MapRenderProfile renderProfile() const { return m_renderProfile; }
+
+	// ========== ͼ ==========
+	// ͼб˳µϣĵ棩Ƭͨͼͼ
+	const QVector<MapLayerInfo>& layers() const { return m_layers; }
+	int layerOrder(int layer) const { return m_layerIndex.value(layer, -1); }
+	bool hasLayer(int layer) const { return m_layerIndex.contains(layer); }
+	int layerTileCount(int layer) const { return m_tileStore.layerSize(layer); }
+
+	// ͼṹֻͼԼƬͼֻڵ
+	int addLayer(const QString& name, int index = -1);      // ͼ
+	bool removeLayer(int layer);
+	bool moveLayer(int layer, int index);
+	bool renameLayer(int layer, const QString& name);
+	bool mergeLayer(int layer, int intoLayer);              // layer Ƭ intoLayer ɾ layer
+	int duplicateLayer(int layer);                          // ԭͼ֮ϣͼ
+
+	// ͼ״̬صͼ㲻ơӦͼ㲻༭
+	void setLayerVisible(int layer, bool visible);
+	void setLayerLocked(int layer, bool locked);
+	void setLayerOpacity(int layer, double opacity);
+	MapLayerState layerState(int layer) const;
+	bool isLayerLocked(int layer) const { return layerState(layer).locked; }
+
 	// ȡǰѡеƬ
 	MapTileItem* selectedTile() const { return m_selectedTile; }
 
-	// ȡѷõƬ
-	const QVector<MapTileItem*>& placedTiles() const { return m_placedTiles; }
+	// ȡѷõƬһбֻʱ forEachPlacedTile  layerTiles
+	QVector<MapTileItem*> placedTiles() const { return m_tileStore.tiles(); }
+	int placedTileCount() const { return m_tileStore.size(); }
+
+	// ѷõƬбڼ䲻ɾƬ
+	template<typename Visitor>
+	void forEachPlacedTile(Visitor&& visitor) const { m_tileStore.forEachTile(std::forward<Visitor>(visitor)); }
+
+	// ͼƬô洢еб
+	const QVector<MapTileItem*>& layerTiles(int layer) const { return m_tileStore.layerTiles(layer); }
+
+	// ָεƬͼ㣩
+	QSet<MapTileItem*> tilesInRect(const QRect& gridRect) const { return m_tileStore.tilesInRect(gridRect); }
+
+	// ԤʵչƬ߼꣬ͼѽΪǰͼ㣬ͼΧģ
+	// gridRect Ϊձʾʵsource ΪƬԭͼײѰ·ʹüСͼ͵
+	using PrefabTileVisitor = std::function<void(const MapExportTile& tile, const QPixmap& source)>;
+	void forEachPrefabTile(const QRect& gridRect, const PrefabTileVisitor& visitor) const;
+
+	// ӿڣ꣩붨λСͼʹ
+	QRectF visibleGridRect() const;
+	void centerOnGrid(const QPointF& gridPos);
 
 	// Ƭ
 	void clearAllTiles();
@@ -45,6 +117,102 @@ public:
 		CollisionType collisionType, const QString& tags,
 		bool flipX = false, bool flipY = false, int rotation = 0);
 
+	// ͼߴ磺anchor ֲָı/ǣͨƽԭƶ
+	// dropOutOfBounds Ϊ true ʱɾ·ΧƬɻָ
+	void resizeMap(int width, int height, Qt::Alignment anchor, bool dropOutOfBounds);
+
+	// ԭ㣨ͼڵƫƣ߼ =  + ԭ㣩
+	QPoint gridOrigin() const { return m_gridOrigin; }
+
+	// ޵ͼûб߽磬Զӿڵķֿ黻ʱļʱ첽
+	// /滻ֻڴеƬʹüѻķֿ
+	void setInfiniteMode(bool infinite);
+	bool isInfiniteMode() const { return m_infinite; }
+	bool isChunkEvicted(const QPoint& chunk) const { return m_chunkCache.isEvicted(chunk); }
+
+	// ƶƬ / ޸ͼ / ޸ײͣͬײ決
+	bool moveTile(MapTileItem* tile, int gridX, int gridY);
+	void setTileLayer(MapTileItem* tile, int layer);
+	void setTileCollisionType(MapTileItem* tile, CollisionType type);
+
+	// ײԤʾϲײΣ༭ʱֻ仯ķֿ
+	void setCollisionOverlayVisible(bool visible);
+	bool isCollisionOverlayVisible() const;
+	int collisionRectCount() const { return m_collisionBaker.rectCount(); }
+
+	// Ѱ·ԤϲΪ Ground ײĸӲߣ˷ƶҲн
+	// Alt + 㣬Alt + Ҽյ㣻༭ͼԶѰ·
+	void setNavigationEndpoints(const QPoint& start, const QPoint& goal);
+	void clearNavigationPreview();
+	bool hasNavigationPreview() const { return m_navStart.has_value() || m_navGoal.has_value(); }
+
+	// Ƭͼ ID + Ƭ UUID ȡƬݺԭʼͼճʱʹã
+	using SliceResolver = std::function<bool(const QString& tilesetId, const QUuid& sliceId,
+		SpriteSlice& outSlice, QPixmap& outPixmap)>;
+	void setSliceResolver(SliceResolver resolver) { m_sliceResolver = std::move(resolver); }
+
+	// ֡ȡضƬ֡ԭʼͼ񣨰Ƭ֡˳
+	using FrameResolver = std::function<bool(const QString& tilesetId, const QUuid& sliceId,
+		QVector<QPixmap>& outFrames)>;
+	void setFrameResolver(FrameResolver resolver) { m_frameResolver = std::move(resolver); }
+
+	// ========== ѡ븴/ճ ==========
+	QRect selectedRegion() const { return m_selectedRegion; }
+	void setSelectedRegion(const QRect& region);
+	void clearRegionSelection();
+
+	// ͼƬƬԭǷΪ׼outTiles رƵƬ
+	// ȫλڵԤʵչΪͨƬһƣoutInstances Щʵ
+	// unlockedOnly ʱͼƬʵƺҪɾԭʱʹã
+	TileRegionData copyRegion(const QRect& region, QVector<MapTileItem*>* outTiles = nullptr,
+		QVector<QUuid>* outInstances = nullptr, bool unlockedOnly = false) const;
+
+	// ɾ copyRegion صƬʵɾ
+	int deleteCopied(const QVector<MapTileItem*>& tiles, const QVector<QUuid>& instances);
+
+	// ճָϽǣطõƬ
+	int pasteRegion(const TileRegionData& region, const QPoint& topLeft);
+
+	// ɾͼƬȫλڵԤʵɾ
+	int deleteRegion(const QRect& region);
+
+	// ========== Ƭ/滻 ==========
+	// ʹָƬƬlayer < 0 ʾͼ㣬region Ϊձʾŵͼ
+	QVector<MapTileItem*> findSliceUsages(const QUuid& sliceId, int layer = -1, const QRect& region = QRect()) const;
+
+	// ԤʵʹָƬƬΧͬϣ
+	int prefabSliceUsageCount(const QUuid& sliceId, int layer = -1, const QRect& region = QRect()) const;
+
+	// ƥƬ滻ΪһƬߴһ£滻
+	// transform  0 ʱƬԭеķת/ת֮ǰԭƬ = Ƭ transform 任
+	// ԤʵֻڷΧΪŵͼͼʱһ滻
+	int replaceSlice(const QUuid& fromSliceId, const QString& toTilesetId, const QUuid& toSliceId,
+		int layer = -1, const QRect& region = QRect(), quint8 transform = 0);
+
+	// ϲظƬضŵͼãͼ㡢ѻķֿԤ壩ĵƬ
+	int remapSlices(const QString& tilesetId, const QVector<SliceRemap>& remaps);
+
+	// ÿƬʹô
+	QHash<QUuid, int> sliceUsage() const;
+
+	// ========== Ԥʵ ==========
+	// Ԥʵȫλڵͼڣʵ IDʧܷؿ ID
+	QUuid placePrefab(const QUuid& prefabId, const QPoint& topLeft);
+	bool movePrefabInstance(const QUuid& instanceId, const QPoint& topLeft);
+	void removePrefabInstance(const QUuid& instanceId);
+
+	// չΪͨƬʵƳ
+	bool unpackPrefabInstance(const QUuid& instanceId);
+
+	QUuid selectedPrefabInstance() const { return m_selectedPrefabInstance; }
+	void selectPrefabInstance(const QUuid& instanceId);
+
+	// õͼƬ¼Ԥʵڴչ
+	QVector<MapExportLayer> exportLayers() const;
+
+	// /ճλãڸӣΪѡϽ
+	QPoint pasteAnchor() const;
+
 public slots:
 	// 
 	void setGridVisible(bool visible);
@@ -59,6 +227,14 @@ public slots:
 	// ɾѡеƬ
 	void deleteSelectedTile();
 
+	// Ԥ嶨仯ؽդˢʵ
+	void onPrefabChanged(const QUuid& prefabId);
+
+	// 
+	void copySelectedRegion();
+	void cutSelectedRegion();
+	void pasteFromClipboard();
+
 signals:
 	// Ա仯ź
 	void gridVisibleChanged(bool visible);
@@ -70,6 +246,33 @@ signals:
 	void tileSelected(MapTileItem* tile);
 	void tileDeselected();
 
+	// ѡ仯վαʾȡѡ
+	void regionSelectionChanged(const QRect& region);
+
+	// Ƭʹôı仯ͬһ¼ѭڵĶ޸ĺϲΪһΣֻб仯Ƭ
+	void sliceUsageChanged(const QHash<QUuid, int>& delta);
+
+	// Ƭ仯漰ķֿ飨ͬһ¼ѭںϲԼʧЧգ
+	void chunksChanged(const QVector<QPoint>& chunks);
+	void tilesReset();
+	// ԭƽƣƫ delta Ƭûб仯
+	void gridOriginShifted(const QPoint& delta);
+
+	// ͼбͼ״̬仯
+	void layersChanged();
+
+	// ͼ˳仯ϲƬ֮ı䣩
+	void layerOrderChanged();
+
+	// ӿڹŻߴ仯
+	void viewportChanged();
+
+	// ײԤ
+	void collisionBaked(int rectCount);
+
+	// Ѱ·ԤɣelapsedMs ˢ£
+	void navigationPathFound(bool found, double cost, int exploredCount, double elapsedMs);
+
 protected:
 	// Ϸ¼
 	void dragEnterEvent(QDragEnterEvent* event) override;
@@ -85,6 +288,11 @@ protected:
 	void mouseReleaseEvent(QMouseEvent* event) override;
 	void wheelEvent(QWheelEvent* event) override;
 
+	// ӿڱ仯ʱȷֿ/޵ͼڱл
+	void scrollContentsBy(int dx, int dy) override;
+	void resizeEvent(QResizeEvent* event) override;
+	void drawBackground(QPainter* painter, const QRectF& rect) override;
+
 private:
 	void setupScene();
 	void drawGrid();
@@ -95,6 +303,9 @@ private:
 	void updateMoveHighlight(const QPointF& scenePos, MapTileItem* tile);
 	void clearDropHighlight();
 
+	// ǷڵͼΧڣ޵ͼʼΪ true
+	bool isInsideMap(int gridX, int gridY, int gridW = 1, int gridH = 1) const;
+
 	// ת
 	QPoint sceneToGrid(const QPointF& scenePos) const;
 	QPointF gridToScene(int gridX, int gridY) const;
@@ -102,8 +313,169 @@ private:
 	// Ƭ
 	void placeTile(const TileDragData& tileData, const QPoint& gridPos);
 
+	// ƬͼԪڷֿ飬ͼ㲢Ǽ
+	MapTileItem* createTileItem(const QPixmap& pixmap, const SpriteSlice& slice, const QString& tilesetId,
+		int gridX, int gridY, int gridW, int gridH, int layer);
+
+	// ֻͼԪǼãֿغɵ÷ֿϲ
+	MapTileItem* insertTileItem(const QPixmap& pixmap, const SpriteSlice& slice, const QString& tilesetId,
+		int gridX, int gridY, int gridW, int gridH, int layer);
+
+	// ƳƬͼԪעӳɾ
+	void destroyTileItem(MapTileItem* tile);
+
+	// ѡ
+	void updateRegionHighlight();
+
+	// ƬԤʵչΪݣ region Ͻ
+	TileRegionData encodeRegion(const QRect& region, const QVector<MapTileItem*>& tiles,
+		const QVector<QUuid>& instances) const;
+
+	// ݴƬreplaceExisting Ϊ false ʱѱռõλãֿã
+	int placeRegionCells(const TileRegionData& region, const QPoint& topLeft, bool replaceExisting);
+
+	// չΪ¼ϽǣoutSources ضӦƬԭͼ
+	QVector<MapExportTile> regionExportTiles(const TileRegionData& region, QVector<QPixmap>* outSources = nullptr) const;
+
+	// ========== ֿʽ ==========
+	void scheduleStreaming();
+	void updateStreaming();
+	void evictChunk(const QPoint& chunk);
+
+	// дǰͬѻķֿ
+	void ensureChunkResident(const QPoint& chunk);
+	void ensureRegionResident(const QRect& gridRect);
+
+	void onChunkLoaded(const QPoint& chunk, const TileRegionData& region);
+
+	// Ƭռ/۱仯ײѰ·ͷֿֿ֪ͨ
+	void markTileDirty(const MapTileItem* tile);
+	void markAreaDirty(const QRect& gridRect);
+	void scheduleChunkNotify();
+
+	// ========== ײ決 ==========
+	void scheduleCollisionBake();
+	void bakeCollision();
+
+	// ΧڵײռãƬ + ԤʵչƬײԤѰ·뵼ͬһԴ
+	// scanAll Ϊ true ʱֱӱȫƬؽã
+	QVector<CollisionFootprint> collisionFootprints(const QRect& area, bool scanAll) const;
+
+	// ========== Ѱ·Ԥ ==========
+	void setNavigationEndpoint(const QPoint& cell, bool isStart);
+	void scheduleNavigation();
+	void updateNavigation();
+
+	// Ѱ·Χ޵ͼΪŵͼ޵ͼΪڴеķֿӶ˵㣬һȦֿ
+	QRect navigationBounds() const;
+
+	// ֿд
+	void refreshNavGrid();
+
+	// ͼڵ㣨贴
+	MapLayerRoot* layerRoot(int layer);
+
+	// ========== ͼ ==========
+	void storeLayerState(int layer, const MapLayerState& state);
+	void applyLayerState(MapLayerRoot* root);
+	void releaseLayerSelection(int layer);
+
+	// ͼб仯ؽ¸ڵ Z ֵдĵ
+	void syncLayers();
+
+	// ˳仯ֿϲƬĻ棬Ƭ
+	void invalidateLayerOrder();
+
+	// ɾͼڵ㣨ƬȴӴ洢ƳͼԪڵһɾ
+	void destroyLayerRoot(int layer);
+
+	// ؽָͼͼԪԤʵ
+	void rebuildPrefabInstancesOnLayer(int layer);
+
+	// ͼţķֿ顢Ԥݡ壩Ӧĵǰͼ
+	QVector<int> resolveLayers(int storedLayer) const;
+	void retargetLayer(int layer, const QVector<int>& targets);
+
+	//  itemAt ͬͼͼԪ
+	QGraphicsItem* editableItemAt(const QPointF& scenePos) const;
+
+	// ========== Ƭ ==========
+	// ƬĹ״ʹʱ֡ȫʱӣ̬Ƭؿ
+	const MapTileAnimation* tileAnimation(const QString& tilesetId, const SpriteSlice& slice, int gridW, int gridH);
+
+	// ȫʱӣƬƽֻ֡ػ溬л֡Ƭķֿ
+	void advanceAnimations();
+	void markAnimationDirty(const QUuid& sliceId);
+	void clearAnimations();
+
+	// ========== ϸڲ㼶 ==========
+	void updateLodLevel();
+	void invalidateLodArea(const QRect& gridRect);
+	void invalidateLodItem(const QGraphicsItem* item);
+
+	// ռֿڵƬԤ壨ͼ˳򣩣ֿͼڹ̻߳
+	// divisor Ϊ 1 ʱͼĹդѡеƬԤʵԼƣդ
+	MapLodSnapshot snapshotLodChunk(const QPoint& chunk, int divisor);
+
+	// ƽԭ㣺ÿͼڵֻƶһ
+	void setGridOrigin(const QPoint& origin);
+
+	// Ԥդͼ㣩޶Żߴ仯ʱؽ
+	struct PrefabRaster
+	{
+		int revision = -1;
+		int tileWidth = 0;
+		int tileHeight = 0;
+		QMap<int, QPixmap> layers;
+	};
+	const PrefabRaster* prefabRaster(const QUuid& prefabId);
+
+	// ݹդؽʵͼͼԪ
+	void rebuildPrefabInstanceItems(const QUuid& instanceId);
+	void clearAllPrefabInstances();
+
+	// Ԥģ壺չƬ¼ʵԭ㣬ͼΪıţ޶Żߴ仯ʱؽ
+	struct PrefabTemplate
+	{
+		int revision = -1;
+		int tileWidth = 0;
+		int tileHeight = 0;
+		QVector<MapExportTile> tiles;
+		QVector<QPixmap> sources;                     //  tiles ӦƬԭͼʽ
+	};
+	const PrefabTemplate* prefabTemplate(const QUuid& prefabId) const;
+
+	// ķֿѯཻʵ
+	QVector<QUuid> prefabInstancesInRect(const QRect& gridRect) const;
+	void indexPrefabInstance(const QUuid& instanceId, bool insert);
+
+	// ʵһͼʱɱ༭
+	bool isPrefabInstanceLocked(const QUuid& instanceId) const;
+
+	// Ƭ滻ʵ֣includeLocked Ϊ true ʱҲ޸ͼ㣨ϲظƬã
+	int replaceSliceTiles(const QUuid& fromSliceId, const QString& toTilesetId, const QUuid& toSliceId,
+		int layer, const QRect& region, quint8 transform, bool includeLocked);
+
+	// ŵͼΧƬ滻дøƬԤ嶨壬ʵӰƬ
+	int replacePrefabSlice(const QUuid& fromSliceId, const TileRegionSliceRef& to, const QSize& gridSize, quint8 transform);
+
+	// ӳ֪ͨƬʹô仯ϲƬֿԤʵۼƵı仯
+	void scheduleUsageNotify();
+
+	// ԤʵƬʹôݡͼͼΧ仯ͳƸʵֵ仯
+	void refreshInstanceUsage(const QUuid& instanceId);
+	void forgetInstanceUsage(const QUuid& instanceId);
+
 	// 
 	void applyZoom(double scaleFactor);
+	void setViewScale(double scale);
+
+	// طŵλdirection Ϊ 0 ʱȡĵλȡ/һ
+	double pixelArtScale(double scale, int direction) const;
+
+	// Ⱦʽϸڲ㼶ûѡ
+	void applyRenderHints();
+	Qt::TransformationMode pixmapTransformMode() const;
 
 	// Ƭ
 	void onTileClicked(MapTileItem* tile);
@@ -164,8 +536,71 @@ private:
 	QGraphicsRectItem* m_dropHighlight = nullptr;
 	QVector<QGraphicsRectItem*> m_coverageHighlights;
 
-	// ѷõƬ
-	QVector<MapTileItem*> m_placedTiles;
+	// ѷõƬƽб + 
+	MapTileStore m_tileStore;
+
+	// ͼڵԭ
+	QMap<int, MapLayerRoot*> m_layerRoots;
+	MapTileEvents* m_tileEvents = nullptr;     // ƬõĽźţʱһΣ
+	QPoint m_gridOrigin;
+
+	// ޵ͼ
+	static constexpr int INFINITE_SCENE_EXTENT = 1 << 24;   // 뾶أ
+	static constexpr int STREAM_PRELOAD_CHUNKS = 1;         // ӿԤķֿȦ
+	bool m_infinite = false;
+	MapChunkCache m_chunkCache;
+	QHash<quint64, QPoint> m_residentChunks;                 // ڴеķֿ飨״дʱ
+	bool m_streamingPending = false;
+
+	// ײ決ֿԤ
+	CollisionBaker m_collisionBaker;
+	MapCollisionOverlay* m_collisionOverlay = nullptr;
+	bool m_collisionBakePending = false;
+
+	// Ѱ·Ԥ
+	NavGrid m_navGrid;
+	MapNavOverlay* m_navOverlay = nullptr;
+	std::optional<QPoint> m_navStart;
+	std::optional<QPoint> m_navGoal;
+	bool m_navPending = false;
+
+	// ϸڲ㼶
+	MapLodLayer* m_lodLayer = nullptr;
+	MapLodLevel m_lodLevel = MapLodLevel::Full;
+	double m_lodMipBelow = 0.3;
+	double m_lodColorBelow = 0.15;
+	static constexpr int MAX_LOD_SOURCE_IMAGES = 4096;
+	QHash<qint64, QImage> m_lodSourceImages;          // pixmap cacheKey -> ͼ
+
+	// Ⱦʽ
+	MapRenderProfile m_renderProfile = MapRenderProfile::Smooth;
+
+	// ƬÿƬһ֡ݣƬһʱ
+	struct SliceAnimation
+	{
+		QSharedPointer<MapTileAnimation> animation;
+		QVector<QPoint> chunks;           // иƬƬķֿ飨Ƭ仯ؽ
+		bool chunksDirty = true;
+	};
+	static constexpr int ANIMATION_TICK_MS = 16;
+	QHash<QUuid, SliceAnimation> m_animations;
+	QTimer m_animationTimer;
+	QElapsedTimer m_animationClock;
+	FrameResolver m_frameResolver;
+
+	// ͼбĵͬ
+	QVector<MapLayerInfo> m_layers = MapDocument::defaultLayers();
+	QHash<int, int> m_layerIndex;                     // ͼ -> ˳
+	int m_nextLayerId = 4;
+	QHash<int, QVector<int>> m_layerTargets;          // ɾ/ϲ/ƹͼ -> ǰͼ
+
+	// ֪ͨı仯ֿ
+	QHash<quint64, QPoint> m_changedChunks;
+	bool m_chunkNotifyPending = false;
+
+	// Ƭص
+	SliceResolver m_sliceResolver;
+	bool m_usageNotifyPending = false;
 
 	// ǰѡеƬ
 	MapTileItem* m_selectedTile = nullptr;
@@ -206,4 +641,36 @@ private:
 	QPoint m_deleteLastGrid;                          // ϴδλ
 	QSet<QPair<int, int>> m_deleteRemovedPositions;   // ɾƳλ
 	QVector<QGraphicsRectItem*> m_deleteHighlights;   // ɾ
+
+	// Ԥʵ
+	struct PrefabInstance
+	{
+		QUuid prefabId;
+		int localX = 0;                               // ꣨ͬƬԭƽƸı䣩
+		int localY = 0;
+		QSize size;                                   // ռõĸԤݸ£
+		QVector<MapPrefabItem*> items;                // ÿͼһͼԪԤդ
+	};
+	QHash<QUuid, PrefabInstance> m_prefabInstances;  // ʵ ID -> ʵ
+	QHash<QUuid, QHash<QUuid, int>> m_instanceUsage; // ʵ ID -> ʹôƬ
+	QHash<QUuid, int> m_prefabUsageDelta;            // Ԥʵδ֪ͨʹô仯
+	QMultiHash<QUuid, QUuid> m_prefabUsers;          // Ԥ ID -> ʵ ID
+	QHash<quint64, QVector<QUuid>> m_prefabChunks;   // ֿ -> ཻ֮ʵ
+	QHash<QUuid, PrefabRaster> m_prefabRasters;
+	mutable QHash<QUuid, PrefabTemplate> m_prefabTemplates;
+	QPoint instanceOrigin(const PrefabInstance& instance) const {
+		return QPoint(instance.localX, instance.localY) + m_gridOrigin;
+	}
+	QRect instanceRect(const PrefabInstance& instance) const {
+		return QRect(instanceOrigin(instance), instance.size);
+	}
+	QUuid m_selectedPrefabInstance;
+	bool m_prefabDragging = false;
+	QPoint m_prefabDragOffset;                        // λʵԭĸƫ
+
+	// ѡCtrl + ϶
+	bool m_regionSelecting = false;
+	QPoint m_regionStartGrid;
+	QRect m_selectedRegion;                           // 
+	QGraphicsRectItem* m_regionHighlight = nullptr;
 };
\ No newline at end of file
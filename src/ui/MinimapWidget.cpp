@@ -0,0 +1,292 @@
+#include "MinimapWidget.h"
+#include "MapViewWidget.h"
+#include "MapTileItem.h"
+#include "core/MapChunkCache.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QtMath>
+#include <limits>
+
+MinimapWidget::MinimapWidget(QWidget* parent)
+	: QWidget(parent)
+{
+	setCursor(Qt::PointingHandCursor);
+}
+
+void MinimapWidget::setMapView(MapViewWidget* mapView)
+{
+	if (m_mapView)
+		disconnect(m_mapView, nullptr, this, nullptr);
+
+	m_mapView = mapView;
+	onTilesReset();
+	if (!m_mapView)
+		return;
+
+	connect(m_mapView, &MapViewWidget::chunksChanged, this, &MinimapWidget::onChunksChanged);
+	connect(m_mapView, &MapViewWidget::tilesReset, this, &MinimapWidget::onTilesReset);
+	connect(m_mapView, &MapViewWidget::gridOriginShifted, this, &MinimapWidget::onGridOriginShifted);
+	connect(m_mapView, &MapViewWidget::layerOrderChanged, this, &MinimapWidget::onLayerOrderChanged);
+	connect(m_mapView, &MapViewWidget::viewportChanged, this, QOverload<>::of(&QWidget::update));
+	connect(m_mapView, &MapViewWidget::mapSizeChanged, this, QOverload<>::of(&QWidget::update));
+
+	// еƬԤʵֿһ
+	QHash<quint64, QPoint> chunks;
+	auto addFootprint = [&chunks](const QRect& footprint) {
+		const QPoint first = MapChunkCache::chunkOf(footprint.left(), footprint.top());
+		const QPoint last = MapChunkCache::chunkOf(footprint.right(), footprint.bottom());
+		for (int cy = first.y(); cy <= last.y(); ++cy)
+		{
+			for (int cx = first.x(); cx <= last.x(); ++cx)
+				chunks.insert(MapChunkCache::chunkKey(QPoint(cx, cy)), QPoint(cx, cy));
+		}
+	};
+	m_mapView->forEachPlacedTile([&addFootprint](const MapTileItem* tile) {
+		addFootprint(QRect(tile->gridX(), tile->gridY(), tile->gridWidth(), tile->gridHeight()));
+		});
+	m_mapView->forEachPrefabTile(QRect(), [&addFootprint](const MapExportTile& tile, const QPixmap&) {
+		addFootprint(QRect(tile.gridX, tile.gridY, tile.gridWidth, tile.gridHeight));
+		});
+	onChunksChanged(QVector<QPoint>(chunks.cbegin(), chunks.cend()));
+}
+
+void MinimapWidget::onChunksChanged(const QVector<QPoint>& chunks)
+{
+	for (const QPoint& chunk : chunks)
+		renderChunk(chunk);
+	update();
+}
+
+void MinimapWidget::onTilesReset()
+{
+	m_chunks.clear();
+	update();
+}
+
+void MinimapWidget::onGridOriginShifted(const QPoint& delta)
+{
+	// ûб仯ѻƵķֿͼƫƺƴµķֿ²ѯƬ
+	const QHash<quint64, ChunkImage> oldChunks = std::move(m_chunks);
+	m_chunks.clear();
+
+	for (const ChunkImage& entry : oldChunks)
+	{
+		const QRect area = MapChunkCache::chunkRect(entry.chunk).translated(delta);
+		const QPoint first = MapChunkCache::chunkOf(area.left(), area.top());
+		const QPoint last = MapChunkCache::chunkOf(area.right(), area.bottom());
+		for (int cy = first.y(); cy <= last.y(); ++cy)
+		{
+			for (int cx = first.x(); cx <= last.x(); ++cx)
+			{
+				const QPoint chunk(cx, cy);
+				const QRect target = MapChunkCache::chunkRect(chunk);
+				auto it = m_chunks.find(MapChunkCache::chunkKey(chunk));
+				if (it == m_chunks.end())
+				{
+					QImage image(target.size(), QImage::Format_ARGB32);
+					image.fill(Qt::transparent);
+					it = m_chunks.insert(MapChunkCache::chunkKey(chunk), ChunkImage{ chunk, image });
+				}
+
+				QPainter painter(&it->image);
+				painter.setCompositionMode(QPainter::CompositionMode_Source);
+				const QRect overlap = area.intersected(target);
+				painter.drawImage(overlap.topLeft() - target.topLeft(), entry.image,
+					QRect(overlap.topLeft() - area.topLeft(), overlap.size()));
+			}
+		}
+	}
+	update();
+}
+
+void MinimapWidget::onLayerOrderChanged()
+{
+	// ˳ֻӰѻƵķֿ
+	const QList<ChunkImage> chunks = m_chunks.values();
+	for (const ChunkImage& entry : chunks)
+		renderChunk(entry.chunk);
+	update();
+}
+
+QRgb MinimapWidget::sliceColor(const QUuid& sliceId, const QPixmap& pixmap)
+{
+	auto it = m_sliceColors.constFind(sliceId);
+	if (it != m_sliceColors.constEnd())
+		return it.value();
+
+	//  alpha Ȩƽɫ͸ز
+	const QImage image = pixmap.toImage().convertToFormat(QImage::Format_ARGB32);
+	quint64 red = 0, green = 0, blue = 0, alpha = 0;
+	for (int y = 0; y < image.height(); ++y)
+	{
+		const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+		for (int x = 0; x < image.width(); ++x)
+		{
+			const quint64 a = qAlpha(line[x]);
+			red += qRed(line[x]) * a;
+			green += qGreen(line[x]) * a;
+			blue += qBlue(line[x]) * a;
+			alpha += a;
+		}
+	}
+
+	QRgb color = qRgba(0, 0, 0, 0);
+	if (alpha > 0)
+	{
+		const quint64 pixels = quint64(image.width()) * image.height();
+		color = qRgba(int(red / alpha), int(green / alpha), int(blue / alpha),
+			int(qMax<quint64>(alpha / pixels, 96)));
+	}
+	m_sliceColors.insert(sliceId, color);
+	return color;
+}
+
+void MinimapWidget::renderChunk(const QPoint& chunk)
+{
+	const quint64 key = MapChunkCache::chunkKey(chunk);
+
+	// ʱƬɾݲûб仯
+	if (!m_mapView || m_mapView->isChunkEvicted(chunk))
+		return;
+
+	const QRect area = MapChunkCache::chunkRect(chunk);
+	const QSet<MapTileItem*> tiles = m_mapView->tilesInRect(area);
+
+	// ÿȡ˳ߵƬ
+	QImage image(area.size(), QImage::Format_ARGB32);
+	image.fill(Qt::transparent);
+	QVector<int> topLayer(area.width() * area.height(), std::numeric_limits<int>::min());
+	bool empty = true;
+
+	auto fill = [&](const QRect& footprint, int layer, QRgb color) {
+		const int order = m_mapView->layerOrder(layer);
+		const QRect cells = footprint.intersected(area);
+		for (int y = cells.top(); y <= cells.bottom(); ++y)
+		{
+			QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y - area.top()));
+			for (int x = cells.left(); x <= cells.right(); ++x)
+			{
+				int& top = topLayer[(y - area.top()) * area.width() + (x - area.left())];
+				if (order < top)
+					continue;
+				top = order;
+				line[x - area.left()] = color;
+			}
+		}
+		empty = false;
+	};
+
+	for (const MapTileItem* tile : tiles)
+	{
+		fill(QRect(tile->gridX(), tile->gridY(), tile->gridWidth(), tile->gridHeight()), tile->layer(),
+			sliceColor(tile->slice().id, tile->originalPixmap()));
+	}
+	m_mapView->forEachPrefabTile(area, [&](const MapExportTile& tile, const QPixmap& source) {
+		fill(QRect(tile.gridX, tile.gridY, tile.gridWidth, tile.gridHeight), tile.layer, sliceColor(tile.slice.id, source));
+		});
+
+	if (empty)
+	{
+		m_chunks.remove(key);
+		return;
+	}
+	m_chunks.insert(key, ChunkImage{ chunk, image });
+}
+
+QRectF MinimapWidget::contentBounds() const
+{
+	if (!m_mapView)
+		return QRectF();
+
+	if (m_dragging)
+		return m_dragBounds;
+
+	if (!m_mapView->isInfiniteMode())
+		return QRectF(0, 0, m_mapView->mapWidth(), m_mapView->mapHeight());
+
+	QRectF bounds = m_mapView->visibleGridRect();
+	for (const ChunkImage& chunk : m_chunks)
+		bounds = bounds.united(MapChunkCache::chunkRect(chunk.chunk));
+	return bounds;
+}
+
+QTransform MinimapWidget::gridToWidget(const QRectF& bounds) const
+{
+	// ȱŲ
+	const qreal scale = qMin(width() / bounds.width(), height() / bounds.height());
+	const qreal offsetX = (width() - bounds.width() * scale) / 2.0;
+	const qreal offsetY = (height() - bounds.height() * scale) / 2.0;
+
+	QTransform transform;
+	transform.translate(offsetX, offsetY);
+	transform.scale(scale, scale);
+	transform.translate(-bounds.x(), -bounds.y());
+	return transform;
+}
+
+void MinimapWidget::paintEvent(QPaintEvent* event)
+{
+	Q_UNUSED(event);
+
+	QPainter painter(this);
+	painter.fillRect(rect(), QColor(40, 42, 48));
+
+	const QRectF bounds = contentBounds();
+	if (bounds.isEmpty())
+		return;
+
+	const QTransform transform = gridToWidget(bounds);
+	painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+	// ͼΧ
+	const QRectF mapArea = transform.mapRect(m_mapView->isInfiniteMode() ? bounds
+		: QRectF(0, 0, m_mapView->mapWidth(), m_mapView->mapHeight()));
+	painter.fillRect(mapArea, QColor(249, 250, 252));
+
+	for (const ChunkImage& chunk : m_chunks)
+	{
+		const QRectF target = transform.mapRect(QRectF(MapChunkCache::chunkRect(chunk.chunk)));
+		if (target.intersects(rect()))
+			painter.drawImage(target, chunk.image);
+	}
+
+	// ͼɼΧ
+	painter.setPen(QPen(QColor(80, 140, 255), 1));
+	painter.setBrush(QColor(80, 140, 255, 40));
+	painter.drawRect(transform.mapRect(m_mapView->visibleGridRect()));
+}
+
+void MinimapWidget::panTo(const QPoint& widgetPos)
+{
+	const QRectF bounds = contentBounds();
+	if (!m_mapView || bounds.isEmpty())
+		return;
+
+	m_mapView->centerOnGrid(gridToWidget(bounds).inverted().map(QPointF(widgetPos)));
+}
+
+void MinimapWidget::mousePressEvent(QMouseEvent* event)
+{
+	if (event->button() != Qt::LeftButton)
+		return;
+
+	m_dragBounds = contentBounds();
+	m_dragging = true;
+	panTo(event->pos());
+}
+
+void MinimapWidget::mouseMoveEvent(QMouseEvent* event)
+{
+	if (m_dragging)
+		panTo(event->pos());
+}
+
+void MinimapWidget::mouseReleaseEvent(QMouseEvent* event)
+{
+	if (event->button() == Qt::LeftButton && m_dragging)
+	{
+		m_dragging = false;
+		update();
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QUuid>
+#include <QWidget>
+
+class MapViewWidget;
+
+// СͼÿһأɫȡϲƬԤʵеƬƬƽɫ
+// - ֿ鱣潵ͼ񣬱༭ֻػ仯ķֿ
+// - Ƭƽɫֻһ
+// - ϶ƽͼ
+class MinimapWidget : public QWidget
+{
+	Q_OBJECT
+public:
+	explicit MinimapWidget(QWidget* parent = nullptr);
+
+	void setMapView(MapViewWidget* mapView);
+
+protected:
+	void paintEvent(QPaintEvent* event) override;
+	void mousePressEvent(QMouseEvent* event) override;
+	void mouseMoveEvent(QMouseEvent* event) override;
+	void mouseReleaseEvent(QMouseEvent* event) override;
+
+private slots:
+	void onChunksChanged(const QVector<QPoint>& chunks);
+	void onTilesReset();
+	void onGridOriginShifted(const QPoint& delta);
+	void onLayerOrderChanged();
+
+private:
+	// դһֿ飨ѻķֿ鱣ԭͼ
+	void renderChunk(const QPoint& chunk);
+	QRgb sliceColor(const QUuid& sliceId, const QPixmap& pixmap);
+
+	// ʾΧ꣩޵ͼΪŵͼ޵ͼΪѻƵķֿӿ
+	QRectF contentBounds() const;
+
+	//  <-> ؼ
+	QTransform gridToWidget(const QRectF& bounds) const;
+	void panTo(const QPoint& widgetPos);
+
+private:
+	struct ChunkImage
+	{
+		QPoint chunk;
+		QImage image;
+	};
+
+	MapViewWidget* m_mapView = nullptr;
+	QHash<quint64, ChunkImage> m_chunks;
+	QHash<QUuid, QRgb> m_sliceColors;
+
+	bool m_dragging = false;
+	QRectF m_dragBounds;         // ϶ڼ̶ʾΧ޵ͼΧӿڱ仯
+};
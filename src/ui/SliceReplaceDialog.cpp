@@ -0,0 +1,170 @@
+#include "SliceReplaceDialog.h"
+#include "MapViewWidget.h"
+#include "MapTileItem.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+namespace
+{
+	constexpr int TilesetIdRole = Qt::UserRole;
+	constexpr int SliceIdRole = Qt::UserRole + 1;
+	constexpr int SliceSizeRole = Qt::UserRole + 2;
+}
+
+SliceReplaceDialog::SliceReplaceDialog(MapViewWidget* mapView, const QVector<SpriteSheetData>& tilesets,
+	const QVector<MapLayerInfo>& layers, QWidget* parent)
+	: QDialog(parent)
+	, m_mapView(mapView)
+{
+	setWindowTitle(QStringLiteral("/滻Ƭ"));
+	setupUi(layers);
+
+	populateSliceCombo(m_comboFind, tilesets);
+	populateSliceCombo(m_comboReplace, tilesets);
+
+	// ĬϲҵǰѡƬƬ
+	if (MapTileItem* tile = m_mapView->selectedTile())
+		selectSlice(m_comboFind, tile->slice().id);
+
+	connect(m_comboFind, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SliceReplaceDialog::updateMatchCount);
+	connect(m_comboLayer, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SliceReplaceDialog::updateMatchCount);
+	connect(m_checkRegion, &QCheckBox::toggled, this, &SliceReplaceDialog::updateMatchCount);
+	connect(m_buttonReplace, &QPushButton::clicked, this, &SliceReplaceDialog::onReplaceClicked);
+
+	updateMatchCount();
+}
+
+void SliceReplaceDialog::setupUi(const QVector<MapLayerInfo>& layers)
+{
+	m_comboFind = new QComboBox(this);
+	m_comboReplace = new QComboBox(this);
+
+	m_comboLayer = new QComboBox(this);
+	m_comboLayer->addItem(QStringLiteral("ȫͼ"), -1);
+	for (const MapLayerInfo& layer : layers)
+		m_comboLayer->addItem(layer.name, layer.id);
+
+	m_checkRegion = new QCheckBox(QStringLiteral("ѡ"), this);
+	m_checkRegion->setEnabled(!m_mapView->selectedRegion().isEmpty());
+	m_checkRegion->setChecked(!m_mapView->selectedRegion().isEmpty());
+
+	m_labelResult = new QLabel(this);
+
+	auto* form = new QFormLayout;
+	form->addRow(QStringLiteral("Ƭ"), m_comboFind);
+	form->addRow(QStringLiteral("滻Ϊ"), m_comboReplace);
+	form->addRow(QStringLiteral("ͼ"), m_comboLayer);
+	form->addRow(QString(), m_checkRegion);
+
+	m_buttonReplace = new QPushButton(QStringLiteral("ȫ滻"), this);
+	auto* buttonClose = new QPushButton(QStringLiteral("ر"), this);
+	connect(buttonClose, &QPushButton::clicked, this, &QDialog::reject);
+
+	auto* buttons = new QHBoxLayout;
+	buttons->addWidget(m_labelResult, 1);
+	buttons->addWidget(m_buttonReplace);
+	buttons->addWidget(buttonClose);
+
+	auto* root = new QVBoxLayout(this);
+	root->addLayout(form);
+	root->addLayout(buttons);
+
+	setMinimumWidth(360);
+}
+
+void SliceReplaceDialog::populateSliceCombo(QComboBox* combo, const QVector<SpriteSheetData>& tilesets)
+{
+	const QString tilesetFallback = QStringLiteral("Tileset");
+	for (const SpriteSheetData& data : tilesets)
+	{
+		//  TilesetsPanel еͼ ID һ
+		const QString tilesetId = data.fileName.isEmpty() ? tilesetFallback : data.fileName;
+		for (const SpriteSlice& slice : data.slices)
+		{
+			combo->addItem(QStringLiteral("%1 / %2").arg(tilesetId, slice.name));
+			const int row = combo->count() - 1;
+			combo->setItemData(row, tilesetId, TilesetIdRole);
+			combo->setItemData(row, QVariant::fromValue(slice.id), SliceIdRole);
+			combo->setItemData(row, QSize(slice.sourceWidth(), slice.sourceHeight()), SliceSizeRole);
+		}
+	}
+}
+
+void SliceReplaceDialog::selectSlice(QComboBox* combo, const QUuid& sliceId)
+{
+	for (int row = 0; row < combo->count(); ++row)
+	{
+		if (combo->itemData(row, SliceIdRole).value<QUuid>() == sliceId)
+		{
+			combo->setCurrentIndex(row);
+			return;
+		}
+	}
+}
+
+int SliceReplaceDialog::scopeLayer() const
+{
+	return m_comboLayer->currentData().toInt();
+}
+
+QRect SliceReplaceDialog::scopeRegion() const
+{
+	return m_checkRegion->isChecked() ? m_mapView->selectedRegion() : QRect();
+}
+
+void SliceReplaceDialog::updateMatchCount()
+{
+	if (m_comboFind->currentIndex() < 0)
+	{
+		m_labelResult->setText(QStringLiteral("ûпõƬ"));
+		m_buttonReplace->setEnabled(false);
+		return;
+	}
+
+	const QUuid sliceId = m_comboFind->currentData(SliceIdRole).value<QUuid>();
+	const int matches = m_mapView->findSliceUsages(sliceId, scopeLayer(), scopeRegion()).size();
+	const int prefabMatches = m_mapView->prefabSliceUsageCount(sliceId, scopeLayer(), scopeRegion());
+
+	// Ԥʵֻŵͼͼ㷶Χ滻
+	const bool prefabsReplaceable = scopeLayer() < 0 && scopeRegion().isEmpty();
+	if (prefabMatches == 0)
+		m_labelResult->setText(QStringLiteral("ƥ: %1").arg(matches));
+	else if (prefabsReplaceable)
+		m_labelResult->setText(QStringLiteral("ƥ: %1Ԥʵ %2").arg(matches + prefabMatches).arg(prefabMatches));
+	else
+		m_labelResult->setText(QStringLiteral("ƥ: %1Ԥʵ %2ŵͼΧ滻").arg(matches).arg(prefabMatches));
+	m_buttonReplace->setEnabled(matches > 0 || (prefabsReplaceable && prefabMatches > 0));
+}
+
+void SliceReplaceDialog::onReplaceClicked()
+{
+	if (m_comboFind->currentIndex() < 0 || m_comboReplace->currentIndex() < 0)
+		return;
+
+	const QUuid fromId = m_comboFind->currentData(SliceIdRole).value<QUuid>();
+	const QUuid toId = m_comboReplace->currentData(SliceIdRole).value<QUuid>();
+	if (fromId == toId)
+		return;
+
+	// 滻ܸıƬռõĸ
+	if (m_comboFind->currentData(SliceSizeRole).toSize() != m_comboReplace->currentData(SliceSizeRole).toSize())
+	{
+		QMessageBox::warning(this, QStringLiteral("滻ʧ"),
+			QStringLiteral("Ƭĳߴ粻һ£޷滻"));
+		return;
+	}
+
+	const int replaced = m_mapView->replaceSlice(fromId,
+		m_comboReplace->currentData(TilesetIdRole).toString(), toId,
+		scopeLayer(), scopeRegion());
+
+	updateMatchCount();
+	m_labelResult->setText(QStringLiteral("滻: %1").arg(replaced));
+}
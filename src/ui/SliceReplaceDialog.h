@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QDialog>
+#include <QVector>
+#include "core/SpriteSliceDefine.h"
+#include "core/MapDocument.h"
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QPushButton;
+class MapViewWidget;
+
+// Ƭ/滻Ի
+// ڵͼϲʹĳƬƬ滻ΪһƬ޶ͼѡ
+class SliceReplaceDialog : public QDialog
+{
+	Q_OBJECT
+public:
+	SliceReplaceDialog(MapViewWidget* mapView, const QVector<SpriteSheetData>& tilesets,
+		const QVector<MapLayerInfo>& layers, QWidget* parent = nullptr);
+
+private slots:
+	void updateMatchCount();
+	void onReplaceClicked();
+
+private:
+	void setupUi(const QVector<MapLayerInfo>& layers);
+	void populateSliceCombo(QComboBox* combo, const QVector<SpriteSheetData>& tilesets);
+	void selectSlice(QComboBox* combo, const QUuid& sliceId);
+
+	// ǰҷΧ
+	int scopeLayer() const;
+	QRect scopeRegion() const;
+
+private:
+	MapViewWidget* m_mapView = nullptr;
+
+	QComboBox* m_comboFind = nullptr;
+	QComboBox* m_comboReplace = nullptr;
+	QComboBox* m_comboLayer = nullptr;
+	QCheckBox* m_checkRegion = nullptr;
+	QLabel* m_labelResult = nullptr;
+	QPushButton* m_buttonReplace = nullptr;
+};
@@ -0,0 +1,289 @@
+#include "SliceTableModel.h"
+#include "app/ThumbnailService.h"
+
+#include <QColor>
+#include <algorithm>
+
+namespace
+{
+	// ԤͼԼΪʱδõģ
+	constexpr int ThumbnailCacheSize = 2000;
+
+	// ɾзɢɹʱΪһѹ + ãƶ
+	constexpr int MaxRemoveRuns = 64;
+}
+
+SliceTableModel::SliceTableModel(QVector<SpriteSlice>& slices, QObject* parent)
+	: QAbstractTableModel(parent)
+	, m_slices(slices)
+	, m_thumbnails(ThumbnailCacheSize)
+{
+	m_index.rebuild(m_slices);
+}
+
+SliceTableModel::~SliceTableModel()
+{
+	if (m_thumbnailService)
+		m_thumbnailService->releaseImage(m_sourceKey);
+}
+
+void SliceTableModel::setThumbnailService(ThumbnailService* service)
+{
+	if (m_thumbnailService == service)
+		return;
+
+	if (m_thumbnailService)
+	{
+		disconnect(m_thumbnailService, nullptr, this, nullptr);
+		m_thumbnailService->releaseImage(m_sourceKey);
+	}
+
+	m_thumbnailService = service;
+	if (m_thumbnailService)
+		connect(m_thumbnailService, &ThumbnailService::thumbnailReady, this, &SliceTableModel::onThumbnailReady);
+
+	registerSource();
+	m_thumbnails.clear();
+}
+
+void SliceTableModel::setSourceImage(const QImage& image, const QString& filePath)
+{
+	if (m_thumbnailService)
+		m_thumbnailService->releaseImage(m_sourceKey);
+
+	m_source = image;
+	m_sourcePath = filePath;
+	m_thumbnails.clear();
+	registerSource();
+
+	if (!m_slices.isEmpty())
+		emit dataChanged(index(0, SliceTableColumn::Preview), index(m_slices.size() - 1, SliceTableColumn::Preview),
+			{ Qt::DecorationRole });
+}
+
+void SliceTableModel::appendSlice(const SpriteSlice& slice)
+{
+	const int row = m_slices.size();
+	beginInsertRows(QModelIndex(), row, row);
+	m_slices.append(slice);
+	m_index.append(QRect(slice.x, slice.y, slice.width, slice.height));
+	endInsertRows();
+}
+
+void SliceTableModel::removeSlices(QVector<int> rows)
+{
+	std::sort(rows.begin(), rows.end(), std::greater<int>());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+	while (!rows.isEmpty() && rows.first() >= m_slices.size())
+		rows.removeFirst();
+	while (!rows.isEmpty() && rows.last() < 0)
+		rows.removeLast();
+	if (rows.isEmpty())
+		return;
+
+	for (int row : rows)
+		forgetSlice(m_slices[row].id);
+
+	// ӺǰɾǰкŲӰ
+	QVector<QPair<int, int>> runs;
+	for (int row : rows)
+	{
+		if (!runs.isEmpty() && runs.last().first == row + 1)
+			runs.last().first = row;
+		else
+			runs.append({ row, row });
+	}
+
+	if (runs.size() > MaxRemoveRuns)
+	{
+		QVector<bool> removed(m_slices.size(), false);
+		for (int row : rows)
+			removed[row] = true;
+
+		beginResetModel();
+		int write = 0;
+		for (int read = 0; read < m_slices.size(); ++read)
+		{
+			if (!removed[read])
+			{
+				if (write != read)
+					m_slices[write] = std::move(m_slices[read]);
+				++write;
+			}
+		}
+		m_slices.resize(write);
+		m_index.remove(rows);
+		endResetModel();
+		return;
+	}
+
+	for (const auto& run : runs)
+	{
+		beginRemoveRows(QModelIndex(), run.first, run.second);
+		m_slices.remove(run.first, run.second - run.first + 1);
+		endRemoveRows();
+	}
+
+	// ֻժɾУкԭǰ
+	m_index.remove(rows);
+}
+
+void SliceTableModel::updateSlice(int row)
+{
+	if (row < 0 || row >= m_slices.size())
+		return;
+
+	const SpriteSlice& slice = m_slices[row];
+	m_thumbnails.remove(slice.id);
+	m_index.update(row, QRect(slice.x, slice.y, slice.width, slice.height));
+	emit dataChanged(index(row, 0), index(row, SliceTableColumn::Count - 1));
+}
+
+void SliceTableModel::resetSlices(QVector<SpriteSlice> slices)
+{
+	beginResetModel();
+	m_slices = std::move(slices);
+	m_index.rebuild(m_slices);
+	m_thumbnails.clear();
+	m_marks.clear();
+	endResetModel();
+}
+
+void SliceTableModel::setRowMark(int row, const QString& toolTip)
+{
+	if (row < 0 || row >= m_slices.size())
+		return;
+
+	m_marks.insert(m_slices[row].id, toolTip);
+	emit dataChanged(index(row, 0), index(row, SliceTableColumn::Count - 1),
+		{ Qt::BackgroundRole, Qt::ToolTipRole });
+}
+
+QPixmap SliceTableModel::thumbnail(int row) const
+{
+	if (row < 0 || row >= m_slices.size() || m_source.isNull())
+		return QPixmap();
+
+	const SpriteSlice& slice = m_slices[row];
+	if (const QPixmap* cached = m_thumbnails.object(slice.id))
+		return *cached;
+
+	const QRect rect(slice.x, slice.y, slice.width, slice.height);
+	QPixmap* thumb = nullptr;
+	if (m_thumbnailService)
+	{
+		// δʱȿţthumbnailReady ˢԤ
+		const QSize size(ThumbnailSize, ThumbnailSize);
+		const QImage image = m_thumbnailService->thumbnail(m_sourceKey, rect, size);
+		if (image.isNull())
+		{
+			m_pendingThumbnails.insert(ThumbnailService::thumbnailKey(m_sourceKey, rect, size));
+			return QPixmap();
+		}
+		thumb = new QPixmap(QPixmap::fromImage(image));
+	}
+	else
+	{
+		thumb = new QPixmap(QPixmap::fromImage(m_source.copy(rect)
+			.scaled(ThumbnailSize, ThumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation)));
+	}
+	const QPixmap result = *thumb;
+	m_thumbnails.insert(slice.id, thumb);
+	return result;
+}
+
+int SliceTableModel::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : m_slices.size();
+}
+
+int SliceTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : SliceTableColumn::Count;
+}
+
+QVariant SliceTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= m_slices.size())
+		return QVariant();
+
+	const SpriteSlice& slice = m_slices[index.row()];
+
+	switch (role)
+	{
+	case Qt::DisplayRole:
+		switch (index.column())
+		{
+		case SliceTableColumn::Name: return slice.name;
+		case SliceTableColumn::X: return slice.x;
+		case SliceTableColumn::Y: return slice.textureY(m_source.height());
+		case SliceTableColumn::Width: return slice.width;
+		case SliceTableColumn::Height: return slice.height;
+		case SliceTableColumn::Group: return slice.group;
+		case SliceTableColumn::Tags: return slice.tags;
+		default: return QVariant();
+		}
+	case Qt::DecorationRole:
+		// ֻлƵвŻԤͼ
+		if (index.column() == SliceTableColumn::Preview)
+			return thumbnail(index.row());
+		return QVariant();
+	case Qt::TextAlignmentRole:
+		if (index.column() >= SliceTableColumn::X && index.column() <= SliceTableColumn::Height)
+			return int(Qt::AlignCenter);
+		return QVariant();
+	case Qt::BackgroundRole:
+		if (m_marks.contains(slice.id))
+			return QColor(255, 200, 50, 60);
+		return QVariant();
+	case Qt::ToolTipRole:
+		return m_marks.value(slice.id);
+	case SliceTableRole::SliceId:
+		return slice.id;
+	default:
+		return QVariant();
+	}
+}
+
+QVariant SliceTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+		return QAbstractTableModel::headerData(section, orientation, role);
+
+	switch (section)
+	{
+	case SliceTableColumn::Preview: return QStringLiteral("Ԥ");
+	case SliceTableColumn::Name: return QStringLiteral("");
+	case SliceTableColumn::X: return QStringLiteral("X");
+	case SliceTableColumn::Y: return QStringLiteral("Y");
+	case SliceTableColumn::Width: return QStringLiteral("");
+	case SliceTableColumn::Height: return QStringLiteral("");
+	case SliceTableColumn::Group: return QStringLiteral("");
+	case SliceTableColumn::Tags: return QStringLiteral("ǩ");
+	default: return QVariant();
+	}
+}
+
+void SliceTableModel::forgetSlice(const QUuid& id)
+{
+	m_thumbnails.remove(id);
+	m_marks.remove(id);
+}
+
+void SliceTableModel::registerSource()
+{
+	m_pendingThumbnails.clear();
+	m_sourceKey = (m_thumbnailService && !m_source.isNull())
+		? m_thumbnailService->registerImage(m_source, m_sourcePath)
+		: QString();
+}
+
+void SliceTableModel::onThumbnailReady(const QString& key)
+{
+	if (!m_pendingThumbnails.remove(key) || m_slices.isEmpty())
+		return;
+
+	// ֻ֪ͨͼػɼ򣬿ɼٴӷڴ滺ȡͼ
+	emit dataChanged(index(0, SliceTableColumn::Preview), index(m_slices.size() - 1, SliceTableColumn::Preview),
+		{ Qt::DecorationRole });
+}
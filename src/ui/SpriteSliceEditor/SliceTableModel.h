@@ -0,0 +1,80 @@
+#ifndef SLICETABLEMODEL_H
+#define SLICETABLEMODEL_H
+#include "core/SpriteSliceDefine.h"
+#include "core/SliceSpatialIndex.h"
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QSet>
+
+class ThumbnailService;
+
+// Ƭģ
+// - ֱñ༭Ƭ飨Դ
+// - ƬɾĶͨз֪ͨͼֻˢ±仯Ĳ
+// - ԤͼͼƵʱͼں̨ɣˢԤ
+// - ͬʱάƬĿռѡѡʹ
+class SliceTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	static constexpr int ThumbnailSize = 48;
+
+	explicit SliceTableModel(QVector<SpriteSlice>& slices, QObject* parent = nullptr);
+	~SliceTableModel();
+
+	// δʱڻʱͬԤͼ
+	void setThumbnailService(ThumbnailService* service);
+
+	// ԤͼԴлͼʱãջ棩༭ͬһ QImage
+	// filePath ͼʶͬһļ
+	void setSourceImage(const QImage& image, const QString& filePath = QString());
+
+	// ==========  ==========
+	void appendSlice(const SpriteSlice& slice);
+	void removeSlices(QVector<int> rows);
+	// Ƭԭ޸ĺ
+	void updateSlice(int row);
+
+	// ========== 滻 ==========
+	void resetSlices(QVector<SpriteSlice> slices);
+	void clearSlices() { resetSlices(QVector<SpriteSlice>()); }
+
+	// УظƬʾ滻ʱ
+	void setRowMark(int row, const QString& toolTip);
+
+	QPixmap thumbnail(int row) const;
+
+	const SliceSpatialIndex& spatialIndex() const { return m_index; }
+
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+	void forgetSlice(const QUuid& id);
+	void registerSource();
+	void onThumbnailReady(const QString& key);
+
+private:
+	QVector<SpriteSlice>& m_slices;
+	QImage m_source;
+	QString m_sourcePath;
+
+	ThumbnailService* m_thumbnailService = nullptr;
+	QString m_sourceKey;                        // Դͼͼеļ
+	mutable QSet<QString> m_pendingThumbnails;  // δͼ
+
+	// Ƭ ID -> ԤͼֻƹУ
+	mutable QCache<QUuid, QPixmap> m_thumbnails;
+	QHash<QUuid, QString> m_marks;
+
+	SliceSpatialIndex m_index;
+};
+
+#endif // SLICETABLEMODEL_H
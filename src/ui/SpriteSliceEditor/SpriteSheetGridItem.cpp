@@ -0,0 +1,113 @@
+#include "SpriteSheetGridItem.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+
+namespace
+{
+	// ĻСڸʱٻ
+	constexpr qreal MinScreenSpacing = 4.0;
+
+	// һռɼλã / ߣ
+	void collectLines(int margin, int tile, int spacing, int extent, qreal visibleFrom, qreal visibleTo,
+		QVector<int>& mainLines, QVector<int>& spaceLines)
+	{
+		const int period = tile + spacing;
+		if (period <= 0)
+			return;
+
+		// Ҳ tile ǰȡһ
+		const int first = qMax(0, qFloor((visibleFrom - margin - tile) / period));
+		for (int k = first;; ++k)
+		{
+			const int pos = margin + k * period;
+			if (pos > extent || pos > visibleTo)
+				break;
+
+			if (pos >= visibleFrom)
+				mainLines.append(pos);
+
+			const int spacePos = pos + tile;
+			if (spacing > 0 && spacePos <= extent && spacePos >= visibleFrom && spacePos <= visibleTo)
+				spaceLines.append(spacePos);
+		}
+	}
+}
+
+SpriteSheetGridItem::SpriteSheetGridItem(QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+{
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+	setAcceptedMouseButtons(Qt::NoButton);
+	setZValue(10);
+}
+
+void SpriteSheetGridItem::setImageSize(const QSize& size)
+{
+	if (m_imageSize == size)
+		return;
+
+	prepareGeometryChange();
+	m_imageSize = size;
+}
+
+void SpriteSheetGridItem::setGrid(const SpriteGridParams& params)
+{
+	m_params = params;
+	update();
+}
+
+QRectF SpriteSheetGridItem::boundingRect() const
+{
+	// ߿ 1Ե߸һ
+	return QRectF(QPointF(0, 0), QSizeF(m_imageSize)).adjusted(-1, -1, 1, 1);
+}
+
+void SpriteSheetGridItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	Q_UNUSED(widget);
+
+	if (m_imageSize.isEmpty() || !m_params.isValid())
+		return;
+
+	const qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+	if ((m_params.tileWidth + m_params.spacingX) * scale < MinScreenSpacing
+		|| (m_params.tileHeight + m_params.spacingY) * scale < MinScreenSpacing)
+		return;
+
+	const QRectF exposed = option->exposedRect.adjusted(-1, -1, 1, 1);
+	const qreal top = qMax<qreal>(0, exposed.top());
+	const qreal bottom = qMin<qreal>(m_imageSize.height(), exposed.bottom());
+	const qreal left = qMax<qreal>(0, exposed.left());
+	const qreal right = qMin<qreal>(m_imageSize.width(), exposed.right());
+	if (top > bottom || left > right)
+		return;
+
+	QVector<int> mainX, spaceX, mainY, spaceY;
+	collectLines(m_params.marginX, m_params.tileWidth, m_params.spacingX, m_imageSize.width(),
+		exposed.left(), exposed.right(), mainX, spaceX);
+	collectLines(m_params.marginY, m_params.tileHeight, m_params.spacingY, m_imageSize.height(),
+		exposed.top(), exposed.bottom(), mainY, spaceY);
+
+	QVector<QLineF> mainLines;
+	mainLines.reserve(mainX.size() + mainY.size());
+	for (int x : mainX)
+		mainLines.append(QLineF(x, top, x, bottom));
+	for (int y : mainY)
+		mainLines.append(QLineF(left, y, right, y));
+
+	QVector<QLineF> spaceLines;
+	spaceLines.reserve(spaceX.size() + spaceY.size());
+	for (int x : spaceX)
+		spaceLines.append(QLineF(x, top, x, bottom));
+	for (int y : spaceY)
+		spaceLines.append(QLineF(left, y, right, y));
+
+	painter->save();
+	painter->setPen(QPen(QColor(255, 100, 100, 180), 1, Qt::SolidLine));
+	painter->drawLines(mainLines);
+	painter->setPen(QPen(QColor(100, 100, 255, 120), 1, Qt::DashLine));
+	painter->drawLines(spaceLines);
+	painter->restore();
+}
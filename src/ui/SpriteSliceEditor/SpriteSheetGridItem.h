@@ -0,0 +1,30 @@
+#ifndef SPRITESHEETGRIDITEM_H
+#define SPRITESHEETGRIDITEM_H
+#include "core/SpriteSheetAnalyzer.h"
+
+#include <QGraphicsItem>
+
+// Ӳ㣺ڻʱΪÿߴͼԪ
+// - ֻػཻ
+// - СĻֻмʱٻ
+class SpriteSheetGridItem : public QGraphicsItem
+{
+public:
+	enum { Type = UserType + 21 };
+
+	explicit SpriteSheetGridItem(QGraphicsItem* parent = nullptr);
+
+	int type() const override { return Type; }
+
+	void setImageSize(const QSize& size);
+	void setGrid(const SpriteGridParams& params);
+
+	QRectF boundingRect() const override;
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	QSize m_imageSize;
+	SpriteGridParams m_params;
+};
+
+#endif // SPRITESHEETGRIDITEM_H
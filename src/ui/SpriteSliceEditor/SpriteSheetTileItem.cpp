@@ -0,0 +1,125 @@
+#include "SpriteSheetTileItem.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+#include <cmath>
+
+SpriteSheetTileItem::SpriteSheetTileItem(QGraphicsItem* parent)
+	: QGraphicsObject(parent)
+{
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+	setAcceptedMouseButtons(Qt::NoButton);
+
+	// 㼶˳ɣһ̼߳
+	m_pool.setMaxThreadCount(1);
+}
+
+SpriteSheetTileItem::~SpriteSheetTileItem()
+{
+	m_pool.clear();
+	m_pool.waitForDone();
+}
+
+void SpriteSheetTileItem::setImage(const QImage& image)
+{
+	++m_generation;
+	m_pool.clear();
+
+	prepareGeometryChange();
+	m_levels.clear();
+	m_bounds = QRectF(QPointF(0, 0), QSizeF(image.size()));
+
+	if (image.isNull())
+	{
+		update();
+		return;
+	}
+
+	// Ԥ˸ʽ RGB32 ʱҪת༭ʱָʽﲻأ
+	const bool native = image.format() == QImage::Format_ARGB32_Premultiplied || image.format() == QImage::Format_RGB32;
+	m_levels.append(native ? image : image.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+
+	// СһֿΪֹ
+	int levelCount = 1;
+	for (int size = qMax(image.width(), image.height()); size > TILE_SIZE; size /= 2)
+		++levelCount;
+	m_levels.resize(levelCount);
+
+	const quint64 generation = m_generation;
+	const QImage source = m_levels.first();
+	m_pool.start([this, generation, source, levelCount]() {
+		QImage current = source;
+		for (int level = 1; level < levelCount; ++level)
+		{
+			current = current.scaled(qMax(1, current.width() / 2), qMax(1, current.height() / 2),
+				Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+			QMetaObject::invokeMethod(this, [this, generation, level, current]() {
+				onLevelBuilt(generation, level, current);
+				}, Qt::QueuedConnection);
+		}
+		});
+
+	update();
+}
+
+void SpriteSheetTileItem::onLevelBuilt(quint64 generation, int level, const QImage& image)
+{
+	if (generation != m_generation || level >= m_levels.size())
+		return;
+
+	m_levels[level] = image;
+
+	// ֮ǰøϸĲ㼶棬ػһ
+	update();
+}
+
+int SpriteSheetTileItem::levelForScale(qreal scale) const
+{
+	if (m_levels.isEmpty() || scale >= 1.0 || scale <= 0.0)
+		return 0;
+
+	int level = qMin(qFloor(std::log2(1.0 / scale)), static_cast<int>(m_levels.size()) - 1);
+	while (level > 0 && m_levels[level].isNull())
+		--level;
+	return level;
+}
+
+void SpriteSheetTileItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	Q_UNUSED(widget);
+
+	if (m_levels.isEmpty())
+		return;
+
+	const QRectF exposed = option->exposedRect.intersected(m_bounds);
+	if (exposed.isEmpty())
+		return;
+
+	const qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+	const QImage& image = m_levels[levelForScale(scale)];
+
+	// 㼶 -> ꣨ߴȡʵʱ㣩
+	const qreal sx = m_bounds.width() / image.width();
+	const qreal sy = m_bounds.height() / image.height();
+
+	const int firstX = qMax(0, qFloor(exposed.left() / sx / TILE_SIZE));
+	const int lastX = qFloor(qMin(exposed.right() / sx, image.width() - 1.0) / TILE_SIZE);
+	const int firstY = qMax(0, qFloor(exposed.top() / sy / TILE_SIZE));
+	const int lastY = qFloor(qMin(exposed.bottom() / sy, image.height() - 1.0) / TILE_SIZE);
+
+	painter->save();
+	// ŴʱСʱƽ
+	painter->setRenderHint(QPainter::SmoothPixmapTransform, scale < 1.0);
+	for (int ty = firstY; ty <= lastY; ++ty)
+	{
+		for (int tx = firstX; tx <= lastX; ++tx)
+		{
+			const QRect source = QRect(tx * TILE_SIZE, ty * TILE_SIZE, TILE_SIZE, TILE_SIZE).intersected(image.rect());
+			const QRectF target(source.x() * sx, source.y() * sy, source.width() * sx, source.height() * sy);
+			painter->drawImage(target, image, source);
+		}
+	}
+	painter->restore();
+}
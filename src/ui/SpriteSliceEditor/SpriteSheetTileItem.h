@@ -0,0 +1,45 @@
+#ifndef SPRITESHEETTILEITEM_H
+#define SPRITESHEETTILEITEM_H
+
+#include <QGraphicsObject>
+#include <QImage>
+#include <QThreadPool>
+#include <QVector>
+
+// ͼʾͼԪ QGraphicsPixmapItem
+// - ԭͼϴΪ QPixmap TILE_SIZE ֿ飬ֻػཻķֿ
+// - Сʱʹ mip 㼶ÿΪһ 1/2̳߳ں̨
+// - Ŀ㼶δʱ˻صϸѾ㼶
+class SpriteSheetTileItem : public QGraphicsObject
+{
+public:
+	enum { Type = UserType + 20 };
+
+	static constexpr int TILE_SIZE = 512;
+
+	explicit SpriteSheetTileItem(QGraphicsItem* parent = nullptr);
+	~SpriteSheetTileItem();
+
+	int type() const override { return Type; }
+
+	// ԭͼʼ mip 㼶֮ǰδɵĲ㼶ϣ
+	void setImage(const QImage& image);
+	const QImage& image() const { return m_levels.isEmpty() ? m_empty : m_levels.first(); }
+
+	QRectF boundingRect() const override { return m_bounds; }
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	// űѡ㼶δʱȡϸĲ㼶
+	int levelForScale(qreal scale) const;
+	void onLevelBuilt(quint64 generation, int level, const QImage& image);
+
+private:
+	QVector<QImage> m_levels;       // 0 Ϊԭͼk Ϊ 1/2^k СͼδɵΪ
+	QImage m_empty;
+	QRectF m_bounds;
+	quint64 m_generation = 0;       // ÿ setImage ĽֱӶ
+	QThreadPool m_pool;
+};
+
+#endif // SPRITESHEETTILEITEM_H
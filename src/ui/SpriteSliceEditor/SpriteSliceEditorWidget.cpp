@@ -1,19 +1,113 @@
 #include "SpriteSliceEditorWidget.h"
 #include "ui_SpriteSliceEditorWidget.h"
+#include "SliceTableModel.h"
+#include "SpriteSheetTileItem.h"
+#include "SpriteSheetGridItem.h"
 #include "ui/Common.h"
 #include "core/SpriteSliceDefine.h"
+#include "core/SpriteSheetAnalyzer.h"
+#include "core/TileRegion.h"
 
 #include <QMouseEvent>
 #include <QFileDialog>
-#include <QGraphicsLineItem>
 #include <QMessageBox>
+#include <QInputDialog>
+#include <QGuiApplication>
 #include <QActionGroup>
+#include <QElapsedTimer>
+#include <QApplication>
+#include <QPainter>
+#include <QStyledItemDelegate>
 #include <algorithm>
 
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 
+namespace
+{
+	// ԤУڵԪолԭߴͼĬίлͼС
+	class SliceThumbnailDelegate : public QStyledItemDelegate
+	{
+	public:
+		using QStyledItemDelegate::QStyledItemDelegate;
+
+		void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+		{
+			QStyleOptionViewItem opt(option);
+			initStyleOption(&opt, index);
+			opt.icon = QIcon();
+			opt.features &= ~QStyleOptionViewItem::HasDecoration;
+
+			const QWidget* widget = option.widget;
+			QStyle* style = widget ? widget->style() : QApplication::style();
+			style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+			const QPixmap thumb = index.data(Qt::DecorationRole).value<QPixmap>();
+			if (thumb.isNull())
+				return;
+
+			QRect target(QPoint(0, 0), thumb.size());
+			target.moveCenter(option.rect.center());
+			painter->drawPixmap(target, thumb);
+		}
+
+		QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override
+		{
+			// ȡԤͼΪɼͼ
+			Q_UNUSED(option);
+			Q_UNUSED(index);
+			return QSize(SliceTableModel::ThumbnailSize + 8, SliceTableModel::ThumbnailSize + 4);
+		}
+	};
+
+	//  TileTransformBits 任ԭʼڵĵ㣨ԸϽǣsize Ϊ任ǰĸӳߴ磩
+	QPointF transformCellPoint(quint8 bits, const QPointF& point, const QSizeF& size)
+	{
+		const TileTransformBits::Matrix m = TileTransformBits::matrix(bits);
+		const QPointF p = point - QPointF(size.width() / 2.0, size.height() / 2.0);
+		const QPointF mapped(p.x() * m.m11 + p.y() * m.m21, p.x() * m.m12 + p.y() * m.m22);
+		const QSizeF target = (m.m12 != 0) ? size.transposed() : size;
+		return mapped + QPointF(target.width() / 2.0, target.height() / 2.0);
+	}
+
+	// duplicate ص canonical  bits 任Ľʱײáԭʼӡ
+	// üêҲҪͬһ任һ²ܺϲϲᶪЩϢ
+	bool isSameSliceAfterTransform(const SpriteSlice& canonical, const SpriteSlice& duplicate, quint8 bits)
+	{
+		if (canonical.isCollision != duplicate.isCollision || canonical.isDecorationOnly != duplicate.isDecorationOnly
+			|| canonical.collisionType != duplicate.collisionType)
+			return false;
+
+		const QSizeF cell(canonical.sourceWidth(), canonical.sourceHeight());
+		const QSizeF target(duplicate.sourceWidth(), duplicate.sourceHeight());
+		const QSizeF mappedCell = (TileTransformBits::matrix(bits).m12 != 0) ? cell.transposed() : cell;
+		if (mappedCell != target)
+			return false;
+
+		const QRectF trim(QPointF(canonical.trimOffset), QSizeF(canonical.width, canonical.height));
+		const QRectF mappedTrim = QRectF(transformCellPoint(bits, trim.topLeft(), cell),
+			transformCellPoint(bits, trim.bottomRight(), cell)).normalized();
+		if (mappedTrim != QRectF(QPointF(duplicate.trimOffset), QSizeF(duplicate.width, duplicate.height)))
+			return false;
+
+		const QPointF anchor = transformCellPoint(bits,
+			QPointF(canonical.anchor.x() * cell.width(), canonical.anchor.y() * cell.height()), cell);
+		return qAbs(anchor.x() / target.width() - duplicate.anchor.x()) < 1e-6
+			&& qAbs(anchor.y() / target.height() - duplicate.anchor.y()) < 1e-6;
+	}
+
+	// ͼֻһΣ͸ͨתΪԤ˸ʽΪ RGB32
+	// ʾͼԪƬͼֱʹָʽٸת
+	QImage loadSheetImage(const QString& filePath)
+	{
+		const QImage image(filePath);
+		if (image.isNull())
+			return image;
+		return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+	}
+}
+
 SpriteSliceEditorWidget::SpriteSliceEditorWidget(QWidget* parent)
 	: QWidget(parent)
 	, ui(new Ui::SpriteSliceEditorWidget)
@@ -51,11 +145,13 @@ SpriteSliceEditorWidget::SpriteSliceEditorWidget(QWidget* parent)
 
 	qDebug() << "The Object Name: [ " << objectName() << " ]\n";
 
-	// slice пӦ
-	ui->sliceTableWidget->horizontalHeader()->setStretchLastSection(true);
-	ui->sliceTableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-	ui->sliceTableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
-	ui->sliceTableWidget->setSelectionMode(QAbstractItemView::SingleSelection);
+	// slice ̶иߡֶпݼߴΪÿһԤͼ
+	ui->sliceTableView->horizontalHeader()->setStretchLastSection(true);
+	ui->sliceTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+	ui->sliceTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+	ui->sliceTableView->verticalHeader()->setDefaultSectionSize(SliceTableModel::ThumbnailSize + 4);
+	ui->sliceTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+	ui->sliceTableView->setSelectionMode(QAbstractItemView::SingleSelection);
 
 	// ԤһЩ Group ѡ
 	ui->groupComboBox->addItem(QStringLiteral("Tiles"));
@@ -139,20 +235,29 @@ void SpriteSliceEditorWidget::setupConnections()
 
 	// ʾ/
 	connect(ui->actionToggleGrid, &QAction::toggled, this, [this](bool checked) {
-		for (auto* item : m_gridLines) {
-			item->setVisible(checked);
-		}
+		if (m_gridItem)
+			m_gridItem->setVisible(checked);
 		});
 
+	// Զʶ
+	connect(ui->detectGridButton, &QPushButton::clicked, this, &SpriteSliceEditorWidget::onDetectGridClicked);
+
 	// /Ƭ
 	connect(ui->generateGridSlicesButton, &QPushButton::clicked, this, &SpriteSliceEditorWidget::onGenerateGridSlicesClicked);
 	connect(ui->clearGridSlicesButton, &QPushButton::clicked, this, &SpriteSliceEditorWidget::onClearGridSlicesClicked);
 
+	// ͸ԶƬ
+	connect(ui->autoSliceButton, &QPushButton::clicked, this, &SpriteSliceEditorWidget::onAutoSliceClicked);
+
+	// ϲظƬ
+	connect(ui->actionDedupeSlices, &QAction::triggered, this, &SpriteSliceEditorWidget::onDedupeSlicesClicked);
+	connect(ui->actionTrimSlices, &QAction::triggered, this, &SpriteSliceEditorWidget::onTrimSlicesClicked);
+
 	// ͼ
 	connect(ui->actionOpenSheet, &QAction::triggered, this, &SpriteSliceEditorWidget::onAddSheetClicked);
 
 	// ѡ仯  ˢҲ
-	connect(ui->sliceTableWidget, &QTableWidget::itemSelectionChanged, this, &SpriteSliceEditorWidget::onSliceSelectionChanged);
+	connect(ui->sliceTableView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &SpriteSliceEditorWidget::onSliceSelectionChanged);
 
 	// Ҳ尴ť
 	connect(ui->applySliceButton, &QPushButton::clicked, this, &SpriteSliceEditorWidget::onApplySliceClicked);
@@ -224,6 +329,13 @@ void SpriteSliceEditorWidget::onOkButtonClicked()
 	// ź
 	emit SignalSpriteSheetConfirmed(data);
 
+	// ϲظƬʱ֪ͨͼøĵƬ
+	if (!m_sliceRemaps.isEmpty())
+	{
+		emit SignalSlicesRemapped(data.fileName.isEmpty() ? QStringLiteral("Tileset") : data.fileName, m_sliceRemaps);
+		m_sliceRemaps.clear();
+	}
+
 	QMessageBox::information(this, QStringLiteral("ɹ"),
 		QStringLiteral("ѵ %1 Ƭ").arg(data.sliceCount()));
 }
@@ -235,9 +347,9 @@ SpriteSheetData SpriteSliceEditorWidget::getSpriteSheetData() const
 	// 侫ͼϢ
 	data.filePath = m_currentFilePath;
 	data.fileName = QFileInfo(m_currentFilePath).fileName();
-	data.pixmap = m_currentPixmap;
-	data.imageWidth = m_currentPixmap.width();
-	data.imageHeight = m_currentPixmap.height();
+	data.pixmap = QPixmap::fromImage(m_currentImage);
+	data.imageWidth = m_currentImage.width();
+	data.imageHeight = m_currentImage.height();
 
 	// ӱȡƬݣȷµģ
 	data.slices = getAllSlicesFromTable();
@@ -283,18 +395,8 @@ void SpriteSliceEditorWidget::onGraphicsViewClicked(const QPointF& scenePos)
 
 int SpriteSliceEditorWidget::findSliceAtPoint(const QPointF& point) const
 {
-	for (int i = m_slices.size() - 1; i >= 0; --i)
-	{
-		const SpriteSlice& slice = m_slices[i];
-		QRectF sliceRect(slice.x, slice.y, slice.width, slice.height);
-
-		if (sliceRect.contains(point))
-		{
-			return i;
-		}
-	}
-
-	return -1;
+	// صʱȡӵƬ
+	return m_sliceModel->spatialIndex().indexAt(point);
 }
 
 void SpriteSliceEditorWidget::selectSlice(int sliceIndex)
@@ -309,11 +411,8 @@ void SpriteSliceEditorWidget::selectSlice(int sliceIndex)
 
 	m_currentSliceIndex = sliceIndex;
 
-	ui->sliceTableWidget->blockSignals(true);
-	ui->sliceTableWidget->selectRow(sliceIndex);
-	ui->sliceTableWidget->blockSignals(false);
-
-	ui->sliceTableWidget->scrollTo(ui->sliceTableWidget->model()->index(sliceIndex, 0));
+	ui->sliceTableView->selectRow(sliceIndex);
+	ui->sliceTableView->scrollTo(m_sliceModel->index(sliceIndex, 0));
 
 	loadSliceToInspector(sliceIndex);
 	setInspectorEnabled(true);
@@ -342,6 +441,13 @@ void SpriteSliceEditorWidget::onManualSelectionFinished(const QRectF& rect)
 		return;
 	}
 
+	// ס Alt ѡɶƬ
+	if (QGuiApplication::keyboardModifiers() & Qt::AltModifier)
+	{
+		createAnimation(selectedIndices);
+		return;
+	}
+
 	mergeSlices(selectedIndices);
 }
 
@@ -349,18 +455,15 @@ QVector<int> SpriteSliceEditorWidget::findSlicesInRect(const QRectF& rect) const
 {
 	QVector<int> result;
 
-	for (int i = 0; i < m_slices.size(); ++i)
+	// ռֻཻƬٰĵǷڿɸѡ
+	for (int i : m_sliceModel->spatialIndex().indicesIntersecting(rect))
 	{
 		const SpriteSlice& slice = m_slices[i];
 		QRectF sliceRect(slice.x, slice.y, slice.width, slice.height);
 
-		if (rect.intersects(sliceRect))
+		if (rect.contains(sliceRect.center()))
 		{
-			QPointF center = sliceRect.center();
-			if (rect.contains(center))
-			{
-				result.append(i);
-			}
+			result.append(i);
 		}
 	}
 
@@ -397,26 +500,70 @@ void SpriteSliceEditorWidget::mergeSlices(const QVector<int>& sliceIndices)
 	mergedSlice.isDecorationOnly = false;
 	mergedSlice.anchor = QPointF(0.5, 0.5);
 
-	QVector<int> sortedIndices = sliceIndices;
-	std::sort(sortedIndices.begin(), sortedIndices.end(), std::greater<int>());
+	m_sliceModel->removeSlices(sliceIndices);
+	m_sliceModel->appendSlice(mergedSlice);
+
+	int newIndex = m_slices.size() - 1;
+	ui->sliceTableView->selectRow(newIndex);
+	m_currentSliceIndex = newIndex;
+	loadSliceToInspector(newIndex);
+	setInspectorEnabled(true);
+	updateSelectionHighlight(newIndex);
+
+	qDebug() << "Merged" << sliceIndices.size() << "slices into:" << mergedSlice.name;
+}
+
+void SpriteSliceEditorWidget::createAnimation(const QVector<int>& sliceIndices)
+{
+	if (sliceIndices.size() < 2)
+		return;
+
+	// ֡˳򣺴ϵ¡
+	QVector<int> ordered = sliceIndices;
+	std::sort(ordered.begin(), ordered.end(), [this](int a, int b) {
+		if (m_slices[a].y != m_slices[b].y)
+			return m_slices[a].y < m_slices[b].y;
+		return m_slices[a].x < m_slices[b].x;
+		});
 
-	for (int idx : sortedIndices)
+	const SpriteSlice first = m_slices[ordered.first()];
+	for (int idx : ordered)
 	{
-		m_slices.removeAt(idx);
+		if (m_slices[idx].width != first.width || m_slices[idx].height != first.height)
+		{
+			QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("֡ĳߴһ"));
+			return;
+		}
 	}
 
-	m_slices.append(mergedSlice);
+	bool ok = false;
+	const int duration = QInputDialog::getInt(this, QStringLiteral(""), QStringLiteral("ÿ֡ʱ룩:"),
+		100, 1, 10000, 10, &ok);
+	if (!ok)
+		return;
+
+	// Ƭõһ֡
+	SpriteSlice animSlice = first;
+	animSlice.id = QUuid::createUuid();
+	animSlice.name = QString("%1_anim%2").arg(first.name).arg(ordered.size());
+	animSlice.frames.clear();
+	for (int idx : ordered)
+	{
+		const SpriteSlice& frame = m_slices[idx];
+		animSlice.frames.append(SpriteSliceFrame{ QRect(frame.x, frame.y, frame.width, frame.height), duration });
+	}
 
-	syncTableFromSlices();
+	m_sliceModel->removeSlices(sliceIndices);
+	m_sliceModel->appendSlice(animSlice);
 
 	int newIndex = m_slices.size() - 1;
-	ui->sliceTableWidget->selectRow(newIndex);
+	ui->sliceTableView->selectRow(newIndex);
 	m_currentSliceIndex = newIndex;
 	loadSliceToInspector(newIndex);
 	setInspectorEnabled(true);
 	updateSelectionHighlight(newIndex);
 
-	qDebug() << "Merged" << sliceIndices.size() << "slices into:" << mergedSlice.name;
+	qDebug() << "Created animation:" << animSlice.name << "frames:" << animSlice.frames.size() << "duration:" << duration;
 }
 
 void SpriteSliceEditorWidget::removeSlice(int index)
@@ -424,8 +571,7 @@ void SpriteSliceEditorWidget::removeSlice(int index)
 	if (index < 0 || index >= m_slices.size())
 		return;
 
-	m_slices.removeAt(index);
-	syncTableFromSlices();
+	m_sliceModel->removeSlices({ index });
 
 	if (m_slices.isEmpty())
 	{
@@ -437,7 +583,7 @@ void SpriteSliceEditorWidget::removeSlice(int index)
 	else if (m_currentSliceIndex >= m_slices.size())
 	{
 		m_currentSliceIndex = m_slices.size() - 1;
-		ui->sliceTableWidget->selectRow(m_currentSliceIndex);
+		ui->sliceTableView->selectRow(m_currentSliceIndex);
 	}
 }
 
@@ -481,8 +627,8 @@ void SpriteSliceEditorWidget::onRemoveSheetClicked()
 	{
 		m_scene->clear();
 		m_spriteSheetItem = nullptr;
-		m_gridLines.clear();
-		m_currentPixmap = QPixmap();
+		m_gridItem = nullptr;
+		m_currentImage = QImage();
 		m_currentFilePath.clear();
 
 		m_highlightRect = new QGraphicsRectItem();
@@ -499,8 +645,8 @@ void SpriteSliceEditorWidget::onRemoveSheetClicked()
 		m_anchorMarker->setVisible(false);
 		m_scene->addItem(m_anchorMarker);
 
-		m_slices.clear();
-		ui->sliceTableWidget->setRowCount(0);
+		m_sliceModel->clearSlices();
+		m_sliceModel->setSourceImage(QImage());
 		clearInspector();
 		setInspectorEnabled(false);
 	}
@@ -515,20 +661,20 @@ void SpriteSliceEditorWidget::onSheetSelectionChanged()
 	QString filePath = item->data(Qt::UserRole).toString();
 	if (!filePath.isEmpty() && filePath != m_currentFilePath)
 	{
-		QPixmap pixmap(filePath);
-		if (!pixmap.isNull())
+		const QImage image = loadSheetImage(filePath);
+		if (!image.isNull())
 		{
 			m_currentFilePath = filePath;
-			m_currentPixmap = pixmap;
-			displaySpriteSheet(pixmap);
+			m_currentImage = image;
+			displaySpriteSheet(image);
 		}
 	}
 }
 
 void SpriteSliceEditorWidget::loadSpriteSheet(const QString& filePath)
 {
-	QPixmap pixmap(filePath);
-	if (pixmap.isNull())
+	const QImage image = loadSheetImage(filePath);
+	if (image.isNull())
 	{
 		QMessageBox::warning(this, QStringLiteral(""), QStringLiteral("޷ͼƬ: %1").arg(filePath));
 		return;
@@ -542,11 +688,11 @@ void SpriteSliceEditorWidget::loadSpriteSheet(const QString& filePath)
 	ui->spriteSheetListWidget->setCurrentItem(listItem);
 
 	m_currentFilePath = filePath;
-	m_currentPixmap = pixmap;
-	displaySpriteSheet(pixmap);
+	m_currentImage = image;
+	displaySpriteSheet(image);
 }
 
-void SpriteSliceEditorWidget::displaySpriteSheet(const QPixmap& pixmap)
+void SpriteSliceEditorWidget::displaySpriteSheet(const QImage& image)
 {
 	auto* tempHighlight = m_highlightRect;
 	auto* tempAnchor = m_anchorMarker;
@@ -555,8 +701,10 @@ void SpriteSliceEditorWidget::displaySpriteSheet(const QPixmap& pixmap)
 	if (tempAnchor) m_scene->removeItem(tempAnchor);
 
 	m_scene->clear();
-	m_gridLines.clear();
 	m_spriteSheetItem = nullptr;
+	m_gridItem = nullptr;
+	m_sliceRemaps.clear();
+	m_sliceModel->setSourceImage(image, m_currentFilePath);
 
 	if (tempHighlight) {
 		m_scene->addItem(tempHighlight);
@@ -567,9 +715,16 @@ void SpriteSliceEditorWidget::displaySpriteSheet(const QPixmap& pixmap)
 		m_anchorMarker = tempAnchor;
 	}
 
-	m_spriteSheetItem = m_scene->addPixmap(pixmap);
+	// ͼϴΪһͼԪֿƲں̨С㼶
+	m_spriteSheetItem = new SpriteSheetTileItem();
+	m_spriteSheetItem->setImage(image);
 	m_spriteSheetItem->setPos(0, 0);
 	m_spriteSheetItem->setZValue(0);
+	m_scene->addItem(m_spriteSheetItem);
+
+	m_gridItem = new SpriteSheetGridItem();
+	m_gridItem->setImageSize(pixmap.size());
+	m_scene->addItem(m_gridItem);
 
 	m_scene->setSceneRect(pixmap.rect());
 	updateGridOverlay();
@@ -590,62 +745,65 @@ void SpriteSliceEditorWidget::onGridSettingsChanged()
 	updateGridOverlay();
 }
 
-void SpriteSliceEditorWidget::updateGridOverlay()
+void SpriteSliceEditorWidget::onDetectGridClicked()
 {
-	clearGridOverlay();
-
-	if (m_currentPixmap.isNull() || !ui->actionToggleGrid->isChecked())
+	if (m_currentImage.isNull())
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ȼؾͼ"));
 		return;
+	}
 
-	int tileWidth = ui->tileWidthSpinBox->value();
-	int tileHeight = ui->tileHeightSpinBox->value();
-	int marginX = ui->marginXSpinBox->value();
-	int marginY = ui->marginYSpinBox->value();
-	int spacingX = ui->spacingXSpinBox->value();
-	int spacingY = ui->spacingYSpinBox->value();
+	QElapsedTimer timer;
+	timer.start();
 
-	int imgWidth = m_currentPixmap.width();
-	int imgHeight = m_currentPixmap.height();
+	const SpriteGridParams params = SpriteSheetAnalyzer::detectGrid(m_currentImage);
 
-	QPen gridPen(QColor(255, 100, 100, 180), 1, Qt::SolidLine);
+	qDebug() << "Grid detection took" << timer.elapsed() << "ms, tile:" << params.tileWidth << "x" << params.tileHeight
+		<< "margin:" << params.marginX << params.marginY << "spacing:" << params.spacingX << params.spacingY;
 
-	for (int x = marginX; x <= imgWidth; x += tileWidth + spacingX)
+	if (!params.isValid())
 	{
-		auto* line = m_scene->addLine(x, 0, x, imgHeight, gridPen);
-		line->setZValue(10);
-		m_gridLines.append(line);
-
-		if (spacingX > 0 && x + tileWidth <= imgWidth)
-		{
-			auto* spaceLine = m_scene->addLine(x + tileWidth, 0, x + tileWidth, imgHeight, QPen(QColor(100, 100, 255, 120), 1, Qt::DashLine));
-			spaceLine->setZValue(10);
-			m_gridLines.append(spaceLine);
-		}
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("δʶֶ"));
+		return;
 	}
 
-	for (int y = marginY; y <= imgHeight; y += tileHeight + spacingY)
-	{
-		auto* line = m_scene->addLine(0, y, imgWidth, y, gridPen);
-		line->setZValue(10);
-		m_gridLines.append(line);
+	// һдвֻˢһ
+	const QList<QSpinBox*> spinBoxes = {
+		ui->tileWidthSpinBox, ui->tileHeightSpinBox,
+		ui->marginXSpinBox, ui->marginYSpinBox,
+		ui->spacingXSpinBox, ui->spacingYSpinBox
+	};
+	for (QSpinBox* spinBox : spinBoxes)
+		spinBox->blockSignals(true);
 
-		if (spacingY > 0 && y + tileHeight <= imgHeight)
-		{
-			auto* spaceLine = m_scene->addLine(0, y + tileHeight, imgWidth, y + tileHeight, QPen(QColor(100, 100, 255, 120), 1, Qt::DashLine));
-			spaceLine->setZValue(10);
-			m_gridLines.append(spaceLine);
-		}
-	}
+	ui->tileWidthSpinBox->setValue(params.tileWidth);
+	ui->tileHeightSpinBox->setValue(params.tileHeight);
+	ui->marginXSpinBox->setValue(params.marginX);
+	ui->marginYSpinBox->setValue(params.marginY);
+	ui->spacingXSpinBox->setValue(params.spacingX);
+	ui->spacingYSpinBox->setValue(params.spacingY);
+
+	for (QSpinBox* spinBox : spinBoxes)
+		spinBox->blockSignals(false);
+
+	updateGridOverlay();
 }
 
-void SpriteSliceEditorWidget::clearGridOverlay()
+void SpriteSliceEditorWidget::updateGridOverlay()
 {
-	for (auto* item : m_gridLines)
-	{
-		m_scene->removeItem(item);
-		delete item;
-	}
-	m_gridLines.clear();
+	if (!m_gridItem)
+		return;
+
+	SpriteGridParams params;
+	params.tileWidth = ui->tileWidthSpinBox->value();
+	params.tileHeight = ui->tileHeightSpinBox->value();
+	params.marginX = ui->marginXSpinBox->value();
+	params.marginY = ui->marginYSpinBox->value();
+	params.spacingX = ui->spacingXSpinBox->value();
+	params.spacingY = ui->spacingYSpinBox->value();
+
+	m_gridItem->setGrid(params);
+	m_gridItem->setVisible(!m_currentImage.isNull() && ui->actionToggleGrid->isChecked());
 }
 
 void SpriteSliceEditorWidget::onZoomSliderChanged(int value)
@@ -660,7 +818,7 @@ void SpriteSliceEditorWidget::onZoomSliderChanged(int value)
 
 void SpriteSliceEditorWidget::onGenerateGridSlicesClicked()
 {
-	if (m_currentPixmap.isNull())
+	if (m_currentImage.isNull())
 	{
 		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ȼؾͼ"));
 		return;
@@ -677,8 +835,8 @@ void SpriteSliceEditorWidget::onGenerateGridSlicesClicked()
 	int rowCount = ui->rowCountSpinBox->value();
 	int colCount = ui->columnCountSpinBox->value();
 
-	int imgWidth = m_currentPixmap.width();
-	int imgHeight = m_currentPixmap.height();
+	int imgWidth = m_currentImage.width();
+	int imgHeight = m_currentImage.height();
 
 	int maxCols = (imgWidth - marginX + spacingX) / (tileWidth + spacingX);
 	int maxRows = (imgHeight - marginY + spacingY) / (tileHeight + spacingY);
@@ -686,12 +844,12 @@ void SpriteSliceEditorWidget::onGenerateGridSlicesClicked()
 	if (colCount == 0) colCount = maxCols - startCol;
 	if (rowCount == 0) rowCount = maxRows - startRow;
 
-	m_slices.clear();
-	ui->sliceTableWidget->setRowCount(0);
 	clearInspector();
 	setInspectorEnabled(false);
 	m_currentSliceIndex = -1;
 
+	// ռƬһ滻
+	QVector<SpriteSlice> slices;
 	for (int row = startRow; row < startRow + rowCount && row < maxRows; ++row)
 	{
 		for (int col = startCol; col < startCol + colCount && col < maxCols; ++col)
@@ -712,142 +870,267 @@ void SpriteSliceEditorWidget::onGenerateGridSlicesClicked()
 			slice.isDecorationOnly = false;
 			slice.anchor = QPointF(0.5, 0.5);
 
-			addSlice(slice);
+			slices.append(slice);
 		}
 	}
+
+	m_sliceModel->resetSlices(std::move(slices));
 }
 
-void SpriteSliceEditorWidget::onClearGridSlicesClicked()
+void SpriteSliceEditorWidget::onAutoSliceClicked()
 {
-	m_slices.clear();
-	ui->sliceTableWidget->setRowCount(0);
+	if (m_currentImage.isNull())
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ȼؾͼ"));
+		return;
+	}
+
+	if (!m_currentImage.hasAlphaChannel())
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ͼû͸ͨ޷͸Ƭ"));
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	const QVector<QRect> regions = SpriteSheetAnalyzer::findOpaqueRegions(m_currentImage,
+		ui->alphaThresholdSpinBox->value(), ui->mergeDistanceSpinBox->value());
+
+	qDebug() << "Auto slice found" << regions.size() << "regions in" << timer.elapsed() << "ms";
+
+	if (regions.isEmpty())
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ûҵ͸"));
+		return;
+	}
+
 	clearInspector();
 	setInspectorEnabled(false);
 	clearSelectionHighlight();
 	m_currentSliceIndex = -1;
-}
-
-// ============== Ƭݹ ==============
 
-void SpriteSliceEditorWidget::addSlice(const SpriteSlice& slice)
-{
-	m_slices.append(slice);
+	// ռƬһ滻
+	QVector<SpriteSlice> slices;
+	slices.reserve(regions.size());
+	for (int i = 0; i < regions.size(); ++i)
+	{
+		const QRect& region = regions[i];
 
-	int tableRow = ui->sliceTableWidget->rowCount();
-	ui->sliceTableWidget->insertRow(tableRow);
+		SpriteSlice slice;
+		slice.id = QUuid::createUuid();
+		slice.name = QString("slice_%1").arg(i);
+		slice.x = region.x();
+		slice.y = region.y();
+		slice.width = region.width();
+		slice.height = region.height();
+		slice.group = "Props";
+		slice.anchor = QPointF(0.5, 0.5);
+
+		slices.append(slice);
+	}
 
-	updateSliceInTable(tableRow, slice);
+	m_sliceModel->resetSlices(std::move(slices));
 }
 
-void SpriteSliceEditorWidget::updateSliceInTable(int row, const SpriteSlice& slice)
+void SpriteSliceEditorWidget::onDedupeSlicesClicked()
 {
-	if (row < 0 || row >= ui->sliceTableWidget->rowCount())
+	if (m_currentImage.isNull() || m_slices.isEmpty())
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ȼؾͼƬ"));
 		return;
+	}
 
-	QPixmap slicePixmap = m_currentPixmap.copy(slice.x, slice.y, slice.width, slice.height);
-	QPixmap thumbnail = slicePixmap.scaled(48, 48, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	// Ƭ֡ͬȽ
+	QVector<QRect> rects;
+	QVector<int> sliceOfRect;
+	for (int i = 0; i < m_slices.size(); ++i)
+	{
+		const SpriteSlice& slice = m_slices[i];
+		if (slice.isAnimated())
+			continue;
+		rects.append(QRect(slice.x, slice.y, slice.width, slice.height));
+		sliceOfRect.append(i);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	const QVector<SliceDuplicate> matches = SpriteSheetAnalyzer::findDuplicates(m_currentImage, rects);
+
+	// ͬײêüϢͬƬϲ
+	QVector<SliceDuplicate> duplicates;
+	QVector<SliceDuplicate> conflicts;
+	duplicates.reserve(matches.size());
+	for (const SliceDuplicate& match : matches)
+	{
+		if (isSameSliceAfterTransform(m_slices[sliceOfRect[match.canonical]], m_slices[sliceOfRect[match.index]], match.transform))
+			duplicates.append(match);
+		else
+			conflicts.append(match);
+	}
+	const int conflicting = conflicts.size();
 
-	auto* previewLabel = qobject_cast<QLabel*>(ui->sliceTableWidget->cellWidget(row, SliceTableColumn::Preview));
-	if (!previewLabel) {
-		previewLabel = new QLabel;
-		previewLabel->setAlignment(Qt::AlignCenter);
-		ui->sliceTableWidget->setCellWidget(row, SliceTableColumn::Preview, previewLabel);
+	qDebug() << "Duplicate detection found" << duplicates.size() << "of" << rects.size() << "slices in" << timer.elapsed() << "ms"
+		<< "metadata conflicts:" << conflicting;
+
+	if (duplicates.isEmpty())
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), conflicting > 0
+			? QStringLiteral(" %1 ƬͬײêüϢͬδΪظƬ").arg(conflicting)
+			: QStringLiteral("ûظƬ"));
+		return;
 	}
-	previewLabel->setPixmap(thumbnail);
 
-	auto getOrCreateItem = [this, row](int col) -> QTableWidgetItem* {
-		auto* item = ui->sliceTableWidget->item(row, col);
-		if (!item) {
-			item = new QTableWidgetItem();
-			ui->sliceTableWidget->setItem(row, col, item);
+	const int transformed = static_cast<int>(std::count_if(duplicates.begin(), duplicates.end(),
+		[](const SliceDuplicate& duplicate) { return duplicate.transform != 0; }));
+
+	QMessageBox box(this);
+	box.setWindowTitle(QStringLiteral("ϲظƬ"));
+	QString text = QStringLiteral("ҵ %1 ظƬ %2 Ϊת/תͬ\nϲ󣬵ͼʹǵƬñƬ")
+		.arg(duplicates.size()).arg(transformed);
+	if (conflicting > 0)
+		text += QStringLiteral("\n %1 ƬͬײêüϢͬϲ").arg(conflicting);
+	box.setText(text);
+	QPushButton* mergeButton = box.addButton(QStringLiteral("ϲ"), QMessageBox::AcceptRole);
+	QPushButton* markButton = box.addButton(QStringLiteral(""), QMessageBox::ActionRole);
+	box.addButton(QMessageBox::Cancel);
+	box.exec();
+
+	if (box.clickedButton() == markButton)
+	{
+		// ڱбظƬ
+		for (const SliceDuplicate& duplicate : duplicates)
+		{
+			m_sliceModel->setRowMark(sliceOfRect[duplicate.index],
+				QStringLiteral(" %1 ͬ").arg(m_slices[sliceOfRect[duplicate.canonical]].name));
 		}
-		return item;
-	};
+		for (const SliceDuplicate& conflict : conflicts)
+		{
+			m_sliceModel->setRowMark(sliceOfRect[conflict.index],
+				QStringLiteral(" %1 ͬԲͬ").arg(m_slices[sliceOfRect[conflict.canonical]].name));
+		}
+		return;
+	}
 
-	int textureY = slice.textureY(m_currentPixmap.height());
-
-	auto* nameItem = getOrCreateItem(SliceTableColumn::Name);
-	nameItem->setText(slice.name);
-	nameItem->setData(SliceTableRole::SliceId, slice.id);
-	nameItem->setData(SliceTableRole::Name, slice.name);
-	nameItem->setData(SliceTableRole::PosX, slice.x);
-	nameItem->setData(SliceTableRole::PosY, textureY);
-	nameItem->setData(SliceTableRole::Width, slice.width);
-	nameItem->setData(SliceTableRole::Height, slice.height);
-	nameItem->setData(SliceTableRole::Group, slice.group);
-	nameItem->setData(SliceTableRole::Tags, slice.tags);
-	nameItem->setData(SliceTableRole::IsCollision, slice.isCollision);
-	nameItem->setData(SliceTableRole::IsDecorationOnly, slice.isDecorationOnly);
-	nameItem->setData(SliceTableRole::AnchorX, slice.anchor.x());
-	nameItem->setData(SliceTableRole::AnchorY, slice.anchor.y());
-	nameItem->setData(SliceTableRole::ImageHeight, m_currentPixmap.height());
-	nameItem->setFlags(nameItem->flags() & ~Qt::ItemIsEditable);
-
-	auto setDisplayItem = [&getOrCreateItem](int col, const QString& text, bool center = false) {
-		auto* item = getOrCreateItem(col);
-		item->setText(text);
-		if (center) item->setTextAlignment(Qt::AlignCenter);
-		item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-	};
+	if (box.clickedButton() != mergeButton)
+		return;
 
-	setDisplayItem(SliceTableColumn::X, QString::number(slice.x), true);
-	setDisplayItem(SliceTableColumn::Y, QString::number(slice.y), true);
-	setDisplayItem(SliceTableColumn::Width, QString::number(slice.width), true);
-	setDisplayItem(SliceTableColumn::Height, QString::number(slice.height), true);
-	setDisplayItem(SliceTableColumn::Group, slice.group);
-	setDisplayItem(SliceTableColumn::Tags, slice.tags);
-}
+	QVector<int> removedRows;
+	removedRows.reserve(duplicates.size());
+	for (const SliceDuplicate& duplicate : duplicates)
+	{
+		const QUuid fromId = m_slices[sliceOfRect[duplicate.index]].id;
+		const QUuid toId = m_slices[sliceOfRect[duplicate.canonical]].id;
 
-SpriteSlice SpriteSliceEditorWidget::getSliceFromTable(int row) const
-{
-	SpriteSlice slice;
-
-	if (row < 0 || row >= ui->sliceTableWidget->rowCount())
-		return slice;
-
-	auto* nameItem = ui->sliceTableWidget->item(row, SliceTableColumn::Name);
-	if (!nameItem)
-		return slice;
-
-	slice.id = nameItem->data(SliceTableRole::SliceId).toUuid();
-	slice.name = nameItem->data(SliceTableRole::Name).toString();
-	slice.x = nameItem->data(SliceTableRole::PosX).toInt();
-	slice.y = nameItem->data(SliceTableRole::PosY).toInt();
-	slice.width = nameItem->data(SliceTableRole::Width).toInt();
-	slice.height = nameItem->data(SliceTableRole::Height).toInt();
-	slice.group = nameItem->data(SliceTableRole::Group).toString();
-	slice.tags = nameItem->data(SliceTableRole::Tags).toString();
-	slice.isCollision = nameItem->data(SliceTableRole::IsCollision).toBool();
-	slice.isDecorationOnly = nameItem->data(SliceTableRole::IsDecorationOnly).toBool();
-	slice.anchor = QPointF(
-		nameItem->data(SliceTableRole::AnchorX).toDouble(),
-		nameItem->data(SliceTableRole::AnchorY).toDouble()
-	);
+		// ֮ǰϲƬض򣬸ΪָƬ
+		for (SliceRemap& remap : m_sliceRemaps)
+		{
+			if (remap.toId == fromId)
+			{
+				remap.toId = toId;
+				remap.transform = TileTransformBits::compose(duplicate.transform, remap.transform);
+			}
+		}
+
+		m_sliceRemaps.append({ fromId, toId, duplicate.transform });
+		removedRows.append(sliceOfRect[duplicate.index]);
+	}
+
+	m_sliceModel->removeSlices(removedRows);
+	clearInspector();
+	setInspectorEnabled(false);
+	clearSelectionHighlight();
+	m_currentSliceIndex = -1;
 
-	return slice;
+	QMessageBox::information(this, QStringLiteral("ɹ"),
+		QStringLiteral("Ѻϲ %1 ظƬ").arg(duplicates.size()));
 }
 
-QVector<SpriteSlice> SpriteSliceEditorWidget::getAllSlicesFromTable() const
+void SpriteSliceEditorWidget::onTrimSlicesClicked()
 {
-	QVector<SpriteSlice> slices;
-	slices.reserve(ui->sliceTableWidget->rowCount());
+	if (m_currentImage.isNull() || m_slices.isEmpty())
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ȼؾͼƬ"));
+		return;
+	}
 
-	for (int i = 0; i < ui->sliceTableWidget->rowCount(); ++i)
+	// Ƭ֡һ򣬲ü
+	QVector<QRect> rects;
+	QVector<int> sliceOfRect;
+	for (int i = 0; i < m_slices.size(); ++i)
 	{
-		slices.append(getSliceFromTable(i));
+		const SpriteSlice& slice = m_slices[i];
+		if (slice.isAnimated())
+			continue;
+		rects.append(QRect(slice.x, slice.y, slice.width, slice.height));
+		sliceOfRect.append(i);
 	}
 
-	return slices;
-}
+	QElapsedTimer timer;
+	timer.start();
 
-void SpriteSliceEditorWidget::syncTableFromSlices()
-{
-	ui->sliceTableWidget->setRowCount(0);
-	for (int i = 0; i < m_slices.size(); ++i)
+	const QVector<QRect> bounds = SpriteSheetAnalyzer::findTightBounds(m_currentImage, rects,
+		ui->alphaThresholdSpinBox->value());
+
+	qDebug() << "Tight bounds computed for" << rects.size() << "slices in" << timer.elapsed() << "ms";
+
+	int trimmed = 0;
+	for (int i = 0; i < bounds.size(); ++i)
+	{
+		// ȫ͸Ƭԭ
+		const QRect& tight = bounds[i];
+		if (tight.isEmpty() || tight == rects[i])
+			continue;
+
+		// ٴβüʱۼƫƣԭʼߴ籣ֵһβüǰĸ
+		SpriteSlice& slice = m_slices[sliceOfRect[i]];
+		if (!slice.isTrimmed())
+			slice.sourceSize = QSize(slice.width, slice.height);
+		slice.trimOffset += tight.topLeft() - QPoint(slice.x, slice.y);
+		slice.x = tight.x();
+		slice.y = tight.y();
+		slice.width = tight.width();
+		slice.height = tight.height();
+		m_sliceModel->updateSlice(sliceOfRect[i]);
+		++trimmed;
+	}
+
+	if (trimmed == 0)
+	{
+		QMessageBox::information(this, QStringLiteral("ʾ"), QStringLiteral("ûпɲü͸"));
+		return;
+	}
+
+	if (m_currentSliceIndex >= 0 && m_currentSliceIndex < m_slices.size())
 	{
-		ui->sliceTableWidget->insertRow(i);
-		updateSliceInTable(i, m_slices[i]);
+		loadSliceToInspector(m_currentSliceIndex);
+		updateSelectionHighlight(m_currentSliceIndex);
 	}
+
+	QMessageBox::information(this, QStringLiteral("ɹ"),
+		QStringLiteral("Ѳü %1 Ƭ͸").arg(trimmed));
+}
+
+void SpriteSliceEditorWidget::onClearGridSlicesClicked()
+{
+	m_sliceModel->clearSlices();
+	clearInspector();
+	setInspectorEnabled(false);
+	clearSelectionHighlight();
+	m_currentSliceIndex = -1;
+}
+
+// ============== Ƭݹ ==============
+
+SpriteSlice SpriteSliceEditorWidget::getSliceFromTable(int row) const
+{
+	return m_slices.value(row);
+}
+
+QVector<SpriteSlice> SpriteSliceEditorWidget::getAllSlicesFromTable() const
+{
+	return m_slices;
 }
 
 int SpriteSliceEditorWidget::findSliceIndexById(const QUuid& id) const
@@ -867,7 +1150,9 @@ void SpriteSliceEditorWidget::onSliceSelectionChanged()
 	if (m_updatingSelection)
 		return;
 
-	int currentRow = ui->sliceTableWidget->currentRow();
+	// ѡģʽѡмǰУѡ仯ʱ currentIndex δ£
+	const QModelIndexList selectedRows = ui->sliceTableView->selectionModel()->selectedRows();
+	int currentRow = selectedRows.isEmpty() ? -1 : selectedRows.first().row();
 
 	if (currentRow < 0 || currentRow >= m_slices.size())
 	{
@@ -892,7 +1177,7 @@ void SpriteSliceEditorWidget::loadSliceToInspector(int sliceIndex)
 	m_updatingInspector = true;
 
 	const SpriteSlice& slice = m_slices[sliceIndex];
-	int imageHeight = m_currentPixmap.height();
+	int imageHeight = m_currentImage.height();
 
 	ui->sliceNameLineEdit->setText(slice.name);
 	ui->sliceIdLineEdit->setText(slice.id.toString(QUuid::WithoutBraces).left(8));
@@ -976,8 +1261,8 @@ void SpriteSliceEditorWidget::onApplySliceClicked()
 	slice.isDecorationOnly = ui->decorCheckBox->isChecked();
 	slice.anchor = QPointF(ui->pivotXSpinBox->value(), ui->pivotYSpinBox->value());
 
-	// ͬµ񣨰ʾʹ洢ݣ
-	updateSliceInTable(m_currentSliceIndex, slice);
+	// ֪ͨˢ¸
+	m_sliceModel->updateSlice(m_currentSliceIndex);
 
 	// ¸ʾ
 	updateSelectionHighlight(m_currentSliceIndex);
@@ -1105,11 +1390,22 @@ void SpriteSliceEditorWidget::clearSelectionHighlight()
 
 // ============== ʼ ==============
 
+void SpriteSliceEditorWidget::setThumbnailService(ThumbnailService* service)
+{
+	if (m_sliceModel)
+		m_sliceModel->setThumbnailService(service);
+}
+
 void SpriteSliceEditorWidget::initSliceTable()
 {
-	auto* table = ui->sliceTableWidget;
+	auto* table = ui->sliceTableView;
 	if (!table) return;
 
+	// ֱʾ m_slicesԤίа
+	m_sliceModel = new SliceTableModel(m_slices, this);
+	table->setModel(m_sliceModel);
+	table->setItemDelegateForColumn(SliceTableColumn::Preview, new SliceThumbnailDelegate(table));
+
 	auto* hv = table->horizontalHeader();
 	hv->setDefaultAlignment(Qt::AlignLeft | Qt::AlignVCenter);
 	hv->setStretchLastSection(true);
@@ -1118,8 +1414,6 @@ void SpriteSliceEditorWidget::initSliceTable()
 
 	table->setColumnWidth(SliceTableColumn::Preview, 80);
 	table->setColumnWidth(SliceTableColumn::Name, 160);
-
-	table->setRowCount(0);
 }
 
 // ============== ¼ ==============
@@ -1218,8 +1512,8 @@ bool SpriteSliceEditorWidget::exportConfig(const QString& jsonPath)
 	QDir jsonDir = QFileInfo(jsonPath).absoluteDir();
 	QString relativePath = jsonDir.relativeFilePath(m_currentFilePath);
 	spriteSheet["imagePath"] = relativePath;
-	spriteSheet["imageWidth"] = m_currentPixmap.width();
-	spriteSheet["imageHeight"] = m_currentPixmap.height();
+	spriteSheet["imageWidth"] = m_currentImage.width();
+	spriteSheet["imageHeight"] = m_currentImage.height();
 	root["spriteSheet"] = spriteSheet;
 
 	// 
@@ -1255,6 +1549,28 @@ bool SpriteSliceEditorWidget::exportConfig(const QString& jsonPath)
 
 		sliceObj["collisionType"] = static_cast<int>(slice.collisionType);
 
+		if (slice.isAnimated())
+		{
+			QJsonArray framesArray;
+			for (const SpriteSliceFrame& frame : slice.frames)
+			{
+				QJsonObject frameObj;
+				frameObj["x"] = frame.rect.x();
+				frameObj["y"] = frame.rect.y();
+				frameObj["duration"] = frame.duration;
+				framesArray.append(frameObj);
+			}
+			sliceObj["frames"] = framesArray;
+		}
+
+		if (slice.isTrimmed())
+		{
+			sliceObj["trimX"] = slice.trimOffset.x();
+			sliceObj["trimY"] = slice.trimOffset.y();
+			sliceObj["sourceWidth"] = slice.sourceSize.width();
+			sliceObj["sourceHeight"] = slice.sourceSize.height();
+		}
+
 		slicesArray.append(sliceObj);
 	}
 	root["slices"] = slicesArray;
@@ -1328,11 +1644,10 @@ bool SpriteSliceEditorWidget::importConfig(const QString& jsonPath)
 		ui->spacingYSpinBox->setValue(gridSettings["spacingY"].toInt(0));
 	}
 
-	// ȡƬ
-	m_slices.clear();
-	ui->sliceTableWidget->setRowCount(0);
-
+	// ȡƬݣȫһ滻ݣ
 	QJsonArray slicesArray = root["slices"].toArray();
+	QVector<SpriteSlice> slices;
+	slices.reserve(slicesArray.size());
 	for (const QJsonValue& value : slicesArray)
 	{
 		QJsonObject sliceObj = value.toObject();
@@ -1360,8 +1675,25 @@ bool SpriteSliceEditorWidget::importConfig(const QString& jsonPath)
 
 		slice.collisionType = static_cast<CollisionType>(sliceObj["collisionType"].toInt(0));
 
-		addSlice(slice);
+		// ֡Ƭͬߴ
+		for (const QJsonValue& frameValue : sliceObj["frames"].toArray())
+		{
+			const QJsonObject frameObj = frameValue.toObject();
+			slice.frames.append(SpriteSliceFrame{
+				QRect(frameObj["x"].toInt(), frameObj["y"].toInt(), slice.width, slice.height),
+				frameObj["duration"].toInt(100) });
+		}
+
+		// üϢδüƬûЩֶ
+		if (sliceObj.contains("sourceWidth") && sliceObj.contains("sourceHeight"))
+		{
+			slice.trimOffset = QPoint(sliceObj["trimX"].toInt(), sliceObj["trimY"].toInt());
+			slice.sourceSize = QSize(sliceObj["sourceWidth"].toInt(), sliceObj["sourceHeight"].toInt());
+		}
+
+		slices.append(slice);
 	}
+	m_sliceModel->resetSlices(std::move(slices));
 
 	// ռ
 	clearInspector();
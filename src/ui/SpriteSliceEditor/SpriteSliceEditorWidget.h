@@ -5,12 +5,17 @@
 
 #include <QWidget>
 #include <QGraphicsScene>
-#include <QGraphicsPixmapItem>
+#include <QImage>
 
 namespace Ui {
 	class SpriteSliceEditorWidget;
 }
 
+class SliceTableModel;
+class ThumbnailService;
+class SpriteSheetTileItem;
+class SpriteSheetGridItem;
+
 class SpriteSliceEditorWidget : public QWidget
 {
 	Q_OBJECT
@@ -21,7 +26,10 @@ public:
 
 	void initSliceTable();
 
-	// ӱȡƬ
+	// ƬԤͼͼں̨
+	void setThumbnailService(ThumbnailService* service);
+
+	// ȡƬݣʾһ£
 	QVector<SpriteSlice> getAllSlicesFromTable() const;
 	SpriteSlice getSliceFromTable(int row) const;
 
@@ -39,6 +47,8 @@ signals:
 	void SignalReturnToMainPanel();
 	// ͼ
 	void SignalSpriteSheetConfirmed(const SpriteSheetData& data);
+	// ϲظƬ SignalSpriteSheetConfirmed ֮󷢳
+	void SignalSlicesRemapped(const QString& tilesetId, const QVector<SliceRemap>& remaps);
 
 private slots:
 	// ͼ
@@ -48,9 +58,13 @@ private slots:
 
 	// 
 	void onGridSettingsChanged();
+	void onDetectGridClicked();
 	void onZoomSliderChanged(int value);
 	void onGenerateGridSlicesClicked();
 	void onClearGridSlicesClicked();
+	void onAutoSliceClicked();
+	void onDedupeSlicesClicked();
+	void onTrimSlicesClicked();
 
 	// Ƭѡ仯
 	void onSliceSelectionChanged();
@@ -83,21 +97,18 @@ private slots:
 private:
 	void setupConnections();
 	void loadSpriteSheet(const QString& filePath);
-	void displaySpriteSheet(const QPixmap& pixmap);
+	void displaySpriteSheet(const QImage& image);
 	void updateGridOverlay();
-	void clearGridOverlay();
 
-	// Ƭݹ
-	void addSlice(const SpriteSlice& slice);
+	// Ƭݹɾľ m_sliceModelˢ£
 	void removeSlice(int index);
-	void updateSliceInTable(int row, const SpriteSlice& slice);
-	void syncTableFromSlices();
 	int findSliceIndexById(const QUuid& id) const;
 
 	// Ƭ
 	int findSliceAtPoint(const QPointF& point) const;
 	QVector<int> findSlicesInRect(const QRectF& rect) const;
 	void mergeSlices(const QVector<int>& sliceIndices);
+	void createAnimation(const QVector<int>& sliceIndices);   // ͬߴƬ˳ɶ
 
 	// ѡƬ
 	void selectSlice(int sliceIndex);
@@ -124,20 +135,26 @@ private:
 
 	// 
 	QGraphicsScene* m_scene = nullptr;
-	QGraphicsPixmapItem* m_spriteSheetItem = nullptr;
-	QList<QGraphicsItem*> m_gridLines;
+	SpriteSheetTileItem* m_spriteSheetItem = nullptr;     // ֿ + mip 㼶ʾͼ
+	SpriteSheetGridItem* m_gridItem = nullptr;            // ڻʱ
 
 	QGraphicsRectItem* m_highlightRect = nullptr;
 	QGraphicsEllipseItem* m_anchorMarker = nullptr;
 
 	// ͼ
-	QPixmap m_currentPixmap;
+	QImage m_currentImage;          // ֻһΣʾͼͬһ
 	QString m_currentFilePath;
 
 	// ƬݣԴ
 	QVector<SpriteSlice> m_slices;
 	int m_currentSliceIndex = -1;
 
+	// Ƭģͣ m_slices
+	SliceTableModel* m_sliceModel = nullptr;
+
+	// ͼϲظƬضȷʱ֪ͨͼ
+	QVector<SliceRemap> m_sliceRemaps;
+
 	// Ƿڳ򻯸¿ؼ
 	bool m_updatingInspector = false;
 	bool m_updatingSelection = false;
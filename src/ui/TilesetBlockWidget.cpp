@@ -1,10 +1,91 @@
 ﻿#include "TilesetBlockWidget.h"
+#include "TilesetPaletteModel.h"
 #include "core/TileDragData.h"
 #include <QToolButton>
-#include <QListWidgetItem>
 #include <QDrag>
 #include <QMouseEvent>
 #include <QApplication>
+#include <QPainter>
+#include <QStyledItemDelegate>
+
+namespace
+{
+	// 绘制切片格子：直接从图集（或缩略图服务的结果）绘制，右下角绘制使用次数角标
+	class TilesetPaletteDelegate : public QStyledItemDelegate
+	{
+	public:
+		TilesetPaletteDelegate(const TilesetPaletteModel* model, QObject* parent)
+			: QStyledItemDelegate(parent)
+			, m_model(model)
+		{
+		}
+
+		void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+		{
+			QStyleOptionViewItem opt = option;
+			initStyleOption(&opt, index);
+			const QWidget* widget = opt.widget;
+			QStyle* style = widget ? widget->style() : QApplication::style();
+			style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, painter, widget);
+
+			const int sliceIndex = index.data(TilesetPaletteRole::SliceIndex).toInt();
+			if (sliceIndex < 0 || sliceIndex >= m_model->slices().size())
+				return;
+
+			const QSize displaySize = index.data(TilesetPaletteRole::DisplaySize).toSize();
+			const QRect target = QStyle::alignedRect(opt.direction, Qt::AlignCenter, displaySize, opt.rect);
+
+			// 裁剪过的切片只绘制裁剪后的区域，放在原始格子中的对应位置
+			const SpriteSlice& slice = m_model->slices()[sliceIndex];
+			const QRect trimmed = m_model->trimmedDisplayRect(sliceIndex).translated(target.topLeft());
+			const QImage thumb = m_model->thumbnail(index.row());
+			if (!thumb.isNull())
+			{
+				painter->drawImage(trimmed.topLeft(), thumb);
+			}
+			else
+			{
+				painter->save();
+				painter->setRenderHint(QPainter::SmoothPixmapTransform);
+				painter->drawPixmap(trimmed, m_model->atlas(), QRect(slice.x, slice.y, slice.width, slice.height));
+				painter->restore();
+			}
+
+			const int usage = index.data(TilesetPaletteRole::Usage).toInt();
+			if (usage <= 0)
+				return;
+
+			const QString text = usage > 999 ? QStringLiteral("999+") : QString::number(usage);
+
+			QFont font = option.font;
+			font.setPixelSize(9);
+			const QFontMetrics metrics(font);
+			const int h = metrics.height();
+			const int w = qMax(metrics.horizontalAdvance(text) + 6, h);
+			const QRect badge(option.rect.right() - w, option.rect.bottom() - h, w, h);
+
+			painter->save();
+			painter->setRenderHint(QPainter::Antialiasing);
+			painter->setPen(Qt::NoPen);
+			painter->setBrush(QColor(80, 140, 255));
+			painter->drawRoundedRect(badge, h / 2.0, h / 2.0);
+			painter->setFont(font);
+			painter->setPen(Qt::white);
+			painter->drawText(badge, Qt::AlignCenter, text);
+			painter->restore();
+		}
+
+		QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override
+		{
+			Q_UNUSED(option);
+			// 布局只读取模型中缓存的尺寸
+			return index.data(Qt::SizeHintRole).toSize();
+		}
+
+	private:
+		const TilesetPaletteModel* m_model;
+	};
+}
 
 TilesetBlockWidget::TilesetBlockWidget(const QString& tilesetId,
 	int columns,
@@ -24,23 +105,35 @@ TilesetBlockWidget::TilesetBlockWidget(const QString& tilesetId,
 	setupDragDrop();
 }
 
+void TilesetBlockWidget::setThumbnailService(ThumbnailService* service)
+{
+	m_model->setThumbnailService(service);
+}
+
 void TilesetBlockWidget::initializeList(int thumbSize)
 {
+	m_model = new TilesetPaletteModel(this);
+
 	auto* list = ui.listTiles;
+	list->setModel(m_model);
 	list->setViewMode(QListView::IconMode);
 	list->setFlow(QListView::LeftToRight);
 	list->setWrapping(true);
 	list->setResizeMode(QListView::Adjust);
 	list->setMovement(QListView::Static);
+	// 大图集分批布局，避免一次性阻塞界面
+	list->setLayoutMode(QListView::Batched);
+	list->setBatchSize(512);
 	list->setSpacing(4);
 	list->setFocusPolicy(Qt::NoFocus);
 	list->setSelectionMode(QAbstractItemView::SingleSelection);
 	list->setFrameShape(QFrame::NoFrame);
 	list->setEditTriggers(QAbstractItemView::NoEditTriggers);
 	list->setIconSize(QSize(thumbSize, thumbSize));
+	list->setItemDelegate(new TilesetPaletteDelegate(m_model, list));
 	list->setStyleSheet(QStringLiteral(
-		"QListWidget { background: transparent; }"
-		"QListWidget::item { border: 0; padding: 2px; }"));
+		"QListView { background: transparent; }"
+		"QListView::item { border: 0; padding: 2px; }"));
 }
 
 void TilesetBlockWidget::setupDragDrop()
@@ -61,45 +154,45 @@ bool TilesetBlockWidget::eventFilter(QObject* watched, QEvent* event)
 			if (me->button() == Qt::LeftButton)
 			{
 				m_dragStartPos = me->pos();
-				m_dragItem = ui.listTiles->itemAt(me->pos());
+				m_dragIndex = ui.listTiles->indexAt(me->pos());
 			}
 		}
 		else if (event->type() == QEvent::MouseMove)
 		{
 			auto* me = static_cast<QMouseEvent*>(event);
-			if ((me->buttons() & Qt::LeftButton) && m_dragItem)
+			if ((me->buttons() & Qt::LeftButton) && m_dragIndex.isValid())
 			{
 				int distance = (me->pos() - m_dragStartPos).manhattanLength();
 				if (distance >= QApplication::startDragDistance())
 				{
-					startDrag(m_dragItem);
-					m_dragItem = nullptr;
+					startDrag(m_dragIndex);
+					m_dragIndex = QPersistentModelIndex();
 					return true;
 				}
 			}
 		}
 		else if (event->type() == QEvent::MouseButtonRelease)
 		{
-			m_dragItem = nullptr;
+			m_dragIndex = QPersistentModelIndex();
 		}
 	}
 	return QWidget::eventFilter(watched, event);
 }
 
-void TilesetBlockWidget::startDrag(QListWidgetItem* item)
+void TilesetBlockWidget::startDrag(const QModelIndex& modelIndex)
 {
-	if (!item)
+	if (!modelIndex.isValid())
 		return;
 
-	int index = item->data(Qt::UserRole).toInt();
-	if (index < 0 || index >= m_slices.size())
+	int index = modelIndex.data(TilesetPaletteRole::SliceIndex).toInt();
+	if (index < 0 || index >= m_model->slices().size())
 		return;
 
 	// 创建拖拽数据
 	TileDragData dragData;
 	dragData.tilesetId = m_tilesetId;
 	dragData.sliceIndex = index;
-	dragData.slice = m_slices[index];
+	dragData.slice = m_model->slices()[index];
 	dragData.pixmap = getSlicePixmap(index);
 
 	auto* mimeData = new TileMimeData(dragData);
@@ -124,98 +217,50 @@ void TilesetBlockWidget::startDrag(QListWidgetItem* item)
 
 SpriteSlice TilesetBlockWidget::getSlice(int index) const
 {
-	if (index >= 0 && index < m_slices.size())
-		return m_slices[index];
-	return SpriteSlice();
+	return m_model->slices().value(index);
 }
 
 QPixmap TilesetBlockWidget::getSlicePixmap(int index) const
 {
-	if (index < 0 || index >= m_slices.size() || m_atlas.isNull())
+	const QVector<SpriteSlice>& slices = m_model->slices();
+	if (index < 0 || index >= slices.size() || m_model->atlas().isNull())
 		return QPixmap();
 
-	const auto& slice = m_slices[index];
-	return m_atlas.copy(slice.x, slice.y, slice.width, slice.height);
+	return slices[index].cellPixmap(m_model->atlas());
 }
 
-void TilesetBlockWidget::populateDemo(int rows, int cols, int thumbSize)
+void TilesetBlockWidget::setSliceUsage(const QHash<QUuid, int>& usage)
 {
-	auto* list = ui.listTiles;
-	list->clear();
-	const int count = rows * cols;
-	for (int i = 0; i < count; ++i)
-	{
-		auto* item = new QListWidgetItem;
-		item->setToolTip(QStringLiteral("Tile %1").arg(i));
-		item->setSizeHint(QSize(thumbSize, thumbSize));
-		item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-		list->addItem(item);
-	}
+	m_model->setSliceUsage(usage);
 }
 
-void TilesetBlockWidget::setTilesetData(const QPixmap& atlas, const QVector<SpriteSlice>& slices, int thumbSize)
+void TilesetBlockWidget::updateSliceUsage(const QVector<QPair<int, int>>& changes)
 {
-	m_atlas = atlas;
-	m_slices = slices;
-	m_thumbSize = thumbSize;
-
-	if (atlas.isNull() || slices.isEmpty())
-		return;
-
-	auto* list = ui.listTiles;
-	list->clear();
-
-	// 计算最大尺寸用于 iconSize
-	int maxWidth = thumbSize;
-	int maxHeight = thumbSize;
-
-	for (const auto& slice : slices)
-	{
-		const int maxDim = thumbSize * 3;
-		QSize originalSize(slice.width, slice.height);
-		QSize scaledSize = originalSize;
-
-		if (slice.width > maxDim || slice.height > maxDim)
-		{
-			scaledSize = originalSize.scaled(maxDim, maxDim, Qt::KeepAspectRatio);
-		}
-
-		maxWidth = qMax(maxWidth, scaledSize.width());
-		maxHeight = qMax(maxHeight, scaledSize.height());
-	}
+	m_model->updateSliceUsage(changes);
+}
 
-	list->setIconSize(QSize(maxWidth, maxHeight));
+void TilesetBlockWidget::setSliceFilter(const QVector<int>& sliceIndices)
+{
+	m_model->setFilter(sliceIndices);
+}
 
-	// 填充精灵图
-	for (int i = 0; i < slices.size(); ++i)
-	{
-		const auto& slice = slices[i];
+void TilesetBlockWidget::clearSliceFilter()
+{
+	m_model->clearFilter();
+}
 
-		const int maxDim = thumbSize * 3;
-		QSize originalSize(slice.width, slice.height);
-		QSize displaySize = originalSize;
+void TilesetBlockWidget::populateDemo(int rows, int cols, int thumbSize)
+{
+	m_model->setPlaceholders(rows * cols, QSize(thumbSize, thumbSize));
+}
 
-		if (slice.width > maxDim || slice.height > maxDim)
-		{
-			displaySize = originalSize.scaled(maxDim, maxDim, Qt::KeepAspectRatio);
-		}
+void TilesetBlockWidget::setTilesetData(const QPixmap& atlas, const QVector<SpriteSlice>& slices, int thumbSize, const QString& atlasPath)
+{
+	m_thumbSize = thumbSize;
 
-		QPixmap tile = atlas.copy(slice.x, slice.y, slice.width, slice.height)
-			.scaled(displaySize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-
-		auto* item = new QListWidgetItem;
-		item->setIcon(QIcon(tile));
-		item->setToolTip(QStringLiteral("%1\n(%2,%3) %4x%5")
-			.arg(slice.name)
-			.arg(slice.x)
-			.arg(slice.y)
-			.arg(slice.width)
-			.arg(slice.height));
-		item->setData(Qt::UserRole, i);
-		item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-		item->setSizeHint(QSize(displaySize.width() + 8, displaySize.height() + 8));
-		list->addItem(item);
-	}
+	// 一次遍历算出每格的显示尺寸，图标不预先生成
+	m_model->setTilesetData(atlas, slices, thumbSize * 3, atlasPath);
+	ui.listTiles->setIconSize(m_model->maxDisplaySize().expandedTo(QSize(thumbSize, thumbSize)));
 }
 
 void TilesetBlockWidget::setCollapsed(bool collapsed)
@@ -250,9 +295,10 @@ void TilesetBlockWidget::updateCollapsedState()
 
 void TilesetBlockWidget::connectSignals()
 {
-	connect(ui.listTiles, &QListWidget::itemClicked, this, [this](QListWidgetItem* item) {
-		const int index = item->data(Qt::UserRole).toInt();
-		emit tileSelected(m_tilesetId, index);
+	connect(ui.listTiles, &QListView::clicked, this, [this](const QModelIndex& index) {
+		const int sliceIndex = index.data(TilesetPaletteRole::SliceIndex).toInt();
+		if (sliceIndex >= 0)
+			emit tileSelected(m_tilesetId, sliceIndex);
 		});
 
 	connect(ui.buttonCollapse, &QToolButton::toggled, this, [this](bool checked) {
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <QWidget>
-#include <QListWidget>
+#include <QListView>
+#include <QHash>
+#include <QUuid>
 #include "ui_TilesetBlockWidget.h"
 #include "core/SpriteSliceDefine.h"
 
+class ThumbnailService;
+class TilesetPaletteModel;
+
 class TilesetBlockWidget : public QWidget
 {
 	Q_OBJECT
@@ -15,8 +20,11 @@ public:
 		int demoRows,
 		QWidget* parent = nullptr);
 
+	// СʾƬʹͼں̨ɵĽδʱֱӴͼ
+	void setThumbnailService(ThumbnailService* service);
+
 	QString tilesetId() const { return m_tilesetId; }
-	void setTilesetData(const QPixmap& atlas, const QVector<SpriteSlice>& slices, int thumbSize);
+	void setTilesetData(const QPixmap& atlas, const QVector<SpriteSlice>& slices, int thumbSize, const QString& atlasPath = QString());
 	void setCollapsed(bool collapsed);
 	bool isCollapsed() const { return m_collapsed; }
 
@@ -24,6 +32,14 @@ public:
 	SpriteSlice getSlice(int index) const;
 	QPixmap getSlicePixmap(int index) const;
 
+	// ƬʹôǱ꣨ / ֻ¸ (Ƭ±, ʹô)
+	void setSliceUsage(const QHash<QUuid, int>& usage);
+	void updateSliceUsage(const QVector<QPair<int, int>>& changes);
+
+	// ˣֻʾ±Ƭ
+	void setSliceFilter(const QVector<int>& sliceIndices);
+	void clearSliceFilter();
+
 signals:
 	void tileSelected(const QString& tilesetId, int tileIndex);
 	void removeRequested(const QString& tilesetId);
@@ -38,17 +54,16 @@ private:
 
 	// ק¼
 	bool eventFilter(QObject* watched, QEvent* event) override;
-	void startDrag(QListWidgetItem* item);
+	void startDrag(const QModelIndex& index);
 
 private:
 	Ui::TilesetBlockWidget ui;
 	QString m_tilesetId;
-	QPixmap m_atlas;
-	QVector<SpriteSlice> m_slices;
+	TilesetPaletteModel* m_model = nullptr;
 	int m_thumbSize = 32;
 	bool m_collapsed = false;
 
 	// ק
 	QPoint m_dragStartPos;
-	QListWidgetItem* m_dragItem = nullptr;
+	QPersistentModelIndex m_dragIndex;
 };
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "TilesetPaletteModel.h"
+#include "app/ThumbnailService.h"
+
+#include <algorithm>
+
+namespace
+{
+	// ͼӱԵ
+	constexpr int CellPadding = 8;
+
+	QString sliceToolTip(const SpriteSlice& slice, int usage)
+	{
+		return QStringLiteral("%1\n(%2,%3) %4x%5\nʹ: %6")
+			.arg(slice.name)
+			.arg(slice.x)
+			.arg(slice.y)
+			.arg(slice.width)
+			.arg(slice.height)
+			.arg(usage);
+	}
+}
+
+TilesetPaletteModel::TilesetPaletteModel(QObject* parent)
+	: QAbstractListModel(parent)
+{
+}
+
+TilesetPaletteModel::~TilesetPaletteModel()
+{
+	if (m_thumbnailService)
+		m_thumbnailService->releaseImage(m_atlasKey);
+}
+
+void TilesetPaletteModel::setThumbnailService(ThumbnailService* service)
+{
+	if (m_thumbnailService == service)
+		return;
+
+	if (m_thumbnailService)
+	{
+		disconnect(m_thumbnailService, nullptr, this, nullptr);
+		m_thumbnailService->releaseImage(m_atlasKey);
+	}
+
+	m_thumbnailService = service;
+	m_pendingRows.clear();
+	m_atlasKey = (m_thumbnailService && !m_atlas.isNull())
+		? m_thumbnailService->registerImage(m_atlas.toImage(), m_atlasPath)
+		: QString();
+
+	if (m_thumbnailService)
+		connect(m_thumbnailService, &ThumbnailService::thumbnailReady, this, &TilesetPaletteModel::onThumbnailReady);
+}
+
+void TilesetPaletteModel::setTilesetData(const QPixmap& atlas, const QVector<SpriteSlice>& slices, int maxDim, const QString& atlasPath)
+{
+	beginResetModel();
+
+	if (m_thumbnailService)
+	{
+		m_thumbnailService->releaseImage(m_atlasKey);
+		m_atlasKey = atlas.isNull() ? QString() : m_thumbnailService->registerImage(atlas.toImage(), atlasPath);
+	}
+	m_pendingRows.clear();
+
+	m_atlas = atlas;
+	m_atlasPath = atlasPath;
+	m_slices = slices;
+	m_placeholderCount = 0;
+	m_filtered = false;
+	m_rows.clear();
+
+	m_displaySizes.resize(slices.size());
+	m_usage.fill(0, slices.size());
+	m_maxDisplaySize = QSize();
+
+	for (int i = 0; i < slices.size(); ++i)
+	{
+		const QSize originalSize(slices[i].sourceWidth(), slices[i].sourceHeight());
+		QSize displaySize = originalSize;
+		if (originalSize.width() > maxDim || originalSize.height() > maxDim)
+			displaySize = originalSize.scaled(maxDim, maxDim, Qt::KeepAspectRatio);
+
+		m_displaySizes[i] = displaySize;
+		m_maxDisplaySize = m_maxDisplaySize.expandedTo(displaySize);
+	}
+
+	endResetModel();
+}
+
+void TilesetPaletteModel::setPlaceholders(int count, const QSize& size)
+{
+	beginResetModel();
+	m_placeholderCount = m_slices.isEmpty() ? count : 0;
+	m_placeholderSize = size;
+	endResetModel();
+}
+
+void TilesetPaletteModel::setSliceUsage(const QHash<QUuid, int>& usage)
+{
+	// ֵֻ֪ͨ仯ķΧ
+	int first = -1;
+	int last = -1;
+	for (int row = 0; row < m_slices.size(); ++row)
+	{
+		const int count = usage.value(m_slices[row].id, 0);
+		if (m_usage[row] == count)
+			continue;
+
+		m_usage[row] = count;
+		if (first < 0)
+			first = row;
+		last = row;
+	}
+
+	if (first < 0)
+		return;
+
+	// ʱкƬ±겻Ӧ֪ͨʾ
+	if (m_filtered)
+	{
+		if (!m_rows.isEmpty())
+			emit dataChanged(index(0), index(m_rows.size() - 1), { TilesetPaletteRole::Usage, Qt::ToolTipRole });
+		return;
+	}
+
+	emit dataChanged(index(first), index(last), { TilesetPaletteRole::Usage, Qt::ToolTipRole });
+}
+
+void TilesetPaletteModel::updateSliceUsage(const QVector<QPair<int, int>>& changes)
+{
+	for (const auto& change : changes)
+	{
+		const int sliceIndex = change.first;
+		if (sliceIndex < 0 || sliceIndex >= m_usage.size() || m_usage[sliceIndex] == change.second)
+			continue;
+
+		m_usage[sliceIndex] = change.second;
+
+		// ʱ±Уڹ˽еƬҪ֪ͨ
+		int row = sliceIndex;
+		if (m_filtered)
+		{
+			auto it = std::lower_bound(m_rows.cbegin(), m_rows.cend(), sliceIndex);
+			if (it == m_rows.cend() || *it != sliceIndex)
+				continue;
+			row = static_cast<int>(it - m_rows.cbegin());
+		}
+		emit dataChanged(index(row), index(row), { TilesetPaletteRole::Usage, Qt::ToolTipRole });
+	}
+}
+
+void TilesetPaletteModel::setFilter(const QVector<int>& sliceIndices)
+{
+	beginResetModel();
+	m_filtered = true;
+	m_rows.clear();
+	m_rows.reserve(sliceIndices.size());
+	for (int sliceIndex : sliceIndices)
+	{
+		if (sliceIndex >= 0 && sliceIndex < m_slices.size())
+			m_rows.append(sliceIndex);
+	}
+	m_pendingRows.clear();
+	endResetModel();
+}
+
+void TilesetPaletteModel::clearFilter()
+{
+	if (!m_filtered)
+		return;
+
+	beginResetModel();
+	m_filtered = false;
+	m_rows.clear();
+	m_pendingRows.clear();
+	endResetModel();
+}
+
+QImage TilesetPaletteModel::thumbnail(int row) const
+{
+	const int sliceIndex = sliceIndexOfRow(row);
+	if (!m_thumbnailService || sliceIndex < 0 || sliceIndex >= m_slices.size())
+		return QImage();
+
+	// ԭߴʾƬֱӴͼƼ
+	const SpriteSlice& slice = m_slices[sliceIndex];
+	const QRect rect(slice.x, slice.y, slice.width, slice.height);
+	const QSize size = trimmedDisplayRect(sliceIndex).size();
+	if (rect.size() == size)
+		return QImage();
+
+	const QImage image = m_thumbnailService->thumbnail(m_atlasKey, rect, size);
+	if (image.isNull())
+	{
+		QVector<int>& rows = m_pendingRows[ThumbnailService::thumbnailKey(m_atlasKey, rect, size)];
+		if (!rows.contains(row))
+			rows.append(row);
+	}
+	return image;
+}
+
+QRect TilesetPaletteModel::trimmedDisplayRect(int sliceIndex) const
+{
+	if (sliceIndex < 0 || sliceIndex >= m_slices.size())
+		return QRect();
+
+	const SpriteSlice& slice = m_slices[sliceIndex];
+	const QSize displaySize = m_displaySizes[sliceIndex];
+	const double sx = static_cast<double>(displaySize.width()) / slice.sourceWidth();
+	const double sy = static_cast<double>(displaySize.height()) / slice.sourceHeight();
+	return QRect(qRound(slice.trimOffset.x() * sx), qRound(slice.trimOffset.y() * sy),
+		qMax(1, qRound(slice.width * sx)), qMax(1, qRound(slice.height * sy)));
+}
+
+int TilesetPaletteModel::rowCount(const QModelIndex& parent) const
+{
+	if (parent.isValid())
+		return 0;
+	if (m_slices.isEmpty())
+		return m_placeholderCount;
+	return m_filtered ? m_rows.size() : m_slices.size();
+}
+
+QVariant TilesetPaletteModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= rowCount())
+		return QVariant();
+
+	const int row = index.row();
+	if (m_slices.isEmpty())
+	{
+		switch (role)
+		{
+		case Qt::ToolTipRole: return QStringLiteral("Tile %1").arg(row);
+		case Qt::SizeHintRole: return m_placeholderSize;
+		case TilesetPaletteRole::SliceIndex: return -1;
+		default: return QVariant();
+		}
+	}
+
+	const int sliceIndex = sliceIndexOfRow(row);
+	switch (role)
+	{
+	case Qt::ToolTipRole:
+		return sliceToolTip(m_slices[sliceIndex], m_usage[sliceIndex]);
+	case Qt::SizeHintRole:
+		return m_displaySizes[sliceIndex] + QSize(CellPadding, CellPadding);
+	case TilesetPaletteRole::SliceIndex:
+		return sliceIndex;
+	case TilesetPaletteRole::Usage:
+		return m_usage[sliceIndex];
+	case TilesetPaletteRole::DisplaySize:
+		return m_displaySizes[sliceIndex];
+	default:
+		return QVariant();
+	}
+}
+
+Qt::ItemFlags TilesetPaletteModel::flags(const QModelIndex& index) const
+{
+	if (!index.isValid())
+		return Qt::NoItemFlags;
+	return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsDragEnabled;
+}
+
+void TilesetPaletteModel::onThumbnailReady(const QString& key)
+{
+	const QVector<int> rows = m_pendingRows.take(key);
+	for (int row : rows)
+	{
+		if (row < rowCount())
+			emit dataChanged(index(row), index(row), { Qt::DecorationRole });
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QPixmap>
+#include <QUuid>
+#include "core/SpriteSliceDefine.h"
+
+class ThumbnailService;
+
+namespace TilesetPaletteRole
+{
+	enum Role
+	{
+		SliceIndex = Qt::UserRole,      // Ƭ±꣨ռλΪ -1
+		Usage = Qt::UserRole + 1,       // ͼϵʹô
+		DisplaySize = Qt::UserRole + 2, // ͼʾߴ
+	};
+}
+
+// ͼƬģͣÿƬһ QListWidgetItem
+// - ÿֻʾߴʹôԤͼ
+// - ίڻƿɼʱֱӴͼȡͼСʾƬʹͼĽֻˢµȴУ
+// - ֻ滻еƬ±ӳ䣬ݲ
+class TilesetPaletteModel : public QAbstractListModel
+{
+	Q_OBJECT
+public:
+	explicit TilesetPaletteModel(QObject* parent = nullptr);
+	~TilesetPaletteModel();
+
+	void setThumbnailService(ThumbnailService* service);
+
+	// ͼݣʾߴ簴 maxDim ȱСһαɲ֣
+	// atlasPath ΪͼԴļͼݴʶͬһͼ
+	void setTilesetData(const QPixmap& atlas, const QVector<SpriteSlice>& slices, int maxDim, const QString& atlasPath = QString());
+
+	// ݼǰʾĿհ׸
+	void setPlaceholders(int count, const QSize& size);
+
+	void setSliceUsage(const QHash<QUuid, int>& usage);
+	// ֻ¸Ƭ±, ʹôڵ
+	void updateSliceUsage(const QVector<QPair<int, int>>& changes);
+
+	// ֻʾƬ±꣩ˣͼʱ
+	void setFilter(const QVector<int>& sliceIndices);
+	void clearFilter();
+	bool isFiltered() const { return m_filtered; }
+
+	const QPixmap& atlas() const { return m_atlas; }
+	const QVector<SpriteSlice>& slices() const { return m_slices; }
+	// Ƭʾߴ
+	QSize maxDisplaySize() const { return m_maxDisplaySize; }
+
+	// СʾƬͼҪͼδʱؿͼʱֱӴͼƣ
+	// ͼüɣ trimmedDisplayRect λ
+	QImage thumbnail(int row) const;
+
+	// üʾеλúͳߴ磨δüʱʾӣ
+	QRect trimmedDisplayRect(int sliceIndex) const;
+
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+private:
+	void onThumbnailReady(const QString& key);
+	int sliceIndexOfRow(int row) const { return m_filtered ? m_rows.value(row, -1) : row; }
+
+private:
+	QPixmap m_atlas;
+	QString m_atlasPath;
+	QVector<SpriteSlice> m_slices;
+	QVector<QSize> m_displaySizes;  // ÿеʾߴ
+	QVector<int> m_usage;           // ÿеʹô
+	QSize m_maxDisplaySize;
+
+	bool m_filtered = false;
+	QVector<int> m_rows;            // ʱ -> Ƭ±
+
+	int m_placeholderCount = 0;
+	QSize m_placeholderSize;
+
+	ThumbnailService* m_thumbnailService = nullptr;
+	QString m_atlasKey;                         // ͼͼеļ
+	mutable QHash<QString, QVector<int>> m_pendingRows; // δͼ -> ȴ
+};
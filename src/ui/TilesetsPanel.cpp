@@ -19,6 +19,7 @@ TilesetsPanel::TilesetsPanel(QWidget* parent)
 
 void TilesetsPanel::connectSignals()
 {
+	connect(ui.editSearch, &QLineEdit::textChanged, this, &TilesetsPanel::applySearch);
 	connect(ui.editSearch, &QLineEdit::textChanged, this, &TilesetsPanel::searchTextChanged);
 	connect(ui.buttonAddTileset, &QToolButton::clicked, this, &TilesetsPanel::addTilesetRequested);
 }
@@ -48,23 +49,97 @@ void TilesetsPanel::removeTilesetById(const QString& id)
 		block->deleteLater();
 	}
 
+	for (const SpriteSlice& slice : m_tilesetDataMap.value(id).slices)
+		m_sliceLocator.remove(slice.id);
+
 	m_tilesetDataMap.remove(id);
+	m_searchIndex.removeTileset(id);
+}
+
+void TilesetsPanel::applySearch(const QString& text)
+{
+	m_searchText = text;
+
+	const QHash<QString, QVector<int>> hits = m_searchIndex.query(text);
+	for (auto it = m_tilesetBlocks.constBegin(); it != m_tilesetBlocks.constEnd(); ++it)
+		applySearchTo(it.key(), hits);
+}
+
+void TilesetsPanel::applySearchTo(const QString& tilesetId, const QHash<QString, QVector<int>>& hits)
+{
+	TilesetBlockWidget* block = m_tilesetBlocks.value(tilesetId);
+	if (!block)
+		return;
+
+	if (SliceSearchIndex::tokenize(m_searchText).isEmpty())
+	{
+		block->clearSliceFilter();
+		block->setVisible(true);
+		return;
+	}
+
+	// 没有命中的图集整块隐藏
+	auto hit = hits.constFind(tilesetId);
+	if (hit == hits.constEnd())
+	{
+		block->setSliceFilter(QVector<int>());
+		block->setVisible(false);
+		return;
+	}
+
+	block->setSliceFilter(hit.value());
+	block->setVisible(true);
 }
 
 void TilesetsPanel::onSpriteSheetConfirmed(const SpriteSheetData& data)
 {
 	const QString tilesetId = data.fileName.isEmpty() ? QStringLiteral("Tileset") : data.fileName;
 	const int columns = 8;
+
+	// 重新确认同一图集：先移除旧的面板和切片索引（切片可能已被合并或删除）
+	removeTilesetById(tilesetId);
 	const int thumbSize = 40;
 
 	auto* widget = new TilesetBlockWidget(tilesetId, columns, thumbSize, 1, this);
-	widget->setTilesetData(data.pixmap, data.slices, thumbSize);
+	widget->setThumbnailService(m_thumbnailService);
+	widget->setTilesetData(data.pixmap, data.slices, thumbSize, data.filePath);
+	widget->setSliceUsage(m_sliceUsage);
 
 	insertTilesetWidget(widget);
 	m_tilesetBlocks.insert(tilesetId, widget);
 
 	// 保存完整的 SpriteSheetData
 	m_tilesetDataMap.insert(tilesetId, data);
+
+	for (int i = 0; i < data.slices.size(); ++i)
+		m_sliceLocator.insert(data.slices[i].id, qMakePair(tilesetId, i));
+
+	m_searchIndex.addTileset(tilesetId, data.slices);
+	if (!SliceSearchIndex::tokenize(m_searchText).isEmpty())
+		applySearchTo(tilesetId, m_searchIndex.query(m_searchText));
+}
+
+void TilesetsPanel::applySliceUsageDelta(const QHash<QUuid, int>& delta)
+{
+	QHash<QString, QVector<QPair<int, int>>> changes;  // 图集 ID -> (切片下标, 新的使用次数)
+	for (auto it = delta.constBegin(); it != delta.constEnd(); ++it)
+	{
+		int& count = m_sliceUsage[it.key()];
+		count = qMax(0, count + it.value());
+		const int usage = count;
+		if (usage == 0)
+			m_sliceUsage.remove(it.key());
+
+		auto located = m_sliceLocator.constFind(it.key());
+		if (located != m_sliceLocator.constEnd())
+			changes[located->first].append(qMakePair(located->second, usage));
+	}
+
+	for (auto it = changes.constBegin(); it != changes.constEnd(); ++it)
+	{
+		if (TilesetBlockWidget* block = m_tilesetBlocks.value(it.key()))
+			block->updateSliceUsage(it.value());
+	}
 }
 
 QVector<SpriteSheetData> TilesetsPanel::getAllTilesetData() const
@@ -94,24 +169,49 @@ void TilesetsPanel::clearAllTilesets()
 
 	m_tilesetBlocks.clear();
 	m_tilesetDataMap.clear();
+	m_sliceLocator.clear();
+	m_searchIndex.clear();
 }
 
 bool TilesetsPanel::findSliceById(const QString& tilesetId, const QString& sliceId, SpriteSlice& outSlice, QPixmap& outPixmap) const
 {
-	if (!m_tilesetDataMap.contains(tilesetId))
+	return findSliceById(tilesetId, QUuid::fromString(sliceId), outSlice, outPixmap);
+}
+
+bool TilesetsPanel::findSliceById(const QString& tilesetId, const QUuid& sliceId, SpriteSlice& outSlice, QPixmap& outPixmap) const
+{
+	auto located = m_sliceLocator.constFind(sliceId);
+	if (located == m_sliceLocator.constEnd() || located->first != tilesetId)
 		return false;
 
-	const SpriteSheetData& data = m_tilesetDataMap[tilesetId];
+	auto dataIt = m_tilesetDataMap.constFind(tilesetId);
+	if (dataIt == m_tilesetDataMap.constEnd() || located->second >= dataIt->slices.size())
+		return false;
 
-	for (const SpriteSlice& slice : data.slices)
-	{
-		if (slice.id.toString(QUuid::WithoutBraces) == sliceId)
-		{
-			outSlice = slice;
-			outPixmap = data.pixmap.copy(slice.x, slice.y, slice.width, slice.height);
-			return true;
-		}
-	}
+	const SpriteSlice& slice = dataIt->slices[located->second];
+	outSlice = slice;
+	// 只取裁剪后的区域，再放回原始格子中，地图上的位置和占用不变
+	outPixmap = slice.cellPixmap(dataIt->pixmap);
+	return true;
+}
+
+bool TilesetsPanel::findSliceFrames(const QString& tilesetId, const QUuid& sliceId, QVector<QPixmap>& outFrames) const
+{
+	auto located = m_sliceLocator.constFind(sliceId);
+	if (located == m_sliceLocator.constEnd() || located->first != tilesetId)
+		return false;
+
+	auto dataIt = m_tilesetDataMap.constFind(tilesetId);
+	if (dataIt == m_tilesetDataMap.constEnd() || located->second >= dataIt->slices.size())
+		return false;
+
+	const SpriteSlice& slice = dataIt->slices[located->second];
+	if (!slice.isAnimated())
+		return false;
 
-	return false;
+	outFrames.clear();
+	outFrames.reserve(slice.frames.size());
+	for (const SpriteSliceFrame& frame : slice.frames)
+		outFrames.append(slice.cellPixmap(dataIt->pixmap, frame.rect));
+	return true;
 }
\ No newline at end of file
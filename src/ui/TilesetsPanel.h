@@ -1,9 +1,14 @@
 ﻿#pragma once
 #include <QWidget>
 #include <QMap>
+#include <QHash>
+#include <QUuid>
 #include "ui_TilesetsPanel.h"
 #include "TilesetBlockWidget.h"
 #include "core/SpriteSliceDefine.h"
+#include "core/SliceSearchIndex.h"
+
+class ThumbnailService;
 
 class TilesetsPanel : public QWidget
 {
@@ -11,6 +16,9 @@ class TilesetsPanel : public QWidget
 public:
 	explicit TilesetsPanel(QWidget* parent = nullptr);
 
+	// 图集缩略图由缩略图服务在后台生成（需在加载图集前设置）
+	void setThumbnailService(ThumbnailService* service) { m_thumbnailService = service; }
+
 	Ui::TilesetsPanel ui;
 
 	// 获取所有已加载的图集数据（用于导出）
@@ -21,6 +29,10 @@ public:
 
 	// 根据 tilesetId 查找切片
 	bool findSliceById(const QString& tilesetId, const QString& sliceId, SpriteSlice& outSlice, QPixmap& outPixmap) const;
+	bool findSliceById(const QString& tilesetId, const QUuid& sliceId, SpriteSlice& outSlice, QPixmap& outPixmap) const;
+
+	// 动画切片各帧的原始图像（静态切片返回 false）
+	bool findSliceFrames(const QString& tilesetId, const QUuid& sliceId, QVector<QPixmap>& outFrames) const;
 
 signals:
 	void searchTextChanged(const QString& text);
@@ -32,11 +44,25 @@ signals:
 public slots:
 	void onSpriteSheetConfirmed(const SpriteSheetData& data);
 
+	// 切片在地图上的使用次数变化：只转给切片所在的图集，只刷新变化的行
+	void applySliceUsageDelta(const QHash<QUuid, int>& delta);
+
 private:
 	void connectSignals();
 	void insertTilesetWidget(TilesetBlockWidget* w);
 	void removeTilesetById(const QString& id);
 
+	// 按搜索框内容过滤各图集（没有可搜索的词时全部显示）
+	void applySearch(const QString& text);
+	void applySearchTo(const QString& tilesetId, const QHash<QString, QVector<int>>& hits);
+
 	QMap<QString, TilesetBlockWidget*> m_tilesetBlocks;
 	QMap<QString, SpriteSheetData> m_tilesetDataMap;  // 保存完整的 SpriteSheetData
+	QHash<QUuid, QPair<QString, int>> m_sliceLocator; // 切片 ID -> (图集 ID, 切片下标)
+	QHash<QUuid, int> m_sliceUsage;                   // 切片 ID -> 使用次数
+	ThumbnailService* m_thumbnailService = nullptr;
+
+	// 搜索
+	SliceSearchIndex m_searchIndex;
+	QString m_searchText;
 };
\ No newline at end of file